@@ -110,6 +110,9 @@ DEFINE_mInt32(max_fill_rate, "2");
 
 DEFINE_mInt32(double_resize_threshold, "23");
 
+DEFINE_mInt64(parallel_hash_join_build_min_rows, "1048576");
+DEFINE_Int32(parallel_hash_join_build_thread_num, "0");
+
 // The maximum low water mark of the system `/proc/meminfo/MemAvailable`, Unit byte, default 1.6G,
 // actual low water mark=min(1.6G, MemTotal * 10%), avoid wasting too much memory on machines
 // with large memory larger than 16G.
@@ -156,6 +159,7 @@ DEFINE_Int32(tablet_publish_txn_max_thread, "32");
 DEFINE_Int32(publish_version_task_timeout_s, "8");
 // the count of thread to calc delete bitmap
 DEFINE_Int32(calc_delete_bitmap_max_thread, "32");
+DEFINE_mInt32(calc_delete_bitmap_rows_per_task, "262144");
 // the count of thread to clear transaction task
 DEFINE_Int32(clear_transaction_task_worker_count, "1");
 // the count of thread to delete
@@ -243,6 +247,14 @@ DEFINE_Validator(doris_scanner_thread_pool_thread_num, [](const int config) -> b
 DEFINE_Int32(doris_max_remote_scanner_thread_pool_thread_num, "-1");
 // number of olap scanner thread pool queue size
 DEFINE_Int32(doris_scanner_thread_pool_queue_size, "102400");
+DEFINE_mBool(enable_io_uring, "false");
+DEFINE_Int32(io_uring_queue_depth, "64");
+DEFINE_mInt32(segment_page_prefetch_num, "0");
+DEFINE_mInt32(segment_prefetch_window_rows, "0");
+DEFINE_mInt64(segment_prefetch_max_gap_bytes, "65536");
+DEFINE_mInt64(segment_prefetch_max_read_bytes, "8388608");
+DEFINE_mBool(enable_scan_late_materialization, "false");
+DEFINE_mBool(enable_bitpacked_integer_encoding, "false");
 // default thrift client connect timeout(in seconds)
 DEFINE_mInt32(thrift_connect_timeout_seconds, "3");
 DEFINE_mInt32(fetch_rpc_timeout_seconds, "30");
@@ -311,6 +323,8 @@ DEFINE_mInt32(trash_file_expire_time_sec, "259200");
 // modify them upon necessity
 DEFINE_Int32(min_file_descriptor_number, "60000");
 DEFINE_mBool(disable_segment_cache, "false");
+DEFINE_mBool(enable_segment_pruning_by_rowset_meta, "true");
+DEFINE_mInt32(rowset_meta_zone_map_max_columns, "64");
 DEFINE_Int64(index_stream_cache_capacity, "10737418240");
 DEFINE_String(row_cache_mem_limit, "20%");
 
@@ -338,6 +352,23 @@ DEFINE_mInt32(data_page_cache_stale_sweep_time_sec, "300");
 DEFINE_mInt32(index_page_cache_stale_sweep_time_sec, "600");
 DEFINE_mInt32(pk_index_page_cache_stale_sweep_time_sec, "600");
 
+DEFINE_String(data_page_cache_eviction_policy, "lru");
+DEFINE_Validator(data_page_cache_eviction_policy, [](std::string_view config) -> bool {
+    return config == "lru" || config == "slru" || config == "tinylfu";
+});
+DEFINE_String(index_page_cache_eviction_policy, "lru");
+DEFINE_Validator(index_page_cache_eviction_policy, [](std::string_view config) -> bool {
+    return config == "lru" || config == "slru" || config == "tinylfu";
+});
+DEFINE_String(pk_index_page_cache_eviction_policy, "lru");
+DEFINE_Validator(pk_index_page_cache_eviction_policy, [](std::string_view config) -> bool {
+    return config == "lru" || config == "slru" || config == "tinylfu";
+});
+DEFINE_String(page_disk_cache_path, "");
+DEFINE_Int64(page_disk_cache_capacity, "107374182400"); // 100GB
+DEFINE_Int64(page_disk_cache_slab_size, "268435456");   // 256MB
+DEFINE_Int64(page_disk_cache_write_queue_bytes, "268435456");
+
 DEFINE_Bool(enable_low_cardinality_optimize, "true");
 DEFINE_Bool(enable_low_cardinality_cache_code, "true");
 
@@ -588,10 +619,13 @@ DEFINE_Int32(memory_max_alignment, "16");
 
 // memtable insert memory tracker will multiply input block size with this ratio
 DEFINE_mDouble(memtable_insert_memory_ratio, "1.4");
+DEFINE_mBool(enable_normalized_sort_key, "true");
 // max write buffer size before flush, default 200MB
 DEFINE_mInt64(write_buffer_size, "104857600");
 // max buffer size used in memtable for the aggregated table, default 400MB
 DEFINE_mInt64(write_buffer_size_for_agg, "419430400");
+DEFINE_mInt64(memtable_merge_on_insert_rows, "65536");
+DEFINE_mDouble(memtable_merge_on_insert_min_dup_ratio, "0");
 // max parallel flush task per memtable writer
 DEFINE_mInt32(memtable_flush_running_count_limit, "2");
 
@@ -671,6 +705,7 @@ DEFINE_mInt64(storage_flood_stage_left_capacity_bytes, "1073741824"); // 1GB
 DEFINE_Int32(flush_thread_num_per_store, "6");
 // number of thread for flushing memtable per store, for high priority load task
 DEFINE_Int32(high_priority_flush_thread_num_per_store, "6");
+DEFINE_Int32(segment_column_encode_thread_num, "0");
 
 // config for tablet meta checkpoint
 DEFINE_mInt32(tablet_meta_checkpoint_min_new_rowsets_num, "10");
@@ -690,6 +725,8 @@ DEFINE_Int64(brpc_socket_max_unwritten_bytes, "-1");
 // is greater than 1.8G. This is to avoid the error of Request length overflow (2G).
 DEFINE_mBool(transfer_large_data_by_brpc, "false");
 
+DEFINE_mBool(enable_exchange_column_compression, "false");
+
 // max number of txns for every txn_partition_map in txn manager
 // this is a self protection to avoid too many txns saving in manager
 DEFINE_mInt64(max_runnings_transactions_per_txn_map, "2000");
@@ -152,6 +152,13 @@ DECLARE_mInt32(max_fill_rate);
 
 DECLARE_mInt32(double_resize_threshold);
 
+// The hash table of a hash join is built in parallel if the session variable
+// parallel_hash_join_build_num is greater than 1 and the build side has at least so many rows.
+DECLARE_mInt64(parallel_hash_join_build_min_rows);
+// number of threads building the hash tables of hash joins in parallel, the tasks of a build are
+// limited to it as well, 0 means the number of cores
+DECLARE_Int32(parallel_hash_join_build_thread_num);
+
 // The maximum low water mark of the system `/proc/meminfo/MemAvailable`, Unit byte, default 1.6G,
 // actual low water mark=min(1.6G, MemTotal * 10%), avoid wasting too much memory on machines
 // with large memory larger than 16G.
@@ -204,6 +211,9 @@ DECLARE_Int32(tablet_publish_txn_max_thread);
 DECLARE_Int32(publish_version_task_timeout_s);
 // the count of thread to calc delete bitmap
 DECLARE_Int32(calc_delete_bitmap_max_thread);
+// the rows of a segment are split into tasks of this many rows to calc their delete bitmap
+// in parallel, 0 means one task per segment
+DECLARE_mInt32(calc_delete_bitmap_rows_per_task);
 // the count of thread to clear transaction task
 DECLARE_Int32(clear_transaction_task_worker_count);
 // the count of thread to delete
@@ -285,6 +295,26 @@ DECLARE_mInt32(doris_scanner_thread_pool_thread_num);
 DECLARE_Int32(doris_max_remote_scanner_thread_pool_thread_num);
 // number of olap scanner thread pool queue size
 DECLARE_Int32(doris_scanner_thread_pool_queue_size);
+// whether to serve batched local file reads through a per-thread io_uring,
+// fallback to pread if io_uring is not supported by the kernel
+DECLARE_mBool(enable_io_uring);
+// submission queue depth of each per-thread io_uring
+DECLARE_Int32(io_uring_queue_depth);
+// number of data pages a column iterator reads ahead in one batch, 0 means disable
+DECLARE_mInt32(segment_page_prefetch_num);
+// number of rows ahead of the current batch whose data pages of all projected columns
+// are planned and read into page cache together by a segment iterator, 0 means disable
+DECLARE_mInt32(segment_prefetch_window_rows);
+// pages whose gap is not larger than this are coalesced into one read when prefetching
+DECLARE_mInt64(segment_prefetch_max_gap_bytes);
+// max size of a coalesced read when prefetching
+DECLARE_mInt64(segment_prefetch_max_read_bytes);
+// olap scanners read the columns which are not used by their filters only for the rows
+// that pass the filters, by row location
+DECLARE_mBool(enable_scan_late_materialization);
+// write integer, datev2 and datetimev2 columns with BITPACK_ENCODING instead of BIT_SHUFFLE.
+// segments written with it can not be read by older versions.
+DECLARE_mBool(enable_bitpacked_integer_encoding);
 // default thrift client connect timeout(in seconds)
 DECLARE_mInt32(thrift_connect_timeout_seconds);
 DECLARE_mInt32(fetch_rpc_timeout_seconds);
@@ -355,6 +385,11 @@ DECLARE_mInt32(trash_file_expire_time_sec);
 // modify them upon necessity
 DECLARE_Int32(min_file_descriptor_number);
 DECLARE_mBool(disable_segment_cache);
+// Prune segments of a query by the key bounds and zone maps in the rowset meta, before the
+// segments are opened.
+DECLARE_mBool(enable_segment_pruning_by_rowset_meta);
+// The zone maps of at most this many columns of each segment are kept in the rowset meta.
+DECLARE_mInt32(rowset_meta_zone_map_max_columns);
 DECLARE_Int64(index_stream_cache_capacity);
 DECLARE_String(row_cache_mem_limit);
 
@@ -385,6 +420,21 @@ DECLARE_mInt32(data_page_cache_stale_sweep_time_sec);
 DECLARE_mInt32(index_page_cache_stale_sweep_time_sec);
 // great impact on the performance of MOW, so it can be longer.
 DECLARE_mInt32(pk_index_page_cache_stale_sweep_time_sec);
+// Eviction policy of data page cache, index page cache and pk index page cache:
+// "lru", "slru" (segmented lru, pages hit more than once are protected from one-off scans)
+// or "tinylfu" (slru plus admission by access frequency once the cache is full).
+DECLARE_String(data_page_cache_eviction_policy);
+DECLARE_String(index_page_cache_eviction_policy);
+DECLARE_String(pk_index_page_cache_eviction_policy);
+// Directory on a local SSD for a second tier of the storage page cache, which keeps the
+// decompressed pages evicted from memory. Empty means disabled.
+DECLARE_String(page_disk_cache_path);
+// Disk space used by the page disk cache.
+DECLARE_Int64(page_disk_cache_capacity);
+// The page disk cache is a ring of slab files of this size, a whole slab is evicted at once.
+DECLARE_Int64(page_disk_cache_slab_size);
+// Evicted pages waiting to be written to the page disk cache, more are dropped.
+DECLARE_Int64(page_disk_cache_write_queue_bytes);
 
 DECLARE_Bool(enable_low_cardinality_optimize);
 DECLARE_Bool(enable_low_cardinality_cache_code);
@@ -639,10 +689,20 @@ DECLARE_Int32(memory_max_alignment);
 
 // memtable insert memory tracker will multiply input block size with this ratio
 DECLARE_mDouble(memtable_insert_memory_ratio);
+// sort the rows of memtables and of multi-column ORDER BY by fixed width memcmp-able prefixes
+// of their keys, comparing the key columns one by one only on ties
+DECLARE_mBool(enable_normalized_sort_key);
 // max write buffer size before flush, default 100MB
 DECLARE_mInt64(write_buffer_size);
 // max buffer size used in memtable for the aggregated table, default 400MB
 DECLARE_mInt64(write_buffer_size_for_agg);
+// rows inserted into a memtable of the aggregate or unique key model are merged into its sorted
+// run once there are this many new rows, or as many as the sorted run has, while the merges find
+// at least memtable_merge_on_insert_min_dup_ratio of the new rows to be duplicate keys.
+// the ratio is 0 by default, which merges the rows only at flush, 0.3 suits tables with a high
+// update rate.
+DECLARE_mInt64(memtable_merge_on_insert_rows);
+DECLARE_mDouble(memtable_merge_on_insert_min_dup_ratio);
 // max parallel flush task per memtable writer
 DECLARE_mInt32(memtable_flush_running_count_limit);
 
@@ -722,6 +782,9 @@ DECLARE_mInt64(storage_flood_stage_left_capacity_bytes); // 1GB
 DECLARE_Int32(flush_thread_num_per_store);
 // number of thread for flushing memtable per store, for high priority load task
 DECLARE_Int32(high_priority_flush_thread_num_per_store);
+// number of threads encoding the value columns of a segment in parallel when a memtable is
+// flushed, 0 means the columns are encoded one by one by the flushing thread
+DECLARE_Int32(segment_column_encode_thread_num);
 
 // config for tablet meta checkpoint
 DECLARE_mInt32(tablet_meta_checkpoint_min_new_rowsets_num);
@@ -744,6 +807,12 @@ DECLARE_Int64(brpc_socket_max_unwritten_bytes);
 // is greater than 1.8G. This is to avoid the error of Request length overflow (2G).
 DECLARE_mBool(transfer_large_data_by_brpc);
 
+// Whether the exchange serializes and compresses the columns of a block one by one, so that
+// the columns which do not compress are sent as they are. Only enable it once every BE of
+// the cluster can read blocks serialized this way. Ignored when transfer_large_data_by_brpc
+// is enabled, which needs the values of a block in one buffer.
+DECLARE_mBool(enable_exchange_column_compression);
+
 // max number of txns for every txn_partition_map in txn manager
 // this is a self protection to avoid too many txns saving in manager
 DECLARE_mInt64(max_runnings_transactions_per_txn_map);
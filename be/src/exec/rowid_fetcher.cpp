@@ -41,7 +41,14 @@
 #include "common/consts.h"
 #include "common/exception.h"
 #include "exec/tablet_info.h" // DorisNodesInfo
+#include "io/io_common.h"
+#include "olap/iterators.h"
 #include "olap/olap_common.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/rowset.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/segment_loader.h"
 #include "olap/tablet_schema.h"
 #include "olap/utils.h"
 #include "runtime/descriptors.h"
@@ -275,4 +282,78 @@ Status RowIDFetcher::fetch(const vectorized::ColumnPtr& column_row_ids,
     return Status::OK();
 }
 
+void LocalRowIdFetcher::add_rowset(const RowsetSharedPtr& rowset) {
+    _rowsets.emplace(rowset->rowset_id(), rowset);
+}
+
+Status LocalRowIdFetcher::_get_column_iterator(const RowLocation& location, uint32_t cid,
+                                               segment_v2::ColumnIterator** iterator) {
+    auto key = std::make_pair(location.rowset_id, location.segment_id);
+    auto it = _segments.find(key);
+    if (it == _segments.end()) {
+        auto rs_it = _rowsets.find(location.rowset_id);
+        if (rs_it == _rowsets.end()) {
+            return Status::InternalError("fetch rows of unknown rowset {}",
+                                         location.rowset_id.to_string());
+        }
+        auto& handle = _segment_handles[location.rowset_id];
+        if (!handle.is_inited()) {
+            RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(
+                    std::static_pointer_cast<BetaRowset>(rs_it->second), &handle, true));
+        }
+        auto seg_it = std::find_if(handle.get_segments().begin(), handle.get_segments().end(),
+                                   [&location](const segment_v2::SegmentSharedPtr& segment) {
+                                       return segment->id() == location.segment_id;
+                                   });
+        if (seg_it == handle.get_segments().end()) {
+            return Status::InternalError("fetch rows of unknown segment {} of rowset {}",
+                                         location.segment_id, location.rowset_id.to_string());
+        }
+        it = _segments.emplace(key, SegmentItem {.segment = *seg_it}).first;
+    }
+
+    auto& column_iterator = it->second.iterators[cid];
+    if (column_iterator == nullptr) {
+        StorageReadOptions storage_read_opt;
+        storage_read_opt.io_ctx.reader_type = ReaderType::READER_QUERY;
+        RETURN_IF_ERROR(it->second.segment->new_column_iterator(
+                _tablet_schema->column(cid), &column_iterator, &storage_read_opt));
+        segment_v2::ColumnIteratorOptions opt {
+                .use_page_cache = _use_page_cache,
+                .file_reader = it->second.segment->file_reader().get(),
+                .stats = _stats,
+                .io_ctx = io::IOContext {.reader_type = ReaderType::READER_QUERY},
+        };
+        RETURN_IF_ERROR(column_iterator->init(opt));
+    }
+    *iterator = column_iterator.get();
+    return Status::OK();
+}
+
+Status LocalRowIdFetcher::fetch(const std::vector<RowLocation>& row_locations, uint32_t cid,
+                                vectorized::MutableColumnPtr& column) {
+    std::vector<segment_v2::rowid_t> rowids;
+    rowids.reserve(row_locations.size());
+    size_t begin = 0;
+    while (begin < row_locations.size()) {
+        // read_by_rowids wants ascending rowids of one segment, so cut the rows into
+        // such runs. Rows coming from a segment iterator are usually a single run.
+        const RowLocation& first = row_locations[begin];
+        rowids.clear();
+        rowids.push_back(first.row_id);
+        size_t end = begin + 1;
+        while (end < row_locations.size() && row_locations[end].segment_id == first.segment_id &&
+               row_locations[end].rowset_id == first.rowset_id &&
+               row_locations[end].row_id > rowids.back()) {
+            rowids.push_back(row_locations[end].row_id);
+            ++end;
+        }
+        segment_v2::ColumnIterator* iterator = nullptr;
+        RETURN_IF_ERROR(_get_column_iterator(first, cid, &iterator));
+        RETURN_IF_ERROR(iterator->read_by_rowids(rowids.data(), rowids.size(), column));
+        begin = end;
+    }
+    return Status::OK();
+}
+
 } // namespace doris
@@ -21,11 +21,19 @@
 #include <gen_cpp/DataSinks_types.h>
 #include <gen_cpp/internal_service.pb.h>
 
+#include <map>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/status.h"
 #include "exec/tablet_info.h" // DorisNodesInfo
+#include "olap/olap_common.h"
+#include "olap/rowset/rowset_fwd.h"
+#include "olap/segment_loader.h"
+#include "olap/tablet_schema.h"
+#include "olap/utils.h"
 #include "vec/core/block.h"
 #include "vec/data_types/data_type.h"
 
@@ -35,6 +43,10 @@ class DorisNodesInfo;
 class RuntimeState;
 class TupleDescriptor;
 
+namespace segment_v2 {
+class ColumnIterator;
+} // namespace segment_v2
+
 namespace vectorized {
 class ColumnString;
 class MutableBlock;
@@ -67,4 +79,45 @@ private:
     FetchOption _fetch_option;
 };
 
+// fetch columns of rows in rowsets of this backend by row location,
+// rowset_id/segment_id/ordinal_id
+//
+// Used by scanners for late materialization: the columns which are not needed by filters
+// are only read for the rows that survive them. Column iterators are kept per segment and
+// column, so the pages loaded for one block are reused by the next one.
+class LocalRowIdFetcher {
+public:
+    LocalRowIdFetcher(TabletSchemaSPtr tablet_schema, OlapReaderStatistics* stats,
+                      bool use_page_cache)
+            : _tablet_schema(std::move(tablet_schema)),
+              _stats(stats),
+              _use_page_cache(use_page_cache) {}
+
+    // Rowsets must be added before rows of them are fetched.
+    void add_rowset(const RowsetSharedPtr& rowset);
+
+    // Read column `cid` of the tablet schema for `row_locations` and append the values to
+    // `column` in the same order. Rows of one segment are best passed in ascending order,
+    // each descending step costs a seek.
+    Status fetch(const std::vector<RowLocation>& row_locations, uint32_t cid,
+                 vectorized::MutableColumnPtr& column);
+
+private:
+    struct SegmentItem {
+        segment_v2::SegmentSharedPtr segment;
+        std::unordered_map<uint32_t, std::unique_ptr<segment_v2::ColumnIterator>> iterators;
+    };
+
+    Status _get_column_iterator(const RowLocation& location, uint32_t cid,
+                                segment_v2::ColumnIterator** iterator);
+
+    TabletSchemaSPtr _tablet_schema;
+    OlapReaderStatistics* _stats = nullptr;
+    bool _use_page_cache = false;
+    std::unordered_map<RowsetId, RowsetSharedPtr, HashOfRowsetId> _rowsets;
+    // hold the segments of a rowset while its iterators are alive
+    std::unordered_map<RowsetId, SegmentCacheHandle, HashOfRowsetId> _segment_handles;
+    std::map<std::pair<RowsetId, uint32_t>, SegmentItem> _segments;
+};
+
 } // namespace doris
@@ -25,6 +25,8 @@
 
 namespace doris {
 
+class MinMaxFuncBase;
+
 class BloomFilterAdaptor {
 public:
     BloomFilterAdaptor() { _bloom_filter = std::make_shared<doris::BlockBloomFilter>(); }
@@ -181,6 +183,20 @@ public:
         _bloom_filter_alloced = other_func->_bloom_filter_alloced;
         _bloom_filter = other_func->_bloom_filter;
         _inited = other_func->_inited;
+        _min_max = other_func->_min_max;
+        _min_max_type = other_func->_min_max_type;
+    }
+
+    // The min and max of the values inserted into the filter, the storage tests them against
+    // the zone maps to skip segments and pages before reading them.
+    void set_min_max(std::shared_ptr<MinMaxFuncBase> min_max, PrimitiveType type) {
+        _min_max = std::move(min_max);
+        _min_max_type = type;
+    }
+
+    // nullptr if the range is unknown or is not of `type`
+    MinMaxFuncBase* get_min_max(PrimitiveType type) const {
+        return _min_max_type == type ? _min_max.get() : nullptr;
     }
 
     virtual void insert(const void* data) = 0;
@@ -201,6 +217,8 @@ protected:
     std::mutex _lock;
     int64_t _bloom_filter_length;
     bool _build_bf_exactly = false;
+    std::shared_ptr<MinMaxFuncBase> _min_max;
+    PrimitiveType _min_max_type = INVALID_TYPE;
 };
 
 template <typename T, bool need_trim = false>
@@ -165,6 +165,33 @@ PrimitiveType to_primitive_type(PColumnType type) {
     return TYPE_INT;
 }
 
+// Types whose min and max are kept along with a bloom filter, so that the storage can skip
+// segments and pages by their zone maps. The min and max of a string would point into the
+// build block, the in filter of IN_OR_BLOOM_FILTER already covers small string sets.
+static bool bloom_filter_keeps_range(PrimitiveType type) {
+    switch (type) {
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+    case TYPE_LARGEINT:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+    case TYPE_DATEV2:
+    case TYPE_DATETIMEV2:
+    case TYPE_DECIMALV2:
+    case TYPE_DECIMAL32:
+    case TYPE_DECIMAL64:
+    case TYPE_DECIMAL128I:
+    case TYPE_DECIMAL256:
+        return true;
+    default:
+        return false;
+    }
+}
+
 // PFilterType -> RuntimeFilterType
 RuntimeFilterType get_type(int filter_type) {
     switch (filter_type) {
@@ -312,6 +339,7 @@ public:
             _context.bloom_filter_func.reset(create_bloom_filter(_column_return_type));
             _context.bloom_filter_func->set_length(params->bloom_filter_size);
             _context.bloom_filter_func->set_build_bf_exactly(params->build_bf_exactly);
+            _init_bloom_filter_range();
             return Status::OK();
         }
         case RuntimeFilterType::IN_OR_BLOOM_FILTER: {
@@ -319,6 +347,7 @@ public:
             _context.bloom_filter_func.reset(create_bloom_filter(_column_return_type));
             _context.bloom_filter_func->set_length(params->bloom_filter_size);
             _context.bloom_filter_func->set_build_bf_exactly(params->build_bf_exactly);
+            _init_bloom_filter_range();
             return Status::OK();
         }
         case RuntimeFilterType::BITMAP_FILTER: {
@@ -382,6 +411,9 @@ public:
         }
         case RuntimeFilterType::BLOOM_FILTER: {
             _context.bloom_filter_func->insert_fixed_len(column, start);
+            if (_context.minmax_func) {
+                _context.minmax_func->insert_fixed_len(column, start);
+            }
             break;
         }
         case RuntimeFilterType::IN_OR_BLOOM_FILTER: {
@@ -390,6 +422,10 @@ public:
             } else {
                 _context.hybrid_set->insert_fixed_len(column, start);
             }
+            // kept in both modes, the in filter may turn into a bloom filter later
+            if (_context.minmax_func) {
+                _context.minmax_func->insert_fixed_len(column, start);
+            }
             break;
         }
         default:
@@ -506,6 +542,7 @@ public:
         case RuntimeFilterType::BLOOM_FILTER: {
             RETURN_IF_ERROR(
                     _context.bloom_filter_func->merge(wrapper->_context.bloom_filter_func.get()));
+            RETURN_IF_ERROR(_merge_bloom_filter_range(wrapper));
             break;
         }
         case RuntimeFilterType::IN_OR_BLOOM_FILTER: {
@@ -525,6 +562,7 @@ public:
                             << wrapper->_filter_id << ") when used IN_OR_BLOOM_FILTER, ignore msg: "
                             << wrapper->get_ignored_in_filter_msg();
                     _context.hybrid_set->insert(wrapper->_context.hybrid_set.get());
+                    RETURN_IF_ERROR(_merge_bloom_filter_range(wrapper));
                     if (_max_in_num >= 0 && _context.hybrid_set->size() >= _max_in_num) {
                         VLOG_DEBUG << " change runtime filter to bloom filter(id=" << _filter_id
                                    << ") because: in_num(" << _context.hybrid_set->size()
@@ -537,6 +575,7 @@ public:
                     change_to_bloom_filter();
                     RETURN_IF_ERROR(_context.bloom_filter_func->merge(
                             wrapper->_context.bloom_filter_func.get()));
+                    RETURN_IF_ERROR(_merge_bloom_filter_range(wrapper));
                 }
             } else {
                 if (other_filter_type == RuntimeFilterType::IN_FILTER) { // bloom filter merge in
@@ -545,10 +584,12 @@ public:
                             << wrapper->_filter_id << ") when used IN_OR_BLOOM_FILTER, ignore msg: "
                             << wrapper->get_ignored_in_filter_msg();
                     wrapper->insert_to_bloom_filter(_context.bloom_filter_func.get());
+                    RETURN_IF_ERROR(_merge_bloom_filter_range(wrapper));
                     // bloom filter merge bloom filter
                 } else {
                     RETURN_IF_ERROR(_context.bloom_filter_func->merge(
                             wrapper->_context.bloom_filter_func.get()));
+                    RETURN_IF_ERROR(_merge_bloom_filter_range(wrapper));
                 }
             }
             break;
@@ -927,6 +968,33 @@ public:
     }
 
 private:
+    void _init_bloom_filter_range() {
+        if (bloom_filter_keeps_range(_column_return_type)) {
+            _context.minmax_func.reset(create_minmax_filter(_column_return_type));
+        }
+    }
+
+    // The range of a bloom filter covers every value of the filters merged into it, it is
+    // unknown once one of them does not know its own.
+    Status _merge_bloom_filter_range(const RuntimePredicateWrapper* wrapper) {
+        if (_context.minmax_func == nullptr) {
+            return Status::OK();
+        }
+        if (wrapper->_context.minmax_func != nullptr) {
+            return _context.minmax_func->merge(wrapper->_context.minmax_func.get(), _pool);
+        }
+        if (!wrapper->_is_bloomfilter && wrapper->_context.hybrid_set != nullptr) {
+            auto* it = wrapper->_context.hybrid_set->begin();
+            while (it->has_next()) {
+                _context.minmax_func->insert(it->get_value());
+                it->next();
+            }
+            return Status::OK();
+        }
+        _context.minmax_func.reset();
+        return Status::OK();
+    }
+
     RuntimeFilterParamsContext* _state;
     int _be_exec_version;
     ObjectPool* _pool;
@@ -1269,7 +1337,11 @@ Status IRuntimeFilter::create_wrapper(RuntimeFilterParamsContext* state,
     }
     case PFilterType::BLOOM_FILTER: {
         DCHECK(param->request->has_bloom_filter());
-        return (*wrapper)->assign(&param->request->bloom_filter(), param->data);
+        RETURN_IF_ERROR((*wrapper)->assign(&param->request->bloom_filter(), param->data));
+        if (param->request->has_minmax_filter()) {
+            return (*wrapper)->assign(&param->request->minmax_filter());
+        }
+        return Status::OK();
     }
     case PFilterType::MIN_FILTER:
     case PFilterType::MAX_FILTER:
@@ -1312,7 +1384,11 @@ Status IRuntimeFilter::_create_wrapper(RuntimeFilterParamsContext* state, const
     }
     case PFilterType::BLOOM_FILTER: {
         DCHECK(param->request->has_bloom_filter());
-        return (*wrapper)->assign(&param->request->bloom_filter(), param->data);
+        RETURN_IF_ERROR((*wrapper)->assign(&param->request->bloom_filter(), param->data));
+        if (param->request->has_minmax_filter()) {
+            return (*wrapper)->assign(&param->request->minmax_filter());
+        }
+        return Status::OK();
     }
     case PFilterType::MIN_FILTER:
     case PFilterType::MAX_FILTER:
@@ -1391,6 +1467,11 @@ Status IRuntimeFilter::serialize_impl(T* request, void** data, int* len) {
         DCHECK(data != nullptr);
         request->mutable_bloom_filter()->set_filter_length(*len);
         request->mutable_bloom_filter()->set_always_true(false);
+        if (_wrapper->_context.minmax_func != nullptr &&
+            bloom_filter_keeps_range(_wrapper->column_type())) {
+            // lets the receivers prune by zone maps, older receivers ignore it
+            to_protobuf(request->mutable_minmax_filter());
+        }
     } else if (real_runtime_filter_type == RuntimeFilterType::MINMAX_FILTER ||
                real_runtime_filter_type == RuntimeFilterType::MIN_FILTER ||
                real_runtime_filter_type == RuntimeFilterType::MAX_FILTER) {
@@ -1801,6 +1882,7 @@ Status RuntimePredicateWrapper::get_push_exprs(std::list<vectorized::VExprContex
         node.__set_opcode(TExprOpcode::RT_FILTER);
         node.__set_is_nullable(false);
         auto bloom_pred = vectorized::VBloomPredicate::create_shared(node);
+        _context.bloom_filter_func->set_min_max(_context.minmax_func, _column_return_type);
         bloom_pred->set_filter(_context.bloom_filter_func);
         bloom_pred->add_child(probe_ctx->root());
         auto wrapper = vectorized::VRuntimeFilterWrapper::create_shared(node, bloom_pred);
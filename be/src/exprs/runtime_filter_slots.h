@@ -166,7 +166,8 @@ public:
         return Status::OK();
     }
 
-    void insert(const vectorized::Block* block) {
+    // The first row of a build block is mocked, so rows are inserted from `start`.
+    void insert(const vectorized::Block* block, size_t start = 1) {
         for (int i = 0; i < _build_expr_context.size(); ++i) {
             auto iter = _runtime_filters.find(i);
             if (iter == _runtime_filters.end()) {
@@ -176,7 +177,7 @@ public:
             int result_column_id = _build_expr_context[i]->get_last_result_column_id();
             const auto& column = block->get_by_position(result_column_id).column;
             for (auto* filter : iter->second) {
-                filter->insert_batch(column, 1);
+                filter->insert_batch(column, start);
             }
         }
     }
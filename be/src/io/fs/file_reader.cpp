@@ -36,5 +36,23 @@ Status FileReader::read_at(size_t offset, Slice result, size_t* bytes_read,
     return st;
 }
 
+Status FileReader::read_batch_at(std::vector<FileReadRequest>* requests,
+                                 const IOContext* io_ctx) {
+    DCHECK(bthread_self() == 0);
+    Status st = read_batch_at_impl(requests, io_ctx);
+    if (!st) {
+        LOG(WARNING) << st;
+    }
+    return st;
+}
+
+Status FileReader::read_batch_at_impl(std::vector<FileReadRequest>* requests,
+                                      const IOContext* io_ctx) {
+    for (auto& request : *requests) {
+        RETURN_IF_ERROR(read_at_impl(request.offset, request.result, &request.bytes_read, io_ctx));
+    }
+    return Status::OK();
+}
+
 } // namespace io
 } // namespace doris
@@ -21,6 +21,7 @@
 #include <stddef.h>
 
 #include <memory>
+#include <vector>
 
 #include "common/status.h"
 #include "io/fs/path.h"
@@ -62,6 +63,14 @@ struct FileReaderOptions {
 
 inline const FileReaderOptions FileReaderOptions::DEFAULT;
 
+// One range of a batched read, see FileReader::read_batch_at().
+struct FileReadRequest {
+    size_t offset = 0;
+    Slice result;
+    // set by the reader
+    size_t bytes_read = 0;
+};
+
 class FileReader {
 public:
     FileReader() = default;
@@ -74,6 +83,12 @@ public:
     Status read_at(size_t offset, Slice result, size_t* bytes_read,
                    const IOContext* io_ctx = nullptr);
 
+    /// Read several ranges at once. Readers which are able to keep many requests in flight
+    /// (e.g. LocalFileReader with io_uring) override read_batch_at_impl(), others serve
+    /// the requests one by one.
+    Status read_batch_at(std::vector<FileReadRequest>* requests,
+                         const IOContext* io_ctx = nullptr);
+
     virtual Status close() = 0;
 
     virtual const Path& path() const = 0;
@@ -87,6 +102,9 @@ public:
 protected:
     virtual Status read_at_impl(size_t offset, Slice result, size_t* bytes_read,
                                 const IOContext* io_ctx) = 0;
+
+    virtual Status read_batch_at_impl(std::vector<FileReadRequest>* requests,
+                                      const IOContext* io_ctx);
 };
 
 using FileReaderSPtr = std::shared_ptr<FileReader>;
@@ -0,0 +1,279 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "io/fs/io_uring.h"
+
+#include <errno.h> // IWYU pragma: keep
+#include <glog/logging.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <deque>
+
+#include "common/compiler_util.h" // IWYU pragma: keep
+#include "common/config.h"
+#include "io/fs/err_utils.h"
+
+namespace doris {
+namespace io {
+
+namespace {
+
+int sys_io_uring_setup(uint32_t entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sys_io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return static_cast<int>(
+            ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+} // namespace
+
+IOUring::~IOUring() {
+    if (_sqes != nullptr) {
+        ::munmap(_sqes, _sqes_map_size);
+    }
+    if (_cq_ptr != nullptr && _cq_ptr != _sq_ptr) {
+        ::munmap(_cq_ptr, _cq_map_size);
+    }
+    if (_sq_ptr != nullptr) {
+        ::munmap(_sq_ptr, _sq_map_size);
+    }
+    if (_ring_fd >= 0) {
+        ::close(_ring_fd);
+    }
+}
+
+Status IOUring::create(uint32_t queue_depth, std::unique_ptr<IOUring>* ring) {
+    std::unique_ptr<IOUring> res(new IOUring());
+    RETURN_IF_ERROR(res->_init(queue_depth));
+    *ring = std::move(res);
+    return Status::OK();
+}
+
+IOUring* IOUring::thread_local_instance() {
+    static thread_local std::unique_ptr<IOUring> ring;
+    static thread_local bool tried = false;
+    if (!tried) {
+        tried = true;
+        Status st = create(config::io_uring_queue_depth, &ring);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to create io_uring, fallback to pread: " << st;
+        }
+    }
+    if (ring != nullptr && ring->_broken) {
+        return nullptr;
+    }
+    return ring.get();
+}
+
+Status IOUring::_init(uint32_t queue_depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _ring_fd = sys_io_uring_setup(std::max(queue_depth, 1U), &params);
+    if (_ring_fd < 0) {
+        return localfs_error(errno, "io_uring_setup failed");
+    }
+
+    _sq_entries = params.sq_entries;
+    _sq_map_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        _sq_map_size = _cq_map_size = std::max(_sq_map_size, _cq_map_size);
+    }
+
+    _sq_ptr = ::mmap(nullptr, _sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     _ring_fd, IORING_OFF_SQ_RING);
+    if (_sq_ptr == MAP_FAILED) {
+        _sq_ptr = nullptr;
+        return localfs_error(errno, "failed to mmap io_uring submission queue");
+    }
+    if (single_mmap) {
+        _cq_ptr = _sq_ptr;
+    } else {
+        _cq_ptr = ::mmap(nullptr, _cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         _ring_fd, IORING_OFF_CQ_RING);
+        if (_cq_ptr == MAP_FAILED) {
+            _cq_ptr = nullptr;
+            return localfs_error(errno, "failed to mmap io_uring completion queue");
+        }
+    }
+    _sqes_map_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, _sqes_map_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return localfs_error(errno, "failed to mmap io_uring submission entries");
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(_sq_ptr);
+    _sq_head = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    _sq_mask = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+    auto* cq = static_cast<char*>(_cq_ptr);
+    _cq_head = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    _cq_mask = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return Status::OK();
+}
+
+void IOUring::_prep_read(int fd, const FileReadRequest& request, size_t idx) {
+    uint32_t tail = *_sq_tail;
+    DCHECK_LT(tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE), _sq_entries);
+    uint32_t index = tail & *_sq_mask;
+    io_uring_sqe* sqe = &_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->off = request.offset + request.bytes_read;
+    sqe->addr = reinterpret_cast<uint64_t>(request.result.data + request.bytes_read);
+    sqe->len = static_cast<uint32_t>(request.result.size - request.bytes_read);
+    sqe->user_data = idx;
+    _sq_array[index] = index;
+    // make the sqe visible to the kernel before publishing the new tail
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+Status IOUring::_submit_and_wait(uint32_t to_submit, uint32_t wait_nr, uint32_t* submitted) {
+    while (true) {
+        int ret = sys_io_uring_enter(_ring_fd, to_submit, wait_nr,
+                                     wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (ret >= 0) {
+            // The kernel may consume less sqes than requested when it is short of memory,
+            // the remaining ones stay in the queue and are submitted by the next call.
+            *submitted = static_cast<uint32_t>(ret);
+            return Status::OK();
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            return localfs_error(errno, "io_uring_enter failed");
+        }
+    }
+}
+
+io_uring_cqe* IOUring::_peek_cqe() {
+    uint32_t head = *_cq_head;
+    if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return &_cqes[head & *_cq_mask];
+}
+
+void IOUring::_cqe_seen() {
+    __atomic_store_n(_cq_head, *_cq_head + 1, __ATOMIC_RELEASE);
+}
+
+void IOUring::_discard_queued(uint32_t n) {
+    // only valid without SQPOLL: the kernel never looks at sqes until io_uring_enter
+    __atomic_store_n(_sq_tail, *_sq_tail - n, __ATOMIC_RELEASE);
+}
+
+Status IOUring::_reap_in_flight(uint32_t in_flight) {
+    while (in_flight > 0) {
+        uint32_t submitted = 0;
+        Status st = _submit_and_wait(0, 1, &submitted);
+        if (UNLIKELY(!st.ok())) {
+            // the kernel may still write into the buffers of the reads, never use this ring
+            // again and leave it to the kernel
+            _broken = true;
+            LOG(WARNING) << "io_uring can not wait for " << in_flight
+                         << " in flight reads, stop using it: " << st;
+            return st;
+        }
+        while (in_flight > 0 && _peek_cqe() != nullptr) {
+            _cqe_seen();
+            --in_flight;
+        }
+    }
+    return Status::OK();
+}
+
+Status IOUring::read(int fd, std::vector<FileReadRequest>* requests) {
+    std::deque<size_t> pending;
+    for (size_t i = 0; i < requests->size(); ++i) {
+        (*requests)[i].bytes_read = 0;
+        if ((*requests)[i].result.size > 0) {
+            pending.push_back(i);
+        }
+    }
+
+    Status st = Status::OK();
+    // queued = prepared but not yet consumed by the kernel, in_flight includes them
+    uint32_t queued = 0;
+    uint32_t in_flight = 0;
+    while (in_flight > 0 || (st.ok() && !pending.empty())) {
+        // 1. fill the submission queue, stop queueing new reads after the first error
+        while (st.ok() && !pending.empty() && in_flight < _sq_entries) {
+            size_t idx = pending.front();
+            pending.pop_front();
+            _prep_read(fd, (*requests)[idx], idx);
+            ++queued;
+            ++in_flight;
+        }
+
+        // 2. submit and wait for at least one completion
+        uint32_t submitted = 0;
+        Status submit_st = _submit_and_wait(queued, 1, &submitted);
+        if (UNLIKELY(!submit_st.ok())) {
+            // the sqes not consumed by the kernel can be dropped, but the buffers of the reads
+            // in flight belong to the kernel until they complete
+            _discard_queued(queued);
+            in_flight -= queued;
+            RETURN_IF_ERROR(_reap_in_flight(in_flight));
+            return submit_st;
+        }
+        queued -= submitted;
+
+        // 3. reap all available completions
+        while (io_uring_cqe* cqe = _peek_cqe()) {
+            size_t idx = cqe->user_data;
+            int res = cqe->res;
+            _cqe_seen();
+            --in_flight;
+
+            FileReadRequest& request = (*requests)[idx];
+            if (res == -EINTR || res == -EAGAIN) {
+                pending.push_front(idx);
+            } else if (UNLIKELY(res < 0)) {
+                if (st.ok()) {
+                    st = localfs_error(-res, "io_uring read failed");
+                }
+            } else if (UNLIKELY(res == 0)) {
+                if (st.ok()) {
+                    st = Status::InternalError("io_uring read: unexpected EOF");
+                }
+            } else {
+                request.bytes_read += res;
+                if (request.bytes_read < request.result.size) {
+                    // short read, queue the rest
+                    pending.push_front(idx);
+                }
+            }
+        }
+    }
+    return st;
+}
+
+} // namespace io
+} // namespace doris
@@ -0,0 +1,99 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "common/status.h"
+#include "io/fs/file_reader.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace doris {
+namespace io {
+
+// A minimal io_uring instance used to keep several reads of one file in flight.
+// It talks to the kernel through the raw syscalls, so there is no dependency on liburing.
+//
+// An IOUring is NOT thread safe. Use IOUring::thread_local_instance() to get the ring
+// bound to the calling thread; it returns nullptr if io_uring is unavailable (old kernel,
+// seccomp, etc.), in which case the caller should fall back to pread.
+class IOUring {
+public:
+    ~IOUring();
+
+    // Create a ring with at least `queue_depth` submission entries.
+    static Status create(uint32_t queue_depth, std::unique_ptr<IOUring>* ring);
+
+    // The ring of the calling thread, created lazily with config::io_uring_queue_depth.
+    // Returns nullptr if the ring can not be created or was given up after an error, and does
+    // not retry afterwards.
+    static IOUring* thread_local_instance();
+
+    // Read all `requests` from `fd`. Requests are submitted in batches of the queue depth
+    // and reaped together; short reads are resubmitted for the remaining bytes.
+    // The caller must make sure that every request lies inside the file.
+    Status read(int fd, std::vector<FileReadRequest>* requests);
+
+    uint32_t queue_depth() const { return _sq_entries; }
+
+private:
+    IOUring() = default;
+
+    Status _init(uint32_t queue_depth);
+    // Put a read of the unfinished part of `requests[idx]` into the submission queue.
+    void _prep_read(int fd, const FileReadRequest& request, size_t idx);
+    // Submit queued sqes and wait until `wait_nr` completions are available.
+    Status _submit_and_wait(uint32_t to_submit, uint32_t wait_nr, uint32_t* submitted);
+    // Drop the last `n` sqes that have not been consumed by the kernel yet.
+    void _discard_queued(uint32_t n);
+    // Wait for and drop the completions of `in_flight` reads, so that the kernel no longer
+    // writes into their buffers. The ring is marked broken if it fails to wait.
+    Status _reap_in_flight(uint32_t in_flight);
+    io_uring_cqe* _peek_cqe();
+    void _cqe_seen();
+
+    int _ring_fd = -1;
+    bool _broken = false;
+
+    void* _sq_ptr = nullptr;
+    size_t _sq_map_size = 0;
+    void* _cq_ptr = nullptr;
+    size_t _cq_map_size = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqes_map_size = 0;
+
+    uint32_t _sq_entries = 0;
+    uint32_t* _sq_head = nullptr;
+    uint32_t* _sq_tail = nullptr;
+    uint32_t* _sq_mask = nullptr;
+    uint32_t* _sq_array = nullptr;
+
+    uint32_t* _cq_head = nullptr;
+    uint32_t* _cq_tail = nullptr;
+    uint32_t* _cq_mask = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+};
+
+} // namespace io
+} // namespace doris
@@ -32,7 +32,9 @@
 
 #include "common/compiler_util.h" // IWYU pragma: keep
 #include "common/sync_point.h"
+#include "common/config.h"
 #include "io/fs/err_utils.h"
+#include "io/fs/io_uring.h"
 #include "util/async_io.h"
 #include "util/doris_metrics.h"
 
@@ -98,5 +100,32 @@ Status LocalFileReader::read_at_impl(size_t offset, Slice result, size_t* bytes_
     return Status::OK();
 }
 
+Status LocalFileReader::read_batch_at_impl(std::vector<FileReadRequest>* requests,
+                                           const IOContext* io_ctx) {
+    IOUring* ring = config::enable_io_uring ? IOUring::thread_local_instance() : nullptr;
+    if (ring == nullptr || requests->size() <= 1) {
+        return FileReader::read_batch_at_impl(requests, io_ctx);
+    }
+    DCHECK(!closed());
+    for (auto& request : *requests) {
+        if (request.offset > _file_size) {
+            return Status::InternalError(
+                    "offset exceeds file size(offset: {}, file size: {}, path: {})",
+                    request.offset, _file_size, _path.native());
+        }
+        request.result.size = std::min(request.result.size, _file_size - request.offset);
+    }
+    Status st = ring->read(_fd, requests);
+    if (!st.ok()) {
+        return st.prepend(fmt::format("failed to read {}: ", _path.native()));
+    }
+    size_t bytes_read = 0;
+    for (const auto& request : *requests) {
+        bytes_read += request.bytes_read;
+    }
+    DorisMetrics::instance()->local_bytes_read_total->increment(bytes_read);
+    return Status::OK();
+}
+
 } // namespace io
 } // namespace doris
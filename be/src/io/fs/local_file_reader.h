@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include "common/status.h"
 #include "io/fs/file_reader.h"
@@ -53,6 +54,9 @@ private:
     Status read_at_impl(size_t offset, Slice result, size_t* bytes_read,
                         const IOContext* io_ctx) override;
 
+    Status read_batch_at_impl(std::vector<FileReadRequest>* requests,
+                              const IOContext* io_ctx) override;
+
 private:
     int _fd = -1; // owned
     Path _path;
@@ -493,7 +493,8 @@ Status BaseTablet::lookup_row_key(const Slice& encoded_key, bool with_seq_col,
                                   const std::vector<RowsetSharedPtr>& specified_rowsets,
                                   RowLocation* row_location, uint32_t version,
                                   std::vector<std::unique_ptr<SegmentCacheHandle>>& segment_caches,
-                                  RowsetSharedPtr* rowset, bool with_rowid) {
+                                  RowsetSharedPtr* rowset, bool with_rowid,
+                                  std::vector<PrimaryKeyIndexIterators>* pk_index_iterators) {
     SCOPED_BVAR_LATENCY(g_tablet_lookup_rowkey_latency);
     size_t seq_col_length = 0;
     if (_tablet_meta->tablet_schema()->has_sequence_col() && with_seq_col) {
@@ -538,9 +539,16 @@ Status BaseTablet::lookup_row_key(const Slice& encoded_key, bool with_seq_col,
         }
         auto& segments = segment_caches[i]->get_segments();
         DCHECK_EQ(segments.size(), num_segments);
+        PrimaryKeyIndexIterators* index_iterators = nullptr;
+        if (pk_index_iterators != nullptr) {
+            index_iterators = &(*pk_index_iterators)[i];
+            index_iterators->resize(num_segments);
+        }
 
         for (auto id : picked_segments) {
-            Status s = segments[id]->lookup_row_key(encoded_key, with_seq_col, with_rowid, &loc);
+            Status s = segments[id]->lookup_row_key(
+                    encoded_key, with_seq_col, with_rowid, &loc,
+                    index_iterators == nullptr ? nullptr : &(*index_iterators)[id]);
             if (s.is<KEY_NOT_FOUND>()) {
                 continue;
             }
@@ -611,11 +619,23 @@ Status BaseTablet::calc_delete_bitmap(const BaseTabletSPtr& tablet, RowsetShared
     }
 
     OlapStopWatch watch;
+    // the rows of a segment are independent of each other unless they are read back for a
+    // partial update, so a large segment is split into ranges of its primary key index
+    uint32_t rows_per_task = config::calc_delete_bitmap_rows_per_task;
+    if (rows_per_task == 0 || (rowset_writer != nullptr && rowset_writer->is_partial_update())) {
+        rows_per_task = UINT32_MAX;
+    }
     for (const auto& segment : segments) {
         const auto& seg = segment;
         if (token != nullptr) {
-            RETURN_IF_ERROR(token->submit(tablet, rowset, seg, specified_rowsets, end_version,
-                                          delete_bitmap, rowset_writer));
+            uint32_t num_rows = seg->num_rows();
+            uint32_t begin = 0;
+            do {
+                uint32_t end = num_rows - begin > rows_per_task ? begin + rows_per_task : num_rows;
+                RETURN_IF_ERROR(token->submit(tablet, rowset, seg, specified_rowsets, end_version,
+                                              delete_bitmap, rowset_writer, begin, end));
+                begin = end;
+            } while (begin < num_rows);
         } else {
             RETURN_IF_ERROR(tablet->calc_segment_delete_bitmap(
                     rowset, segment, specified_rowsets, delete_bitmap, end_version, rowset_writer));
@@ -629,7 +649,8 @@ Status BaseTablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
                                               const segment_v2::SegmentSharedPtr& seg,
                                               const std::vector<RowsetSharedPtr>& specified_rowsets,
                                               DeleteBitmapPtr delete_bitmap, int64_t end_version,
-                                              RowsetWriter* rowset_writer) {
+                                              RowsetWriter* rowset_writer, uint32_t begin_ordinal,
+                                              uint32_t end_ordinal) {
     OlapStopWatch watch;
     auto rowset_id = rowset->rowset_id();
     Version dummy_version(end_version + 1, end_version + 1);
@@ -656,41 +677,33 @@ Status BaseTablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
 
     RETURN_IF_ERROR(seg->load_pk_index_and_bf()); // We need index blocks to iterate
     const auto* pk_idx = seg->get_primary_key_index();
-    int total = pk_idx->num_rows();
-    uint32_t row_id = 0;
-    int32_t remaining = total;
-    bool exact_match = false;
-    std::string last_key;
-    int batch_size = 1024;
+    end_ordinal = std::min(end_ordinal, pk_idx->num_rows());
+    size_t batch_size = 1024;
     // The data for each segment may be lookup multiple times. Creating a SegmentCacheHandle
     // will update the lru cache, and there will be obvious lock competition in multithreading
     // scenarios, so using a segment_caches to cache SegmentCacheHandle.
     std::vector<std::unique_ptr<SegmentCacheHandle>> segment_caches(specified_rowsets.size());
-    while (remaining > 0) {
-        std::unique_ptr<segment_v2::IndexedColumnIterator> iter;
-        RETURN_IF_ERROR(pk_idx->new_iterator(&iter));
-
-        size_t num_to_read = std::min(batch_size, remaining);
-        auto index_type = vectorized::DataTypeFactory::instance().create_data_type(
-                pk_idx->type_info()->type(), 1, 0);
+    // the keys of the segment are looked up in ascending order, the iterators over the primary
+    // key indexes of the specified rowsets mostly find the next key on their current page
+    std::vector<PrimaryKeyIndexIterators> pk_index_iterators(specified_rowsets.size());
+    std::unique_ptr<segment_v2::IndexedColumnIterator> iter;
+    RETURN_IF_ERROR(pk_idx->new_iterator(&iter));
+    auto index_type = vectorized::DataTypeFactory::instance().create_data_type(
+            pk_idx->type_info()->type(), 1, 0);
+    for (uint32_t ordinal = begin_ordinal; ordinal < end_ordinal;) {
         auto index_column = index_type->create_column();
-        Slice last_key_slice(last_key);
-        RETURN_IF_ERROR(iter->seek_at_or_after(&last_key_slice, &exact_match));
-        auto current_ordinal = iter->get_current_ordinal();
-        DCHECK(total == remaining + current_ordinal)
-                << "total: " << total << ", remaining: " << remaining
-                << ", current_ordinal: " << current_ordinal;
-
+        RETURN_IF_ERROR(iter->seek_to_ordinal(ordinal));
+        size_t num_to_read = std::min<size_t>(batch_size, end_ordinal - ordinal);
         size_t num_read = num_to_read;
         RETURN_IF_ERROR(iter->next_batch(&num_read, index_column));
         DCHECK(num_to_read == num_read)
                 << "num_to_read: " << num_to_read << ", num_read: " << num_read;
-        last_key = index_column->get_data_at(num_read - 1).to_string();
-
-        // exclude last_key, last_key will be read in next batch.
-        if (num_read == batch_size && num_read != remaining) {
-            num_read -= 1;
+        if (UNLIKELY(num_read == 0)) {
+            return Status::InternalError("no primary key read at ordinal {} of segment {}",
+                                         ordinal, seg->id());
         }
+
+        uint32_t row_id = ordinal;
         for (size_t i = 0; i < num_read; i++, row_id++) {
             Slice key = Slice(index_column->get_data_at(i).data, index_column->get_data_at(i).size);
             RowLocation loc;
@@ -724,7 +737,7 @@ Status BaseTablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
 
             RowsetSharedPtr rowset_find;
             auto st = lookup_row_key(key, true, specified_rowsets, &loc, dummy_version.first - 1,
-                                     segment_caches, &rowset_find);
+                                     segment_caches, &rowset_find, true, &pk_index_iterators);
             bool expected_st = st.ok() || st.is<KEY_NOT_FOUND>() || st.is<KEY_ALREADY_EXISTS>();
             // It's a defensive DCHECK, we need to exclude some common errors to avoid core-dump
             // while stress test
@@ -785,9 +798,8 @@ Status BaseTablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
             delete_bitmap->add({loc.rowset_id, loc.segment_id, DeleteBitmap::TEMP_VERSION_COMMON},
                                loc.row_id);
         }
-        remaining -= num_read;
+        ordinal += num_read;
     }
-    // DCHECK_EQ(total, row_id) << "segment total rows: " << total << " row_id:" << row_id;
 
     if (config::enable_merge_on_write_correctness_check) {
         RowsetIdUnorderedSet rowsetids;
@@ -811,8 +823,8 @@ Status BaseTablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
     }
     LOG(INFO) << "calc segment delete bitmap, tablet: " << tablet_id() << " rowset: " << rowset_id
               << " seg_id: " << seg->id() << " dummy_version: " << end_version + 1
-              << " rows: " << seg->num_rows()
-              << " bitmap num: " << delete_bitmap->delete_bitmap.size()
+              << " rows: " << seg->num_rows() << " range: [" << begin_ordinal << ", "
+              << end_ordinal << ") bitmap num: " << delete_bitmap->delete_bitmap.size()
               << " cost: " << watch.get_elapse_time_us() << "(us)";
     return Status::OK();
 }
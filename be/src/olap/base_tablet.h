@@ -35,6 +35,9 @@ class RowsetWriter;
 class CalcDeleteBitmapToken;
 class SegmentCacheHandle;
 
+// the iterators over the primary key indexes of the segments of a rowset
+using PrimaryKeyIndexIterators = std::vector<std::unique_ptr<segment_v2::IndexedColumnIterator>>;
+
 struct TabletWithVersion {
     BaseTabletSPtr tablet;
     int64_t version;
@@ -136,11 +139,15 @@ public:
     // Lookup the row location of `encoded_key`, the function sets `row_location` on success.
     // NOTE: the method only works in unique key model with primary key index, you will got a
     //       not supported error in other data model.
+    // `pk_index_iterators` keeps an iterator over the primary key index of each segment of the
+    // specified rowsets between the lookups, which makes the lookups of ascending keys a merge
+    // of the keys with the indexes.
     Status lookup_row_key(const Slice& encoded_key, bool with_seq_col,
                           const std::vector<RowsetSharedPtr>& specified_rowsets,
                           RowLocation* row_location, uint32_t version,
                           std::vector<std::unique_ptr<SegmentCacheHandle>>& segment_caches,
-                          RowsetSharedPtr* rowset = nullptr, bool with_rowid = true);
+                          RowsetSharedPtr* rowset = nullptr, bool with_rowid = true,
+                          std::vector<PrimaryKeyIndexIterators>* pk_index_iterators = nullptr);
 
     static void prepare_to_read(const RowLocation& row_location, size_t pos,
                                 PartialUpdateReadPlan* read_plan);
@@ -158,11 +165,14 @@ public:
                                      CalcDeleteBitmapToken* token,
                                      RowsetWriter* rowset_writer = nullptr);
 
+    // calc the delete bitmap of the rows in [begin_ordinal, end_ordinal) of the primary key
+    // index of `seg`
     Status calc_segment_delete_bitmap(RowsetSharedPtr rowset,
                                       const segment_v2::SegmentSharedPtr& seg,
                                       const std::vector<RowsetSharedPtr>& specified_rowsets,
                                       DeleteBitmapPtr delete_bitmap, int64_t end_version,
-                                      RowsetWriter* rowset_writer);
+                                      RowsetWriter* rowset_writer, uint32_t begin_ordinal = 0,
+                                      uint32_t end_ordinal = UINT32_MAX);
 
     Status calc_delete_bitmap_between_segments(
             RowsetSharedPtr rowset, const std::vector<segment_v2::SegmentSharedPtr>& segments,
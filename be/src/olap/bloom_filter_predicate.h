@@ -18,6 +18,7 @@
 #pragma once
 
 #include "exprs/bloom_filter_func.h"
+#include "exprs/minmax_predicate.h"
 #include "exprs/runtime_filter.h"
 #include "olap/column_predicate.h"
 #include "runtime/primitive_type.h"
@@ -55,6 +56,30 @@ public:
     uint16_t evaluate(const vectorized::IColumn& column, uint16_t* sel,
                       uint16_t size) const override;
 
+    bool evaluate_and(const std::pair<WrapperField*, WrapperField*>& statistic) const override {
+        if constexpr (is_string_type(T)) {
+            return true;
+        } else {
+            using CppType = typename PrimitiveTypeTraits<T>::CppType;
+            auto* min_max = _filter->get_min_max(T);
+            if (min_max == nullptr) {
+                return true;
+            }
+            if (statistic.second->is_null()) {
+                // all values are null, the bloom filter rejects them
+                return false;
+            }
+            const auto& min_value = *reinterpret_cast<const CppType*>(min_max->get_min());
+            const auto& max_value = *reinterpret_cast<const CppType*>(min_max->get_max());
+            if (get_zone_map_value<T, CppType>(statistic.second->cell_ptr()) < min_value) {
+                return false;
+            }
+            // a null min means the page contains nulls, its non-null values start anywhere
+            return statistic.first->is_null() ||
+                   get_zone_map_value<T, CppType>(statistic.first->cell_ptr()) <= max_value;
+        }
+    }
+
     bool can_do_apply_safely(PrimitiveType input_type, bool is_null) const override {
         return input_type == T || (is_string_type(input_type) && is_string_type(T));
     }
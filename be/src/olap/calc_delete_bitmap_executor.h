@@ -52,7 +52,8 @@ public:
     Status submit(BaseTabletSPtr tablet, RowsetSharedPtr cur_rowset,
                   const segment_v2::SegmentSharedPtr& cur_segment,
                   const std::vector<RowsetSharedPtr>& target_rowsets, int64_t end_version,
-                  DeleteBitmapPtr delete_bitmap, RowsetWriter* rowset_writer);
+                  DeleteBitmapPtr delete_bitmap, RowsetWriter* rowset_writer,
+                  uint32_t begin_ordinal, uint32_t end_ordinal);
 
     // wait all tasks in token to be completed.
     Status wait();
@@ -0,0 +1,144 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "olap/olap_common.h"
+#include "util/simd/bits.h"
+#include "vec/columns/column_dictionary.h"
+#include "vec/common/string_ref.h"
+#include "vec/core/types.h"
+
+namespace doris {
+
+// Evaluates a string predicate on the codes of a ColumnDictI32 instead of on its strings.
+//
+// The predicate is evaluated once for every word of a segment's dictionary and the results
+// are kept as one byte per code. Rows are then filtered by looking up their codes, which is a
+// gather and a compaction of the result bytes instead of a string comparison, LIKE match or
+// hash set probe per row.
+//
+// flags[0] belongs to the null code -1, so the codes index `flags.data() + 1` directly.
+// A row passes if `opposite ^ (!null && flags[code + 1])`, the same null semantics as the
+// row by row evaluation of the predicates.
+//
+// Like the other per segment state of the predicates, it is not thread safe, every scanner
+// has its own predicates.
+class DictCodeFilter {
+public:
+    using CodeFlags = std::vector<vectorized::UInt8>;
+
+    // Return the code flags of the dictionary of `column`, evaluating `matcher` on every word
+    // the first time the segment's dictionary is seen. `matcher(const StringRef&)` returns
+    // whether the rows with this word pass the predicate.
+    template <typename Matcher>
+    const CodeFlags& get(const vectorized::ColumnDictI32& column, Matcher&& matcher) const {
+        auto& flags = _segment_code_flags[column.get_rowset_segment_id()];
+        // The dictionary may still be empty if all pages read so far are null.
+        if (flags.size() != column.dict_size() + 1) {
+            flags.resize(column.dict_size() + 1);
+            flags[0] = 0;
+            for (size_t code = 0; code < column.dict_size(); ++code) {
+                flags[code + 1] = matcher(column.get_value(int32_t(code)));
+            }
+        }
+        return flags;
+    }
+
+    // Keep the rows of `sel` that pass, return the new size of `sel`.
+    // `null_map` is nullptr for a not nullable column.
+    static uint16_t evaluate(const CodeFlags& flags, const vectorized::ColumnDictI32& column,
+                             const uint8_t* null_map, bool opposite, uint16_t* sel,
+                             uint16_t size) {
+        const vectorized::UInt8* code_flags = flags.data() + 1;
+        const int32_t* codes = column.get_data().data();
+        uint16_t new_size = 0;
+        if (column.size() != size) {
+            for (uint16_t i = 0; i < size; ++i) {
+                uint16_t idx = sel[i];
+                sel[new_size] = idx;
+                new_size += opposite ^ ((null_map == nullptr || !null_map[idx]) &&
+                                        code_flags[codes[idx]]);
+            }
+            return new_size;
+        }
+
+        // `sel` is 0, 1, ..., size - 1: compute the result of all rows with branch free loops
+        // and compact it 32 rows at a time.
+        uint8_t passed[size];
+        _gather<false>(code_flags, codes, null_map, opposite, size, passed);
+
+        static constexpr uint16_t SIMD_BYTES = 32;
+        const uint16_t end_simd = size / SIMD_BYTES * SIMD_BYTES;
+        uint16_t pos = 0;
+        for (; pos < end_simd; pos += SIMD_BYTES) {
+            auto mask = simd::bytes32_mask_to_bits32_mask(passed + pos);
+            if (mask == 0xffffffff) {
+                for (uint16_t i = 0; i < SIMD_BYTES; ++i) {
+                    sel[new_size++] = pos + i;
+                }
+            } else {
+                while (mask) {
+                    sel[new_size++] = pos + __builtin_ctz(mask);
+                    mask &= mask - 1;
+                }
+            }
+        }
+        for (; pos < size; ++pos) {
+            sel[new_size] = pos;
+            new_size += passed[pos];
+        }
+        return new_size;
+    }
+
+    // Set (or and with, if is_and) flags[i] to whether row i passes, for rows 0 to size - 1.
+    template <bool is_and>
+    static void evaluate_vec(const CodeFlags& flags, const vectorized::ColumnDictI32& column,
+                             const uint8_t* null_map, bool opposite, uint16_t size,
+                             bool* result) {
+        _gather<is_and>(flags.data() + 1, column.get_data().data(), null_map, opposite, size,
+                        reinterpret_cast<uint8_t*>(result));
+    }
+
+private:
+    template <bool is_and>
+    static void _gather(const vectorized::UInt8* __restrict code_flags,
+                        const int32_t* __restrict codes, const uint8_t* __restrict null_map,
+                        bool opposite, uint16_t size, uint8_t* __restrict result) {
+        if (null_map == nullptr) {
+            for (uint16_t i = 0; i < size; ++i) {
+                uint8_t passed = opposite ^ code_flags[codes[i]];
+                result[i] = is_and ? result[i] & passed : passed;
+            }
+        } else {
+            for (uint16_t i = 0; i < size; ++i) {
+                uint8_t passed = opposite ^ (code_flags[codes[i]] & !null_map[i]);
+                result[i] = is_and ? result[i] & passed : passed;
+            }
+        }
+    }
+
+    mutable std::map<std::pair<RowsetId, uint32_t>, CodeFlags> _segment_code_flags;
+};
+
+} // namespace doris
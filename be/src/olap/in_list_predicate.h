@@ -23,6 +23,7 @@
 #include "decimal12.h"
 #include "exprs/hybrid_set.h"
 #include "olap/column_predicate.h"
+#include "olap/dict_code_filter.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/bloom_filter.h"
 #include "olap/rowset/segment_v2/inverted_index_cache.h" // IWYU pragma: keep
@@ -390,43 +391,13 @@ private:
 
         if (column->is_column_dictionary()) {
             if constexpr (std::is_same_v<T, StringRef>) {
-                auto* nested_col_ptr = vectorized::check_and_get_column<
-                        vectorized::ColumnDictionary<vectorized::Int32>>(column);
-                auto& data_array = nested_col_ptr->get_data();
+                auto* nested_col_ptr =
+                        vectorized::check_and_get_column<vectorized::ColumnDictI32>(column);
                 auto segid = column->get_rowset_segment_id();
                 DCHECK((segid.first.hi | segid.first.mi | segid.first.lo) != 0);
-                auto& value_in_dict_flags = _segment_id_to_value_in_dict_flags[segid];
-                if (value_in_dict_flags.empty()) {
-                    nested_col_ptr->find_codes(_values.get(), value_in_dict_flags);
-                }
-
-                CHECK(value_in_dict_flags.size() == nested_col_ptr->dict_size())
-                        << "value_in_dict_flags.size()!=nested_col_ptr->dict_size(), "
-                        << value_in_dict_flags.size() << " vs " << nested_col_ptr->dict_size()
-                        << " rowsetid=" << segid.first << " segmentid=" << segid.second
-                        << "dict_info" << nested_col_ptr->dict_debug_string();
-
-                for (uint16_t i = 0; i < size; i++) {
-                    uint16_t idx = sel[i];
-                    if constexpr (is_nullable) {
-                        if ((*null_map)[idx]) {
-                            if constexpr (is_opposite) {
-                                sel[new_size++] = idx;
-                            }
-                            continue;
-                        }
-                    }
-
-                    if constexpr (is_opposite != (PT == PredicateType::IN_LIST)) {
-                        if (value_in_dict_flags[data_array[idx]]) {
-                            sel[new_size++] = idx;
-                        }
-                    } else {
-                        if (!value_in_dict_flags[data_array[idx]]) {
-                            sel[new_size++] = idx;
-                        }
-                    }
-                }
+                new_size = DictCodeFilter::evaluate(
+                        _find_dict_code_flags(*nested_col_ptr), *nested_col_ptr,
+                        is_nullable ? null_map->data() : nullptr, is_opposite, sel, size);
             } else {
                 LOG(FATAL) << "column_dictionary must use StringRef predicate.";
             }
@@ -456,14 +427,10 @@ private:
                             const uint16_t* sel, uint16_t size, bool* flags) const {
         if (column->is_column_dictionary()) {
             if constexpr (std::is_same_v<T, StringRef>) {
-                auto* nested_col_ptr = vectorized::check_and_get_column<
-                        vectorized::ColumnDictionary<vectorized::Int32>>(column);
+                auto* nested_col_ptr =
+                        vectorized::check_and_get_column<vectorized::ColumnDictI32>(column);
                 auto& data_array = nested_col_ptr->get_data();
-                auto& value_in_dict_flags =
-                        _segment_id_to_value_in_dict_flags[column->get_rowset_segment_id()];
-                if (value_in_dict_flags.empty()) {
-                    nested_col_ptr->find_codes(_values.get(), value_in_dict_flags);
-                }
+                const auto* code_flags = _find_dict_code_flags(*nested_col_ptr).data() + 1;
 
                 for (uint16_t i = 0; i < size; i++) {
                     if (is_and ^ flags[i]) {
@@ -480,14 +447,8 @@ private:
                         }
                     }
 
-                    if constexpr (is_opposite != (PT == PredicateType::IN_LIST)) {
-                        if (is_and ^ value_in_dict_flags[data_array[idx]]) {
-                            flags[i] = !is_and;
-                        }
-                    } else {
-                        if (is_and ^ !value_in_dict_flags[data_array[idx]]) {
-                            flags[i] = !is_and;
-                        }
+                    if (is_and ^ is_opposite ^ code_flags[data_array[idx]]) {
+                        flags[i] = !is_and;
                     }
                 }
             } else {
@@ -529,6 +490,14 @@ private:
         }
     }
 
+    // flags[code + 1] is whether the word of the code passes NOT_IN_LIST or IN_LIST.
+    const DictCodeFilter::CodeFlags& _find_dict_code_flags(
+            const vectorized::ColumnDictI32& column) const {
+        return _dict_code_filter.get(column, [this](const StringRef& word) {
+            return _values->find(&word) == (PT == PredicateType::IN_LIST);
+        });
+    }
+
     std::string _debug_string() const override {
         std::string info =
                 "InListPredicateBase(" + type_to_string(Type) + ", " + type_to_string(PT) + ")";
@@ -545,8 +514,7 @@ private:
     }
 
     std::shared_ptr<HybridSetBase> _values;
-    mutable std::map<std::pair<RowsetId, uint32_t>, std::vector<vectorized::UInt8>>
-            _segment_id_to_value_in_dict_flags;
+    DictCodeFilter _dict_code_filter;
     T _min_value;
     T _max_value;
 
@@ -59,37 +59,12 @@ uint16_t LikeColumnPredicate<T>::evaluate(const vectorized::IColumn& column, uin
         auto& null_map_data = nullable_col->get_null_map_column().get_data();
         auto& nested_col = nullable_col->get_nested_column();
         if (nested_col.is_column_dictionary()) {
-            auto* nested_col_ptr = vectorized::check_and_get_column<
-                    vectorized::ColumnDictionary<vectorized::Int32>>(nested_col);
-            auto& data_array = nested_col_ptr->get_data();
-            if (!nullable_col->has_null()) {
-                for (uint16_t i = 0; i != size; i++) {
-                    uint16_t idx = sel[i];
-                    sel[new_size] = idx;
-                    StringRef cell_value = nested_col_ptr->get_shrink_value(data_array[idx]);
-                    unsigned char flag = 0;
-                    static_cast<void>((_state->scalar_function)(
-                            const_cast<vectorized::LikeSearchState*>(&_like_state),
-                            StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                    new_size += _opposite ^ flag;
-                }
-            } else {
-                for (uint16_t i = 0; i != size; i++) {
-                    uint16_t idx = sel[i];
-                    sel[new_size] = idx;
-                    if (null_map_data[idx]) {
-                        new_size += _opposite;
-                        continue;
-                    }
-
-                    StringRef cell_value = nested_col_ptr->get_shrink_value(data_array[idx]);
-                    unsigned char flag = 0;
-                    static_cast<void>((_state->scalar_function)(
-                            const_cast<vectorized::LikeSearchState*>(&_like_state),
-                            StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                    new_size += _opposite ^ flag;
-                }
-            }
+            auto* nested_col_ptr =
+                    vectorized::check_and_get_column<vectorized::ColumnDictI32>(nested_col);
+            new_size = DictCodeFilter::evaluate(
+                    _find_dict_code_flags(*nested_col_ptr), *nested_col_ptr,
+                    nullable_col->has_null() ? null_map_data.data() : nullptr, _opposite, sel,
+                    size);
         } else {
             auto* str_col = vectorized::check_and_get_column<vectorized::PredicateColumnType<T>>(
                     nested_col);
@@ -124,19 +99,10 @@ uint16_t LikeColumnPredicate<T>::evaluate(const vectorized::IColumn& column, uin
         }
     } else {
         if (column.is_column_dictionary()) {
-            auto* nested_col_ptr = vectorized::check_and_get_column<
-                    vectorized::ColumnDictionary<vectorized::Int32>>(column);
-            auto& data_array = nested_col_ptr->get_data();
-            for (uint16_t i = 0; i != size; i++) {
-                uint16_t idx = sel[i];
-                sel[new_size] = idx;
-                StringRef cell_value = nested_col_ptr->get_shrink_value(data_array[idx]);
-                unsigned char flag = 0;
-                static_cast<void>((_state->scalar_function)(
-                        const_cast<vectorized::LikeSearchState*>(&_like_state),
-                        StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                new_size += _opposite ^ flag;
-            }
+            auto* nested_col_ptr =
+                    vectorized::check_and_get_column<vectorized::ColumnDictI32>(column);
+            new_size = DictCodeFilter::evaluate(_find_dict_code_flags(*nested_col_ptr),
+                                                *nested_col_ptr, nullptr, _opposite, sel, size);
         } else {
             const vectorized::PredicateColumnType<T>* str_col =
                     vectorized::check_and_get_column<vectorized::PredicateColumnType<T>>(column);
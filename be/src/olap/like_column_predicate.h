@@ -28,6 +28,7 @@
 
 #include "common/status.h"
 #include "olap/column_predicate.h"
+#include "olap/dict_code_filter.h"
 #include "olap/rowset/segment_v2/bloom_filter.h"
 #include "vec/columns/column.h"
 #include "vec/columns/column_dictionary.h"
@@ -99,64 +100,44 @@ private:
             auto& null_map_data = nullable_col->get_null_map_column().get_data();
             auto& nested_col = nullable_col->get_nested_column();
             if (nested_col.is_column_dictionary()) {
-                auto* nested_col_ptr = vectorized::check_and_get_column<
-                        vectorized::ColumnDictionary<vectorized::Int32>>(nested_col);
-                auto& data_array = nested_col_ptr->get_data();
-                for (uint16_t i = 0; i < size; i++) {
-                    if (null_map_data[i]) {
-                        if constexpr (is_and) {
-                            flags[i] &= _opposite;
-                        } else {
-                            flags[i] = _opposite;
-                        }
-                        continue;
-                    }
-
-                    StringRef cell_value = nested_col_ptr->get_shrink_value(data_array[i]);
-                    if constexpr (is_and) {
-                        unsigned char flag = 0;
-                        static_cast<void>((_state->scalar_function)(
-                                const_cast<vectorized::LikeSearchState*>(&_like_state),
-                                StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                        flags[i] &= _opposite ^ flag;
-                    } else {
-                        unsigned char flag = 0;
-                        static_cast<void>((_state->scalar_function)(
-                                const_cast<vectorized::LikeSearchState*>(&_like_state),
-                                StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                        flags[i] = _opposite ^ flag;
-                    }
-                }
+                auto* nested_col_ptr =
+                        vectorized::check_and_get_column<vectorized::ColumnDictI32>(nested_col);
+                DictCodeFilter::evaluate_vec<is_and>(_find_dict_code_flags(*nested_col_ptr),
+                                                     *nested_col_ptr, null_map_data.data(),
+                                                     _opposite, size, flags);
             } else {
                 LOG(FATAL) << "vectorized (not) like predicates should be dict column";
             }
         } else {
             if (column.is_column_dictionary()) {
-                auto* nested_col_ptr = vectorized::check_and_get_column<
-                        vectorized::ColumnDictionary<vectorized::Int32>>(column);
-                auto& data_array = nested_col_ptr->get_data();
-                for (uint16_t i = 0; i < size; i++) {
-                    StringRef cell_value = nested_col_ptr->get_shrink_value(data_array[i]);
-                    if constexpr (is_and) {
-                        unsigned char flag = 0;
-                        static_cast<void>((_state->scalar_function)(
-                                const_cast<vectorized::LikeSearchState*>(&_like_state),
-                                StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                        flags[i] &= _opposite ^ flag;
-                    } else {
-                        unsigned char flag = 0;
-                        static_cast<void>((_state->scalar_function)(
-                                const_cast<vectorized::LikeSearchState*>(&_like_state),
-                                StringRef(cell_value.data, cell_value.size), pattern, &flag));
-                        flags[i] = _opposite ^ flag;
-                    }
-                }
+                auto* nested_col_ptr =
+                        vectorized::check_and_get_column<vectorized::ColumnDictI32>(column);
+                DictCodeFilter::evaluate_vec<is_and>(_find_dict_code_flags(*nested_col_ptr),
+                                                     *nested_col_ptr, nullptr, _opposite, size,
+                                                     flags);
             } else {
                 LOG(FATAL) << "vectorized (not) like predicates should be dict column";
             }
         }
     }
 
+    // Match the pattern against every word of the dictionary once instead of against the
+    // value of every row.
+    const DictCodeFilter::CodeFlags& _find_dict_code_flags(
+            const vectorized::ColumnDictI32& column) const {
+        return _dict_code_filter.get(column, [this](const StringRef& word) {
+            StringRef value = word;
+            if constexpr (T == TYPE_CHAR) {
+                value.size = strnlen(value.data, value.size);
+            }
+            unsigned char flag = 0;
+            static_cast<void>((_state->scalar_function)(
+                    const_cast<vectorized::LikeSearchState*>(&_like_state), value, pattern,
+                    &flag));
+            return flag != 0;
+        });
+    }
+
     std::string _debug_string() const override {
         std::string info = "LikeColumnPredicate";
         return info;
@@ -174,6 +155,7 @@ private:
     // LikeColumnPredicate.
     vectorized::LikeSearchState _like_state;
     std::unique_ptr<segment_v2::BloomFilter> _page_ng_bf; // for ngram-bf index
+    DictCodeFilter _dict_code_filter;
 };
 
 } // namespace doris
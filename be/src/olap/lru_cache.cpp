@@ -6,6 +6,7 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <mutex>
 #include <new>
 #include <sstream>
@@ -26,6 +27,8 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(cache_usage_ratio, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(cache_lookup_count, MetricUnit::OPERATIONS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(cache_hit_count, MetricUnit::OPERATIONS);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(cache_hit_ratio, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(cache_protected_usage, MetricUnit::BYTES);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(cache_admission_rejected_count, MetricUnit::OPERATIONS);
 
 uint32_t CacheKey::hash(const char* data, size_t n, uint32_t seed) const {
     // Similar to murmur hash
@@ -164,10 +167,80 @@ uint32_t HandleTable::element_count() const {
     return _elems;
 }
 
+void FrequencySketch::ensure_capacity(uint32_t max_entries) {
+    // about one counter per entry, at least 1024 counters to keep small caches accurate
+    size_t words = 64;
+    while (words * 16 < max_entries) {
+        words *= 2;
+    }
+    if (words <= _table.size()) {
+        return;
+    }
+    if (_table.empty()) {
+        _table.assign(words, 0);
+    } else {
+        // a hash maps to the same counter of word `index & (old_size - 1)` before the resize,
+        // so repeating the old table keeps every frequency while the cache warms up
+        size_t old_size = _table.size();
+        _table.resize(words);
+        for (size_t i = old_size; i < words; ++i) {
+            _table[i] = _table[i & (old_size - 1)];
+        }
+    }
+    _sample_size = static_cast<uint32_t>(std::min<size_t>(words * 16 * 10, UINT32_MAX));
+}
+
+std::pair<size_t, int> FrequencySketch::_slot(uint32_t hash, int i) const {
+    static constexpr uint64_t kSeeds[kDepth] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                                                0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+    uint64_t h = (hash + kSeeds[i]) * kSeeds[i];
+    h ^= h >> 32;
+    // the low bits choose the word, the high bits choose one of its 16 counters
+    return {h & (_table.size() - 1), static_cast<int>((h >> 59) & 15) << 2};
+}
+
+void FrequencySketch::increment(uint32_t hash) {
+    if (_table.empty()) {
+        return;
+    }
+    bool added = false;
+    for (int i = 0; i < kDepth; ++i) {
+        auto [index, shift] = _slot(hash, i);
+        if (((_table[index] >> shift) & 0xf) != 0xf) {
+            _table[index] += 1ULL << shift;
+            added = true;
+        }
+    }
+    if (added && ++_additions >= _sample_size) {
+        _reset();
+    }
+}
+
+uint32_t FrequencySketch::frequency(uint32_t hash) const {
+    if (_table.empty()) {
+        return 0;
+    }
+    uint32_t freq = 0xf;
+    for (int i = 0; i < kDepth; ++i) {
+        auto [index, shift] = _slot(hash, i);
+        freq = std::min(freq, static_cast<uint32_t>((_table[index] >> shift) & 0xf));
+    }
+    return freq;
+}
+
+void FrequencySketch::_reset() {
+    for (auto& word : _table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    _additions /= 2;
+}
+
 LRUCache::LRUCache(LRUCacheType type) : _type(type) {
     // Make empty circular linked list
     _lru_normal.next = &_lru_normal;
     _lru_normal.prev = &_lru_normal;
+    _lru_protected.next = &_lru_protected;
+    _lru_protected.prev = &_lru_protected;
     _lru_durable.next = &_lru_durable;
     _lru_durable.prev = &_lru_durable;
 }
@@ -233,6 +306,10 @@ void LRUCache::_lru_append(LRUHandle* list, LRUHandle* e) {
 Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
     std::lock_guard l(_mutex);
     ++_lookup_count;
+    if (_eviction_policy == CacheEvictionPolicy::TINY_LFU) {
+        // misses are counted too, so a key can earn its admission by being asked for
+        _sketch.increment(hash);
+    }
     LRUHandle* e = _table.lookup(key, hash);
     if (e != nullptr) {
         // we get it from _table, so in_cache must be true
@@ -243,10 +320,21 @@ Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
         }
         e->refs++;
         ++_hit_count;
+        if (_eviction_policy != CacheEvictionPolicy::LRU &&
+            e->priority == CachePriority::NORMAL && !e->in_protected) {
+            // promoted on hit, it joins the protected list when released
+            e->in_protected = true;
+            _protected_usage += e->total_size;
+        }
     }
     return reinterpret_cast<Cache::Handle*>(e);
 }
 
+bool LRUCache::exists(const CacheKey& key, uint32_t hash) {
+    std::lock_guard l(_mutex);
+    return _table.lookup(key, hash) != nullptr;
+}
+
 void LRUCache::release(Cache::Handle* handle) {
     if (handle == nullptr) {
         return;
@@ -265,12 +353,16 @@ void LRUCache::release(Cache::Handle* handle) {
                 bool removed = _table.remove(e);
                 DCHECK(removed);
                 e->in_cache = false;
+                _leave_protected(e);
                 _unref(e);
                 _usage -= e->total_size;
                 last_ref = true;
             } else {
                 // put it to LRU free list
-                if (e->priority == CachePriority::NORMAL) {
+                if (e->priority == CachePriority::NORMAL && e->in_protected) {
+                    _lru_append(&_lru_protected, e);
+                    _demote_protected();
+                } else if (e->priority == CachePriority::NORMAL) {
                     _lru_append(&_lru_normal, e);
                 } else if (e->priority == CachePriority::DURABLE) {
                     _lru_append(&_lru_durable, e);
@@ -312,14 +404,16 @@ void LRUCache::_evict_from_lru_with_time(size_t total_size, LRUHandle** to_remov
 }
 
 void LRUCache::_evict_from_lru(size_t total_size, LRUHandle** to_remove_head) {
-    // 1. evict normal cache entries
-    while ((_usage + total_size > _capacity || _check_element_count_limit()) &&
-           _lru_normal.next != &_lru_normal) {
-        LRUHandle* old = _lru_normal.next;
-        DCHECK(old->priority == CachePriority::NORMAL);
-        _evict_one_entry(old);
-        old->next = *to_remove_head;
-        *to_remove_head = old;
+    // 1. evict normal cache entries, the probation segment goes first with SLRU and TINY_LFU
+    for (LRUHandle* list : {&_lru_normal, &_lru_protected}) {
+        while ((_usage + total_size > _capacity || _check_element_count_limit()) &&
+               list->next != list) {
+            LRUHandle* old = list->next;
+            DCHECK(old->priority == CachePriority::NORMAL);
+            _evict_one_entry(old);
+            old->next = *to_remove_head;
+            *to_remove_head = old;
+        }
     }
     // 2. evict durable cache entries if need
     while ((_usage + total_size > _capacity || _check_element_count_limit()) &&
@@ -339,6 +433,7 @@ void LRUCache::_evict_one_entry(LRUHandle* e) {
     bool removed = _table.remove(e);
     DCHECK(removed);
     e->in_cache = false;
+    _leave_protected(e);
     _unref(e);
     _usage -= e->total_size;
 }
@@ -347,6 +442,39 @@ bool LRUCache::_check_element_count_limit() {
     return _element_count_capacity != 0 && _table.element_count() >= _element_count_capacity;
 }
 
+bool LRUCache::_reject_admission(const LRUHandle* e) {
+    if (_eviction_policy != CacheEvictionPolicy::TINY_LFU ||
+        e->priority != CachePriority::NORMAL ||
+        (_usage + e->total_size <= _capacity && !_check_element_count_limit())) {
+        return false;
+    }
+    const LRUHandle* victim = _lru_normal.next != &_lru_normal ? _lru_normal.next
+                                                                : _lru_protected.next;
+    if (victim == &_lru_protected) {
+        // nothing could be evicted anyway, keep the behavior of LRU
+        return false;
+    }
+    // on a tie the entry already in cache wins, a one-off scan can not flush the cache
+    return _sketch.frequency(e->hash) <= _sketch.frequency(victim->hash);
+}
+
+void LRUCache::_leave_protected(LRUHandle* e) {
+    if (e->in_protected) {
+        e->in_protected = false;
+        _protected_usage -= e->total_size;
+    }
+}
+
+void LRUCache::_demote_protected() {
+    const auto protected_capacity = static_cast<size_t>(_capacity * SLRU_PROTECTED_RATIO);
+    while (_protected_usage > protected_capacity && _lru_protected.next != &_lru_protected) {
+        LRUHandle* e = _lru_protected.next;
+        _lru_remove(e);
+        _leave_protected(e);
+        _lru_append(&_lru_normal, e);
+    }
+}
+
 Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
                                 void (*deleter)(const CacheKey& key, void* value),
                                 MemTrackerLimiter* tracker, CachePriority priority, size_t bytes) {
@@ -367,6 +495,7 @@ Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value,
     e->refs = 2; // one for the returned handle, one for LRUCache.
     e->next = e->prev = nullptr;
     e->in_cache = true;
+    e->in_protected = false;
     e->priority = priority;
     e->mem_tracker = tracker;
     e->type = _type;
@@ -379,6 +508,18 @@ Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value,
     {
         std::lock_guard l(_mutex);
 
+        if (_eviction_policy == CacheEvictionPolicy::TINY_LFU) {
+            _sketch.ensure_capacity(_table.element_count() + 1);
+            if (_reject_admission(e)) {
+                // hand out the value without caching it, release() frees it
+                e->in_cache = false;
+                e->refs = 1;
+                _usage += e->total_size;
+                ++_admission_rejected_count;
+                return reinterpret_cast<Cache::Handle*>(e);
+            }
+        }
+
         // Free the space following strict LRU policy until enough space
         // is freed or the lru list is empty
         if (_cache_value_check_timestamp) {
@@ -394,6 +535,7 @@ Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value,
         _usage += e->total_size;
         if (old != nullptr) {
             old->in_cache = false;
+            _leave_protected(old);
             if (_unref(old)) {
                 _usage -= old->total_size;
                 // old is on LRU because it's in cache and its reference count
@@ -432,6 +574,7 @@ void LRUCache::erase(const CacheKey& key, uint32_t hash) {
                 }
             }
             e->in_cache = false;
+            _leave_protected(e);
         }
     }
     // free handle out of mutex, when last_ref is true, e must not be nullptr
@@ -444,17 +587,13 @@ int64_t LRUCache::prune() {
     LRUHandle* to_remove_head = nullptr;
     {
         std::lock_guard l(_mutex);
-        while (_lru_normal.next != &_lru_normal) {
-            LRUHandle* old = _lru_normal.next;
-            _evict_one_entry(old);
-            old->next = to_remove_head;
-            to_remove_head = old;
-        }
-        while (_lru_durable.next != &_lru_durable) {
-            LRUHandle* old = _lru_durable.next;
-            _evict_one_entry(old);
-            old->next = to_remove_head;
-            to_remove_head = old;
+        for (LRUHandle* list : {&_lru_normal, &_lru_protected, &_lru_durable}) {
+            while (list->next != list) {
+                LRUHandle* old = list->next;
+                _evict_one_entry(old);
+                old->next = to_remove_head;
+                to_remove_head = old;
+            }
         }
     }
     int64_t pruned_count = 0;
@@ -471,30 +610,19 @@ int64_t LRUCache::prune_if(CacheValuePredicate pred, bool lazy_mode) {
     LRUHandle* to_remove_head = nullptr;
     {
         std::lock_guard l(_mutex);
-        LRUHandle* p = _lru_normal.next;
-        while (p != &_lru_normal) {
-            LRUHandle* next = p->next;
-            if (pred(p->value)) {
-                _evict_one_entry(p);
-                p->next = to_remove_head;
-                to_remove_head = p;
-            } else if (lazy_mode) {
-                break;
-            }
-            p = next;
-        }
-
-        p = _lru_durable.next;
-        while (p != &_lru_durable) {
-            LRUHandle* next = p->next;
-            if (pred(p->value)) {
-                _evict_one_entry(p);
-                p->next = to_remove_head;
-                to_remove_head = p;
-            } else if (lazy_mode) {
-                break;
+        for (LRUHandle* list : {&_lru_normal, &_lru_protected, &_lru_durable}) {
+            LRUHandle* p = list->next;
+            while (p != list) {
+                LRUHandle* next = p->next;
+                if (pred(p->value)) {
+                    _evict_one_entry(p);
+                    p->next = to_remove_head;
+                    to_remove_head = p;
+                } else if (lazy_mode) {
+                    break;
+                }
+                p = next;
             }
-            p = next;
         }
     }
     int64_t pruned_count = 0;
@@ -520,7 +648,8 @@ inline uint32_t ShardedLRUCache::_hash_slice(const CacheKey& s) {
 }
 
 ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
-                                 uint32_t num_shards, uint32_t total_element_count_capacity)
+                                 uint32_t num_shards, uint32_t total_element_count_capacity,
+                                 CacheEvictionPolicy eviction_policy)
         : _name(name),
           _num_shard_bits(Bits::FindLSBSetNonZero(num_shards)),
           _num_shards(num_shards),
@@ -542,11 +671,13 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
         shards[s] = new LRUCache(type);
         shards[s]->set_capacity(per_shard);
         shards[s]->set_element_count_capacity(per_shard_element_count_capacity);
+        shards[s]->set_eviction_policy(eviction_policy);
     }
     _shards = shards;
 
     _entity = DorisMetrics::instance()->metric_registry()->register_entity(
-            std::string("lru_cache:") + name, {{"name", name}});
+            std::string("lru_cache:") + name,
+            {{"name", name}, {"policy", eviction_policy_string(eviction_policy)}});
     _entity->register_hook(name, std::bind(&ShardedLRUCache::update_cache_metrics, this));
     INT_GAUGE_METRIC_REGISTER(_entity, cache_capacity);
     INT_GAUGE_METRIC_REGISTER(_entity, cache_usage);
@@ -554,6 +685,8 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, cache_lookup_count);
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, cache_hit_count);
     INT_DOUBLE_METRIC_REGISTER(_entity, cache_hit_ratio);
+    INT_GAUGE_METRIC_REGISTER(_entity, cache_protected_usage);
+    INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, cache_admission_rejected_count);
 
     _hit_count_bvar.reset(new bvar::Adder<uint64_t>("doris_cache", _name));
     _hit_count_per_second.reset(new bvar::PerSecond<bvar::Adder<uint64_t>>(
@@ -569,6 +702,7 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
                                  bool cache_value_check_timestamp,
                                  uint32_t total_element_count_capacity)
         : ShardedLRUCache(name, total_capacity, type, num_shards, total_element_count_capacity) {
+    // the timestamp ordered eviction only works with the LRU policy
     for (int s = 0; s < _num_shards; s++) {
         _shards[s]->set_cache_value_time_extractor(cache_value_time_extractor);
         _shards[s]->set_cache_value_check_timestamp(cache_value_check_timestamp);
@@ -599,6 +733,11 @@ Cache::Handle* ShardedLRUCache::lookup(const CacheKey& key) {
     return _shards[_shard(hash)]->lookup(key, hash);
 }
 
+bool ShardedLRUCache::exists(const CacheKey& key) {
+    const uint32_t hash = _hash_slice(key);
+    return _shards[_shard(hash)]->exists(key, hash);
+}
+
 void ShardedLRUCache::release(Handle* handle) {
     LRUHandle* h = reinterpret_cast<LRUHandle*>(handle);
     _shards[_shard(h->hash)]->release(handle);
@@ -655,17 +794,23 @@ void ShardedLRUCache::update_cache_metrics() const {
     size_t total_usage = 0;
     size_t total_lookup_count = 0;
     size_t total_hit_count = 0;
+    size_t total_protected_usage = 0;
+    size_t total_admission_rejected_count = 0;
     for (int i = 0; i < _num_shards; i++) {
         total_capacity += _shards[i]->get_capacity();
         total_usage += _shards[i]->get_usage();
         total_lookup_count += _shards[i]->get_lookup_count();
         total_hit_count += _shards[i]->get_hit_count();
+        total_protected_usage += _shards[i]->get_protected_usage();
+        total_admission_rejected_count += _shards[i]->get_admission_rejected_count();
     }
 
     cache_capacity->set_value(total_capacity);
     cache_usage->set_value(total_usage);
     cache_lookup_count->set_value(total_lookup_count);
     cache_hit_count->set_value(total_hit_count);
+    cache_protected_usage->set_value(total_protected_usage);
+    cache_admission_rejected_count->set_value(total_admission_rejected_count);
     cache_usage_ratio->set_value(total_capacity == 0 ? 0 : ((double)total_usage / total_capacity));
     cache_hit_ratio->set_value(
             total_lookup_count == 0 ? 0 : ((double)total_hit_count / total_lookup_count));
@@ -686,6 +831,7 @@ Cache::Handle* DummyLRUCache::insert(const CacheKey& key, void* value, size_t ch
     e->refs = 1; // only one for the returned handle
     e->next = e->prev = nullptr;
     e->in_cache = false;
+    e->in_protected = false;
     return reinterpret_cast<Cache::Handle*>(e);
 }
 
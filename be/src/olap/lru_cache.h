@@ -17,7 +17,9 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "runtime/memory/mem_tracker_limiter.h"
 #include "runtime/thread_context.h"
@@ -59,9 +61,31 @@ enum LRUCacheType {
     NUMBER // The capacity of cache is based on the number of cache entry, number = charge, the weight of an entry.
 };
 
+// How a shard chooses the entry to evict.
+// LRU: evict the least recently used entry.
+// SLRU: segmented LRU, a new entry enters the probation segment and is moved to the protected
+//   segment on its first hit, so entries accessed only once (e.g. by a large scan) are evicted
+//   before the entries which are accessed repeatedly.
+// TINY_LFU: SLRU plus a frequency based admission filter. When the cache is full, a new entry
+//   is only admitted if it is accessed more frequently than the entry it would evict.
+enum class CacheEvictionPolicy { LRU, SLRU, TINY_LFU };
+
 static constexpr LRUCacheType DEFAULT_LRU_CACHE_TYPE = LRUCacheType::SIZE;
 static constexpr uint32_t DEFAULT_LRU_CACHE_NUM_SHARDS = 16;
 static constexpr size_t DEFAULT_LRU_CACHE_ELEMENT_COUNT_CAPACITY = 0;
+static constexpr CacheEvictionPolicy DEFAULT_CACHE_EVICTION_POLICY = CacheEvictionPolicy::LRU;
+// Max share of the shard capacity held by the protected segment of SLRU and TINY_LFU.
+static constexpr double SLRU_PROTECTED_RATIO = 0.8;
+
+// "lru", "slru" or "tinylfu", see config::data_page_cache_eviction_policy.
+inline CacheEvictionPolicy cache_eviction_policy_from_string(std::string_view policy) {
+    if (policy == "slru") {
+        return CacheEvictionPolicy::SLRU;
+    } else if (policy == "tinylfu") {
+        return CacheEvictionPolicy::TINY_LFU;
+    }
+    return CacheEvictionPolicy::LRU;
+}
 
 class CacheKey {
 public:
@@ -187,6 +211,10 @@ public:
     // longer needed.
     virtual Handle* lookup(const CacheKey& key) = 0;
 
+    // Return whether the cache has a mapping for "key". Unlike lookup(), it is not counted as
+    // a lookup or a hit and does not change the eviction order or the admission statistics.
+    virtual bool exists(const CacheKey& key) = 0;
+
     // Release a mapping returned by a previous Lookup().
     // REQUIRES: handle must not have been released yet.
     // REQUIRES: handle must have been returned by a method on *this.
@@ -249,6 +277,7 @@ struct LRUHandle {
     size_t total_size; // including key length
     size_t bytes;      // Used by LRUCacheType::NUMBER, LRUCacheType::SIZE equal to total_size.
     bool in_cache;     // Whether entry is in the cache.
+    bool in_protected; // Whether entry is in the protected segment of SLRU and TINY_LFU.
     uint32_t refs;
     uint32_t hash; // Hash of key(); used for fast sharding and comparisons
     CachePriority priority = CachePriority::NORMAL;
@@ -319,6 +348,32 @@ private:
     void _resize();
 };
 
+// A count-min sketch with 4-bit saturating counters, which estimates how many times a key
+// was accessed recently. All counters are halved once the number of increments reaches
+// 10 times the table size, so that old accesses fade out. Used by the TINY_LFU admission.
+// Not thread safe, it is protected by the mutex of the owner shard.
+class FrequencySketch {
+public:
+    // Size the sketch for about `max_entries` keys. A resize keeps the estimated frequencies.
+    void ensure_capacity(uint32_t max_entries);
+    void increment(uint32_t hash);
+    uint32_t frequency(uint32_t hash) const;
+
+private:
+    FRIEND_TEST(CacheTest, FrequencySketch);
+
+    static constexpr int kDepth = 4;
+
+    // Index of the counter of row `i` for `hash`, as a 4-bit slot inside a table word.
+    std::pair<size_t, int> _slot(uint32_t hash, int i) const;
+    void _reset();
+
+    // each word holds 16 counters
+    std::vector<uint64_t> _table;
+    uint32_t _sample_size = 0;
+    uint32_t _additions = 0;
+};
+
 // pair first is timestatmp, put <timestatmp, LRUHandle*> into asc set,
 // when need to free space, can first evict the begin of the set,
 // because the begin element's timestamp is the oldest.
@@ -335,6 +390,9 @@ public:
     void set_element_count_capacity(uint32_t element_count_capacity) {
         _element_count_capacity = element_count_capacity;
     }
+    void set_eviction_policy(CacheEvictionPolicy eviction_policy) {
+        _eviction_policy = eviction_policy;
+    }
 
     // Like Cache methods, but with an extra "hash" parameter.
     // Must call release on the returned handle pointer.
@@ -343,6 +401,7 @@ public:
                           MemTrackerLimiter* tracker,
                           CachePriority priority = CachePriority::NORMAL, size_t bytes = -1);
     Cache::Handle* lookup(const CacheKey& key, uint32_t hash);
+    bool exists(const CacheKey& key, uint32_t hash);
     void release(Cache::Handle* handle);
     void erase(const CacheKey& key, uint32_t hash);
     int64_t prune();
@@ -355,6 +414,8 @@ public:
     uint64_t get_hit_count() const { return _hit_count; }
     size_t get_usage() const { return _usage; }
     size_t get_capacity() const { return _capacity; }
+    size_t get_protected_usage() const { return _protected_usage; }
+    uint64_t get_admission_rejected_count() const { return _admission_rejected_count; }
 
 private:
     void _lru_remove(LRUHandle* e);
@@ -364,6 +425,11 @@ private:
     void _evict_from_lru_with_time(size_t total_size, LRUHandle** to_remove_head);
     void _evict_one_entry(LRUHandle* e);
     bool _check_element_count_limit();
+    // Whether TINY_LFU should refuse to cache the new entry `e` rather than evicting others.
+    bool _reject_admission(const LRUHandle* e);
+    void _leave_protected(LRUHandle* e);
+    // Move the oldest protected entries back to probation while the protected segment is full.
+    void _demote_protected();
 
 private:
     LRUCacheType _type;
@@ -375,10 +441,17 @@ private:
     std::mutex _mutex;
     size_t _usage = 0;
 
+    CacheEvictionPolicy _eviction_policy = DEFAULT_CACHE_EVICTION_POLICY;
+
     // Dummy head of LRU list.
     // Entries have refs==1 and in_cache==true.
     // _lru_normal.prev is newest entry, _lru_normal.next is oldest entry.
+    // For SLRU and TINY_LFU, _lru_normal is the probation segment.
     LRUHandle _lru_normal;
+    // The protected segment of SLRU and TINY_LFU, normal entries which have been hit.
+    LRUHandle _lru_protected;
+    // total size of protected entries, including the ones currently referenced
+    size_t _protected_usage = 0;
     // _lru_durable.prev is newest entry, _lru_durable.next is oldest entry.
     LRUHandle _lru_durable;
 
@@ -386,6 +459,9 @@ private:
 
     uint64_t _lookup_count = 0; // cache查找总次数
     uint64_t _hit_count = 0;    // 命中cache的总次数
+    uint64_t _admission_rejected_count = 0;
+
+    FrequencySketch _sketch;
 
     CacheValueTimeExtractor _cache_value_time_extractor;
     bool _cache_value_check_timestamp = false;
@@ -403,6 +479,7 @@ public:
                            CachePriority priority = CachePriority::NORMAL,
                            size_t bytes = -1) override;
     virtual Handle* lookup(const CacheKey& key) override;
+    bool exists(const CacheKey& key) override;
     virtual void release(Handle* handle) override;
     virtual void erase(const CacheKey& key) override;
     virtual void* value(Handle* handle) override;
@@ -419,7 +496,8 @@ private:
     friend class LRUCachePolicy;
 
     explicit ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
-                             uint32_t num_shards, uint32_t element_count_capacity);
+                             uint32_t num_shards, uint32_t element_count_capacity,
+                             CacheEvictionPolicy eviction_policy = DEFAULT_CACHE_EVICTION_POLICY);
     explicit ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
                              uint32_t num_shards,
                              CacheValueTimeExtractor cache_value_time_extractor,
@@ -438,6 +516,20 @@ private:
         }
     }
 
+    static std::string eviction_policy_string(CacheEvictionPolicy policy) {
+        switch (policy) {
+        case CacheEvictionPolicy::LRU:
+            return "lru";
+        case CacheEvictionPolicy::SLRU:
+            return "slru";
+        case CacheEvictionPolicy::TINY_LFU:
+            return "tinylfu";
+        default:
+            LOG(FATAL) << "not match eviction policy of lru cache:" << static_cast<int>(policy);
+            __builtin_unreachable();
+        }
+    }
+
 private:
     static uint32_t _hash_slice(const CacheKey& s);
     uint32_t _shard(uint32_t hash) {
@@ -459,6 +551,8 @@ private:
     IntAtomicCounter* cache_lookup_count = nullptr;
     IntAtomicCounter* cache_hit_count = nullptr;
     DoubleGauge* cache_hit_ratio = nullptr;
+    IntGauge* cache_protected_usage = nullptr;
+    IntAtomicCounter* cache_admission_rejected_count = nullptr;
     // bvars
     std::unique_ptr<bvar::Adder<uint64_t>> _hit_count_bvar;
     std::unique_ptr<bvar::PerSecond<bvar::Adder<uint64_t>>> _hit_count_per_second;
@@ -474,6 +568,7 @@ public:
                    void (*deleter)(const CacheKey& key, void* value),
                    CachePriority priority = CachePriority::NORMAL, size_t bytes = -1) override;
     Handle* lookup(const CacheKey& key) override { return nullptr; };
+    bool exists(const CacheKey& key) override { return false; };
     void release(Handle* handle) override;
     void erase(const CacheKey& key) override {};
     void* value(Handle* handle) override;
@@ -40,6 +40,7 @@
 #include "vec/aggregate_functions/aggregate_function_reader.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
 #include "vec/columns/column.h"
+#include "vec/core/sort_block.h"
 
 namespace doris {
 
@@ -84,6 +85,8 @@ MemTable::MemTable(int64_t tablet_id, const TabletSchema* tablet_schema,
             _num_columns = partial_update_info->partial_update_input_columns.size();
         }
     }
+    _merge_on_insert = _keys_type != KeysType::DUP_KEYS &&
+                       config::memtable_merge_on_insert_min_dup_ratio > 0;
 }
 void MemTable::_init_columns_offset_by_slot_descs(const std::vector<SlotDescriptor*>* slot_descs,
                                                   const TupleDescriptor* tuple_desc) {
@@ -255,17 +258,48 @@ void MemTable::_put_into_output(vectorized::Block& in_block) {
                                    row_pos_vec.data() + in_block.rows());
 }
 
+bool MemTable::_build_normalized_keys() {
+    if (!config::enable_normalized_sort_key || _tablet_schema->num_key_columns() == 0) {
+        return false;
+    }
+    vectorized::ColumnsWithSortDescriptions key_columns;
+    for (int i = 0; i < _tablet_schema->num_key_columns(); i++) {
+        key_columns.emplace_back(_input_mutable_block.get_column_by_position(i).get(),
+                                 vectorized::SortColumnDescription(i, 1, -1));
+    }
+    return _normalized_keys.build(key_columns, _normalized_keys.rows(),
+                                  _input_mutable_block.rows());
+}
+
 size_t MemTable::_sort() {
     SCOPED_RAW_TIMER(&_stat.sort_ns);
     _stat.sort_times++;
     size_t same_keys_num = 0;
+    _vec_row_comparator->set_block(&_input_mutable_block);
+    // compare the key columns only if the normalized keys are equal and not the whole keys
+    bool use_normalized_keys = _build_normalized_keys();
+    auto key_cmp = [this, use_normalized_keys](const RowInBlock* lhs,
+                                               const RowInBlock* rhs) -> int {
+        if (use_normalized_keys) {
+            int res = _normalized_keys.compare(lhs->_row_pos, rhs->_row_pos);
+            if (res != 0 || _normalized_keys.is_complete()) {
+                return res;
+            }
+        }
+        return (*_vec_row_comparator)(lhs, rhs);
+    };
     // sort new rows
     Tie tie = Tie(_last_sorted_pos, _row_in_blocks.size());
-    for (size_t i = 0; i < _tablet_schema->num_key_columns(); i++) {
-        auto cmp = [&](const RowInBlock* lhs, const RowInBlock* rhs) -> int {
-            return _input_mutable_block.compare_one_column(lhs->_row_pos, rhs->_row_pos, i, -1);
-        };
-        _sort_one_column(_row_in_blocks, tie, cmp);
+    if (use_normalized_keys) {
+        _sort_one_column(_row_in_blocks, tie, key_cmp);
+    } else {
+        for (size_t i = 0; i < _tablet_schema->num_key_columns(); i++) {
+            auto cmp = [&](const RowInBlock* lhs, const RowInBlock* rhs) -> int {
+                return _input_mutable_block.compare_one_column(lhs->_row_pos, rhs->_row_pos, i,
+                                                               -1);
+            };
+            _sort_one_column(_row_in_blocks, tie, cmp);
+        }
     }
     bool is_dup = (_keys_type == KeysType::DUP_KEYS);
     // sort extra round by _row_pos to make the sort stable
@@ -279,10 +313,9 @@ size_t MemTable::_sort() {
         same_keys_num += iter.right() - iter.left();
     }
     // merge new rows and old rows
-    _vec_row_comparator->set_block(&_input_mutable_block);
-    auto cmp_func = [this, is_dup, &same_keys_num](const RowInBlock* l,
-                                                   const RowInBlock* r) -> bool {
-        auto value = (*(this->_vec_row_comparator))(l, r);
+    auto cmp_func = [&key_cmp, is_dup, &same_keys_num](const RowInBlock* l,
+                                                       const RowInBlock* r) -> bool {
+        auto value = key_cmp(l, r);
         if (value == 0) {
             same_keys_num++;
             return is_dup ? l->_row_pos > r->_row_pos : l->_row_pos < r->_row_pos;
@@ -431,6 +464,11 @@ void MemTable::_aggregate() {
             }
             _stat.merged_rows++;
             _aggregate_two_row_in_block(mutable_block, _row_in_blocks[i], prev_row);
+            if constexpr (!is_final) {
+                // the merged row is dropped from _row_in_blocks below
+                DCHECK(!_row_in_blocks[i]->has_init_agg());
+                delete _row_in_blocks[i];
+            }
         } else {
             prev_row = _row_in_blocks[i];
             if (!temp_row_in_blocks.empty()) {
@@ -452,6 +490,7 @@ void MemTable::_aggregate() {
         _insert_mem_tracker->consume(shrunked_after_agg - _mem_usage);
         _mem_usage = shrunked_after_agg;
         _input_mutable_block.swap(_output_mutable_block);
+        _normalized_keys.clear();
         //TODO(weixang):opt here.
         std::unique_ptr<vectorized::Block> empty_input_block = in_block.create_same_struct_block(0);
         _output_mutable_block =
@@ -473,6 +512,16 @@ void MemTable::shrink_memtable_by_agg() {
     }
 }
 
+void MemTable::merge_on_insert() {
+    size_t new_rows = _row_in_blocks.size() - _last_sorted_pos;
+    int64_t merged_rows = _stat.merged_rows;
+    shrink_memtable_by_agg();
+    merged_rows = _stat.merged_rows - merged_rows;
+    if (merged_rows < new_rows * config::memtable_merge_on_insert_min_dup_ratio) {
+        _merge_on_insert = false;
+    }
+}
+
 bool MemTable::need_flush() const {
     auto max_size = config::write_buffer_size;
     if (_is_partial_update) {
@@ -491,6 +540,16 @@ bool MemTable::need_agg() const {
     return false;
 }
 
+bool MemTable::need_merge_on_insert() const {
+    if (!_merge_on_insert) {
+        return false;
+    }
+    // wait for as many new rows as the sorted run has, so that a row is copied by the merges
+    // only a few times even if the sorted run keeps growing
+    size_t new_rows = _row_in_blocks.size() - _last_sorted_pos;
+    return new_rows >= std::max<size_t>(config::memtable_merge_on_insert_rows, _last_sorted_pos);
+}
+
 std::unique_ptr<vectorized::Block> MemTable::to_block() {
     size_t same_keys_num = _sort();
     if (_keys_type == KeysType::DUP_KEYS || same_keys_num == 0) {
@@ -37,6 +37,7 @@
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/common/arena.h"
 #include "vec/core/block.h"
+#include "vec/core/normalized_key.h"
 
 namespace doris {
 
@@ -189,6 +190,14 @@ public:
 
     bool need_agg() const;
 
+    // whether enough rows were inserted since the last sort to merge them into the sorted run,
+    // which is only done while the merges find enough duplicate keys
+    bool need_merge_on_insert() const;
+
+    // merges the rows inserted since the last sort into the sorted run, and gives merging on
+    // insert up if too few of them were duplicate keys
+    void merge_on_insert();
+
     std::unique_ptr<vectorized::Block> to_block();
 
     bool empty() const { return _input_mutable_block.rows() == 0; }
@@ -241,7 +250,15 @@ private:
     vectorized::MutableBlock _input_mutable_block;
     vectorized::MutableBlock _output_mutable_block;
     size_t _last_sorted_pos = 0;
-
+    // merging on insert is given up for the rest of this memtable once a merge finds that the
+    // keys are mostly distinct, sorting them once at flush is cheaper then
+    bool _merge_on_insert = false;
+    // normalized keys of the rows of _input_mutable_block, which are built before sorting
+    vectorized::NormalizedKeys _normalized_keys;
+
+    // build the normalized keys of the rows which are not sorted yet, return false if the
+    // keys can not be normalized
+    bool _build_normalized_keys();
     //return number of same keys
     size_t _sort();
     void _sort_by_cluster_keys();
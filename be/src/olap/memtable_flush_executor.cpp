@@ -218,7 +218,8 @@ void MemTableFlushExecutor::init(int num_disk) {
     _register_metrics();
 }
 
-// NOTE: we use SERIAL mode here to ensure all mem-tables from one tablet are flushed in order.
+// NOTE: the memtables of a tablet are flushed concurrently, each of them into a segment of its
+// own, whose id is allocated in the order the memtables are submitted.
 Status MemTableFlushExecutor::create_flush_token(std::unique_ptr<FlushToken>& flush_token,
                                                  RowsetWriter* rowset_writer,
                                                  bool is_high_priority) {
@@ -126,6 +126,8 @@ Status MemTableWriter::write(const vectorized::Block* block, const std::vector<u
 
     if (UNLIKELY(_mem_table->need_agg() && config::enable_shrink_memory)) {
         _mem_table->shrink_memtable_by_agg();
+    } else if (_mem_table->need_merge_on_insert()) {
+        _mem_table->merge_on_insert();
     }
     if (UNLIKELY(_mem_table->need_flush())) {
         auto s = _flush_memtable_async();
@@ -320,6 +320,9 @@ struct OlapReaderStatistics {
     int64_t short_cond_ns = 0;
     int64_t expr_filter_ns = 0;
     int64_t output_col_ns = 0;
+    // columns read by row location after the scanner filters, see NewOlapScanner
+    int64_t late_materialization_ns = 0;
+    int64_t rows_late_materialized = 0;
 
     std::map<int, PredicateFilterInfo> filter_info;
 
@@ -347,6 +350,7 @@ struct OlapReaderStatistics {
 
     int64_t total_pages_num = 0;
     int64_t cached_pages_num = 0;
+    int64_t prefetched_pages_num = 0;
 
     int64_t rows_bitmap_index_filtered = 0;
     int64_t bitmap_index_filter_timer = 0;
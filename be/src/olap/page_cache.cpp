@@ -21,6 +21,7 @@
 
 #include <ostream>
 
+#include "olap/page_disk_cache.h"
 #include "runtime/exec_env.h"
 
 namespace doris {
@@ -52,24 +53,57 @@ StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percenta
     _pk_index_page_cache = std::make_unique<PKIndexPageCache>(pk_index_cache_capacity, num_shards);
 }
 
+StoragePageCache::~StoragePageCache() {
+    // pages freed by the destruction of the page caches are not written to disk
+    if (_disk_cache) {
+        _disk_cache->stop();
+    }
+}
+
+void StoragePageCache::set_disk_cache(std::unique_ptr<PageDiskCache> disk_cache) {
+    _disk_cache = std::move(disk_cache);
+}
+
 bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle,
                               segment_v2::PageTypePB page_type) {
     auto cache = _get_page_cache(page_type);
-    auto lru_handle = cache->lookup(key.encode());
+    std::string encoded_key = key.encode();
+    auto lru_handle = cache->lookup(encoded_key);
     if (lru_handle == nullptr) {
-        return false;
+        std::unique_ptr<DataPage> page;
+        if (_disk_cache == nullptr || !_disk_cache->lookup(encoded_key, &page)) {
+            return false;
+        }
+        insert(key, page.release(), handle, page_type);
+        return true;
     }
     *handle = PageCacheHandle(cache, lru_handle);
     handle->update_last_visit_time();
     return true;
 }
 
+bool StoragePageCache::contains(const CacheKey& key, segment_v2::PageTypePB page_type) {
+    std::string encoded_key = key.encode();
+    return _get_page_cache(page_type)->exists(encoded_key) ||
+           (_disk_cache != nullptr && _disk_cache->contains(encoded_key));
+}
+
 void StoragePageCache::insert(const CacheKey& key, DataPage* data, PageCacheHandle* handle,
                               segment_v2::PageTypePB page_type, bool in_memory) {
     auto deleter = [](const doris::CacheKey& key, void* value) {
         DataPage* cache_value = (DataPage*)value;
         delete cache_value;
     };
+    // hand the evicted page over to the disk cache instead of freeing it
+    auto disk_cache_deleter = [](const doris::CacheKey& key, void* value) {
+        DataPage* cache_value = (DataPage*)value;
+        PageDiskCache* disk_cache = PageDiskCache::instance();
+        if (disk_cache != nullptr) {
+            disk_cache->insert(key.to_string(), cache_value);
+        } else {
+            delete cache_value;
+        }
+    };
 
     CachePriority priority = CachePriority::NORMAL;
     if (in_memory) {
@@ -77,7 +111,8 @@ void StoragePageCache::insert(const CacheKey& key, DataPage* data, PageCacheHand
     }
 
     auto cache = _get_page_cache(page_type);
-    auto lru_handle = cache->insert(key.encode(), data, data->capacity(), deleter, priority);
+    auto lru_handle = cache->insert(key.encode(), data, data->capacity(),
+                                    _disk_cache ? disk_cache_deleter : deleter, priority);
     *handle = PageCacheHandle(cache, lru_handle);
     handle->update_last_visit_time();
 }
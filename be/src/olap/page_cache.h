@@ -35,6 +35,7 @@
 namespace doris {
 
 class PageCacheHandle;
+class PageDiskCache;
 
 template <typename TAllocator>
 class PageBase : private TAllocator, public LRUCacheValueBase {
@@ -105,7 +106,9 @@ public:
         DataPageCache(size_t capacity, uint32_t num_shards)
                 : LRUCachePolicy(CachePolicy::CacheType::DATA_PAGE_CACHE, capacity,
                                  LRUCacheType::SIZE, config::data_page_cache_stale_sweep_time_sec,
-                                 num_shards) {}
+                                 num_shards, DEFAULT_LRU_CACHE_ELEMENT_COUNT_CAPACITY, true,
+                                 cache_eviction_policy_from_string(
+                                         config::data_page_cache_eviction_policy)) {}
     };
 
     class IndexPageCache : public LRUCachePolicy {
@@ -113,7 +116,9 @@ public:
         IndexPageCache(size_t capacity, uint32_t num_shards)
                 : LRUCachePolicy(CachePolicy::CacheType::INDEXPAGE_CACHE, capacity,
                                  LRUCacheType::SIZE, config::index_page_cache_stale_sweep_time_sec,
-                                 num_shards) {}
+                                 num_shards, DEFAULT_LRU_CACHE_ELEMENT_COUNT_CAPACITY, true,
+                                 cache_eviction_policy_from_string(
+                                         config::index_page_cache_eviction_policy)) {}
     };
 
     class PKIndexPageCache : public LRUCachePolicy {
@@ -121,7 +126,10 @@ public:
         PKIndexPageCache(size_t capacity, uint32_t num_shards)
                 : LRUCachePolicy(CachePolicy::CacheType::PK_INDEX_PAGE_CACHE, capacity,
                                  LRUCacheType::SIZE,
-                                 config::pk_index_page_cache_stale_sweep_time_sec, num_shards) {}
+                                 config::pk_index_page_cache_stale_sweep_time_sec, num_shards,
+                                 DEFAULT_LRU_CACHE_ELEMENT_COUNT_CAPACITY, true,
+                                 cache_eviction_policy_from_string(
+                                         config::pk_index_page_cache_eviction_policy)) {}
     };
 
     static constexpr uint32_t kDefaultNumShards = 16;
@@ -138,6 +146,12 @@ public:
     StoragePageCache(size_t capacity, int32_t index_cache_percentage,
                      int64_t pk_index_cache_capacity, uint32_t num_shards);
 
+    ~StoragePageCache();
+
+    // Use `disk_cache` as the second tier of this cache: evicted pages are written to it and
+    // pages missing in memory are looked up in it before they are read from the segment file.
+    void set_disk_cache(std::unique_ptr<PageDiskCache> disk_cache);
+
     // Lookup the given page in the cache.
     //
     // If the page is found, the cache entry will be written into handle.
@@ -149,6 +163,11 @@ public:
     // Return true if entry is found, otherwise return false.
     bool lookup(const CacheKey& key, PageCacheHandle* handle, segment_v2::PageTypePB page_type);
 
+    // Return whether the given page is in the cache or in its disk cache. It is not counted as
+    // a lookup and does not promote the page, so it is used to decide whether a page needs
+    // to be read.
+    bool contains(const CacheKey& key, segment_v2::PageTypePB page_type);
+
     // Insert a page with key into this cache.
     // Given handle will be set to valid reference.
     // This function is thread-safe, and when two clients insert two same key
@@ -161,6 +180,8 @@ private:
     StoragePageCache();
 
     int32_t _index_cache_percentage = 0;
+    // Declared before the page caches, so it is destroyed after them.
+    std::unique_ptr<PageDiskCache> _disk_cache;
     std::unique_ptr<DataPageCache> _data_page_cache;
     std::unique_ptr<IndexPageCache> _index_page_cache;
     // Cache data for primary key index data page, seperated from data
@@ -0,0 +1,332 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/page_disk_cache.h"
+
+// IWYU pragma: no_include <bthread/errno.h>
+#include <errno.h> // IWYU pragma: keep
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <glog/logging.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "gutil/macros.h"
+#include "io/fs/err_utils.h"
+#include "io/fs/local_file_system.h"
+#include "util/crc32c.h"
+#include "util/thread.h"
+
+namespace doris {
+
+std::atomic<PageDiskCache*> PageDiskCache::_s_instance = nullptr;
+
+PageDiskCache::PageDiskCache(std::string path, int64_t capacity, int64_t slab_size,
+                             int64_t write_queue_bytes)
+        : _path(std::move(path)),
+          _capacity(capacity),
+          // locations are 32 bits offsets
+          _slab_size(std::clamp<int64_t>(slab_size, 1L << 20, 1L << 31)),
+          _write_queue_bytes(write_queue_bytes) {}
+
+PageDiskCache::~PageDiskCache() {
+    stop();
+    for (auto& slab : _slabs) {
+        if (slab.fd >= 0) {
+            ::close(slab.fd);
+        }
+    }
+}
+
+std::string PageDiskCache::_slab_path(size_t slab) const {
+    return fmt::format("{}/slab_{}", _path, slab);
+}
+
+Status PageDiskCache::init() {
+    RETURN_IF_ERROR(io::global_local_filesystem()->create_directory(_path));
+    // at least two slabs, so recycling one never drops everything
+    size_t num_slabs = std::max<int64_t>(2, _capacity / _slab_size);
+    _slabs.resize(num_slabs);
+    for (size_t slab = 0; slab < num_slabs; ++slab) {
+        RETURN_IF_ERROR(_open_slab(slab));
+        RETURN_IF_ERROR(_recover_slab(slab));
+    }
+
+    bool found_active = false;
+    for (size_t slab = 0; slab < num_slabs; ++slab) {
+        if (_slabs[slab].sequence > _max_sequence) {
+            _max_sequence = _slabs[slab].sequence;
+            _active_slab = slab;
+            found_active = true;
+        }
+    }
+    if (!found_active) {
+        // a new cache, _start_next_slab() starts appending to slab 0
+        _active_slab = num_slabs - 1;
+        RETURN_IF_ERROR(_start_next_slab());
+    }
+    LOG(INFO) << "page disk cache " << _path << " started with " << num_slabs << " slabs of "
+              << _slab_size << " bytes, recovered " << _index.size() << " pages";
+
+    RETURN_IF_ERROR(Thread::create(
+            "PageDiskCache", "page_disk_cache_writer", [this]() { this->_writer_thread(); },
+            &_writer));
+    _s_instance.store(this, std::memory_order_release);
+    return Status::OK();
+}
+
+void PageDiskCache::stop() {
+    PageDiskCache* expected = this;
+    _s_instance.compare_exchange_strong(expected, nullptr);
+    {
+        std::lock_guard l(_queue_lock);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+        _queue.clear();
+        _queue_bytes = 0;
+    }
+    _queue_cv.notify_all();
+    _queue_empty_cv.notify_all();
+    if (_writer) {
+        _writer->join();
+    }
+}
+
+Status PageDiskCache::_open_slab(size_t slab) {
+    std::string path = _slab_path(slab);
+    int fd = -1;
+    RETRY_ON_EINTR(fd, ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+    if (fd < 0) {
+        return io::localfs_error(errno, fmt::format("failed to open {}", path));
+    }
+    _slabs[slab].fd = fd;
+    return Status::OK();
+}
+
+Status PageDiskCache::_recover_slab(size_t slab_id) {
+    Slab& slab = _slabs[slab_id];
+    SlabHeader slab_header;
+    ssize_t res = -1;
+    RETRY_ON_EINTR(res, ::pread(slab.fd, &slab_header, sizeof(slab_header), 0));
+    if (res != sizeof(slab_header) || slab_header.magic != SLAB_MAGIC ||
+        slab_header.version != SLAB_VERSION) {
+        // a free slab
+        return Status::OK();
+    }
+    slab.sequence = slab_header.sequence;
+    slab.end = sizeof(SlabHeader);
+
+    std::string key;
+    while (slab.end + sizeof(RecordHeader) <= _slab_size) {
+        RecordHeader header;
+        RETRY_ON_EINTR(res, ::pread(slab.fd, &header, sizeof(header), slab.end));
+        if (res != sizeof(header) || header.magic != RECORD_MAGIC ||
+            slab.end + sizeof(header) + header.key_size + header.data_size > _slab_size) {
+            break;
+        }
+        key.resize(header.key_size);
+        RETRY_ON_EINTR(res, ::pread(slab.fd, key.data(), key.size(), slab.end + sizeof(header)));
+        if (res != key.size()) {
+            break;
+        }
+        // The data is checked when it is read, the record may be torn if the process crashed
+        // while writing it, in which case the slab continues at the start of it.
+        _index[key] = {.slab = uint32_t(slab_id),
+                       .offset = slab.end,
+                       .data_size = header.data_size};
+        slab.end += sizeof(header) + header.key_size + header.data_size;
+    }
+    return Status::OK();
+}
+
+Status PageDiskCache::_start_next_slab() {
+    size_t next = (_active_slab + 1) % _slabs.size();
+    Slab& slab = _slabs[next];
+    {
+        std::lock_guard l(_index_lock);
+        for (auto it = _index.begin(); it != _index.end();) {
+            if (it->second.slab == next) {
+                it = _index.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    SlabHeader header {.magic = SLAB_MAGIC, .version = SLAB_VERSION, .sequence = ++_max_sequence};
+    ssize_t res = -1;
+    RETRY_ON_EINTR(res, ::pwrite(slab.fd, &header, sizeof(header), 0));
+    if (res != sizeof(header)) {
+        return io::localfs_error(errno, fmt::format("failed to write {}", _slab_path(next)));
+    }
+    RETRY_ON_EINTR(res, ::ftruncate(slab.fd, sizeof(header)));
+    if (res != 0) {
+        return io::localfs_error(errno, fmt::format("failed to truncate {}", _slab_path(next)));
+    }
+    slab.sequence = header.sequence;
+    slab.end = sizeof(header);
+    _active_slab = next;
+    return Status::OK();
+}
+
+Status PageDiskCache::_write(const std::string& key, DataPage* page) {
+    size_t record_size = sizeof(RecordHeader) + key.size() + page->size();
+    if (record_size > _slab_size - sizeof(SlabHeader)) {
+        return Status::OK();
+    }
+    if (_slabs[_active_slab].end + record_size > _slab_size) {
+        RETURN_IF_ERROR(_start_next_slab());
+    }
+    Slab& slab = _slabs[_active_slab];
+
+    RecordHeader header {.magic = RECORD_MAGIC,
+                         .key_size = uint32_t(key.size()),
+                         .data_size = uint32_t(page->size()),
+                         .checksum = crc32c::Extend(crc32c::Value(key.data(), key.size()),
+                                                    page->data(), page->size())};
+    struct iovec iov[3] = {{&header, sizeof(header)},
+                           {const_cast<char*>(key.data()), key.size()},
+                           {page->data(), page->size()}};
+    ssize_t res = -1;
+    RETRY_ON_EINTR(res, ::pwritev(slab.fd, iov, 3, slab.end));
+    if (res != record_size) {
+        // the torn record is overwritten by the next one
+        return io::localfs_error(errno, fmt::format("failed to write {}",
+                                                    _slab_path(_active_slab)));
+    }
+    {
+        std::lock_guard l(_index_lock);
+        _index[key] = {.slab = uint32_t(_active_slab),
+                       .offset = slab.end,
+                       .data_size = header.data_size};
+    }
+    slab.end += record_size;
+    ++_write_count;
+    return Status::OK();
+}
+
+bool PageDiskCache::lookup(const std::string& key, std::unique_ptr<DataPage>* page) {
+    Location location;
+    {
+        std::lock_guard l(_index_lock);
+        auto it = _index.find(key);
+        if (it == _index.end()) {
+            ++_miss_count;
+            return false;
+        }
+        location = it->second;
+    }
+
+    RecordHeader header;
+    std::string record_key(key.size(), '\0');
+    auto data_page = std::make_unique<DataPage>(location.data_size);
+    struct iovec iov[3] = {{&header, sizeof(header)},
+                           {record_key.data(), record_key.size()},
+                           {data_page->data(), location.data_size}};
+    size_t record_size = sizeof(header) + key.size() + location.data_size;
+    ssize_t res = -1;
+    RETRY_ON_EINTR(res, ::preadv(_slabs[location.slab].fd, iov, 3, location.offset));
+    // The slab may have been recycled since the location was looked up.
+    if (res != record_size || header.magic != RECORD_MAGIC || header.key_size != key.size() ||
+        header.data_size != location.data_size || record_key != key ||
+        header.checksum != crc32c::Extend(crc32c::Value(key.data(), key.size()),
+                                          data_page->data(), location.data_size)) {
+        std::lock_guard l(_index_lock);
+        auto it = _index.find(key);
+        if (it != _index.end() && it->second.slab == location.slab &&
+            it->second.offset == location.offset) {
+            _index.erase(it);
+        }
+        ++_miss_count;
+        return false;
+    }
+    ++_hit_count;
+    *page = std::move(data_page);
+    return true;
+}
+
+bool PageDiskCache::contains(const std::string& key) const {
+    std::lock_guard l(_index_lock);
+    return _index.find(key) != _index.end();
+}
+
+void PageDiskCache::insert(const std::string& key, DataPage* page) {
+    std::unique_ptr<DataPage> owned_page(page);
+    {
+        // a page read from this cache and evicted again is still here
+        std::lock_guard l(_index_lock);
+        if (_index.contains(key)) {
+            return;
+        }
+    }
+    {
+        std::lock_guard l(_queue_lock);
+        if (_stopped || _queue_bytes + page->size() > _write_queue_bytes) {
+            ++_dropped_count;
+            return;
+        }
+        _queue_bytes += page->size();
+        _queue.push_back({key, std::move(owned_page)});
+    }
+    _queue_cv.notify_one();
+}
+
+void PageDiskCache::_writer_thread() {
+    while (true) {
+        PendingPage pending;
+        {
+            std::unique_lock l(_queue_lock);
+            _queue_cv.wait(l, [this]() { return _stopped || !_queue.empty(); });
+            if (_stopped) {
+                return;
+            }
+            pending = std::move(_queue.front());
+            _queue.pop_front();
+            _writing = true;
+        }
+
+        Status st = _write(pending.key, pending.page.get());
+        if (!st.ok()) {
+            LOG_EVERY_N(WARNING, 100) << "failed to write page to disk cache: " << st;
+        }
+
+        {
+            std::lock_guard l(_queue_lock);
+            _queue_bytes -= pending.page->size();
+            _writing = false;
+            if (_queue.empty()) {
+                _queue_empty_cv.notify_all();
+            }
+        }
+    }
+}
+
+void PageDiskCache::wait_for_writes() {
+    std::unique_lock l(_queue_lock);
+    _queue_empty_cv.wait(l, [this]() { return _stopped || (_queue.empty() && !_writing); });
+}
+
+size_t PageDiskCache::num_pages() const {
+    std::lock_guard l(_index_lock);
+    return _index.size();
+}
+
+} // namespace doris
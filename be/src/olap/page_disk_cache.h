@@ -0,0 +1,173 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/ref_counted.h"
+#include "olap/page_cache.h"
+
+namespace doris {
+
+class Thread;
+
+// Second tier of StoragePageCache on a local SSD.
+//
+// Pages evicted from the DRAM page cache are already decompressed (and pre-decoded), so
+// keeping them on a fast local disk saves both the read from the slow storage (HDD or remote)
+// and the decompression of the next access.
+//
+// The pages are appended to a ring of `capacity / slab_size` slab files. When the ring wraps
+// around, the oldest slab is recycled as a whole and its pages are dropped from the index,
+// so the disk space is reclaimed without any compaction (FIFO eviction at slab granularity).
+//
+// Slab file layout:
+//     SlabHeader, Record, Record, ...
+// Record:
+//     RecordHeader, key (the encoded StoragePageCache::CacheKey), page data
+// The index from key to record lives in memory and is rebuilt from the slab files on start.
+// Records are checked by a crc on every read, so a torn write or a slab recycled while the
+// record was read is a miss instead of a wrong page.
+//
+// Pages are written by a background thread. insert() only queues the page and drops it if
+// more than `write_queue_bytes` are pending, so the eviction path never waits for the disk.
+class PageDiskCache {
+public:
+    PageDiskCache(std::string path, int64_t capacity, int64_t slab_size,
+                  int64_t write_queue_bytes);
+    ~PageDiskCache();
+
+    // Open or create the slab files under the cache path, rebuild the index and start the
+    // writer thread.
+    Status init();
+
+    // Stop the writer thread. Pending pages are dropped and later inserts free their page.
+    void stop();
+
+    // Read the page of `key` into `page`. Return false if the page is not in the cache.
+    bool lookup(const std::string& key, std::unique_ptr<DataPage>* page);
+
+    // Return whether the page of `key` is in the cache, without reading it or counting a hit.
+    bool contains(const std::string& key) const;
+
+    // Queue `page` to be written with `key`, taking the ownership of the page.
+    void insert(const std::string& key, DataPage* page);
+
+    // Return the started disk cache, nullptr if there is none. The DRAM page cache uses it
+    // to hand over the pages it evicts.
+    static PageDiskCache* instance() { return _s_instance.load(std::memory_order_acquire); }
+
+    int64_t hit_count() const { return _hit_count; }
+    int64_t miss_count() const { return _miss_count; }
+    int64_t write_count() const { return _write_count; }
+    int64_t dropped_count() const { return _dropped_count; }
+    size_t num_pages() const;
+
+    // Block until the write queue is empty, for tests.
+    void wait_for_writes();
+
+private:
+    struct SlabHeader {
+        uint32_t magic;
+        uint32_t version;
+        // Increased every time a slab is (re)started, the slab with the largest sequence is
+        // the one being appended to.
+        uint64_t sequence;
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t key_size;
+        uint32_t data_size;
+        // crc32c of key and data
+        uint32_t checksum;
+    };
+
+    struct Location {
+        uint32_t slab;
+        uint32_t offset;
+        uint32_t data_size;
+    };
+
+    struct Slab {
+        int fd = -1;
+        uint64_t sequence = 0;
+        // end of the last record
+        uint32_t end = 0;
+    };
+
+    struct PendingPage {
+        std::string key;
+        std::unique_ptr<DataPage> page;
+    };
+
+    static constexpr uint32_t SLAB_MAGIC = 0x53434450;   // "PDCS"
+    static constexpr uint32_t RECORD_MAGIC = 0x52434450; // "PDCR"
+    static constexpr uint32_t SLAB_VERSION = 1;
+
+    std::string _slab_path(size_t slab) const;
+    Status _open_slab(size_t slab);
+    // Add the records of a slab to the index, stopping at the first invalid one.
+    Status _recover_slab(size_t slab);
+    Status _write(const std::string& key, DataPage* page);
+    // Move the appending to the next slab of the ring, dropping the pages it held.
+    Status _start_next_slab();
+    void _writer_thread();
+
+    const std::string _path;
+    const int64_t _capacity;
+    const int64_t _slab_size;
+    const int64_t _write_queue_bytes;
+
+    std::vector<Slab> _slabs;
+    // Only used by the writer thread (and init()).
+    size_t _active_slab = 0;
+    uint64_t _max_sequence = 0;
+
+    mutable std::mutex _index_lock;
+    std::unordered_map<std::string, Location> _index;
+
+    std::mutex _queue_lock;
+    std::condition_variable _queue_cv;
+    std::condition_variable _queue_empty_cv;
+    std::deque<PendingPage> _queue;
+    int64_t _queue_bytes = 0;
+    bool _writing = false;
+    bool _stopped = false;
+    scoped_refptr<Thread> _writer;
+
+    std::atomic<int64_t> _hit_count = 0;
+    std::atomic<int64_t> _miss_count = 0;
+    std::atomic<int64_t> _write_count = 0;
+    std::atomic<int64_t> _dropped_count = 0;
+
+    static std::atomic<PageDiskCache*> _s_instance;
+};
+
+} // namespace doris
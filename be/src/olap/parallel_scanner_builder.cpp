@@ -17,7 +17,10 @@
 
 #include "parallel_scanner_builder.h"
 
+#include "common/config.h"
+#include "exec/olap_utils.h"
 #include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/segment_meta_pruner.h"
 #include "pipeline/exec/olap_scan_operator.h"
 #include "vec/exec/scan/new_olap_scanner.h"
 
@@ -67,12 +70,28 @@ Status ParallelScannerBuilder<ParentType>::_build_scanners_by_rowid(
                 continue;
             }
 
+            // only the segments which may match the key ranges were loaded, the segments of a
+            // split are contiguous, so a pruned segment ends the split
             const auto& segments = segment_cache_handle.get_segments();
-            int segment_start = 0;
             auto split = RowSetSplits(reader->clone());
+            auto add_row_ranges = [&split](uint32_t segment_id, RowRanges&& row_ranges) {
+                if (split.segment_row_ranges.empty()) {
+                    split.segment_offsets.first = segment_id;
+                }
+                DCHECK_EQ(split.segment_offsets.first + split.segment_row_ranges.size(),
+                          segment_id);
+                split.segment_offsets.second = segment_id + 1;
+                split.segment_row_ranges.emplace_back(std::move(row_ranges));
+            };
+
+            for (const auto& segment : segments) {
+                const uint32_t segment_id = segment->id();
+                if (!split.segment_row_ranges.empty() &&
+                    split.segment_offsets.second != segment_id) {
+                    read_source.rs_splits.emplace_back(std::move(split));
+                    split = RowSetSplits(reader->clone());
+                }
 
-            for (size_t i = 0; i != segments.size(); ++i) {
-                const auto& segment = segments[i];
                 RowRanges row_ranges;
                 const size_t rows_of_segment = segment->num_rows();
                 int64_t offset_in_segment = 0;
@@ -96,13 +115,7 @@ Status ParallelScannerBuilder<ParentType>::_build_scanners_by_rowid(
 
                     // If collected enough rows, build a new scanner
                     if (rows_collected >= _rows_per_scanner) {
-                        split.segment_offsets.first = segment_start,
-                        split.segment_offsets.second = i + 1;
-                        split.segment_row_ranges.emplace_back(std::move(row_ranges));
-
-                        DCHECK_EQ(split.segment_offsets.second - split.segment_offsets.first,
-                                  split.segment_row_ranges.size());
-
+                        add_row_ranges(segment_id, std::move(row_ranges));
                         read_source.rs_splits.emplace_back(std::move(split));
 
                         scanners.emplace_back(
@@ -113,8 +126,6 @@ Status ParallelScannerBuilder<ParentType>::_build_scanners_by_rowid(
                         read_source = TabletReader::ReadSource();
                         split = RowSetSplits(reader->clone());
                         row_ranges = RowRanges();
-
-                        segment_start = offset_in_segment < rows_of_segment ? i : i + 1;
                         rows_collected = 0;
                     }
                 }
@@ -123,14 +134,12 @@ Status ParallelScannerBuilder<ParentType>::_build_scanners_by_rowid(
                 if (!row_ranges.is_empty()) {
                     DCHECK_GT(rows_collected, 0);
                     DCHECK_EQ(row_ranges.to(), segment->num_rows());
-                    split.segment_row_ranges.emplace_back(std::move(row_ranges));
+                    add_row_ranges(segment_id, std::move(row_ranges));
                 }
             }
 
             DCHECK_LE(rows_collected, _rows_per_scanner);
-            if (rows_collected > 0) {
-                split.segment_offsets.first = segment_start;
-                split.segment_offsets.second = segments.size();
+            if (!split.segment_row_ranges.empty()) {
                 DCHECK_GT(split.segment_offsets.second, split.segment_offsets.first);
                 DCHECK_EQ(split.segment_row_ranges.size(),
                           split.segment_offsets.second - split.segment_offsets.first);
@@ -160,7 +169,8 @@ Status ParallelScannerBuilder<ParentType>::_build_scanners_by_rowid(
 }
 
 /**
- * Load rowsets of each tablet with specified version, segments of each rowset.
+ * Load rowsets of each tablet with specified version, and the segments of each rowset which may
+ * match the key ranges according to the rowset meta.
  */
 template <typename ParentType>
 Status ParallelScannerBuilder<ParentType>::_load() {
@@ -173,14 +183,30 @@ Status ParallelScannerBuilder<ParentType>::_load() {
             RETURN_IF_ERROR(tablet->capture_consistent_rowsets_unlocked({0, version}, &rowsets));
         }
 
+        std::vector<RowCursor> lower_keys;
+        std::vector<RowCursor> upper_keys;
+        StorageReadOptions read_options;
+        RETURN_IF_ERROR(_init_key_ranges(tablet->tablet_schema(), &lower_keys, &upper_keys,
+                                         &read_options));
+
         for (auto& rowset : rowsets) {
             RETURN_IF_ERROR(rowset->load());
             const auto rowset_id = rowset->rowset_id();
             auto& segment_cache_handle = _segment_cache_handles[rowset_id];
 
+            std::vector<uint32_t> segment_ids;
+            SegmentMetaPruner pruner(rowset->rowset_meta(), read_options);
+            for (uint32_t i = 0; i < rowset->num_segments(); ++i) {
+                if (!config::enable_segment_pruning_by_rowset_meta || pruner.may_match(i)) {
+                    segment_ids.push_back(i);
+                }
+            }
             RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(
-                    std::dynamic_pointer_cast<BetaRowset>(rowset), &segment_cache_handle, true));
-            _total_rows += rowset->num_rows();
+                    std::dynamic_pointer_cast<BetaRowset>(rowset), segment_ids,
+                    &segment_cache_handle, true));
+            for (const auto& segment : segment_cache_handle.get_segments()) {
+                _total_rows += segment->num_rows();
+            }
         }
     }
 
@@ -190,6 +216,42 @@ Status ParallelScannerBuilder<ParentType>::_load() {
     return Status::OK();
 }
 
+// The same key ranges as NewOlapScanner passes to TabletReader::_init_keys_param().
+template <typename ParentType>
+Status ParallelScannerBuilder<ParentType>::_init_key_ranges(const TabletSchemaSPtr& tablet_schema,
+                                                            std::vector<RowCursor>* lower_keys,
+                                                            std::vector<RowCursor>* upper_keys,
+                                                            StorageReadOptions* read_options) {
+    read_options->tablet_schema = tablet_schema;
+    std::vector<OlapScanRange*> key_ranges;
+    for (auto* key_range : _key_ranges) {
+        if (key_range->begin_scan_range.size() == 1 &&
+            key_range->begin_scan_range.get_value(0) == NEGATIVE_INFINITY) {
+            continue;
+        }
+        if (key_range->begin_scan_range.size() > tablet_schema->num_key_columns() ||
+            key_range->end_scan_range.size() != key_range->begin_scan_range.size()) {
+            // the scanner fails on such a range, do not prune by it
+            return Status::OK();
+        }
+        key_ranges.push_back(key_range);
+    }
+
+    std::vector<RowCursor>(key_ranges.size()).swap(*lower_keys);
+    std::vector<RowCursor>(key_ranges.size()).swap(*upper_keys);
+    for (size_t i = 0; i < key_ranges.size(); ++i) {
+        const auto& begin = key_ranges[i]->begin_scan_range;
+        const auto& end = key_ranges[i]->end_scan_range;
+        RETURN_IF_ERROR((*lower_keys)[i].init_scan_key(tablet_schema, begin.values()));
+        RETURN_IF_ERROR((*lower_keys)[i].from_tuple(begin));
+        RETURN_IF_ERROR((*upper_keys)[i].init_scan_key(tablet_schema, end.values()));
+        RETURN_IF_ERROR((*upper_keys)[i].from_tuple(end));
+        read_options->key_ranges.emplace_back(&(*lower_keys)[i], key_ranges[i]->begin_include,
+                                              &(*upper_keys)[i], key_ranges[i]->end_include);
+    }
+    return Status::OK();
+}
+
 template <typename ParentType>
 std::shared_ptr<NewOlapScanner> ParallelScannerBuilder<ParentType>::_build_scanner(
         BaseTabletSPtr tablet, int64_t version, const std::vector<OlapScanRange*>& key_ranges,
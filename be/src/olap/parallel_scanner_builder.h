@@ -21,6 +21,8 @@
 #include <string>
 #include <utility>
 
+#include "olap/iterators.h"
+#include "olap/row_cursor.h"
 #include "olap/rowset/segment_v2/row_ranges.h"
 #include "olap/segment_loader.h"
 #include "olap/tablet.h"
@@ -59,6 +61,13 @@ public:
 private:
     Status _load();
 
+    // Init the key ranges the scanners of a tablet read, to open only the segments which may
+    // have rows in them. No range is added if the whole tablet is read.
+    Status _init_key_ranges(const TabletSchemaSPtr& tablet_schema,
+                            std::vector<RowCursor>* lower_keys,
+                            std::vector<RowCursor>* upper_keys,
+                            StorageReadOptions* read_options);
+
     Status _build_scanners_by_rowid(std::list<VScannerSPtr>& scanners);
 
     std::shared_ptr<vectorized::NewOlapScanner> _build_scanner(
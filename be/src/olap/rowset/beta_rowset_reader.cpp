@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <ostream>
 #include <roaring/roaring.hh>
 #include <set>
@@ -28,6 +29,7 @@
 #include <unordered_map>
 #include <utility>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "common/status.h"
 #include "io/io_common.h"
@@ -38,6 +40,7 @@
 #include "olap/row_cursor.h"
 #include "olap/rowset/rowset_meta.h"
 #include "olap/rowset/rowset_reader_context.h"
+#include "olap/rowset/segment_meta_pruner.h"
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/schema.h"
 #include "olap/schema_cache.h"
@@ -221,21 +224,44 @@ Status BetaRowsetReader::get_segment_iterators(RowsetReaderContext* read_context
                 _read_context->runtime_state->query_options().enable_file_cache;
     }
 
-    // load segments
-    bool should_use_cache = use_cache || _read_context->reader_type == ReaderType::READER_QUERY;
-    RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(_rowset, &_segment_cache_handle,
-                                                             should_use_cache));
-
-    // create iterator for each segment
-    auto& segments = _segment_cache_handle.get_segments();
     auto [seg_start, seg_end] = _segment_offsets;
     if (seg_start == seg_end) {
         seg_start = 0;
-        seg_end = segments.size();
+        seg_end = _rowset->num_segments();
     }
 
-    for (int i = seg_start; i < seg_end; i++) {
-        auto& seg_ptr = segments[i];
+    // A query only opens the segments it reads which may match it according to the rowset
+    // meta, other readers load all segments for get_segment_num_rows().
+    std::vector<uint32_t> segment_ids;
+    if (_read_context->reader_type == ReaderType::READER_QUERY &&
+        config::enable_segment_pruning_by_rowset_meta) {
+        SegmentMetaPruner pruner(_rowset->rowset_meta(), _read_options);
+        for (uint32_t i = seg_start; i < seg_end; i++) {
+            if (!pruner.may_match(i)) {
+                _stats->total_segment_number++;
+                _stats->filtered_segment_number++;
+                continue;
+            }
+            segment_ids.push_back(i);
+        }
+    } else {
+        segment_ids.resize(_rowset->num_segments());
+        std::iota(segment_ids.begin(), segment_ids.end(), 0);
+    }
+
+    // load segments
+    bool should_use_cache = use_cache || _read_context->reader_type == ReaderType::READER_QUERY;
+    RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(
+            _rowset, segment_ids, &_segment_cache_handle, should_use_cache));
+
+    // create iterator for each segment
+    auto& segments = _segment_cache_handle.get_segments();
+    for (size_t k = 0; k < segment_ids.size(); k++) {
+        uint32_t i = segment_ids[k];
+        if (i < seg_start || i >= seg_end) {
+            continue;
+        }
+        auto& seg_ptr = segments[k];
         std::unique_ptr<RowwiseIterator> iter;
         Status status;
 
@@ -452,7 +452,13 @@ Status BaseBetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
     _num_segment += rowset->num_segments();
     // append key_bounds to current rowset
     RETURN_IF_ERROR(rowset->get_segments_key_bounds(&_segments_encoded_key_bounds));
-    // TODO update zonemap
+    const auto& zone_maps = rowset->rowset_meta()->get_segments_zone_maps();
+    if (zone_maps.size() == rowset->num_segments()) {
+        _segments_zone_maps.insert(_segments_zone_maps.end(), zone_maps.begin(), zone_maps.end());
+    } else {
+        // segments without zone maps are never pruned
+        _segments_zone_maps.resize(_segments_zone_maps.size() + rowset->num_segments());
+    }
     if (rowset->rowset_meta()->has_delete_predicate()) {
         _rowset_meta->set_delete_predicate(rowset->rowset_meta()->delete_predicate());
     }
@@ -623,6 +629,7 @@ void BaseBetaRowsetWriter::_build_rowset_meta(RowsetMeta* rowset_meta) {
     int64_t total_data_size = 0;
     int64_t total_index_size = 0;
     std::vector<KeyBoundsPB> segments_encoded_key_bounds;
+    std::vector<SegmentZoneMapsPB> segments_zone_maps;
     {
         std::lock_guard<std::mutex> lock(_segid_statistics_map_mutex);
         for (const auto& itr : _segid_statistics_map) {
@@ -630,11 +637,14 @@ void BaseBetaRowsetWriter::_build_rowset_meta(RowsetMeta* rowset_meta) {
             total_data_size += itr.second.data_size;
             total_index_size += itr.second.index_size;
             segments_encoded_key_bounds.push_back(itr.second.key_bounds);
+            segments_zone_maps.push_back(itr.second.zone_maps);
         }
     }
     for (auto& key_bound : _segments_encoded_key_bounds) {
         segments_encoded_key_bounds.push_back(key_bound);
     }
+    segments_zone_maps.insert(segments_zone_maps.end(), _segments_zone_maps.begin(),
+                              _segments_zone_maps.end());
     // segment key bounds are empty in old version(before version 1.2.x). So we should not modify
     // the overlap property when key bounds are empty.
     if (!segments_encoded_key_bounds.empty() &&
@@ -649,7 +659,10 @@ void BaseBetaRowsetWriter::_build_rowset_meta(RowsetMeta* rowset_meta) {
     rowset_meta->set_data_disk_size(total_data_size + _total_data_size);
     rowset_meta->set_index_disk_size(total_index_size + _total_index_size);
     rowset_meta->set_segments_key_bounds(segments_encoded_key_bounds);
-    // TODO write zonemap to meta
+    // the zone maps are looked up by segment id, so they are useless if any segment misses
+    if (segments_zone_maps.size() == _num_seg()) {
+        rowset_meta->set_segments_zone_maps(segments_zone_maps);
+    }
     rowset_meta->set_empty((num_rows_written + _num_rows_written) == 0);
     rowset_meta->set_creation_time(time(nullptr));
 }
@@ -812,6 +825,7 @@ Status BetaRowsetWriter::flush_segment_writer_for_segcompaction(
     segstat.data_size = segment_size + (*writer)->get_inverted_index_file_size();
     segstat.index_size = index_size + (*writer)->get_inverted_index_file_size();
     segstat.key_bounds = key_bounds;
+    (*writer)->get_segment_zone_maps(&segstat.zone_maps);
     {
         std::lock_guard<std::mutex> lock(_segid_statistics_map_mutex);
         CHECK_EQ(_segid_statistics_map.find(segid) == _segid_statistics_map.end(), true);
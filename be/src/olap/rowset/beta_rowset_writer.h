@@ -151,6 +151,9 @@ protected:
     std::vector<io::FileWriterPtr> _file_writers;
     // for unique key table with merge-on-write
     std::vector<KeyBoundsPB> _segments_encoded_key_bounds;
+    // zone maps of the segments written outside of _segid_statistics_map, in the same order as
+    // _segments_encoded_key_bounds
+    std::vector<SegmentZoneMapsPB> _segments_zone_maps;
 
     // counters and statistics maintained during add_rowset
     std::atomic<int64_t> _num_rows_written;
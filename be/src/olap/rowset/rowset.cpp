@@ -81,6 +81,16 @@ bool Rowset::check_rowset_segment() {
 }
 
 void Rowset::merge_rowset_meta(const RowsetMetaSharedPtr& other) {
+    // the zone maps are kept only if both rowsets have them for all their segments
+    std::vector<SegmentZoneMapsPB> zone_maps;
+    if (_rowset_meta->get_segments_zone_maps().size() == num_segments() &&
+        other->get_segments_zone_maps().size() == other->num_segments()) {
+        zone_maps.assign(_rowset_meta->get_segments_zone_maps().begin(),
+                         _rowset_meta->get_segments_zone_maps().end());
+        zone_maps.insert(zone_maps.end(), other->get_segments_zone_maps().begin(),
+                         other->get_segments_zone_maps().end());
+    }
+    _rowset_meta->set_segments_zone_maps(zone_maps);
     _rowset_meta->set_num_segments(num_segments() + other->num_segments());
     _rowset_meta->set_num_rows(num_rows() + other->num_rows());
     _rowset_meta->set_data_disk_size(data_disk_size() + other->data_disk_size());
@@ -299,6 +299,17 @@ public:
         set_segments_overlap(OVERLAPPING);
     }
 
+    // Empty for rowsets written before the zone maps were kept in the rowset meta, otherwise
+    // one entry per segment.
+    const auto& get_segments_zone_maps() const { return _rowset_meta_pb.segments_zone_maps(); }
+
+    void set_segments_zone_maps(const std::vector<SegmentZoneMapsPB>& segments_zone_maps) {
+        _rowset_meta_pb.clear_segments_zone_maps();
+        for (const SegmentZoneMapsPB& zone_maps : segments_zone_maps) {
+            *_rowset_meta_pb.add_segments_zone_maps() = zone_maps;
+        }
+    }
+
     void set_newest_write_timestamp(int64_t timestamp) {
         _rowset_meta_pb.set_newest_write_timestamp(timestamp);
     }
@@ -41,6 +41,7 @@ struct SegmentStatistics {
     int64_t data_size;
     int64_t index_size;
     KeyBoundsPB key_bounds;
+    SegmentZoneMapsPB zone_maps;
 
     SegmentStatistics() = default;
 
@@ -48,13 +49,15 @@ struct SegmentStatistics {
             : row_num(pb.row_num()),
               data_size(pb.data_size()),
               index_size(pb.index_size()),
-              key_bounds(pb.key_bounds()) {}
+              key_bounds(pb.key_bounds()),
+              zone_maps(pb.zone_maps()) {}
 
     void to_pb(SegmentStatisticsPB* segstat_pb) const {
         segstat_pb->set_row_num(row_num);
         segstat_pb->set_data_size(data_size);
         segstat_pb->set_index_size(index_size);
         segstat_pb->mutable_key_bounds()->CopyFrom(key_bounds);
+        segstat_pb->mutable_zone_maps()->CopyFrom(zone_maps);
     }
 
     std::string to_string() {
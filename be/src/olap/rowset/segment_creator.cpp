@@ -354,6 +354,7 @@ Status SegmentFlusher::_flush_segment_writer(
     segstat.data_size = segment_size + writer->inverted_index_file_size();
     segstat.index_size = index_size + writer->inverted_index_file_size();
     segstat.key_bounds = key_bounds;
+    writer->get_segment_zone_maps(&segstat.zone_maps);
 
     writer.reset();
 
@@ -396,6 +397,7 @@ Status SegmentFlusher::_flush_segment_writer(std::unique_ptr<segment_v2::Segment
     segstat.data_size = segment_size + writer->get_inverted_index_file_size();
     segstat.index_size = index_size + writer->get_inverted_index_file_size();
     segstat.key_bounds = key_bounds;
+    writer->get_segment_zone_maps(&segstat.zone_maps);
 
     writer.reset();
 
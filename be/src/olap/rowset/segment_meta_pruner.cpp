@@ -0,0 +1,144 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_meta_pruner.h"
+
+#include <gen_cpp/olap_file.pb.h>
+
+#include <algorithm>
+
+#include "olap/block_column_predicate.h"
+#include "olap/field.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset_meta.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "olap/types.h"
+#include "util/key_util.h"
+
+namespace doris {
+
+SegmentMetaPruner::SegmentMetaPruner(RowsetMetaSharedPtr rowset_meta,
+                                     const StorageReadOptions& read_options)
+        : _rowset_meta(std::move(rowset_meta)), _read_options(read_options) {
+    const TabletSchemaSPtr& tablet_schema = _read_options.tablet_schema;
+    int64_t num_segments = _rowset_meta->num_segments();
+
+    // The key bounds of a segment with cluster keys are not its min/max sort keys.
+    _use_key_bounds = !_read_options.key_ranges.empty() &&
+                      _rowset_meta->get_segments_key_bounds().size() == num_segments &&
+                      tablet_schema->cluster_key_idxes().empty();
+    if (_use_key_bounds) {
+        size_t num_keys = tablet_schema->num_key_columns();
+        for (const auto& key_range : _read_options.key_ranges) {
+            _key_bounds.emplace_back(encode_key_bound(*key_range.lower_key, num_keys, false),
+                                     encode_key_bound(*key_range.upper_key, num_keys, true));
+        }
+    }
+
+    _use_zone_maps = !_read_options.col_id_to_predicates.empty() &&
+                     _rowset_meta->get_segments_zone_maps().size() == num_segments;
+}
+
+std::string SegmentMetaPruner::encode_key_bound(const RowCursor& key, size_t num_keys,
+                                                bool is_upper) {
+    std::string buf;
+    for (size_t cid = 0; cid < num_keys; ++cid) {
+        const Field* field = key.schema()->column(cid);
+        if (field == nullptr) {
+            break;
+        }
+        auto cell = key.cell(cid);
+        if (cell.is_null()) {
+            buf.push_back(KEY_NULL_FIRST_MARKER);
+            continue;
+        }
+        buf.push_back(KEY_NORMAL_MARKER);
+        if (!is_olap_string_type(field->type())) {
+            field->full_encode_ascending(cell.cell_ptr(), &buf);
+            continue;
+        }
+        // Strings are encoded without a terminator, so the keys after a string column are not
+        // ordered by their values anymore, stop at the first one. And a string only orders like
+        // its encoded key up to a byte which may be taken for the marker of the next column.
+        const auto* slice = reinterpret_cast<const Slice*>(cell.cell_ptr());
+        size_t size = slice->size;
+        if (is_upper) {
+            size = std::find_if(slice->data, slice->data + slice->size,
+                                [](char c) { return uint8_t(c) <= KEY_NORMAL_MARKER; }) -
+                   slice->data;
+        }
+        buf.append(slice->data, size);
+        break;
+    }
+    // A prefix is not larger than the keys starting with it, a prefix followed by the maximal
+    // marker is larger than all of them, including those with an encoded sequence column.
+    if (is_upper) {
+        buf.push_back(KEY_MAXIMAL_MARKER);
+    }
+    return buf;
+}
+
+bool SegmentMetaPruner::may_match(uint32_t segment_id) const {
+    if (_use_key_bounds &&
+        !_match_key_bounds(_rowset_meta->get_segments_key_bounds()[segment_id])) {
+        return false;
+    }
+    if (_use_zone_maps && !_match_zone_maps(_rowset_meta->get_segments_zone_maps()[segment_id])) {
+        return false;
+    }
+    return true;
+}
+
+bool SegmentMetaPruner::_match_key_bounds(const KeyBoundsPB& key_bounds) const {
+    for (const auto& [lower, upper] : _key_bounds) {
+        if (key_bounds.max_key() >= lower && key_bounds.min_key() <= upper) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SegmentMetaPruner::_match_zone_maps(const SegmentZoneMapsPB& zone_maps) const {
+    const TabletSchemaSPtr& tablet_schema = _read_options.tablet_schema;
+    for (const auto& [column_id, predicates] : _read_options.col_id_to_predicates) {
+        if (column_id >= tablet_schema->num_columns()) {
+            continue;
+        }
+        const TabletColumn& column = tablet_schema->column(column_id);
+        // predicates on variant columns are not always safe to apply to the stored type
+        if (column.is_variant_type() || column.is_extracted_column()) {
+            continue;
+        }
+        auto it = std::find_if(zone_maps.columns().begin(), zone_maps.columns().end(),
+                               [&](const ColumnZoneMapPB& zone_map) {
+                                   return int32_t(zone_map.unique_id()) == column.unique_id();
+                               });
+        // a column added after the segment was written, or whose type has changed since
+        if (it == zone_maps.columns().end() || FieldType(it->type()) != column.type()) {
+            continue;
+        }
+        if (!segment_v2::ColumnReader::match_zone_map(it->zone_map(), column.type(), it->length(),
+                                                      predicates.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace doris
@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "olap/iterators.h"
+#include "olap/rowset/rowset_fwd.h"
+
+namespace doris {
+
+class KeyBoundsPB;
+class RowCursor;
+class SegmentZoneMapsPB;
+
+// Decides from the rowset meta alone whether a segment may have rows matching the key ranges
+// and the column predicates of a read, so that segments which cannot are never opened.
+//
+// It uses the encoded min/max keys of the segments (segments_key_bounds) and the
+// segment-level zone maps copied from the segment footers (segments_zone_maps). Rowsets
+// written before either was kept in the meta are not pruned by it.
+class SegmentMetaPruner {
+public:
+    SegmentMetaPruner(RowsetMetaSharedPtr rowset_meta, const StorageReadOptions& read_options);
+
+    // Return false if no row of the segment can match the read.
+    bool may_match(uint32_t segment_id) const;
+
+    // Encode `key` to a bound which is not larger (`is_upper` = false) or not smaller
+    // (`is_upper` = true) than the full encoded keys of the rows starting with `key`.
+    // Exposed for tests.
+    static std::string encode_key_bound(const RowCursor& key, size_t num_keys, bool is_upper);
+
+private:
+    bool _match_key_bounds(const KeyBoundsPB& key_bounds) const;
+    bool _match_zone_maps(const SegmentZoneMapsPB& zone_maps) const;
+
+    RowsetMetaSharedPtr _rowset_meta;
+    const StorageReadOptions& _read_options;
+    bool _use_key_bounds = false;
+    bool _use_zone_maps = false;
+    // encoded lower and upper bound of each key range
+    std::vector<std::pair<std::string, std::string>> _key_bounds;
+};
+
+} // namespace doris
@@ -0,0 +1,641 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "olap/column_predicate.h"
+#include "olap/comparison_predicate.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "olap/types.h"
+#include "util/bp128_coding.h"
+#include "util/coding.h"
+#include "util/faststring.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// BITPACK_ENCODING stores integers in blocks of 128 values, every block is bit packed
+// with BP128 (see util/bp128_coding.h) after subtracting the minimum of the block.
+// A page either packs the values themselves (FOR) or the deltas between neighbouring
+// values (DELTA), whichever is smaller; DELTA is meant for sorted data like timestamps
+// and auto increment ids.
+//
+// The bit width of a block is chosen to minimize the block size, and values which do
+// not fit into it are stored as patched exceptions (PFor): the packed lower bits are
+// completed by the higher bits stored after the packed data.
+//
+// Page layout:
+//   Header: num_elements (uint32), mode (uint8), size of value (uint8), 2 reserved bytes
+//   BlockOffsets: one uint32 per block, the offset of the block from the page start
+//   Blocks, each of them:
+//     bit_width (uint8), num_exceptions (uint8)
+//     base: FOR: min value of the block, DELTA: min delta of the block
+//     prev (DELTA only): the value before the first value of the block
+//     packed: BP128 packed lower bit_width bits of (value - base) or (delta - base)
+//     exception positions: uint8 * num_exceptions
+//     exception values: offset >> bit_width for every exception
+// base, prev and exception values have the size of the value type.
+static constexpr size_t BITPACKED_PAGE_HEADER_SIZE = 8;
+
+enum BitPackedMode : uint8_t { BITPACKED_FOR = 0, BITPACKED_DELTA = 1 };
+
+template <typename CppType>
+struct BitPackedTraits {
+    using UnsignedType = std::make_unsigned_t<CppType>;
+    using SignedType = std::make_signed_t<CppType>;
+    using Word = std::conditional_t<sizeof(CppType) <= sizeof(uint32_t), uint32_t, uint64_t>;
+    using Packing = BP128<Word>;
+
+    static constexpr size_t BLOCK_SIZE = Packing::BLOCK_SIZE;
+    static constexpr int VALUE_BITS = sizeof(CppType) * 8;
+
+    static int bits(UnsignedType v) {
+        return v == 0 ? 0 : 64 - __builtin_clzll(static_cast<uint64_t>(v));
+    }
+
+    static UnsignedType low_mask(int bit_width) {
+        return bit_width >= VALUE_BITS ? ~UnsignedType(0)
+                                       : static_cast<UnsignedType>((uint64_t(1) << bit_width) - 1);
+    }
+};
+
+// The type of the comparison predicates which BitPackedPageDecoder evaluates for a column
+// of field type `Type`.
+template <FieldType Type>
+constexpr PrimitiveType bitpacked_predicate_type() {
+    if constexpr (Type == FieldType::OLAP_FIELD_TYPE_TINYINT) {
+        return TYPE_TINYINT;
+    } else if constexpr (Type == FieldType::OLAP_FIELD_TYPE_SMALLINT) {
+        return TYPE_SMALLINT;
+    } else if constexpr (Type == FieldType::OLAP_FIELD_TYPE_INT) {
+        return TYPE_INT;
+    } else if constexpr (Type == FieldType::OLAP_FIELD_TYPE_BIGINT) {
+        return TYPE_BIGINT;
+    } else if constexpr (Type == FieldType::OLAP_FIELD_TYPE_DATEV2) {
+        return TYPE_DATEV2;
+    } else {
+        static_assert(Type == FieldType::OLAP_FIELD_TYPE_DATETIMEV2);
+        return TYPE_DATETIMEV2;
+    }
+}
+
+template <FieldType Type>
+class BitPackedPageBuilder : public PageBuilder {
+public:
+    explicit BitPackedPageBuilder(const PageBuilderOptions& options)
+            : _options(options),
+              _capacity(std::max<size_t>(options.data_page_size / sizeof(CppType), 1)) {
+        reset();
+    }
+
+    bool is_page_full() override { return _values.size() >= _capacity; }
+
+    Status add(const uint8_t* vals, size_t* count) override {
+        DCHECK(!_finished);
+        if (is_page_full()) {
+            *count = 0;
+            return Status::OK();
+        }
+        size_t to_add = std::min(*count, _capacity - _values.size());
+        const auto* new_vals = reinterpret_cast<const CppType*>(vals);
+        _values.insert(_values.end(), new_vals, new_vals + to_add);
+        *count = to_add;
+        return Status::OK();
+    }
+
+    OwnedSlice finish() override {
+        DCHECK(!_finished);
+        _finished = true;
+        _encode();
+        _encoded_size = _buffer.size();
+        return _buffer.build();
+    }
+
+    void reset() override {
+        _values.clear();
+        _values.reserve(_capacity);
+        _buffer.clear();
+        _encoded_size = 0;
+        _finished = false;
+    }
+
+    size_t count() const override { return _values.size(); }
+
+    uint64_t size() const override {
+        return _finished ? _encoded_size : _values.size() * sizeof(CppType);
+    }
+
+    Status get_first_value(void* value) const override {
+        if (_values.empty()) {
+            return Status::Error<ErrorCode::ENTRY_NOT_FOUND>("page is empty");
+        }
+        memcpy(value, &_values.front(), sizeof(CppType));
+        return Status::OK();
+    }
+
+    Status get_last_value(void* value) const override {
+        if (_values.empty()) {
+            return Status::Error<ErrorCode::ENTRY_NOT_FOUND>("page is empty");
+        }
+        memcpy(value, &_values.back(), sizeof(CppType));
+        return Status::OK();
+    }
+
+private:
+    using CppType = typename TypeTraits<Type>::CppType;
+    using Traits = BitPackedTraits<CppType>;
+    using UnsignedType = typename Traits::UnsignedType;
+    using SignedType = typename Traits::SignedType;
+    using Word = typename Traits::Word;
+    static constexpr size_t BLOCK_SIZE = Traits::BLOCK_SIZE;
+
+    // Fill `offsets` with what is packed for the block starting at `begin`, padded by 0.
+    void _compute_offsets(BitPackedMode mode, size_t begin, UnsignedType* offsets,
+                          UnsignedType* base, UnsignedType* prev) const {
+        size_t len = std::min(BLOCK_SIZE, _values.size() - begin);
+        const CppType* values = _values.data() + begin;
+        if (mode == BITPACKED_FOR) {
+            CppType min_value = *std::min_element(values, values + len);
+            for (size_t i = 0; i < len; ++i) {
+                offsets[i] = UnsignedType(values[i]) - UnsignedType(min_value);
+            }
+            *base = UnsignedType(min_value);
+            *prev = 0;
+        } else {
+            *prev = UnsignedType(begin == 0 ? values[0] : values[-1]);
+            UnsignedType last = *prev;
+            SignedType min_delta = std::numeric_limits<SignedType>::max();
+            for (size_t i = 0; i < len; ++i) {
+                offsets[i] = UnsignedType(values[i]) - last;
+                last = UnsignedType(values[i]);
+                min_delta = std::min(min_delta, SignedType(offsets[i]));
+            }
+            for (size_t i = 0; i < len; ++i) {
+                offsets[i] -= UnsignedType(min_delta);
+            }
+            *base = UnsignedType(min_delta);
+        }
+        std::fill(offsets + len, offsets + BLOCK_SIZE, 0);
+    }
+
+    // Choose the bit width which minimizes the size of packed data plus exceptions.
+    static int _choose_bit_width(const UnsignedType* offsets, size_t* size) {
+        size_t histogram[Traits::VALUE_BITS + 1] = {};
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            ++histogram[Traits::bits(offsets[i])];
+        }
+        int bit_width = Traits::VALUE_BITS;
+        while (bit_width > 0 && histogram[bit_width] == 0) {
+            --bit_width;
+        }
+        constexpr size_t exception_size = 1 + sizeof(UnsignedType);
+        size_t best_size = BLOCK_SIZE / 8 * bit_width;
+        int best_width = bit_width;
+        size_t exceptions = 0;
+        for (int width = bit_width - 1; width >= 0; --width) {
+            exceptions += histogram[width + 1];
+            size_t block_size = BLOCK_SIZE / 8 * width + exceptions * exception_size;
+            if (block_size < best_size) {
+                best_size = block_size;
+                best_width = width;
+            }
+        }
+        *size = best_size;
+        return best_width;
+    }
+
+    BitPackedMode _choose_mode() const {
+        UnsignedType offsets[BLOCK_SIZE];
+        UnsignedType base;
+        UnsignedType prev;
+        size_t for_size = 0;
+        size_t delta_size = 0;
+        for (size_t begin = 0; begin < _values.size(); begin += BLOCK_SIZE) {
+            size_t size = 0;
+            _compute_offsets(BITPACKED_FOR, begin, offsets, &base, &prev);
+            _choose_bit_width(offsets, &size);
+            for_size += size;
+            _compute_offsets(BITPACKED_DELTA, begin, offsets, &base, &prev);
+            _choose_bit_width(offsets, &size);
+            delta_size += size + sizeof(UnsignedType);
+        }
+        return delta_size < for_size ? BITPACKED_DELTA : BITPACKED_FOR;
+    }
+
+    void _encode() {
+        size_t num_blocks = (_values.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        BitPackedMode mode = _choose_mode();
+        _buffer.clear();
+        _buffer.resize(BITPACKED_PAGE_HEADER_SIZE + num_blocks * sizeof(uint32_t));
+        encode_fixed32_le(reinterpret_cast<uint8_t*>(&_buffer[0]), _values.size());
+        _buffer[4] = mode;
+        _buffer[5] = sizeof(CppType);
+        _buffer[6] = 0;
+        _buffer[7] = 0;
+
+        UnsignedType offsets[BLOCK_SIZE];
+        Word words[BLOCK_SIZE];
+        Word packed[BLOCK_SIZE];
+        for (size_t block = 0; block < num_blocks; ++block) {
+            size_t offset_pos = BITPACKED_PAGE_HEADER_SIZE + block * sizeof(uint32_t);
+            encode_fixed32_le(reinterpret_cast<uint8_t*>(&_buffer[offset_pos]), _buffer.size());
+            UnsignedType base;
+            UnsignedType prev;
+            _compute_offsets(mode, block * BLOCK_SIZE, offsets, &base, &prev);
+            size_t unused;
+            int bit_width = _choose_bit_width(offsets, &unused);
+            UnsignedType mask = Traits::low_mask(bit_width);
+            uint8_t num_exceptions = 0;
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                words[i] = offsets[i] & mask;
+                num_exceptions += Traits::bits(offsets[i]) > bit_width;
+            }
+
+            _buffer.push_back(static_cast<char>(bit_width));
+            _buffer.push_back(static_cast<char>(num_exceptions));
+            _buffer.append(&base, sizeof(base));
+            if (mode == BITPACKED_DELTA) {
+                _buffer.append(&prev, sizeof(prev));
+            }
+            Traits::Packing::pack(bit_width, words, packed);
+            _buffer.append(packed, Traits::Packing::packed_words(bit_width) * sizeof(Word));
+            if (num_exceptions > 0) {
+                for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                    if (Traits::bits(offsets[i]) > bit_width) {
+                        _buffer.push_back(static_cast<char>(i));
+                    }
+                }
+                for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                    if (Traits::bits(offsets[i]) > bit_width) {
+                        UnsignedType high = offsets[i] >> bit_width;
+                        _buffer.append(&high, sizeof(high));
+                    }
+                }
+            }
+        }
+    }
+
+    PageBuilderOptions _options;
+    size_t _capacity;
+    std::vector<CppType> _values;
+    faststring _buffer;
+    uint64_t _encoded_size = 0;
+    bool _finished = false;
+};
+
+template <FieldType Type>
+class BitPackedPageDecoder : public PageDecoder {
+    using CppType = typename TypeTraits<Type>::CppType;
+    using Traits = BitPackedTraits<CppType>;
+    using UnsignedType = typename Traits::UnsignedType;
+    using Word = typename Traits::Word;
+    static constexpr size_t BLOCK_SIZE = Traits::BLOCK_SIZE;
+
+public:
+    BitPackedPageDecoder(Slice data, const PageDecoderOptions& options) : _data(data) {}
+
+    Status init() override {
+        CHECK(!_parsed);
+        if (_data.size < BITPACKED_PAGE_HEADER_SIZE) {
+            return Status::Corruption("bitpacked page is too small: {}", _data.size);
+        }
+        const auto* header = reinterpret_cast<const uint8_t*>(_data.data);
+        _num_elements = decode_fixed32_le(header);
+        _mode = static_cast<BitPackedMode>(header[4]);
+        if (_mode != BITPACKED_FOR && _mode != BITPACKED_DELTA) {
+            return Status::Corruption("invalid bitpacked page mode {}", header[4]);
+        }
+        if (header[5] != sizeof(CppType)) {
+            return Status::Corruption("invalid value size {} of bitpacked page, expected {}",
+                                      header[5], sizeof(CppType));
+        }
+        _num_blocks = (_num_elements + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (BITPACKED_PAGE_HEADER_SIZE + _num_blocks * sizeof(uint32_t) > _data.size) {
+            return Status::Corruption("bitpacked page is too small for {} values: {}",
+                                      _num_elements, _data.size);
+        }
+        _parsed = true;
+        return Status::OK();
+    }
+
+    Status seek_to_position_in_page(size_t pos) override {
+        DCHECK(_parsed) << "Must call init() firstly";
+        DCHECK_LE(pos, _num_elements);
+        _cur_index = pos;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, vectorized::MutableColumnPtr& dst) override {
+        return next_batch<>(n, dst);
+    }
+
+    template <bool forward_index = true>
+    Status next_batch(size_t* n, vectorized::MutableColumnPtr& dst) {
+        DCHECK(_parsed);
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+        size_t max_fetch = std::min(*n, _num_elements - _cur_index);
+        auto* column = typeid_cast<vectorized::ColumnVector<CppType>*>(dst.get());
+        size_t pos = _cur_index;
+        size_t end = pos + max_fetch;
+        while (pos < end) {
+            size_t block = pos / BLOCK_SIZE;
+            size_t in_block = pos % BLOCK_SIZE;
+            size_t len = std::min(BLOCK_SIZE - in_block, end - pos);
+            if (column != nullptr && len == BLOCK_SIZE) {
+                // whole blocks are decoded straight into the column
+                auto& data = column->get_data();
+                size_t old_size = data.size();
+                data.resize(old_size + BLOCK_SIZE);
+                RETURN_IF_ERROR(
+                        _decode_block(block, reinterpret_cast<UnsignedType*>(&data[old_size])));
+            } else {
+                RETURN_IF_ERROR(_load_block(block));
+                dst->insert_many_fix_len_data(
+                        reinterpret_cast<const char*>(_block_values + in_block), len);
+            }
+            pos += len;
+        }
+        *n = max_fetch;
+        if constexpr (forward_index) {
+            _cur_index = end;
+        }
+        return Status::OK();
+    }
+
+    Status read_by_rowids(const rowid_t* rowids, ordinal_t page_first_ordinal, size_t* n,
+                          vectorized::MutableColumnPtr& dst) override {
+        DCHECK(_parsed);
+        if (PREDICT_FALSE(*n == 0)) {
+            return Status::OK();
+        }
+        std::vector<UnsignedType> values;
+        values.reserve(*n);
+        for (size_t i = 0; i < *n; ++i) {
+            ordinal_t ord = rowids[i] - page_first_ordinal;
+            if (UNLIKELY(ord >= _num_elements)) {
+                break;
+            }
+            RETURN_IF_ERROR(_load_block(ord / BLOCK_SIZE));
+            values.push_back(_block_values[ord % BLOCK_SIZE]);
+        }
+        if (LIKELY(!values.empty())) {
+            dst->insert_many_fix_len_data(reinterpret_cast<const char*>(values.data()),
+                                          values.size());
+        }
+        *n = values.size();
+        return Status::OK();
+    }
+
+    Status peek_next_batch(size_t* n, vectorized::MutableColumnPtr& dst) override {
+        return next_batch<false>(n, dst);
+    }
+
+    // Evaluate `v PT value` for the next *n values and move forward, flags[i] is set to
+    // the result of the i-th value. In FOR pages the values are compared as offsets to
+    // the block base without being decoded, and a block whose range of offsets can not
+    // contain `value` is decided by its header alone.
+    template <PredicateType PT>
+    Status evaluate(const CppType& value, size_t* n, uint8_t* flags) {
+        static_assert(PT == PredicateType::EQ || PT == PredicateType::NE ||
+                      PT == PredicateType::LT || PT == PredicateType::LE ||
+                      PT == PredicateType::GT || PT == PredicateType::GE);
+        DCHECK(_parsed);
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+        size_t max_fetch = std::min(*n, _num_elements - _cur_index);
+        size_t pos = _cur_index;
+        size_t end = pos + max_fetch;
+        while (pos < end) {
+            size_t block = pos / BLOCK_SIZE;
+            size_t in_block = pos % BLOCK_SIZE;
+            size_t len = std::min(BLOCK_SIZE - in_block, end - pos);
+            if (_mode == BITPACKED_FOR) {
+                RETURN_IF_ERROR(_evaluate_for_block<PT>(block, in_block, len, value, flags));
+            } else {
+                RETURN_IF_ERROR(_load_block(block));
+                for (size_t i = 0; i < len; ++i) {
+                    flags[i] = _compare<PT>(CppType(_block_values[in_block + i]), value);
+                }
+            }
+            flags += len;
+            pos += len;
+        }
+        *n = max_fetch;
+        _cur_index = end;
+        return Status::OK();
+    }
+
+    // Evaluate a comparison predicate of the column with evaluate<PT>(), other predicates
+    // are not supported.
+    Status evaluate(const ColumnPredicate& predicate, size_t* n, uint8_t* flags) override {
+        switch (predicate.type()) {
+        case PredicateType::EQ:
+            return _evaluate_predicate<PredicateType::EQ>(predicate, n, flags);
+        case PredicateType::NE:
+            return _evaluate_predicate<PredicateType::NE>(predicate, n, flags);
+        case PredicateType::LT:
+            return _evaluate_predicate<PredicateType::LT>(predicate, n, flags);
+        case PredicateType::LE:
+            return _evaluate_predicate<PredicateType::LE>(predicate, n, flags);
+        case PredicateType::GT:
+            return _evaluate_predicate<PredicateType::GT>(predicate, n, flags);
+        case PredicateType::GE:
+            return _evaluate_predicate<PredicateType::GE>(predicate, n, flags);
+        default:
+            return Status::NotSupported("bitpacked page can not evaluate {}",
+                                        predicate.debug_string());
+        }
+    }
+
+    size_t count() const override { return _num_elements; }
+
+    size_t current_index() const override { return _cur_index; }
+
+private:
+    struct Block {
+        int bit_width;
+        int num_exceptions;
+        UnsignedType base;
+        UnsignedType prev;
+        const uint8_t* packed;
+        const uint8_t* exception_positions;
+        const uint8_t* exception_values;
+    };
+
+    template <PredicateType PT>
+    Status _evaluate_predicate(const ColumnPredicate& predicate, size_t* n, uint8_t* flags) {
+        constexpr PrimitiveType PType = bitpacked_predicate_type<Type>();
+        const auto* comparison =
+                dynamic_cast<const ComparisonPredicateBase<PType, PT>*>(&predicate);
+        if (comparison == nullptr || predicate.opposite()) {
+            return Status::NotSupported("bitpacked page can not evaluate {}",
+                                        predicate.debug_string());
+        }
+        CppType value =
+                CppType(PrimitiveTypeConvertor<PType>::to_storage_field_type(comparison->value()));
+        return evaluate<PT>(value, n, flags);
+    }
+
+    template <PredicateType PT, typename T>
+    static bool _compare(const T& lhs, const T& rhs) {
+        if constexpr (PT == PredicateType::EQ) {
+            return lhs == rhs;
+        } else if constexpr (PT == PredicateType::NE) {
+            return lhs != rhs;
+        } else if constexpr (PT == PredicateType::LT) {
+            return lhs < rhs;
+        } else if constexpr (PT == PredicateType::LE) {
+            return lhs <= rhs;
+        } else if constexpr (PT == PredicateType::GT) {
+            return lhs > rhs;
+        } else {
+            return lhs >= rhs;
+        }
+    }
+
+    Status _parse_block(size_t block, Block* res) const {
+        const auto* page = reinterpret_cast<const uint8_t*>(_data.data);
+        const uint8_t* offsets = page + BITPACKED_PAGE_HEADER_SIZE;
+        size_t begin = decode_fixed32_le(offsets + block * sizeof(uint32_t));
+        size_t end = block + 1 < _num_blocks
+                             ? decode_fixed32_le(offsets + (block + 1) * sizeof(uint32_t))
+                             : _data.size;
+        size_t header_size = 2 + sizeof(UnsignedType) * (_mode == BITPACKED_DELTA ? 2 : 1);
+        if (begin + header_size > end || end > _data.size) {
+            return Status::Corruption("invalid bitpacked block {}: [{}, {})", block, begin, end);
+        }
+        const uint8_t* data = page + begin;
+        res->bit_width = data[0];
+        res->num_exceptions = data[1];
+        memcpy(&res->base, data + 2, sizeof(UnsignedType));
+        res->prev = 0;
+        if (_mode == BITPACKED_DELTA) {
+            memcpy(&res->prev, data + 2 + sizeof(UnsignedType), sizeof(UnsignedType));
+        }
+        if (res->bit_width > Traits::VALUE_BITS) {
+            return Status::Corruption("invalid bit width {} of bitpacked block {}",
+                                      res->bit_width, block);
+        }
+        res->packed = data + header_size;
+        res->exception_positions =
+                res->packed + Traits::Packing::packed_words(res->bit_width) * sizeof(Word);
+        res->exception_values = res->exception_positions + res->num_exceptions;
+        if (res->exception_values + res->num_exceptions * sizeof(UnsignedType) > page + end) {
+            return Status::Corruption("bitpacked block {} is truncated", block);
+        }
+        return Status::OK();
+    }
+
+    // Unpack the offsets of a block and patch the exceptions.
+    static void _unpack_offsets(const Block& block, Word* offsets) {
+        alignas(16) Word packed[BLOCK_SIZE];
+        memcpy(packed, block.packed, Traits::Packing::packed_words(block.bit_width) * sizeof(Word));
+        Traits::Packing::unpack(block.bit_width, packed, offsets);
+        for (int i = 0; i < block.num_exceptions; ++i) {
+            UnsignedType high;
+            memcpy(&high, block.exception_values + i * sizeof(UnsignedType), sizeof(high));
+            offsets[block.exception_positions[i] % BLOCK_SIZE] |= Word(high) << block.bit_width;
+        }
+    }
+
+    // Decode all 128 values of a block, including the padding of the last block.
+    Status _decode_block(size_t block, UnsignedType* values) const {
+        Block header;
+        RETURN_IF_ERROR(_parse_block(block, &header));
+        alignas(16) Word offsets[BLOCK_SIZE];
+        _unpack_offsets(header, offsets);
+        if (_mode == BITPACKED_FOR) {
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                values[i] = UnsignedType(offsets[i]) + header.base;
+            }
+        } else {
+            UnsignedType value = header.prev;
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                value += UnsignedType(offsets[i]) + header.base;
+                values[i] = value;
+            }
+        }
+        return Status::OK();
+    }
+
+    Status _load_block(size_t block) {
+        if (_block_index != block) {
+            RETURN_IF_ERROR(_decode_block(block, _block_values));
+            _block_index = block;
+        }
+        return Status::OK();
+    }
+
+    template <PredicateType PT>
+    Status _evaluate_for_block(size_t block, size_t in_block, size_t len, const CppType& value,
+                               uint8_t* flags) const {
+        Block header;
+        RETURN_IF_ERROR(_parse_block(block, &header));
+        CppType base = CppType(header.base);
+        if (value < base) {
+            // every value of the block is greater than `value`
+            memset(flags, _compare<PT>(1, 0), len);
+            return Status::OK();
+        }
+        Word target = UnsignedType(UnsignedType(value) - header.base);
+        if (header.num_exceptions == 0 && header.bit_width < Traits::VALUE_BITS &&
+            target > Traits::low_mask(header.bit_width)) {
+            // every value of the block is less than `value`
+            memset(flags, _compare<PT>(0, 1), len);
+            return Status::OK();
+        }
+        alignas(16) Word offsets[BLOCK_SIZE];
+        _unpack_offsets(header, offsets);
+        for (size_t i = 0; i < len; ++i) {
+            flags[i] = _compare<PT>(offsets[in_block + i], target);
+        }
+        return Status::OK();
+    }
+
+    Slice _data;
+    bool _parsed = false;
+    BitPackedMode _mode = BITPACKED_FOR;
+    size_t _num_elements = 0;
+    size_t _num_blocks = 0;
+    size_t _cur_index = 0;
+
+    // the decoded block used by partial batches and random reads
+    size_t _block_index = -1;
+    alignas(16) UnsignedType _block_values[BLOCK_SIZE];
+};
+
+} // namespace segment_v2
+} // namespace doris
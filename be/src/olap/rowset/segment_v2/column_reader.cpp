@@ -268,10 +268,9 @@ Status ColumnReader::new_inverted_index_iterator(const TabletIndex* index_meta,
     return Status::OK();
 }
 
-Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
-                               PageHandle* handle, Slice* page_body, PageFooterPB* footer,
-                               BlockCompressionCodec* codec) const {
-    iter_opts.sanity_check();
+PageReadOptions ColumnReader::_page_read_options(const ColumnIteratorOptions& iter_opts,
+                                                const PagePointer& pp,
+                                                BlockCompressionCodec* codec) const {
     PageReadOptions opts {
             .verify_checksum = _opts.verify_checksum,
             .use_page_cache = iter_opts.use_page_cache,
@@ -286,7 +285,53 @@ Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const Pag
     };
     // index page should not pre decode
     if (iter_opts.type == INDEX_PAGE) opts.pre_decode = false;
-    return PageIO::read_and_decompress_page(opts, handle, page_body, footer);
+    return opts;
+}
+
+Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
+                               PageHandle* handle, Slice* page_body, PageFooterPB* footer,
+                               BlockCompressionCodec* codec) const {
+    iter_opts.sanity_check();
+    return PageIO::read_and_decompress_page(_page_read_options(iter_opts, pp, codec), handle,
+                                            page_body, footer);
+}
+
+Status ColumnReader::prefetch_pages(const ColumnIteratorOptions& iter_opts,
+                                    const std::vector<PagePointer>& pages,
+                                    BlockCompressionCodec* codec) const {
+    iter_opts.sanity_check();
+    return PageIO::prefetch_pages(_page_read_options(iter_opts, PagePointer(), codec), pages);
+}
+
+Status ColumnReader::get_uncached_data_pages(const ColumnIteratorOptions& iter_opts,
+                                             const RowRanges& row_ranges,
+                                             std::vector<PagePointer>* pages) {
+    iter_opts.sanity_check();
+    DCHECK_EQ(iter_opts.type, DATA_PAGE);
+    RETURN_IF_ERROR(_load_ordinal_index(_use_index_page_cache, _opts.kept_in_memory));
+    int32_t last_page_index = -1;
+    for (size_t i = 0; i < row_ranges.range_size(); ++i) {
+        auto from = row_ranges.get_range_from(i);
+        auto to = row_ranges.get_range_to(i);
+        auto iter = _ordinal_index->seek_at_or_before(from);
+        // pages are collected in order, skip the ones collected by the previous range
+        for (; iter.valid() && iter.first_ordinal() < to; iter.next()) {
+            if (iter.page_index() <= last_page_index) {
+                continue;
+            }
+            last_page_index = iter.page_index();
+            if (!PageIO::is_page_cached(_page_read_options(iter_opts, iter.page(), nullptr))) {
+                pages->push_back(iter.page());
+            }
+        }
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::cache_raw_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
+                                    Slice raw_page, BlockCompressionCodec* codec) const {
+    iter_opts.sanity_check();
+    return PageIO::cache_raw_page(_page_read_options(iter_opts, pp, codec), raw_page);
 }
 
 Status ColumnReader::get_row_ranges_by_zone_map(
@@ -343,13 +388,19 @@ bool ColumnReader::match_condition(const AndBlockColumnPredicate* col_predicates
     if (_zone_map_index == nullptr) {
         return true;
     }
-    FieldType type = _type_info->type();
-    std::unique_ptr<WrapperField> min_value(WrapperField::create_by_type(type, _meta_length));
-    std::unique_ptr<WrapperField> max_value(WrapperField::create_by_type(type, _meta_length));
-    _parse_zone_map(*_segment_zone_map, min_value.get(), max_value.get());
+    return match_zone_map(*_segment_zone_map, _type_info->type(), _meta_length, col_predicates);
+}
 
-    return _zone_map_match_condition(*_segment_zone_map, min_value.get(), max_value.get(),
-                                     col_predicates);
+bool ColumnReader::match_zone_map(const ZoneMapPB& zone_map, FieldType type, int64_t length,
+                                  const AndBlockColumnPredicate* col_predicates) {
+    std::unique_ptr<WrapperField> min_value(WrapperField::create_by_type(type, length));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create_by_type(type, length));
+    if (min_value == nullptr || max_value == nullptr) {
+        return true;
+    }
+    _parse_zone_map(zone_map, min_value.get(), max_value.get());
+
+    return _zone_map_match_condition(zone_map, min_value.get(), max_value.get(), col_predicates);
 }
 
 bool ColumnReader::prune_predicates_by_zone_map(std::vector<ColumnPredicate*>& predicates,
@@ -378,7 +429,7 @@ bool ColumnReader::prune_predicates_by_zone_map(std::vector<ColumnPredicate*>& p
 }
 
 void ColumnReader::_parse_zone_map(const ZoneMapPB& zone_map, WrapperField* min_value_container,
-                                   WrapperField* max_value_container) const {
+                                   WrapperField* max_value_container) {
     // min value and max value are valid if has_not_null is true
     if (zone_map.has_not_null()) {
         static_cast<void>(min_value_container->from_string(zone_map.min()));
@@ -413,7 +464,7 @@ void ColumnReader::_parse_zone_map_skip_null(const ZoneMapPB& zone_map,
 bool ColumnReader::_zone_map_match_condition(const ZoneMapPB& zone_map,
                                              WrapperField* min_value_container,
                                              WrapperField* max_value_container,
-                                             const AndBlockColumnPredicate* col_predicates) const {
+                                             const AndBlockColumnPredicate* col_predicates) {
     if (!zone_map.has_not_null() && !zone_map.has_null()) {
         return false; // no data in this zone
     }
@@ -995,6 +1046,14 @@ Status ArrayFileColumnIterator::read_by_rowids(const rowid_t* rowids, const size
     return Status::OK();
 }
 
+Status ColumnIterator::evaluate_predicate(const ColumnPredicate& predicate, size_t* n, bool* flags,
+                                          vectorized::MutableColumnPtr& buffer) {
+    buffer->clear();
+    RETURN_IF_ERROR(next_batch(n, buffer));
+    predicate.evaluate_vec(*buffer, *n, flags);
+    return Status::OK();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 FileColumnIterator::FileColumnIterator(ColumnReader* reader) : _reader(reader) {}
@@ -1144,6 +1203,51 @@ Status FileColumnIterator::next_batch(size_t* n, vectorized::MutableColumnPtr& d
     return Status::OK();
 }
 
+bool FileColumnIterator::support_page_evaluation() const {
+    return _reader->encoding_info()->encoding() == BITPACK_ENCODING;
+}
+
+Status FileColumnIterator::evaluate_predicate(const ColumnPredicate& predicate, size_t* n,
+                                              bool* flags, vectorized::MutableColumnPtr& buffer) {
+    size_t remaining = *n;
+    while (remaining > 0) {
+        if (!_page.has_remaining()) {
+            bool eos = false;
+            RETURN_IF_ERROR(_load_next_page(&eos));
+            if (eos) {
+                break;
+            }
+        }
+
+        // number of rows to be evaluated in this page
+        size_t nrows_in_page = std::min(remaining, _page.remaining());
+        size_t nrows_to_read = nrows_in_page;
+        Status st = Status::NotSupported("page has null values");
+        if (!_page.has_null) {
+            st = _page.data_decoder->evaluate(predicate, &nrows_to_read,
+                                              reinterpret_cast<uint8_t*>(flags));
+            if (st.ok()) {
+                DCHECK_EQ(nrows_to_read, nrows_in_page);
+                _page.offset_in_page += nrows_to_read;
+                _current_ordinal += nrows_to_read;
+            } else if (!st.is<ErrorCode::NOT_IMPLEMENTED_ERROR>()) {
+                return st;
+            }
+        }
+        if (!st.ok()) {
+            // the values of this page are decoded and evaluated as usual
+            buffer->clear();
+            RETURN_IF_ERROR(next_batch(&nrows_to_read, buffer));
+            DCHECK_EQ(nrows_to_read, nrows_in_page);
+            predicate.evaluate_vec(*buffer, nrows_to_read, flags);
+        }
+        flags += nrows_in_page;
+        remaining -= nrows_in_page;
+    }
+    *n -= remaining;
+    return Status::OK();
+}
+
 Status FileColumnIterator::read_by_rowids(const rowid_t* rowids, const size_t count,
                                           vectorized::MutableColumnPtr& dst) {
     size_t remaining = count;
@@ -1228,12 +1332,48 @@ Status FileColumnIterator::_load_next_page(bool* eos) {
         return Status::OK();
     }
 
+    RETURN_IF_ERROR(_prefetch_data_pages());
     RETURN_IF_ERROR(_read_data_page(_page_iter));
     _seek_to_pos_in_page(&_page, 0);
     *eos = false;
     return Status::OK();
 }
 
+Status FileColumnIterator::_prefetch_data_pages() {
+    int32_t num_pages = config::segment_page_prefetch_num;
+    if (num_pages <= 1 || !_opts.use_page_cache) {
+        return Status::OK();
+    }
+    int32_t page_index = _page_iter.page_index();
+    if (page_index >= _prefetch_begin && page_index < _prefetch_end) {
+        return Status::OK();
+    }
+    std::vector<PagePointer> pages;
+    pages.reserve(num_pages);
+    for (auto iter = _page_iter; iter.valid() && pages.size() < static_cast<size_t>(num_pages);
+         iter.next()) {
+        pages.push_back(iter.page());
+    }
+    _prefetch_begin = page_index;
+    _prefetch_end = page_index + pages.size();
+    _opts.type = DATA_PAGE;
+    return _reader->prefetch_pages(_opts, pages, _compress_codec);
+}
+
+Status FileColumnIterator::get_uncached_data_pages(const RowRanges& row_ranges,
+                                                   std::vector<PagePointer>* pages) {
+    if (!_opts.use_page_cache) {
+        return Status::OK();
+    }
+    _opts.type = DATA_PAGE;
+    return _reader->get_uncached_data_pages(_opts, row_ranges, pages);
+}
+
+Status FileColumnIterator::cache_raw_page(const PagePointer& pp, Slice raw_page) {
+    _opts.type = DATA_PAGE;
+    return _reader->cache_raw_page(_opts, pp, raw_page, _compress_codec);
+}
+
 Status FileColumnIterator::_read_data_page(const OrdinalPageIndexIterator& iter) {
     PageHandle handle;
     Slice page_body;
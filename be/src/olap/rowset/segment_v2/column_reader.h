@@ -73,6 +73,7 @@ class BitmapIndexReader;
 class InvertedIndexIterator;
 class InvertedIndexReader;
 class PageDecoder;
+struct PageReadOptions;
 class RowRanges;
 class ZoneMapIndexReader;
 
@@ -135,6 +136,19 @@ public:
                      PageHandle* handle, Slice* page_body, PageFooterPB* footer,
                      BlockCompressionCodec* codec) const;
 
+    // read the pages into page cache with one batched request, see PageIO::prefetch_pages
+    Status prefetch_pages(const ColumnIteratorOptions& iter_opts,
+                          const std::vector<PagePointer>& pages,
+                          BlockCompressionCodec* codec) const;
+
+    // collect the data pages which contain rows in `row_ranges' and are not in page cache
+    Status get_uncached_data_pages(const ColumnIteratorOptions& iter_opts,
+                                   const RowRanges& row_ranges, std::vector<PagePointer>* pages);
+
+    // decode the page `pp' read by the caller into page cache, see PageIO::cache_raw_page
+    Status cache_raw_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
+                          Slice raw_page, BlockCompressionCodec* codec) const;
+
     bool is_nullable() const { return _meta_is_nullable; }
 
     const EncodingInfo* encoding_info() const { return _encoding_info; }
@@ -147,6 +161,11 @@ public:
     // Return true if segment zone map is absent or `cond' could be satisfied, false otherwise.
     bool match_condition(const AndBlockColumnPredicate* col_predicates) const;
 
+    // Same as match_condition(), for a segment zone map of a column of `type` and `length`
+    // which is kept outside of the segment.
+    static bool match_zone_map(const ZoneMapPB& zone_map, FieldType type, int64_t length,
+                               const AndBlockColumnPredicate* col_predicates);
+
     Status next_batch_of_zone_map(size_t* n, vectorized::MutableColumnPtr& dst) const;
 
     // get row ranges with zone map
@@ -189,6 +208,9 @@ private:
                  io::FileReaderSPtr file_reader);
     Status init(const ColumnMetaPB* meta);
 
+    PageReadOptions _page_read_options(const ColumnIteratorOptions& iter_opts,
+                                       const PagePointer& pp, BlockCompressionCodec* codec) const;
+
     // Read column inverted indexes into memory
     // May be called multiple times, subsequent calls will no op.
     Status _ensure_inverted_index_loaded(const TabletIndex* index_meta) {
@@ -203,12 +225,13 @@ private:
     [[nodiscard]] Status _load_inverted_index_index(const TabletIndex* index_meta);
     [[nodiscard]] Status _load_bloom_filter_index(bool use_page_cache, bool kept_in_memory);
 
-    bool _zone_map_match_condition(const ZoneMapPB& zone_map, WrapperField* min_value_container,
-                                   WrapperField* max_value_container,
-                                   const AndBlockColumnPredicate* col_predicates) const;
+    static bool _zone_map_match_condition(const ZoneMapPB& zone_map,
+                                          WrapperField* min_value_container,
+                                          WrapperField* max_value_container,
+                                          const AndBlockColumnPredicate* col_predicates);
 
-    void _parse_zone_map(const ZoneMapPB& zone_map, WrapperField* min_value_container,
-                         WrapperField* max_value_container) const;
+    static void _parse_zone_map(const ZoneMapPB& zone_map, WrapperField* min_value_container,
+                                WrapperField* max_value_container);
 
     void _parse_zone_map_skip_null(const ZoneMapPB& zone_map, WrapperField* min_value_container,
                                    WrapperField* max_value_container) const;
@@ -314,6 +337,17 @@ public:
 
     virtual bool is_all_dict_encoding() const { return false; }
 
+    // Whether evaluate_predicate() can evaluate predicates on the encoded values of the pages
+    // of the column, instead of decoding them first.
+    virtual bool support_page_evaluation() const { return false; }
+
+    // Evaluate `predicate` on the next *n rows and move forward like next_batch, flags[i] is
+    // set to the result of the i-th row and null rows never match. Rows which can not be
+    // evaluated in their pages are decoded into `buffer`, a column of the type the predicate
+    // evaluates, and the predicate is evaluated on it.
+    virtual Status evaluate_predicate(const ColumnPredicate& predicate, size_t* n, bool* flags,
+                                      vectorized::MutableColumnPtr& buffer);
+
 protected:
     ColumnIteratorOptions _opts;
 };
@@ -361,9 +395,23 @@ public:
 
     bool is_all_dict_encoding() const override { return _is_all_dict_encoding; }
 
+    bool support_page_evaluation() const override;
+
+    Status evaluate_predicate(const ColumnPredicate& predicate, size_t* n, bool* flags,
+                              vectorized::MutableColumnPtr& buffer) override;
+
+    // data pages which contain rows in `row_ranges' and are not in page cache
+    Status get_uncached_data_pages(const RowRanges& row_ranges, std::vector<PagePointer>* pages);
+
+    // decode the data page `pp' read by the caller into page cache
+    Status cache_raw_page(const PagePointer& pp, Slice raw_page);
+
 private:
     void _seek_to_pos_in_page(ParsedPage* page, ordinal_t offset_in_page) const;
     Status _load_next_page(bool* eos);
+    // read ahead config::segment_page_prefetch_num pages from _page_iter if they
+    // are not prefetched yet
+    Status _prefetch_data_pages();
     Status _read_data_page(const OrdinalPageIndexIterator& iter);
     Status _read_dict_data();
 
@@ -387,6 +435,10 @@ private:
     // This value will be reset when a new seek is issued
     OrdinalPageIndexIterator _page_iter;
 
+    // pages in [_prefetch_begin, _prefetch_end) have been read into page cache
+    int32_t _prefetch_begin = 0;
+    int32_t _prefetch_end = 0;
+
     // current value ordinal
     ordinal_t _current_ordinal = 0;
 
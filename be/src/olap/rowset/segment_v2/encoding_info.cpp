@@ -24,10 +24,12 @@
 #include <unordered_map>
 #include <utility>
 
+#include "common/config.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/binary_dict_page.h"
 #include "olap/rowset/segment_v2/binary_plain_page.h"
 #include "olap/rowset/segment_v2/binary_prefix_page.h"
+#include "olap/rowset/segment_v2/bitpacked_page.h"
 #include "olap/rowset/segment_v2/bitshuffle_page.h"
 #include "olap/rowset/segment_v2/bitshuffle_page_pre_decoder.h"
 #include "olap/rowset/segment_v2/frame_of_reference_page.h"
@@ -171,6 +173,21 @@ struct TypeEncodingTraits<type, FOR_ENCODING, CppType,
     }
 };
 
+template <FieldType type, typename CppType>
+struct TypeEncodingTraits<
+        type, BITPACK_ENCODING, CppType,
+        typename std::enable_if<std::is_integral<CppType>::value && sizeof(CppType) <= 8>::type> {
+    static Status create_page_builder(const PageBuilderOptions& opts, PageBuilder** builder) {
+        *builder = new BitPackedPageBuilder<type>(opts);
+        return Status::OK();
+    }
+    static Status create_page_decoder(const Slice& data, const PageDecoderOptions& opts,
+                                      PageDecoder** decoder) {
+        *decoder = new BitPackedPageDecoder<type>(data, opts);
+        return Status::OK();
+    }
+};
+
 template <FieldType type>
 struct TypeEncodingTraits<type, PREFIX_ENCODING, Slice> {
     static Status create_page_builder(const PageBuilderOptions& opts, PageBuilder** builder) {
@@ -242,18 +259,22 @@ EncodingInfoResolver::EncodingInfoResolver() {
     _add_map<FieldType::OLAP_FIELD_TYPE_TINYINT, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_TINYINT, FOR_ENCODING, true>();
     _add_map<FieldType::OLAP_FIELD_TYPE_TINYINT, PLAIN_ENCODING>();
+    _add_map<FieldType::OLAP_FIELD_TYPE_TINYINT, BITPACK_ENCODING>();
 
     _add_map<FieldType::OLAP_FIELD_TYPE_SMALLINT, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_SMALLINT, FOR_ENCODING, true>();
     _add_map<FieldType::OLAP_FIELD_TYPE_SMALLINT, PLAIN_ENCODING>();
+    _add_map<FieldType::OLAP_FIELD_TYPE_SMALLINT, BITPACK_ENCODING>();
 
     _add_map<FieldType::OLAP_FIELD_TYPE_INT, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_INT, FOR_ENCODING, true>();
     _add_map<FieldType::OLAP_FIELD_TYPE_INT, PLAIN_ENCODING>();
+    _add_map<FieldType::OLAP_FIELD_TYPE_INT, BITPACK_ENCODING>();
 
     _add_map<FieldType::OLAP_FIELD_TYPE_BIGINT, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_BIGINT, FOR_ENCODING, true>();
     _add_map<FieldType::OLAP_FIELD_TYPE_BIGINT, PLAIN_ENCODING>();
+    _add_map<FieldType::OLAP_FIELD_TYPE_BIGINT, BITPACK_ENCODING>();
 
     _add_map<FieldType::OLAP_FIELD_TYPE_UNSIGNED_BIGINT, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_UNSIGNED_INT, BIT_SHUFFLE>();
@@ -300,10 +321,12 @@ EncodingInfoResolver::EncodingInfoResolver() {
     _add_map<FieldType::OLAP_FIELD_TYPE_DATEV2, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_DATEV2, PLAIN_ENCODING>();
     _add_map<FieldType::OLAP_FIELD_TYPE_DATEV2, FOR_ENCODING, true>();
+    _add_map<FieldType::OLAP_FIELD_TYPE_DATEV2, BITPACK_ENCODING>();
 
     _add_map<FieldType::OLAP_FIELD_TYPE_DATETIMEV2, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_DATETIMEV2, PLAIN_ENCODING>();
     _add_map<FieldType::OLAP_FIELD_TYPE_DATETIMEV2, FOR_ENCODING, true>();
+    _add_map<FieldType::OLAP_FIELD_TYPE_DATETIMEV2, BITPACK_ENCODING>();
 
     _add_map<FieldType::OLAP_FIELD_TYPE_DATETIME, BIT_SHUFFLE>();
     _add_map<FieldType::OLAP_FIELD_TYPE_DATETIME, PLAIN_ENCODING>();
@@ -357,6 +380,10 @@ Status EncodingInfoResolver::get(FieldType data_type, EncodingTypePB encoding_ty
                                  const EncodingInfo** out) {
     if (encoding_type == DEFAULT_ENCODING) {
         encoding_type = get_default_encoding(data_type, false);
+        if (config::enable_bitpacked_integer_encoding &&
+            _encoding_map.contains(std::make_pair(data_type, BITPACK_ENCODING))) {
+            encoding_type = BITPACK_ENCODING;
+        }
     }
     auto key = std::make_pair(data_type, encoding_type);
     auto it = _encoding_map.find(key);
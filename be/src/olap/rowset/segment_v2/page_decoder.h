@@ -21,6 +21,8 @@
 #include "vec/columns/column.h"
 
 namespace doris {
+class ColumnPredicate;
+
 namespace segment_v2 {
 
 // PageDecoder is used to decode page.
@@ -85,6 +87,13 @@ public:
         return Status::NotSupported("not implement vec op now");
     }
 
+    // Evaluate `predicate` on the next *n values and move forward like `next_batch`, flags[i]
+    // is set to the result of the i-th value. Decoders which can not evaluate the predicate
+    // on the encoded values return NotSupported without moving forward.
+    virtual Status evaluate(const ColumnPredicate& predicate, size_t* n, uint8_t* flags) {
+        return Status::NotSupported("evaluate is not supported by this page decoder");
+    }
+
     // Return the number of elements in this page.
     virtual size_t count() const = 0;
 
@@ -111,50 +111,13 @@ Status PageIO::write_page(io::FileWriter* writer, const std::vector<Slice>& body
     return Status::OK();
 }
 
-Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle* handle,
-                                        Slice* body, PageFooterPB* footer) {
-    opts.sanity_check();
-    opts.stats->total_pages_num++;
-
-    auto cache = StoragePageCache::instance();
-    PageCacheHandle cache_handle;
-    StoragePageCache::CacheKey cache_key(opts.file_reader->path().native(),
-                                         opts.file_reader->size(), opts.page_pointer.offset);
-    if (opts.use_page_cache && cache && cache->lookup(cache_key, &cache_handle, opts.type)) {
-        // we find page in cache, use it
-        *handle = PageHandle(std::move(cache_handle));
-        opts.stats->cached_pages_num++;
-        // parse body and footer
-        Slice page_slice = handle->data();
-        uint32_t footer_size = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
-        std::string footer_buf(page_slice.data + page_slice.size - 4 - footer_size, footer_size);
-        if (!footer->ParseFromString(footer_buf)) {
-            return Status::Corruption("Bad page: invalid footer, footer_size={}, file={}",
-                                      footer_size, opts.file_reader->path().native());
-        }
-        *body = Slice(page_slice.data, page_slice.size - 4 - footer_size);
-        return Status::OK();
-    }
-
-    // every page contains 4 bytes footer length and 4 bytes checksum
-    const uint32_t page_size = opts.page_pointer.size;
-    if (page_size < 8) {
-        return Status::Corruption("Bad page: too small size ({}), file={}", page_size,
-                                  opts.file_reader->path().native());
-    }
-
-    // hold compressed page at first, reset to decompressed page later
-    std::unique_ptr<DataPage> page = std::make_unique<DataPage>(page_size);
-    Slice page_slice(page->data(), page_size);
-    {
-        SCOPED_RAW_TIMER(&opts.stats->io_ns);
-        size_t bytes_read = 0;
-        RETURN_IF_ERROR(opts.file_reader->read_at(opts.page_pointer.offset, page_slice, &bytes_read,
-                                                  &opts.io_ctx));
-        DCHECK_EQ(bytes_read, page_size);
-        opts.stats->compressed_bytes_read += page_size;
-    }
-
+// Verify, decompress and pre-decode the raw page in `page', whose content is `page_slice'.
+// On success `page' and `page_slice' hold the decoded page without checksum, which is
+//     PageBody(uncompressed), PageFooter, FooterSize(4)
+static Status decode_page(const PageReadOptions& opts, std::unique_ptr<DataPage>* page_ptr,
+                          Slice* page_slice_ptr, PageFooterPB* footer) {
+    std::unique_ptr<DataPage>& page = *page_ptr;
+    Slice& page_slice = *page_slice_ptr;
     if (opts.verify_checksum) {
         uint32_t expect = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
         uint32_t actual = crc32c::Value(page_slice.data, page_slice.size - 4);
@@ -214,6 +177,55 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
                     footer->data_page_footer().nullmap_size() + footer_size + 4));
         }
     }
+    return Status::OK();
+}
+
+Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle* handle,
+                                        Slice* body, PageFooterPB* footer) {
+    opts.sanity_check();
+    opts.stats->total_pages_num++;
+
+    auto cache = StoragePageCache::instance();
+    PageCacheHandle cache_handle;
+    StoragePageCache::CacheKey cache_key(opts.file_reader->path().native(),
+                                         opts.file_reader->size(), opts.page_pointer.offset);
+    if (opts.use_page_cache && cache && cache->lookup(cache_key, &cache_handle, opts.type)) {
+        // we find page in cache, use it
+        *handle = PageHandle(std::move(cache_handle));
+        opts.stats->cached_pages_num++;
+        // parse body and footer
+        Slice page_slice = handle->data();
+        uint32_t footer_size = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
+        std::string footer_buf(page_slice.data + page_slice.size - 4 - footer_size, footer_size);
+        if (!footer->ParseFromString(footer_buf)) {
+            return Status::Corruption("Bad page: invalid footer, footer_size={}, file={}",
+                                      footer_size, opts.file_reader->path().native());
+        }
+        *body = Slice(page_slice.data, page_slice.size - 4 - footer_size);
+        return Status::OK();
+    }
+
+    // every page contains 4 bytes footer length and 4 bytes checksum
+    const uint32_t page_size = opts.page_pointer.size;
+    if (page_size < 8) {
+        return Status::Corruption("Bad page: too small size ({}), file={}", page_size,
+                                  opts.file_reader->path().native());
+    }
+
+    // hold compressed page at first, reset to decompressed page later
+    std::unique_ptr<DataPage> page = std::make_unique<DataPage>(page_size);
+    Slice page_slice(page->data(), page_size);
+    {
+        SCOPED_RAW_TIMER(&opts.stats->io_ns);
+        size_t bytes_read = 0;
+        RETURN_IF_ERROR(opts.file_reader->read_at(opts.page_pointer.offset, page_slice, &bytes_read,
+                                                  &opts.io_ctx));
+        DCHECK_EQ(bytes_read, page_size);
+        opts.stats->compressed_bytes_read += page_size;
+    }
+
+    RETURN_IF_ERROR(decode_page(opts, &page, &page_slice, footer));
+    uint32_t footer_size = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
 
     *body = Slice(page_slice.data, page_slice.size - 4 - footer_size);
     page->reset_size(page_slice.size);
@@ -228,5 +240,100 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
     return Status::OK();
 }
 
+Status PageIO::prefetch_pages(const PageReadOptions& opts, const std::vector<PagePointer>& pages) {
+    opts.sanity_check();
+    auto cache = StoragePageCache::instance();
+    if (!opts.use_page_cache || cache == nullptr) {
+        return Status::OK();
+    }
+
+    std::vector<PagePointer> to_read;
+    std::vector<std::unique_ptr<DataPage>> raw_pages;
+    std::vector<io::FileReadRequest> requests;
+    for (const auto& pp : pages) {
+        if (pp.size < 8) {
+            return Status::Corruption("Bad page: too small size ({}), file={}", pp.size,
+                                      opts.file_reader->path().native());
+        }
+        StoragePageCache::CacheKey cache_key(opts.file_reader->path().native(),
+                                             opts.file_reader->size(), pp.offset);
+        if (cache->contains(cache_key, opts.type)) {
+            continue;
+        }
+        auto& page = raw_pages.emplace_back(std::make_unique<DataPage>(pp.size));
+        requests.push_back({.offset = pp.offset, .result = Slice(page->data(), pp.size)});
+        to_read.push_back(pp);
+    }
+    if (requests.empty()) {
+        return Status::OK();
+    }
+
+    {
+        SCOPED_RAW_TIMER(&opts.stats->io_ns);
+        RETURN_IF_ERROR(opts.file_reader->read_batch_at(&requests, &opts.io_ctx));
+    }
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].bytes_read != to_read[i].size) {
+            return Status::Corruption("Bad page: read {} of {} bytes at offset {}, file={}",
+                                      requests[i].bytes_read, to_read[i].size, to_read[i].offset,
+                                      opts.file_reader->path().native());
+        }
+        opts.stats->compressed_bytes_read += to_read[i].size;
+
+        PageReadOptions page_opts = opts;
+        page_opts.page_pointer = to_read[i];
+        Slice page_slice = requests[i].result;
+        PageFooterPB footer;
+        RETURN_IF_ERROR(decode_page(page_opts, &raw_pages[i], &page_slice, &footer));
+        raw_pages[i]->reset_size(page_slice.size);
+
+        PageCacheHandle cache_handle;
+        StoragePageCache::CacheKey cache_key(opts.file_reader->path().native(),
+                                             opts.file_reader->size(), to_read[i].offset);
+        cache->insert(cache_key, raw_pages[i].get(), &cache_handle, opts.type,
+                      opts.kept_in_memory);
+        raw_pages[i].release(); // memory now managed by cache
+    }
+    opts.stats->prefetched_pages_num += requests.size();
+    return Status::OK();
+}
+
+bool PageIO::is_page_cached(const PageReadOptions& opts) {
+    auto cache = StoragePageCache::instance();
+    if (!opts.use_page_cache || cache == nullptr) {
+        return false;
+    }
+    StoragePageCache::CacheKey cache_key(opts.file_reader->path().native(),
+                                         opts.file_reader->size(), opts.page_pointer.offset);
+    return cache->contains(cache_key, opts.type);
+}
+
+Status PageIO::cache_raw_page(const PageReadOptions& opts, Slice raw_page) {
+    opts.sanity_check();
+    auto cache = StoragePageCache::instance();
+    if (!opts.use_page_cache || cache == nullptr) {
+        return Status::OK();
+    }
+    if (raw_page.size != opts.page_pointer.size || raw_page.size < 8) {
+        return Status::Corruption("Bad page: unexpected size ({} vs {}), file={}", raw_page.size,
+                                  opts.page_pointer.size, opts.file_reader->path().native());
+    }
+    std::unique_ptr<DataPage> page = std::make_unique<DataPage>(raw_page.size);
+    memcpy(page->data(), raw_page.data, raw_page.size);
+    Slice page_slice(page->data(), raw_page.size);
+    opts.stats->compressed_bytes_read += raw_page.size;
+    PageFooterPB footer;
+    RETURN_IF_ERROR(decode_page(opts, &page, &page_slice, &footer));
+    page->reset_size(page_slice.size);
+
+    PageCacheHandle cache_handle;
+    StoragePageCache::CacheKey cache_key(opts.file_reader->path().native(),
+                                         opts.file_reader->size(), opts.page_pointer.offset);
+    cache->insert(cache_key, page.get(), &cache_handle, opts.type, opts.kept_in_memory);
+    page.release(); // memory now managed by cache
+    opts.stats->prefetched_pages_num++;
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
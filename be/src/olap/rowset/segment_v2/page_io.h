@@ -125,6 +125,20 @@ public:
     //     `footer' stores the page footer.
     static Status read_and_decompress_page(const PageReadOptions& opts, PageHandle* handle,
                                            Slice* body, PageFooterPB* footer);
+
+    // Read the pages which are not in page cache with one batched request
+    // (see io::FileReader::read_batch_at) and insert them into page cache, so that
+    // following read_and_decompress_page() of these pages hit the cache.
+    // `opts.page_pointer' is ignored. Do nothing if page cache is not used.
+    static Status prefetch_pages(const PageReadOptions& opts,
+                                 const std::vector<PagePointer>& pages);
+
+    // Return true if the page of `opts.page_pointer' is in page cache.
+    static bool is_page_cached(const PageReadOptions& opts);
+
+    // Decode the page of `opts.page_pointer' from `raw_page', which has been read from
+    // file by the caller, and insert it into page cache. `raw_page' is copied.
+    static Status cache_raw_page(const PageReadOptions& opts, Slice raw_page);
 };
 
 } // namespace segment_v2
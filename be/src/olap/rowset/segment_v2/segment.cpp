@@ -585,7 +585,8 @@ Status Segment::new_inverted_index_iterator(const TabletColumn& tablet_column,
 }
 
 Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, bool with_rowid,
-                               RowLocation* row_location) {
+                               RowLocation* row_location,
+                               std::unique_ptr<IndexedColumnIterator>* index_iterator) {
     RETURN_IF_ERROR(load_pk_index_and_bf());
     bool has_seq_col = _tablet_schema->has_sequence_col();
     bool has_rowid = !_tablet_schema->cluster_key_idxes().empty();
@@ -604,16 +605,21 @@ Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, bool with_ro
         return Status::Error<ErrorCode::KEY_NOT_FOUND>("Can't find key in the segment");
     }
     bool exact_match = false;
-    std::unique_ptr<segment_v2::IndexedColumnIterator> index_iterator;
-    RETURN_IF_ERROR(_pk_index_reader->new_iterator(&index_iterator));
-    auto st = index_iterator->seek_at_or_after(&key_without_seq, &exact_match);
+    std::unique_ptr<segment_v2::IndexedColumnIterator> local_index_iterator;
+    if (index_iterator == nullptr) {
+        index_iterator = &local_index_iterator;
+    }
+    if (*index_iterator == nullptr) {
+        RETURN_IF_ERROR(_pk_index_reader->new_iterator(index_iterator));
+    }
+    auto st = (*index_iterator)->seek_at_or_after(&key_without_seq, &exact_match);
     if (!st.ok() && !st.is<ErrorCode::ENTRY_NOT_FOUND>()) {
         return st;
     }
     if (st.is<ErrorCode::ENTRY_NOT_FOUND>() || (!has_seq_col && !has_rowid && !exact_match)) {
         return Status::Error<ErrorCode::KEY_NOT_FOUND>("Can't find key in the segment");
     }
-    row_location->row_id = index_iterator->get_current_ordinal();
+    row_location->row_id = (*index_iterator)->get_current_ordinal();
     row_location->segment_id = _segment_id;
     row_location->rowset_id = _rowset_id;
 
@@ -622,7 +628,7 @@ Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, bool with_ro
             _pk_index_reader->type_info()->type(), 1, 0);
     auto index_column = index_type->create_column();
     size_t num_read = num_to_read;
-    RETURN_IF_ERROR(index_iterator->next_batch(&num_read, index_column));
+    RETURN_IF_ERROR((*index_iterator)->next_batch(&num_read, index_column));
     DCHECK(num_to_read == num_read);
 
     Slice sought_key = Slice(index_column->get_data_at(0).data, index_column->get_data_at(0).size);
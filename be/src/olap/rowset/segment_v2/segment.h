@@ -66,6 +66,7 @@ namespace segment_v2 {
 class BitmapIndexIterator;
 class Segment;
 class InvertedIndexIterator;
+class IndexedColumnIterator;
 
 using SegmentSharedPtr = std::shared_ptr<Segment>;
 // A Segment is used to represent a segment in memory format. When segment is
@@ -121,8 +122,11 @@ public:
         return _pk_index_reader.get();
     }
 
+    // `index_iterator` keeps the iterator over the primary key index between the lookups, which
+    // stays on the data page of the last key, so looking up ascending keys reads a page only once
     Status lookup_row_key(const Slice& key, bool with_seq_col, bool with_rowid,
-                          RowLocation* row_location);
+                          RowLocation* row_location,
+                          std::unique_ptr<IndexedColumnIterator>* index_iterator = nullptr);
 
     Status read_key_by_rowid(uint32_t row_id, std::string* key);
 
@@ -53,6 +53,7 @@
 #include "olap/rowset/segment_v2/inverted_index_reader.h"
 #include "olap/rowset/segment_v2/row_ranges.h"
 #include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_prefetcher.h"
 #include "olap/schema.h"
 #include "olap/short_key_index.h"
 #include "olap/tablet_schema.h"
@@ -388,9 +389,49 @@ Status SegmentIterator::_lazy_init() {
     } else {
         _range_iter.reset(new BitmapRangeIterator(_row_bitmap));
     }
+
+    if (config::segment_prefetch_window_rows > 0 && _opts.use_page_cache &&
+        !_opts.read_orderby_key_reverse) {
+        _prefetcher = std::make_unique<SegmentPrefetcher>(_file_reader.get(), &_opts.io_ctx,
+                                                          _opts.stats);
+        for (auto cid : _schema->column_ids()) {
+            if (auto* iter = dynamic_cast<FileColumnIterator*>(_column_iterators[cid].get())) {
+                _prefetcher->add_column(iter);
+            }
+        }
+        if (_prefetcher->empty()) {
+            _prefetcher.reset();
+        }
+    }
     return Status::OK();
 }
 
+Status SegmentIterator::_prefetch_column_pages(rowid_t first_rowid) {
+    if (first_rowid < _prefetched_rowid) {
+        return Status::OK();
+    }
+    uint32_t window_rows = config::segment_prefetch_window_rows;
+    rowid_t end_rowid =
+            std::min<uint64_t>(num_rows(), static_cast<uint64_t>(first_rowid) + window_rows);
+    roaring::Roaring window;
+    window.addRange(first_rowid, end_rowid);
+    window &= _row_bitmap;
+
+    RowRanges row_ranges;
+    rowid_t from = 0;
+    rowid_t to = 0;
+    for (rowid_t rowid : window) {
+        if (rowid != to) {
+            row_ranges.add(RowRange(from, to));
+            from = rowid;
+        }
+        to = rowid + 1;
+    }
+    row_ranges.add(RowRange(from, to));
+    _prefetched_rowid = end_rowid;
+    return _prefetcher->prefetch(row_ranges);
+}
+
 Status SegmentIterator::_get_row_ranges_by_keys() {
     DorisMetrics::instance()->segment_row_total->increment(num_rows());
 
@@ -1680,9 +1721,62 @@ Status SegmentIterator::_vec_init_lazy_materialization() {
             }
         }
     }
+
+    // Step 5: predicates evaluated while reading their columns
+    _init_page_evaluation();
     return Status::OK();
 }
 
+void SegmentIterator::_init_page_evaluation() {
+    _is_page_eval_column.resize(_schema->columns().size(), false);
+    // The values of the column are replaced by defaults, so it must not be output, the same
+    // condition as for columns whose predicates are evaluated by inverted index.
+    if (_opts.io_ctx.reader_type != ReaderType::READER_QUERY ||
+        _opts.tablet_schema->keys_type() != KeysType::DUP_KEYS || _output_columns.empty() ||
+        _output_columns.count(-1)) {
+        return;
+    }
+    std::set<ColumnId> del_cond_id_set;
+    _opts.delete_condition_predicates->get_all_column_ids(del_cond_id_set);
+    std::map<ColumnId, int> num_predicates;
+    for (auto* predicate : _col_predicates) {
+        num_predicates[predicate->column_id()]++;
+    }
+    for (auto* predicate : _col_preds_except_leafnode_of_andnode) {
+        num_predicates[predicate->column_id()]++;
+    }
+    auto can_evaluate_in_pages = [&](ColumnPredicate* predicate) {
+        auto cid = predicate->column_id();
+        return num_predicates[cid] == 1 && !predicate->opposite() &&
+               PredicateTypeTraits::is_comparison(predicate->type()) &&
+               !del_cond_id_set.contains(cid) && !_is_common_expr_column[cid] &&
+               _need_read_data(cid) &&
+               !_output_columns.contains(_opts.tablet_schema->column(cid).unique_id()) &&
+               _column_iterators[cid] != nullptr &&
+               _column_iterators[cid]->support_page_evaluation();
+    };
+    for (auto* predicates : {&_pre_eval_block_predicate, &_short_cir_eval_predicate}) {
+        for (auto it = predicates->begin(); it != predicates->end();) {
+            if (can_evaluate_in_pages(*it)) {
+                _is_page_eval_column[(*it)->column_id()] = true;
+                _page_eval_predicates.push_back(*it);
+                it = predicates->erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (_page_eval_predicates.empty()) {
+        return;
+    }
+    // the flags of the page evaluated predicates are applied with the short circuit predicates
+    _is_need_vec_eval = !_pre_eval_block_predicate.empty();
+    _is_need_short_eval = true;
+    _page_eval_flags.reset(new bool[_opts.block_row_max]);
+    _page_eval_tmp_flags.reset(new bool[_opts.block_row_max]);
+    _page_eval_buffers.resize(_page_eval_predicates.size());
+}
+
 bool SegmentIterator::_can_evaluated_by_vectorized(ColumnPredicate* predicate) {
     auto cid = predicate->column_id();
     FieldType field_type = _schema->column(cid)->type();
@@ -1866,11 +1960,20 @@ Status SegmentIterator::_read_columns_by_index(uint32_t nrows_read_limit, uint32
     SCOPED_RAW_TIMER(&_opts.stats->first_read_ns);
 
     nrows_read = _range_iter->read_batch_rowids(_block_rowids.data(), nrows_read_limit);
+    if (_prefetcher && nrows_read > 0) {
+        RETURN_IF_ERROR(_prefetch_column_pages(_block_rowids[0]));
+    }
     bool is_continuous = (nrows_read > 1) &&
                          (_block_rowids[nrows_read - 1] - _block_rowids[0] == nrows_read - 1);
 
+    if (!_page_eval_predicates.empty()) {
+        RETURN_IF_ERROR(_evaluate_page_predicates(nrows_read, is_continuous));
+    }
     for (auto cid : _first_read_column_ids) {
         auto& column = _current_return_columns[cid];
+        if (_is_page_eval_column[cid]) {
+            continue;
+        }
         if (_need_read_key_data(cid, column, nrows_read)) {
             continue;
         }
@@ -1930,6 +2033,51 @@ Status SegmentIterator::_read_columns_by_index(uint32_t nrows_read_limit, uint32
     return Status::OK();
 }
 
+Status SegmentIterator::_evaluate_page_predicates(uint32_t nrows_read, bool is_continuous) {
+    if (nrows_read == 0) {
+        return Status::OK();
+    }
+    for (size_t i = 0; i < _page_eval_predicates.size(); ++i) {
+        auto* predicate = _page_eval_predicates[i];
+        auto cid = predicate->column_id();
+        auto& column = _current_return_columns[cid];
+        auto& buffer = _page_eval_buffers[i];
+        if (buffer == nullptr) {
+            buffer = column->clone_empty();
+        }
+        bool* flags = i == 0 ? _page_eval_flags.get() : _page_eval_tmp_flags.get();
+        if (is_continuous || nrows_read == 1) {
+            size_t rows_read = nrows_read;
+            RETURN_IF_ERROR(_column_iterators[cid]->seek_to_ordinal(_block_rowids[0]));
+            RETURN_IF_ERROR(_column_iterators[cid]->evaluate_predicate(*predicate, &rows_read,
+                                                                       flags, buffer));
+            if (rows_read != nrows_read) {
+                return Status::Error<ErrorCode::INTERNAL_ERROR>("nrows({}) != rows_read({})",
+                                                                nrows_read, rows_read);
+            }
+        } else {
+            buffer->clear();
+            RETURN_IF_ERROR(_column_iterators[cid]->read_by_rowids(_block_rowids.data(),
+                                                                   nrows_read, buffer));
+            predicate->evaluate_vec(*buffer, nrows_read, flags);
+        }
+        if (i > 0) {
+            for (uint32_t j = 0; j < nrows_read; ++j) {
+                _page_eval_flags[j] &= flags[j];
+            }
+        }
+        // the values are not output, only keep the column as long as the others
+        if (column->is_nullable()) {
+            auto* nullable_col_ptr = reinterpret_cast<vectorized::ColumnNullable*>(column.get());
+            nullable_col_ptr->get_null_map_column().insert_many_defaults(nrows_read);
+            nullable_col_ptr->get_nested_column_ptr()->insert_many_defaults(nrows_read);
+        } else {
+            column->insert_many_defaults(nrows_read);
+        }
+    }
+    return Status::OK();
+}
+
 void SegmentIterator::_replace_version_col(size_t num_rows) {
     // Only the rowset with single version need to replace the version column.
     // Doris can't determine the version before publish_version finished, so
@@ -2023,6 +2171,15 @@ uint16_t SegmentIterator::_evaluate_short_circuit_predicate(uint16_t* vec_sel_ro
     }
 
     uint16_t original_size = selected_size;
+    if (!_page_eval_predicates.empty()) {
+        uint16_t new_size = 0;
+        for (uint16_t i = 0; i < selected_size; ++i) {
+            uint16_t idx = vec_sel_rowid_idx[i];
+            vec_sel_rowid_idx[new_size] = idx;
+            new_size += _page_eval_flags[idx];
+        }
+        selected_size = new_size;
+    }
     for (auto predicate : _short_cir_eval_predicate) {
         auto column_id = predicate->column_id();
         auto& short_cir_column = _current_return_columns[column_id];
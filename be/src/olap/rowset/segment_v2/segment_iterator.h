@@ -69,6 +69,7 @@ class BitmapIndexIterator;
 class ColumnIterator;
 class InvertedIndexIterator;
 class RowRanges;
+class SegmentPrefetcher;
 
 struct ColumnPredicateInfo {
     ColumnPredicateInfo() = default;
@@ -128,6 +129,7 @@ public:
         bool updated = false;
         updated |= _update_profile(profile, _short_cir_eval_predicate, "ShortCircuitPredicates");
         updated |= _update_profile(profile, _pre_eval_block_predicate, "PreEvaluatePredicates");
+        updated |= _update_profile(profile, _page_eval_predicates, "PageEvaluatePredicates");
 
         if (_opts.delete_condition_predicates != nullptr) {
             std::set<const ColumnPredicate*> delete_predicate_set;
@@ -202,6 +204,12 @@ private:
     bool _is_literal_node(const TExprNodeType::type& node_type);
 
     Status _vec_init_lazy_materialization();
+    // Move the comparison predicates of columns which are read only to evaluate them to
+    // _page_eval_predicates, if the column iterator can evaluate them on encoded pages.
+    void _init_page_evaluation();
+    // Evaluate _page_eval_predicates on the rows of the current block into _page_eval_flags
+    // and fill their columns with default values.
+    [[nodiscard]] Status _evaluate_page_predicates(uint32_t nrows_read, bool is_continuous);
     // TODO: Fix Me
     // CHAR type in storage layer padding the 0 in length. But query engine need ignore the padding 0.
     // so segment iterator need to shrink char column before output it. only use in vec query engine.
@@ -216,6 +224,9 @@ private:
     // for vectorization implementation
     [[nodiscard]] Status _read_columns(const std::vector<ColumnId>& column_ids,
                                        vectorized::MutableColumns& column_block, size_t nrows);
+    // prefetch data pages of rows in [first_rowid, first_rowid + segment_prefetch_window_rows)
+    // if they are not prefetched yet
+    [[nodiscard]] Status _prefetch_column_pages(rowid_t first_rowid);
     [[nodiscard]] Status _read_columns_by_index(uint32_t nrows_read_limit, uint32_t& nrows_read,
                                                 bool set_block_rowid);
     void _replace_version_col(size_t num_rows);
@@ -398,6 +409,10 @@ private:
     std::unordered_map<std::string, std::pair<bool, roaring::Roaring>> _rowid_result_for_index;
     // an iterator for `_row_bitmap` that can be used to extract row range to scan
     std::unique_ptr<BitmapRangeIterator> _range_iter;
+    // reads data pages of all columns ahead of decoding, null if prefetch is disabled
+    std::unique_ptr<SegmentPrefetcher> _prefetcher;
+    // pages of rows before it have been prefetched
+    rowid_t _prefetched_rowid = 0;
     // the next rowid to read
     rowid_t _cur_rowid;
     // members related to lazy materialization read
@@ -425,6 +440,15 @@ private:
     vectorized::MutableColumns _current_return_columns;
     std::vector<ColumnPredicate*> _pre_eval_block_predicate;
     std::vector<ColumnPredicate*> _short_cir_eval_predicate;
+    // predicates evaluated by the column iterators while the columns are read, the values of
+    // their columns are not needed afterwards, see _init_page_evaluation()
+    std::vector<ColumnPredicate*> _page_eval_predicates;
+    std::vector<bool> _is_page_eval_column;
+    // result of _page_eval_predicates for the rows of the current block
+    std::unique_ptr<bool[]> _page_eval_flags;
+    std::unique_ptr<bool[]> _page_eval_tmp_flags;
+    // decoded values of pages which can not be evaluated without decoding them
+    vectorized::MutableColumns _page_eval_buffers;
     std::vector<uint32_t> _delete_range_column_ids;
     std::vector<uint32_t> _delete_bloom_filter_column_ids;
     // when lazy materialization is enabled, segmentIter need to read data at least twice
@@ -0,0 +1,102 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_prefetcher.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "common/config.h"
+#include "io/fs/file_reader.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/row_ranges.h"
+#include "util/runtime_profile.h"
+
+namespace doris {
+namespace segment_v2 {
+
+std::vector<SegmentPrefetcher::CoalescedRead> SegmentPrefetcher::coalesce(
+        const std::vector<PrefetchPage>& pages, uint64_t max_gap_bytes, uint64_t max_read_bytes) {
+    std::vector<CoalescedRead> reads;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        const PagePointer& pp = pages[i].page_pointer;
+        if (!reads.empty()) {
+            CoalescedRead& last = reads.back();
+            uint64_t last_end = last.offset + last.size;
+            DCHECK_GE(pp.offset, last.offset);
+            if (pp.offset <= last_end + max_gap_bytes &&
+                pp.offset + pp.size - last.offset <= max_read_bytes) {
+                last.size = std::max(last_end, pp.offset + pp.size) - last.offset;
+                last.last_page = i + 1;
+                continue;
+            }
+        }
+        reads.push_back(
+                {.offset = pp.offset, .size = pp.size, .first_page = i, .last_page = i + 1});
+    }
+    return reads;
+}
+
+Status SegmentPrefetcher::prefetch(const RowRanges& row_ranges) {
+    std::vector<PrefetchPage> pages;
+    std::vector<PagePointer> column_pages;
+    for (auto* column_iterator : _column_iterators) {
+        column_pages.clear();
+        RETURN_IF_ERROR(column_iterator->get_uncached_data_pages(row_ranges, &column_pages));
+        for (const auto& pp : column_pages) {
+            pages.push_back({.page_pointer = pp, .column_iterator = column_iterator});
+        }
+    }
+    if (pages.empty()) {
+        return Status::OK();
+    }
+    std::sort(pages.begin(), pages.end(), [](const PrefetchPage& lhs, const PrefetchPage& rhs) {
+        return lhs.page_pointer.offset < rhs.page_pointer.offset;
+    });
+
+    auto reads = coalesce(pages, config::segment_prefetch_max_gap_bytes,
+                          config::segment_prefetch_max_read_bytes);
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<io::FileReadRequest> requests;
+    buffers.reserve(reads.size());
+    requests.reserve(reads.size());
+    for (const auto& read : reads) {
+        auto& buffer = buffers.emplace_back(new char[read.size]);
+        requests.push_back({.offset = read.offset, .result = Slice(buffer.get(), read.size)});
+    }
+    {
+        SCOPED_RAW_TIMER(&_stats->io_ns);
+        RETURN_IF_ERROR(_file_reader->read_batch_at(&requests, _io_ctx));
+    }
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (requests[i].bytes_read != reads[i].size) {
+            return Status::InternalError("short read of {} at {}: {} vs {}",
+                                         _file_reader->path().native(), reads[i].offset,
+                                         requests[i].bytes_read, reads[i].size);
+        }
+        for (size_t p = reads[i].first_page; p < reads[i].last_page; ++p) {
+            const PagePointer& pp = pages[p].page_pointer;
+            Slice raw_page(buffers[i].get() + (pp.offset - reads[i].offset), pp.size);
+            RETURN_IF_ERROR(pages[p].column_iterator->cache_raw_page(pp, raw_page));
+        }
+    }
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "common/status.h"
+#include "olap/rowset/segment_v2/page_pointer.h"
+
+namespace doris {
+
+struct OlapReaderStatistics;
+
+namespace io {
+class FileReader;
+struct IOContext;
+} // namespace io
+
+namespace segment_v2 {
+
+class FileColumnIterator;
+class RowRanges;
+
+// Plans the data pages of all projected columns of a segment that are needed by a
+// set of row ranges, and reads them into page cache before they are decoded.
+//
+// Pages of all columns are sorted by file offset, and pages that are adjacent or close
+// to each other are coalesced into one read, so a batch over a remote or cold segment
+// issues a few large reads instead of one small read per column page. All coalesced
+// reads are submitted together through io::FileReader::read_batch_at.
+class SegmentPrefetcher {
+public:
+    struct PrefetchPage {
+        PagePointer page_pointer;
+        FileColumnIterator* column_iterator = nullptr;
+    };
+
+    // A coalesced read which covers pages [first_page, last_page) of the sorted pages.
+    struct CoalescedRead {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        size_t first_page = 0;
+        size_t last_page = 0;
+    };
+
+    SegmentPrefetcher(io::FileReader* file_reader, const io::IOContext* io_ctx,
+                      OlapReaderStatistics* stats)
+            : _file_reader(file_reader), _io_ctx(io_ctx), _stats(stats) {}
+
+    void add_column(FileColumnIterator* column_iterator) {
+        _column_iterators.push_back(column_iterator);
+    }
+
+    bool empty() const { return _column_iterators.empty(); }
+
+    // Read the uncached data pages of all columns which contain rows in `row_ranges'
+    // into page cache.
+    Status prefetch(const RowRanges& row_ranges);
+
+    // Coalesce `pages', which are sorted by offset, into reads. Two neighbouring pages
+    // are read together if the gap between them is at most `max_gap_bytes' and the
+    // read does not grow beyond `max_read_bytes'.
+    static std::vector<CoalescedRead> coalesce(const std::vector<PrefetchPage>& pages,
+                                               uint64_t max_gap_bytes, uint64_t max_read_bytes);
+
+private:
+    io::FileReader* _file_reader = nullptr;
+    const io::IOContext* _io_ctx = nullptr;
+    OlapReaderStatistics* _stats = nullptr;
+    std::vector<FileColumnIterator*> _column_iterators;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -43,6 +43,7 @@
 #include "olap/rowset/segment_v2/column_writer.h" // ColumnWriter
 #include "olap/rowset/segment_v2/page_io.h"
 #include "olap/rowset/segment_v2/page_pointer.h"
+#include "olap/rowset/segment_v2/zone_map_index.h"
 #include "olap/segment_loader.h"
 #include "olap/short_key_index.h"
 #include "olap/storage_engine.h"
@@ -1136,6 +1137,10 @@ Status SegmentWriter::_write_raw_data(const std::vector<Slice>& slices) {
     return Status::OK();
 }
 
+void SegmentWriter::get_segment_zone_maps(SegmentZoneMapsPB* zone_maps) const {
+    segment_v2::get_segment_zone_maps(_footer, config::rowset_meta_zone_map_max_columns, zone_maps);
+}
+
 Slice SegmentWriter::min_encoded_key() {
     return (_primary_key_index_builder == nullptr || !_tablet_schema->cluster_key_idxes().empty())
                    ? Slice(_min_key.data(), _min_key.size())
@@ -120,6 +120,8 @@ public:
                           TabletSchemaSPtr tablet_schema);
     Slice min_encoded_key();
     Slice max_encoded_key();
+    // The segment-level zone maps of the columns, valid after the footer is finalized.
+    void get_segment_zone_maps(SegmentZoneMapsPB* zone_maps) const;
 
     bool is_unique_key() { return _tablet_schema->keys_type() == UNIQUE_KEYS; }
 
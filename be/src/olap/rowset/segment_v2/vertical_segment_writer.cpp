@@ -41,17 +41,20 @@
 #include "olap/rowset/segment_v2/column_writer.h" // ColumnWriter
 #include "olap/rowset/segment_v2/page_io.h"
 #include "olap/rowset/segment_v2/page_pointer.h"
+#include "olap/rowset/segment_v2/zone_map_index.h"
 #include "olap/segment_loader.h"
 #include "olap/short_key_index.h"
 #include "olap/tablet_schema.h"
 #include "olap/utils.h"
 #include "runtime/exec_env.h"
 #include "runtime/memory/mem_tracker.h"
+#include "runtime/thread_context.h"
 #include "service/point_query_executor.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
 #include "util/faststring.h"
 #include "util/key_util.h"
+#include "util/threadpool.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/common/schema_util.h"
 #include "vec/core/block.h"
@@ -687,34 +690,36 @@ Status VerticalSegmentWriter::write_batch() {
 
     std::vector<vectorized::IOlapColumnDataAccessor*> key_columns;
     vectorized::IOlapColumnDataAccessor* seq_column = nullptr;
-    for (uint32_t cid = 0; cid < _tablet_schema->num_columns(); ++cid) {
-        RETURN_IF_ERROR(_create_column_writer(cid, _tablet_schema->column(cid)));
-        for (auto& data : _batched_blocks) {
-            _olap_data_convertor->set_source_content_with_specifid_columns(
-                    data.block, data.row_pos, data.num_rows, std::vector<uint32_t> {cid});
-
-            // convert column data from engine format to storage layer format
-            auto [status, column] = _olap_data_convertor->convert_column_data(cid);
-            if (!status.ok()) {
-                return status;
-            }
-            if (cid < _num_key_columns) {
-                key_columns.push_back(column);
-            } else if (_tablet_schema->has_sequence_col() &&
-                       cid == _tablet_schema->sequence_col_idx()) {
-                seq_column = column;
-            }
-            RETURN_IF_ERROR(_column_writers[cid]->append(column->get_nullmap(), column->get_data(),
-                                                         data.num_rows));
-            _olap_data_convertor->clear_source_content();
+    // The value columns of a flushed memtable are encoded a group at a time in parallel, their
+    // data is then written in the order of the columns. The key columns are encoded here, they
+    // are kept for the key indexes below.
+    ThreadPool* encode_pool = _opts.write_type == DataWriteType::TYPE_DIRECT
+                                      ? ExecEnv::GetInstance()->segment_column_encode_thread_pool()
+                                      : nullptr;
+    const uint32_t encode_group_size =
+            encode_pool == nullptr ? 1 : std::max(1, config::segment_column_encode_thread_num);
+    for (uint32_t cid = 0; cid < _tablet_schema->num_columns();) {
+        uint32_t end_cid = cid + 1;
+        if (cid >= _num_key_columns) {
+            end_cid = std::min<uint32_t>(cid + encode_group_size, _tablet_schema->num_columns());
         }
-        if (_data_dir != nullptr &&
-            _data_dir->reach_capacity_limit(_column_writers[cid]->estimate_buffer_size())) {
-            return Status::Error<DISK_REACH_CAPACITY_LIMIT>("disk {} exceed capacity limit.",
-                                                            _data_dir->path_hash());
+        for (uint32_t i = cid; i < end_cid; ++i) {
+            RETURN_IF_ERROR(_create_column_writer(i, _tablet_schema->column(i)));
+        }
+        if (end_cid - cid > 1) {
+            RETURN_IF_ERROR(_encode_columns_in_parallel(encode_pool, cid, end_cid, &seq_column));
+        } else {
+            RETURN_IF_ERROR(_encode_column(cid, &key_columns, &seq_column));
+        }
+        _olap_data_convertor->clear_source_content();
+        for (; cid < end_cid; ++cid) {
+            if (_data_dir != nullptr &&
+                _data_dir->reach_capacity_limit(_column_writers[cid]->estimate_buffer_size())) {
+                return Status::Error<DISK_REACH_CAPACITY_LIMIT>("disk {} exceed capacity limit.",
+                                                                _data_dir->path_hash());
+            }
+            RETURN_IF_ERROR(_column_writers[cid]->write_data());
         }
-        RETURN_IF_ERROR(_column_writers[cid]->finish());
-        RETURN_IF_ERROR(_column_writers[cid]->write_data());
     }
 
     for (auto& data : _batched_blocks) {
@@ -765,6 +770,56 @@ Status VerticalSegmentWriter::write_batch() {
     return Status::OK();
 }
 
+// Converts and appends the batched blocks to the writer of `cid`, and finishes its pages.
+// Only touches the column of `cid`, so that columns can be encoded in parallel.
+Status VerticalSegmentWriter::_encode_column(
+        uint32_t cid, std::vector<vectorized::IOlapColumnDataAccessor*>* key_columns,
+        vectorized::IOlapColumnDataAccessor** seq_column) {
+    for (auto& data : _batched_blocks) {
+        _olap_data_convertor->set_source_content_with_specifid_columns(
+                data.block, data.row_pos, data.num_rows, std::vector<uint32_t> {cid});
+
+        // convert column data from engine format to storage layer format
+        auto [status, column] = _olap_data_convertor->convert_column_data(cid);
+        if (!status.ok()) {
+            return status;
+        }
+        if (cid < _num_key_columns) {
+            key_columns->push_back(column);
+        } else if (_tablet_schema->has_sequence_col() &&
+                   cid == _tablet_schema->sequence_col_idx()) {
+            *seq_column = column;
+        }
+        RETURN_IF_ERROR(_column_writers[cid]->append(column->get_nullmap(), column->get_data(),
+                                                     data.num_rows));
+    }
+    return _column_writers[cid]->finish();
+}
+
+Status VerticalSegmentWriter::_encode_columns_in_parallel(
+        ThreadPool* pool, uint32_t begin_cid, uint32_t end_cid,
+        vectorized::IOlapColumnDataAccessor** seq_column) {
+    DCHECK(begin_cid >= _num_key_columns);
+    std::vector<Status> statuses(end_cid - begin_cid);
+    auto token = pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+    Status submit_status;
+    for (uint32_t cid = begin_cid; cid < end_cid && submit_status.ok(); ++cid) {
+        // only the task of the sequence column sets `seq_column`
+        submit_status = token->submit_func(
+                [this, cid, seq_column, status = &statuses[cid - begin_cid],
+                 mem_tracker = thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker()] {
+                    SCOPED_ATTACH_TASK(mem_tracker);
+                    *status = _encode_column(cid, nullptr, seq_column);
+                });
+    }
+    token->wait();
+    RETURN_IF_ERROR(submit_status);
+    for (const auto& status : statuses) {
+        RETURN_IF_ERROR(status);
+    }
+    return Status::OK();
+}
+
 std::string VerticalSegmentWriter::_full_encode_keys(
         const std::vector<vectorized::IOlapColumnDataAccessor*>& key_columns, size_t pos) {
     assert(_key_index_size.size() == _num_key_columns);
@@ -993,6 +1048,10 @@ Status VerticalSegmentWriter::_write_raw_data(const std::vector<Slice>& slices)
     return Status::OK();
 }
 
+void VerticalSegmentWriter::get_segment_zone_maps(SegmentZoneMapsPB* zone_maps) const {
+    segment_v2::get_segment_zone_maps(_footer, config::rowset_meta_zone_map_max_columns, zone_maps);
+}
+
 Slice VerticalSegmentWriter::min_encoded_key() {
     return (_primary_key_index_builder == nullptr) ? Slice(_min_key.data(), _min_key.size())
                                                    : _primary_key_index_builder->min_key();
@@ -51,6 +51,7 @@ class MemTracker;
 class ShortKeyIndexBuilder;
 class PrimaryKeyIndexBuilder;
 class KeyCoder;
+class ThreadPool;
 struct RowsetWriterContext;
 
 namespace io {
@@ -110,12 +111,19 @@ public:
 
     Slice min_encoded_key();
     Slice max_encoded_key();
+    // The segment-level zone maps of the columns, valid after the footer is finalized.
+    void get_segment_zone_maps(SegmentZoneMapsPB* zone_maps) const;
 
     void clear();
 
 private:
     void _init_column_meta(ColumnMetaPB* meta, uint32_t column_id, const TabletColumn& column);
     Status _create_column_writer(uint32_t cid, const TabletColumn& column);
+    Status _encode_column(uint32_t cid,
+                          std::vector<vectorized::IOlapColumnDataAccessor*>* key_columns,
+                          vectorized::IOlapColumnDataAccessor** seq_column);
+    Status _encode_columns_in_parallel(ThreadPool* pool, uint32_t begin_cid, uint32_t end_cid,
+                                       vectorized::IOlapColumnDataAccessor** seq_column);
     size_t _calculate_inverted_index_file_size();
     uint64_t _estimated_remaining_size();
     Status _write_ordinal_index();
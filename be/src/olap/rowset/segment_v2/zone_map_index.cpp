@@ -17,6 +17,7 @@
 
 #include "olap/rowset/segment_v2/zone_map_index.h"
 
+#include <gen_cpp/olap_file.pb.h>
 #include <gen_cpp/segment_v2.pb.h>
 #include <glog/logging.h>
 
@@ -219,5 +220,29 @@ Status ZoneMapIndexWriter::create(Field* field, std::unique_ptr<ZoneMapIndexWrit
         return Status::InvalidArgument("Invalid type!");
     }
 }
+
+void get_segment_zone_maps(const SegmentFooterPB& footer, int max_columns,
+                           SegmentZoneMapsPB* zone_maps) {
+    for (const ColumnMetaPB& column : footer.columns()) {
+        if (zone_maps->columns_size() >= max_columns) {
+            break;
+        }
+        // subcolumns of variant are not in the tablet schema
+        if (column.has_column_path_info()) {
+            continue;
+        }
+        for (const ColumnIndexMetaPB& index : column.indexes()) {
+            if (index.type() == ZONE_MAP_INDEX && index.zone_map_index().has_segment_zone_map()) {
+                ColumnZoneMapPB* zone_map = zone_maps->add_columns();
+                zone_map->set_unique_id(column.unique_id());
+                zone_map->set_type(column.type());
+                zone_map->set_length(column.length());
+                *zone_map->mutable_zone_map() = index.zone_map_index().segment_zone_map();
+                break;
+            }
+        }
+    }
+}
+
 } // namespace segment_v2
 } // namespace doris
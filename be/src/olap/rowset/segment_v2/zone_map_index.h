@@ -35,6 +35,8 @@
 
 namespace doris {
 
+class SegmentZoneMapsPB;
+
 namespace io {
 class FileWriter;
 } // namespace io
@@ -169,5 +171,10 @@ private:
     std::vector<ZoneMapPB> _page_zone_maps;
 };
 
+// Copy the segment-level zone maps of the first `max_columns` columns of a finalized segment
+// footer, so that they can be kept in the rowset meta.
+void get_segment_zone_maps(const SegmentFooterPB& footer, int max_columns,
+                           SegmentZoneMapsPB* zone_maps);
+
 } // namespace segment_v2
 } // namespace doris
@@ -216,6 +216,7 @@ Status VerticalBetaRowsetWriter::final_flush() {
             return st;
         }
         _total_data_size += segment_size + segment_writer->get_inverted_index_file_size();
+        segment_writer->get_segment_zone_maps(&_segments_zone_maps.emplace_back());
         segment_writer.reset();
     }
     return Status::OK();
@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/scan_tablet_pruner.h"
+
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+#include <shared_mutex>
+
+#include "cloud/config.h"
+#include "exprs/create_predicate_function.h"
+#include "olap/base_tablet.h"
+#include "olap/block_column_predicate.h"
+#include "olap/column_predicate.h"
+#include "olap/iterators.h"
+#include "olap/predicate_creator.h"
+#include "olap/rowset/rowset.h"
+#include "olap/rowset/segment_meta_pruner.h"
+#include "olap/tablet_schema.h"
+#include "runtime/exec_env.h"
+#include "vec/common/arena.h"
+
+namespace doris {
+
+ScanTabletPruner::ScanTabletPruner(
+        const std::vector<TCondition>& conditions,
+        const std::vector<TCondition>& scan_key_conditions,
+        const std::vector<std::pair<std::string, std::shared_ptr<BloomFilterFuncBase>>>&
+                bloom_filters,
+        const std::vector<std::pair<std::string, std::shared_ptr<HybridSetBase>>>& in_filters,
+        int be_exec_version)
+        : _conditions(conditions),
+          _scan_key_conditions(scan_key_conditions),
+          _bloom_filters(bloom_filters),
+          _in_filters(in_filters),
+          _be_exec_version(be_exec_version) {}
+
+bool ScanTabletPruner::may_match(const BaseTabletSPtr& tablet, int64_t version) const {
+    const TabletSchemaSPtr& tablet_schema = tablet->tablet_schema();
+    // The value columns of the other tables are only known after merging the rows of a key.
+    bool use_value_columns =
+            tablet->keys_type() == DUP_KEYS ||
+            (tablet->keys_type() == UNIQUE_KEYS && tablet->enable_unique_key_merge_on_write());
+
+    vectorized::Arena arena;
+    std::vector<std::unique_ptr<ColumnPredicate>> predicates;
+    StorageReadOptions read_options;
+    read_options.tablet_schema = tablet_schema;
+    auto find_column = [&](const std::string& name) -> const TabletColumn* {
+        int32_t index = tablet_schema->field_index(name);
+        if (index < 0) {
+            return nullptr;
+        }
+        const TabletColumn& column = tablet_schema->column(index);
+        if (column.is_variant_type() || column.is_extracted_column() ||
+            (!column.is_key() && !use_value_columns)) {
+            return nullptr;
+        }
+        return &column;
+    };
+    auto add_predicate = [&](ColumnPredicate* predicate) {
+        if (predicate == nullptr) {
+            return;
+        }
+        predicates.emplace_back(predicate);
+        auto& column_predicates = read_options.col_id_to_predicates[predicate->column_id()];
+        if (column_predicates == nullptr) {
+            column_predicates = std::make_shared<AndBlockColumnPredicate>();
+        }
+        column_predicates->add_column_predicate(new SingleColumnBlockPredicate(predicate));
+    };
+
+    for (const auto* conditions : {&_conditions, &_scan_key_conditions}) {
+        for (const auto& condition : *conditions) {
+            if (const auto* column = find_column(condition.column_name)) {
+                add_predicate(parse_to_predicate(*column,
+                                                 tablet_schema->field_index(condition.column_name),
+                                                 condition, &arena));
+            }
+        }
+    }
+    for (const auto& [name, filter] : _bloom_filters) {
+        if (const auto* column = find_column(name)) {
+            add_predicate(create_column_predicate(tablet_schema->field_index(name), filter,
+                                                  column->type(), _be_exec_version, column));
+        }
+    }
+    for (const auto& [name, filter] : _in_filters) {
+        if (const auto* column = find_column(name)) {
+            add_predicate(create_column_predicate(tablet_schema->field_index(name), filter,
+                                                  column->type(), _be_exec_version, column));
+        }
+    }
+    if (read_options.col_id_to_predicates.empty()) {
+        return true;
+    }
+
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        std::shared_lock rlock(tablet->get_header_lock());
+        // let the scanner report a missing version
+        if (!tablet->capture_consistent_rowsets_unlocked({0, version}, &rowsets).ok()) {
+            return true;
+        }
+    }
+    for (const auto& rowset : rowsets) {
+        SegmentMetaPruner pruner(rowset->rowset_meta(), read_options);
+        for (int64_t segment_id = 0; segment_id < rowset->num_segments(); ++segment_id) {
+            if (pruner.may_match(segment_id)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t ScanTabletPruner::prune(std::vector<std::unique_ptr<TPaloScanRange>>* scan_ranges) const {
+    // The rowsets of a cloud tablet are only synced up to the version when it is read.
+    if (config::is_cloud_mode() ||
+        (_conditions.empty() && _scan_key_conditions.empty() && _bloom_filters.empty() &&
+         _in_filters.empty())) {
+        return 0;
+    }
+    size_t num_scan_ranges = scan_ranges->size();
+    scan_ranges->erase(
+            std::remove_if(scan_ranges->begin(), scan_ranges->end(),
+                           [&](const std::unique_ptr<TPaloScanRange>& scan_range) {
+                               auto tablet = ExecEnv::get_tablet(scan_range->tablet_id);
+                               if (!tablet.has_value()) {
+                                   // the scanner reports the error
+                                   return false;
+                               }
+                               int64_t version = 0;
+                               std::from_chars(
+                                       scan_range->version.data(),
+                                       scan_range->version.data() + scan_range->version.size(),
+                                       version);
+                               return !may_match(tablet.value(), version);
+                           }),
+            scan_ranges->end());
+    return num_scan_ranges - scan_ranges->size();
+}
+
+} // namespace doris
@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "olap/tablet_fwd.h"
+
+namespace doris {
+
+class BloomFilterFuncBase;
+class HybridSetBase;
+
+// Drops the tablets of an olap scan which have no segment that may match the pushed down
+// conditions, before any scanner is created for them. The conditions include the key ranges,
+// the MINMAX and IN runtime filters arrived before the scanners are built, and the range kept
+// along with a BLOOM runtime filter, so a join with a selective dimension skips whole tablets of
+// the fact table (e.g. the partitions of the days it does not select).
+//
+// A tablet is tested with the segment zone maps kept in its rowset metas (see
+// SegmentMetaPruner), so it costs no IO. Tablets with a rowset written before those were kept
+// are never dropped.
+class ScanTabletPruner {
+public:
+    // `scan_key_conditions` are the exact key ranges which were moved to the scan keys and so
+    // are not in `conditions`.
+    ScanTabletPruner(
+            const std::vector<TCondition>& conditions,
+            const std::vector<TCondition>& scan_key_conditions,
+            const std::vector<std::pair<std::string, std::shared_ptr<BloomFilterFuncBase>>>&
+                    bloom_filters,
+            const std::vector<std::pair<std::string, std::shared_ptr<HybridSetBase>>>& in_filters,
+            int be_exec_version);
+
+    // Return false if no row of `tablet` at `version` can match the filters.
+    bool may_match(const BaseTabletSPtr& tablet, int64_t version) const;
+
+    // Remove the scan ranges of the tablets which cannot match, return how many were removed.
+    size_t prune(std::vector<std::unique_ptr<TPaloScanRange>>* scan_ranges) const;
+
+private:
+    const std::vector<TCondition>& _conditions;
+    const std::vector<TCondition>& _scan_key_conditions;
+    const std::vector<std::pair<std::string, std::shared_ptr<BloomFilterFuncBase>>>&
+            _bloom_filters;
+    const std::vector<std::pair<std::string, std::shared_ptr<HybridSetBase>>>& _in_filters;
+    int _be_exec_version;
+};
+
+} // namespace doris
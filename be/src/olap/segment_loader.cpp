@@ -17,6 +17,8 @@
 
 #include "olap/segment_loader.h"
 
+#include <numeric>
+
 #include "common/config.h"
 #include "olap/olap_define.h"
 #include "olap/rowset/beta_rowset.h"
@@ -56,10 +58,18 @@ void SegmentCache::erase(const SegmentCache::CacheKey& key) {
 
 Status SegmentLoader::load_segments(const BetaRowsetSharedPtr& rowset,
                                     SegmentCacheHandle* cache_handle, bool use_cache) {
+    std::vector<uint32_t> segment_ids(rowset->num_segments());
+    std::iota(segment_ids.begin(), segment_ids.end(), 0);
+    return load_segments(rowset, segment_ids, cache_handle, use_cache);
+}
+
+Status SegmentLoader::load_segments(const BetaRowsetSharedPtr& rowset,
+                                    const std::vector<uint32_t>& segment_ids,
+                                    SegmentCacheHandle* cache_handle, bool use_cache) {
     if (cache_handle->is_inited()) {
         return Status::OK();
     }
-    for (int64_t i = 0; i < rowset->num_segments(); i++) {
+    for (uint32_t i : segment_ids) {
         SegmentCache::CacheKey cache_key(rowset->rowset_id(), i);
         if (_segment_cache->lookup(cache_key, cache_handle)) {
             continue;
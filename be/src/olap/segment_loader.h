@@ -112,6 +112,11 @@ public:
     Status load_segments(const BetaRowsetSharedPtr& rowset, SegmentCacheHandle* cache_handle,
                          bool use_cache = false);
 
+    // Load the segments of "rowset" in "segment_ids" only, in that order.
+    Status load_segments(const BetaRowsetSharedPtr& rowset,
+                         const std::vector<uint32_t>& segment_ids,
+                         SegmentCacheHandle* cache_handle, bool use_cache = false);
+
     void erase_segment(const SegmentCache::CacheKey& key);
 
     void erase_segments(const RowsetId& rowset_id, int64_t num_segments);
@@ -77,6 +77,8 @@ Status AggSinkLocalState<DependencyType, Derived>::init(RuntimeState* state,
     Base::_shared_state->offsets_of_aggregate_states = p._offsets_of_aggregate_states;
     Base::_shared_state->make_nullable_keys = p._make_nullable_keys;
     Base::_shared_state->init_spill_partition_helper(p._spill_partition_count_bits);
+    RETURN_IF_ERROR(
+            state->spill_compression_type(&Base::_shared_state->spill_context.compression_type));
     for (auto& evaluator : p._aggregate_evaluators) {
         Base::_shared_state->aggregate_evaluators.push_back(evaluator->clone(state, p._pool));
     }
@@ -216,14 +216,11 @@ protected:
         }
 
         vectorized::BlockSpillWriterUPtr writer;
-        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
-                std::numeric_limits<int32_t>::max(), writer,
-                Base::_shared_state->spill_context.runtime_profile));
+        RETURN_IF_ERROR(Base::_shared_state->spill_context.get_writer(writer));
         Defer defer {[&]() {
             // redundant call is ok
             static_cast<void>(writer->close());
         }};
-        Base::_shared_state->spill_context.stream_ids.emplace_back(writer->get_id());
 
         std::vector<size_t> partitioned_indices(block.rows());
         std::vector<size_t> blocks_rows(
@@ -22,6 +22,7 @@
 #include <memory>
 
 #include "olap/parallel_scanner_builder.h"
+#include "olap/scan_tablet_pruner.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_manager.h"
 #include "pipeline/exec/scan_operator.h"
@@ -99,6 +100,9 @@ Status OlapScanLocalState::_init_profile() {
     _bf_filtered_counter = ADD_COUNTER(_segment_profile, "RowsBloomFilterFiltered", TUnit::UNIT);
     _dict_filtered_counter = ADD_COUNTER(_segment_profile, "RowsDictFiltered", TUnit::UNIT);
     _del_filtered_counter = ADD_COUNTER(_scanner_profile, "RowsDelFiltered", TUnit::UNIT);
+    _late_materialization_timer = ADD_TIMER(_scanner_profile, "LateMaterializationTime");
+    _rows_late_materialized_counter =
+            ADD_COUNTER(_scanner_profile, "RowsLateMaterialized", TUnit::UNIT);
     _conditions_filtered_counter =
             ADD_COUNTER(_segment_profile, "RowsConditionsFiltered", TUnit::UNIT);
     _key_range_filtered_counter =
@@ -109,6 +113,8 @@ Status OlapScanLocalState::_init_profile() {
 
     _total_pages_num_counter = ADD_COUNTER(_segment_profile, "TotalPagesNum", TUnit::UNIT);
     _cached_pages_num_counter = ADD_COUNTER(_segment_profile, "CachedPagesNum", TUnit::UNIT);
+    _prefetched_pages_num_counter =
+            ADD_COUNTER(_segment_profile, "PrefetchedPagesNum", TUnit::UNIT);
 
     _bitmap_index_filter_counter =
             ADD_COUNTER(_segment_profile, "RowsBitmapIndexFiltered", TUnit::UNIT);
@@ -136,6 +142,7 @@ Status OlapScanLocalState::_init_profile() {
     _filtered_segment_counter = ADD_COUNTER(_segment_profile, "NumSegmentFiltered", TUnit::UNIT);
     _total_segment_counter = ADD_COUNTER(_segment_profile, "NumSegmentTotal", TUnit::UNIT);
     _tablet_counter = ADD_COUNTER(_runtime_profile, "TabletNum", TUnit::UNIT);
+    _pruned_tablet_counter = ADD_COUNTER(_runtime_profile, "PrunedTabletNum", TUnit::UNIT);
     _key_range_counter = ADD_COUNTER(_runtime_profile, "KeyRangesNum", TUnit::UNIT);
     _runtime_filter_info = ADD_LABEL_COUNTER_WITH_LEVEL(_runtime_profile, "RuntimeFilterInfo", 1);
     return Status::OK();
@@ -223,6 +230,13 @@ bool OlapScanLocalState::_storage_no_merge() {
 }
 
 Status OlapScanLocalState::_init_scanners(std::list<vectorized::VScannerSPtr>* scanners) {
+    {
+        SCOPED_TIMER(_scanner_init_timer);
+        ScanTabletPruner pruner(_olap_filters, _scan_key_filters,
+                                _filter_predicates.bloom_filters, _filter_predicates.in_filters,
+                                state()->be_exec_version());
+        COUNTER_UPDATE(_pruned_tablet_counter, pruner.prune(&_scan_ranges));
+    }
     if (_scan_ranges.empty()) {
         _eos = true;
         _scan_dependency->set_ready();
@@ -471,6 +485,7 @@ Status OlapScanLocalState::_build_key_ranges_and_filters() {
                             RETURN_IF_ERROR(_scan_keys.extend_scan_key(
                                     temp_range, p._max_scan_key_num, &exact_range, &eos));
                             if (exact_range) {
+                                range.to_olap_filter(_scan_key_filters);
                                 _colname_to_value_range.erase(iter->first);
                             }
                         } else {
@@ -108,7 +108,8 @@ Status PartitionSortSinkOperatorX::sink(RuntimeState* state, vectorized::Block*
                         local_state._partition_sort_info, local_state._value_places.empty())));
             }
             //no partition key
-            local_state._value_places[0]->append_whole_block(input_block, _child_x->row_desc());
+            RETURN_IF_ERROR(local_state._value_places[0]->append_whole_block(
+                    input_block, _child_x->row_desc()));
         } else {
             //just simply use partition num to check
             //if is TWO_PHASE_GLOBAL, must be sort all data thought partition num threshold have been exceeded.
@@ -134,21 +135,9 @@ Status PartitionSortSinkOperatorX::sink(RuntimeState* state, vectorized::Block*
         //seems could free for hashtable
         local_state._agg_arena_pool.reset(nullptr);
         local_state._partitioned_data.reset(nullptr);
-        for (int i = 0; i < local_state._value_places.size(); ++i) {
-            auto sorter = vectorized::PartitionSorter::create_unique(
-                    _vsort_exec_exprs, _limit, 0, _pool, _is_asc_order, _nulls_first,
-                    _child_x->row_desc(), state, i == 0 ? local_state._profile : nullptr,
-                    _has_global_limit, _partition_inner_limit, _top_n_algorithm,
-                    local_state._shared_state->previous_row.get());
-
-            DCHECK(_child_x->row_desc().num_materialized_slots() ==
-                   local_state._value_places[i]->blocks.back()->columns());
-            //get blocks from every partition, and sorter get those data.
-            for (const auto& block : local_state._value_places[i]->blocks) {
-                RETURN_IF_ERROR(sorter->append_block(block.get()));
-            }
-            sorter->init_profile(local_state._profile);
-            RETURN_IF_ERROR(sorter->prepare_for_read());
+        for (auto* place : local_state._value_places) {
+            std::unique_ptr<vectorized::PartitionSorter> sorter;
+            RETURN_IF_ERROR(place->build_sorter(&sorter));
             local_state._shared_state->partition_sorts.push_back(std::move(sorter));
         }
 
@@ -173,15 +162,15 @@ Status PartitionSortSinkOperatorX::_split_block_by_partition(
         local_state._partition_columns[i] =
                 input_block->get_by_position(result_column_id).column.get();
     }
-    _emplace_into_hash_table(local_state._partition_columns, input_block, batch_size, local_state);
-    return Status::OK();
+    return _emplace_into_hash_table(local_state._partition_columns, input_block, batch_size,
+                                    local_state);
 }
 
-void PartitionSortSinkOperatorX::_emplace_into_hash_table(
+Status PartitionSortSinkOperatorX::_emplace_into_hash_table(
         const vectorized::ColumnRawPtrs& key_columns, const vectorized::Block* input_block,
         int batch_size, PartitionSortSinkLocalState& local_state) {
-    std::visit(
-            [&](auto&& agg_method) -> void {
+    return std::visit(
+            [&](auto&& agg_method) -> Status {
                 SCOPED_TIMER(local_state._build_timer);
                 using HashMethodType = std::decay_t<decltype(agg_method)>;
                 using AggState = typename HashMethodType::State;
@@ -213,10 +202,11 @@ void PartitionSortSinkOperatorX::_emplace_into_hash_table(
                 }
                 for (auto* place : local_state._value_places) {
                     SCOPED_TIMER(local_state._selector_block_timer);
-                    place->append_block_by_selector(input_block, _child_x->row_desc(),
-                                                    _has_global_limit, _partition_inner_limit,
-                                                    batch_size);
+                    RETURN_IF_ERROR(place->append_block_by_selector(
+                            input_block, _child_x->row_desc(), _has_global_limit,
+                            _partition_inner_limit, batch_size));
                 }
+                return Status::OK();
             },
             local_state._partitioned_data->method_variant);
 }
@@ -133,9 +133,9 @@ private:
 
     Status _split_block_by_partition(vectorized::Block* input_block, int batch_size,
                                      PartitionSortSinkLocalState& local_state);
-    void _emplace_into_hash_table(const vectorized::ColumnRawPtrs& key_columns,
-                                  const vectorized::Block* input_block, int batch_size,
-                                  PartitionSortSinkLocalState& local_state);
+    Status _emplace_into_hash_table(const vectorized::ColumnRawPtrs& key_columns,
+                                    const vectorized::Block* input_block, int batch_size,
+                                    PartitionSortSinkLocalState& local_state);
 };
 
 } // namespace pipeline
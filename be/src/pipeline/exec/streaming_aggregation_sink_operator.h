@@ -28,6 +28,7 @@
 #include "pipeline/pipeline_x/operator.h"
 #include "util/runtime_profile.h"
 #include "vec/core/block.h"
+#include "vec/exec/streaming_agg_controller.h"
 #include "vec/exec/vaggregation_node.h"
 
 namespace doris {
@@ -92,7 +93,11 @@ private:
 
     Status _pre_agg_with_serialized_key(doris::vectorized::Block* in_block,
                                         doris::vectorized::Block* out_block);
-    bool _should_expand_preagg_hash_tables();
+    // serialize the rows of `in_block` to `out_block` without aggregating them,
+    // `key_column_ids` are the positions of the evaluated group by keys in `in_block`
+    Status _pre_agg_pass_through(vectorized::Block* in_block,
+                                 const std::vector<int>& key_column_ids,
+                                 vectorized::Block* out_block);
     void _make_nullable_output_key(vectorized::Block* block) {
         if (block->rows() != 0) {
             auto& shared_state = *Base ::_shared_state;
@@ -108,8 +113,7 @@ private:
     RuntimeProfile::Counter* _queue_size_counter = nullptr;
     RuntimeProfile::Counter* _streaming_agg_timer = nullptr;
 
-    bool _should_expand_hash_table = true;
-    int64_t _num_rows_returned = 0;
+    vectorized::StreamingAggController _preagg_controller;
 };
 
 class StreamingAggSinkOperatorX final : public AggSinkOperatorX<StreamingAggSinkLocalState> {
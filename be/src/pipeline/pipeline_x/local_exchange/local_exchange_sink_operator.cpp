@@ -30,6 +30,7 @@ Status LocalExchangeSinkLocalState::init(RuntimeState* state, LocalSinkStateInfo
 
     _exchanger = _shared_state->exchanger.get();
     DCHECK(_exchanger != nullptr);
+    _sender_id = _exchanger->_next_sender_id.fetch_add(1);
 
     if (_exchanger->get_type() == ExchangeType::HASH_SHUFFLE ||
         _exchanger->get_type() == ExchangeType::BUCKET_HASH_SHUFFLE) {
@@ -68,6 +68,8 @@ private:
 
     // Used by random passthrough exchanger
     int _channel_id = 0;
+    // Index of the producer tokens of this sink in the queues of the exchanger
+    int _sender_id = -1;
 };
 
 // A single 32-bit division on a recent x64 processor has a throughput of one instruction every six cycles with a latency of 26 cycles.
@@ -56,11 +56,11 @@ Status ShuffleExchanger::get_block(RuntimeState* state, vectorized::Block* block
                                     offset_start + std::get<2>(partitioned_block.second));
             block_wrapper->unref(local_state._shared_state);
         } while (mutable_block->rows() < state->batch_size() &&
-                 _data_queue[local_state._channel_id].try_dequeue(partitioned_block));
+                 _data_queue.try_dequeue(local_state._channel_id, partitioned_block));
         *result_block = mutable_block->to_block();
     };
     if (_running_sink_operators == 0) {
-        if (_data_queue[local_state._channel_id].try_dequeue(partitioned_block)) {
+        if (_data_queue.try_dequeue(local_state._channel_id, partitioned_block)) {
             SCOPED_TIMER(local_state._copy_data_timer);
             mutable_block = vectorized::MutableBlock::create_unique(
                     partitioned_block.first->data_block.clone_empty());
@@ -69,7 +69,7 @@ Status ShuffleExchanger::get_block(RuntimeState* state, vectorized::Block* block
             COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
             source_state = SourceState::FINISHED;
         }
-    } else if (_data_queue[local_state._channel_id].try_dequeue(partitioned_block)) {
+    } else if (_data_queue.try_dequeue(local_state._channel_id, partitioned_block)) {
         SCOPED_TIMER(local_state._copy_data_timer);
         mutable_block = vectorized::MutableBlock::create_unique(
                 partitioned_block.first->data_block.clone_empty());
@@ -84,7 +84,6 @@ Status ShuffleExchanger::get_block(RuntimeState* state, vectorized::Block* block
 Status ShuffleExchanger::_split_rows(RuntimeState* state, const uint32_t* __restrict channel_ids,
                                      vectorized::Block* block, SourceState source_state,
                                      LocalExchangeSinkLocalState& local_state) {
-    auto& data_queue = _data_queue;
     const auto rows = block->rows();
     auto row_idx = std::make_shared<std::vector<uint32_t>>(rows);
     {
@@ -105,7 +104,7 @@ Status ShuffleExchanger::_split_rows(RuntimeState* state, const uint32_t* __rest
 
     vectorized::Block data_block;
     std::shared_ptr<ShuffleBlockWrapper> new_block_wrapper;
-    if (_free_blocks.try_enqueue(data_block)) {
+    if (_free_blocks.try_dequeue(data_block)) {
         new_block_wrapper = ShuffleBlockWrapper::create_shared(std::move(data_block));
     } else {
         new_block_wrapper = ShuffleBlockWrapper::create_shared(block->clone_empty());
@@ -128,7 +127,8 @@ Status ShuffleExchanger::_split_rows(RuntimeState* state, const uint32_t* __rest
             if (size > 0) {
                 local_state._shared_state->add_mem_usage(
                         it.second, new_block_wrapper->data_block.allocated_bytes(), false);
-                data_queue[it.second].enqueue({new_block_wrapper, {row_idx, start, size}});
+                _data_queue.enqueue(local_state._sender_id, it.second,
+                                    {new_block_wrapper, {row_idx, start, size}});
                 local_state._shared_state->set_ready_to_read(it.second);
             } else {
                 new_block_wrapper->unref(local_state._shared_state);
@@ -142,7 +142,8 @@ Status ShuffleExchanger::_split_rows(RuntimeState* state, const uint32_t* __rest
             if (size > 0) {
                 local_state._shared_state->add_mem_usage(
                         i % _num_sources, new_block_wrapper->data_block.allocated_bytes(), false);
-                data_queue[i % _num_sources].enqueue({new_block_wrapper, {row_idx, start, size}});
+                _data_queue.enqueue(local_state._sender_id, i % _num_sources,
+                                    {new_block_wrapper, {row_idx, start, size}});
                 local_state._shared_state->set_ready_to_read(i % _num_sources);
             } else {
                 new_block_wrapper->unref(local_state._shared_state);
@@ -158,7 +159,8 @@ Status ShuffleExchanger::_split_rows(RuntimeState* state, const uint32_t* __rest
             if (size > 0) {
                 local_state._shared_state->add_mem_usage(
                         map[i], new_block_wrapper->data_block.allocated_bytes(), false);
-                data_queue[map[i]].enqueue({new_block_wrapper, {row_idx, start, size}});
+                _data_queue.enqueue(local_state._sender_id, map[i],
+                                    {new_block_wrapper, {row_idx, start, size}});
                 local_state._shared_state->set_ready_to_read(map[i]);
             } else {
                 new_block_wrapper->unref(local_state._shared_state);
@@ -179,7 +181,7 @@ Status PassthroughExchanger::sink(RuntimeState* state, vectorized::Block* in_blo
     new_block.swap(*in_block);
     auto channel_id = (local_state._channel_id++) % _num_partitions;
     local_state._shared_state->add_mem_usage(channel_id, new_block.allocated_bytes());
-    _data_queue[channel_id].enqueue(std::move(new_block));
+    _data_queue.enqueue(local_state._sender_id, channel_id, std::move(new_block));
     local_state._shared_state->set_ready_to_read(channel_id);
 
     return Status::OK();
@@ -190,7 +192,7 @@ Status PassthroughExchanger::get_block(RuntimeState* state, vectorized::Block* b
                                        LocalExchangeSourceLocalState& local_state) {
     vectorized::Block next_block;
     if (_running_sink_operators == 0) {
-        if (_data_queue[local_state._channel_id].try_dequeue(next_block)) {
+        if (_data_queue.try_dequeue(local_state._channel_id, next_block)) {
             block->swap(next_block);
             _free_blocks.enqueue(std::move(next_block));
             local_state._shared_state->sub_mem_usage(local_state._channel_id,
@@ -199,7 +201,7 @@ Status PassthroughExchanger::get_block(RuntimeState* state, vectorized::Block* b
             COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
             source_state = SourceState::FINISHED;
         }
-    } else if (_data_queue[local_state._channel_id].try_dequeue(next_block)) {
+    } else if (_data_queue.try_dequeue(local_state._channel_id, next_block)) {
         block->swap(next_block);
         _free_blocks.enqueue(std::move(next_block));
         local_state._shared_state->sub_mem_usage(local_state._channel_id, block->allocated_bytes());
@@ -215,7 +217,7 @@ Status PassToOneExchanger::sink(RuntimeState* state, vectorized::Block* in_block
                                 LocalExchangeSinkLocalState& local_state) {
     vectorized::Block new_block(in_block->clone_empty());
     new_block.swap(*in_block);
-    _data_queue[0].enqueue(std::move(new_block));
+    _data_queue.enqueue(local_state._sender_id, 0, std::move(new_block));
     local_state._shared_state->set_ready_to_read(0);
 
     return Status::OK();
@@ -230,13 +232,13 @@ Status PassToOneExchanger::get_block(RuntimeState* state, vectorized::Block* blo
     }
     vectorized::Block next_block;
     if (_running_sink_operators == 0) {
-        if (_data_queue[0].try_dequeue(next_block)) {
+        if (_data_queue.try_dequeue(0, next_block)) {
             *block = std::move(next_block);
         } else {
             COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
             source_state = SourceState::FINISHED;
         }
-    } else if (_data_queue[0].try_dequeue(next_block)) {
+    } else if (_data_queue.try_dequeue(0, next_block)) {
         *block = std::move(next_block);
     } else {
         COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
@@ -251,7 +253,7 @@ Status BroadcastExchanger::sink(RuntimeState* state, vectorized::Block* in_block
     for (size_t i = 0; i < _num_partitions; i++) {
         auto mutable_block = vectorized::MutableBlock::create_unique(in_block->clone_empty());
         mutable_block->add_rows(in_block, 0, in_block->rows());
-        _data_queue[i].enqueue(mutable_block->to_block());
+        _data_queue.enqueue(local_state._sender_id, i, mutable_block->to_block());
         local_state._shared_state->set_ready_to_read(i);
     }
 
@@ -263,13 +265,13 @@ Status BroadcastExchanger::get_block(RuntimeState* state, vectorized::Block* blo
                                      LocalExchangeSourceLocalState& local_state) {
     vectorized::Block next_block;
     if (_running_sink_operators == 0) {
-        if (_data_queue[local_state._channel_id].try_dequeue(next_block)) {
+        if (_data_queue.try_dequeue(local_state._channel_id, next_block)) {
             *block = std::move(next_block);
         } else {
             COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
             source_state = SourceState::FINISHED;
         }
-    } else if (_data_queue[local_state._channel_id].try_dequeue(next_block)) {
+    } else if (_data_queue.try_dequeue(local_state._channel_id, next_block)) {
         *block = std::move(next_block);
     } else {
         COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
@@ -289,7 +291,7 @@ Status AdaptivePassthroughExchanger::_passthrough_sink(RuntimeState* state,
     new_block.swap(*in_block);
     auto channel_id = (local_state._channel_id++) % _num_partitions;
     local_state._shared_state->add_mem_usage(channel_id, new_block.allocated_bytes());
-    _data_queue[channel_id].enqueue(std::move(new_block));
+    _data_queue.enqueue(local_state._sender_id, channel_id, std::move(new_block));
     local_state._shared_state->set_ready_to_read(channel_id);
 
     return Status::OK();
@@ -319,7 +321,6 @@ Status AdaptivePassthroughExchanger::_split_rows(RuntimeState* state,
                                                  const uint32_t* __restrict channel_ids,
                                                  vectorized::Block* block, SourceState source_state,
                                                  LocalExchangeSinkLocalState& local_state) {
-    auto& data_queue = _data_queue;
     const auto rows = block->rows();
     auto row_idx = std::make_shared<std::vector<uint32_t>>(rows);
     {
@@ -346,7 +347,7 @@ Status AdaptivePassthroughExchanger::_split_rows(RuntimeState* state,
             mutable_block->add_rows(block, start, size);
             auto new_block = mutable_block->to_block();
             local_state._shared_state->add_mem_usage(i, new_block.allocated_bytes());
-            data_queue[i].enqueue(std::move(new_block));
+            _data_queue.enqueue(local_state._sender_id, i, std::move(new_block));
         }
         local_state._shared_state->set_ready_to_read(i);
     }
@@ -371,7 +372,7 @@ Status AdaptivePassthroughExchanger::get_block(RuntimeState* state, vectorized::
                                                LocalExchangeSourceLocalState& local_state) {
     vectorized::Block next_block;
     if (_running_sink_operators == 0) {
-        if (_data_queue[local_state._channel_id].try_dequeue(next_block)) {
+        if (_data_queue.try_dequeue(local_state._channel_id, next_block)) {
             block->swap(next_block);
             _free_blocks.enqueue(std::move(next_block));
             local_state._shared_state->sub_mem_usage(local_state._channel_id,
@@ -380,7 +381,7 @@ Status AdaptivePassthroughExchanger::get_block(RuntimeState* state, vectorized::
             COUNTER_UPDATE(local_state._get_block_failed_counter, 1);
             source_state = SourceState::FINISHED;
         }
-    } else if (_data_queue[local_state._channel_id].try_dequeue(next_block)) {
+    } else if (_data_queue.try_dequeue(local_state._channel_id, next_block)) {
         block->swap(next_block);
         _free_blocks.enqueue(std::move(next_block));
         local_state._shared_state->sub_mem_usage(local_state._channel_id, block->allocated_bytes());
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "pipeline/pipeline_x/dependency.h"
 #include "pipeline/pipeline_x/operator.h"
 
@@ -26,6 +29,51 @@ class LocalExchangeSourceLocalState;
 class LocalExchangeSinkLocalState;
 struct ShuffleBlockWrapper;
 
+// The queues of the channels of an exchanger, one lock-free MPMC queue per channel.
+// Every sink enqueues through its own producer token of the queue, and the only source of a
+// channel dequeues through a consumer token, so each (sink, source) pair exchanges blocks
+// through a single-producer single-consumer sub-queue. Without tokens each enqueue looks up
+// the implicit sub-queue of the calling thread, and as pipeline tasks move between threads
+// every queue ends up with a sub-queue per thread that the source has to scan.
+template <typename BlockType>
+class LocalExchangeQueues {
+public:
+    void init(int num_channels, int num_senders) {
+        _queues = std::vector<moodycamel::ConcurrentQueue<BlockType>>(num_channels);
+        _producer_tokens.resize(num_senders);
+        for (auto& tokens : _producer_tokens) {
+            tokens.resize(num_channels);
+        }
+        for (auto& queue : _queues) {
+            _consumer_tokens.emplace_back(std::make_unique<moodycamel::ConsumerToken>(queue));
+        }
+    }
+
+    // Only called by the sink `sender_id`, its tokens are created on first use.
+    void enqueue(int sender_id, int channel_id, BlockType&& block) {
+        if (sender_id < 0 || sender_id >= static_cast<int>(_producer_tokens.size())) {
+            _queues[channel_id].enqueue(std::move(block));
+            return;
+        }
+        auto& token = _producer_tokens[sender_id][channel_id];
+        if (token == nullptr) {
+            token = std::make_unique<moodycamel::ProducerToken>(_queues[channel_id]);
+        }
+        _queues[channel_id].enqueue(*token, std::move(block));
+    }
+
+    // Only called by the source of `channel_id`.
+    bool try_dequeue(int channel_id, BlockType& block) {
+        return _queues[channel_id].try_dequeue(*_consumer_tokens[channel_id], block);
+    }
+
+private:
+    std::vector<moodycamel::ConcurrentQueue<BlockType>> _queues;
+    // declared after the queues they belong to, so that they are destroyed first
+    std::vector<std::vector<std::unique_ptr<moodycamel::ProducerToken>>> _producer_tokens;
+    std::vector<std::unique_ptr<moodycamel::ConsumerToken>> _consumer_tokens;
+};
+
 class Exchanger {
 public:
     Exchanger(int running_sink_operators, int num_partitions)
@@ -53,6 +101,8 @@ protected:
     friend class LocalExchangeSourceLocalState;
     friend class LocalExchangeSinkLocalState;
     std::atomic<int> _running_sink_operators = 0;
+    // hands out the ids of the sinks, which index their producer tokens
+    std::atomic<int> _next_sender_id = 0;
     const int _num_partitions;
     const int _num_senders;
     const int _num_sources;
@@ -86,7 +136,7 @@ public:
     ENABLE_FACTORY_CREATOR(ShuffleExchanger);
     ShuffleExchanger(int running_sink_operators, int num_partitions)
             : Exchanger(running_sink_operators, num_partitions) {
-        _data_queue.resize(num_partitions);
+        _data_queue.init(num_partitions, running_sink_operators);
     }
     ~ShuffleExchanger() override = default;
     Status sink(RuntimeState* state, vectorized::Block* in_block, SourceState source_state,
@@ -101,13 +151,13 @@ protected:
                      bool ignore_source_data_distribution)
             : Exchanger(running_sink_operators, num_sources, num_partitions),
               _ignore_source_data_distribution(ignore_source_data_distribution) {
-        _data_queue.resize(num_partitions);
+        _data_queue.init(num_partitions, running_sink_operators);
     }
     Status _split_rows(RuntimeState* state, const uint32_t* __restrict channel_ids,
                        vectorized::Block* block, SourceState source_state,
                        LocalExchangeSinkLocalState& local_state);
 
-    std::vector<moodycamel::ConcurrentQueue<PartitionedBlock>> _data_queue;
+    LocalExchangeQueues<PartitionedBlock> _data_queue;
 
     const bool _ignore_source_data_distribution = false;
 };
@@ -127,7 +177,7 @@ public:
     ENABLE_FACTORY_CREATOR(PassthroughExchanger);
     PassthroughExchanger(int running_sink_operators, int num_partitions)
             : Exchanger(running_sink_operators, num_partitions) {
-        _data_queue.resize(num_partitions);
+        _data_queue.init(num_partitions, running_sink_operators);
     }
     ~PassthroughExchanger() override = default;
     Status sink(RuntimeState* state, vectorized::Block* in_block, SourceState source_state,
@@ -138,7 +188,7 @@ public:
     ExchangeType get_type() const override { return ExchangeType::PASSTHROUGH; }
 
 private:
-    std::vector<moodycamel::ConcurrentQueue<vectorized::Block>> _data_queue;
+    LocalExchangeQueues<vectorized::Block> _data_queue;
 };
 
 class PassToOneExchanger final : public Exchanger {
@@ -146,7 +196,7 @@ public:
     ENABLE_FACTORY_CREATOR(PassToOneExchanger);
     PassToOneExchanger(int running_sink_operators, int num_partitions)
             : Exchanger(running_sink_operators, num_partitions) {
-        _data_queue.resize(num_partitions);
+        _data_queue.init(num_partitions, running_sink_operators);
     }
     ~PassToOneExchanger() override = default;
     Status sink(RuntimeState* state, vectorized::Block* in_block, SourceState source_state,
@@ -157,7 +207,7 @@ public:
     ExchangeType get_type() const override { return ExchangeType::PASS_TO_ONE; }
 
 private:
-    std::vector<moodycamel::ConcurrentQueue<vectorized::Block>> _data_queue;
+    LocalExchangeQueues<vectorized::Block> _data_queue;
 };
 
 class BroadcastExchanger final : public Exchanger {
@@ -165,7 +215,7 @@ public:
     ENABLE_FACTORY_CREATOR(BroadcastExchanger);
     BroadcastExchanger(int running_sink_operators, int num_partitions)
             : Exchanger(running_sink_operators, num_partitions) {
-        _data_queue.resize(num_partitions);
+        _data_queue.init(num_partitions, running_sink_operators);
     }
     ~BroadcastExchanger() override = default;
     Status sink(RuntimeState* state, vectorized::Block* in_block, SourceState source_state,
@@ -176,7 +226,7 @@ public:
     ExchangeType get_type() const override { return ExchangeType::BROADCAST; }
 
 private:
-    std::vector<moodycamel::ConcurrentQueue<vectorized::Block>> _data_queue;
+    LocalExchangeQueues<vectorized::Block> _data_queue;
 };
 
 //The code in AdaptivePassthroughExchanger is essentially
@@ -186,7 +236,7 @@ public:
     ENABLE_FACTORY_CREATOR(AdaptivePassthroughExchanger);
     AdaptivePassthroughExchanger(int running_sink_operators, int num_partitions)
             : Exchanger(running_sink_operators, num_partitions) {
-        _data_queue.resize(num_partitions);
+        _data_queue.init(num_partitions, running_sink_operators);
     }
     Status sink(RuntimeState* state, vectorized::Block* in_block, SourceState source_state,
                 LocalExchangeSinkLocalState& local_state) override;
@@ -203,7 +253,7 @@ private:
     Status _split_rows(RuntimeState* state, const uint32_t* __restrict channel_ids,
                        vectorized::Block* block, SourceState source_state,
                        LocalExchangeSinkLocalState& local_state);
-    std::vector<moodycamel::ConcurrentQueue<vectorized::Block>> _data_queue;
+    LocalExchangeQueues<vectorized::Block> _data_queue;
 
     std::atomic_bool _is_pass_through = false;
     std::atomic_int32_t _total_block = 0;
@@ -174,7 +174,11 @@ public:
     ThreadPool* s3_file_upload_thread_pool() { return _s3_file_upload_thread_pool.get(); }
     ThreadPool* send_report_thread_pool() { return _send_report_thread_pool.get(); }
     ThreadPool* join_node_thread_pool() { return _join_node_thread_pool.get(); }
+    ThreadPool* join_build_thread_pool() { return _join_build_thread_pool.get(); }
     ThreadPool* lazy_release_obj_pool() { return _lazy_release_obj_pool.get(); }
+    ThreadPool* segment_column_encode_thread_pool() {
+        return _segment_column_encode_thread_pool.get();
+    }
 
     Status init_pipeline_task_scheduler();
     void init_file_cache_factory();
@@ -315,8 +319,12 @@ private:
     std::unique_ptr<ThreadPool> _send_report_thread_pool;
     // Pool used by join node to build hash table
     std::unique_ptr<ThreadPool> _join_node_thread_pool;
+    // Pool used by hash joins to build large hash tables in parallel
+    std::unique_ptr<ThreadPool> _join_build_thread_pool;
     // Pool to use a new thread to release object
     std::unique_ptr<ThreadPool> _lazy_release_obj_pool;
+    // Pool used by segment writers to encode the columns of a flushed memtable in parallel
+    std::unique_ptr<ThreadPool> _segment_column_encode_thread_pool;
 
     FragmentMgr* _fragment_mgr = nullptr;
     pipeline::TaskScheduler* _without_group_task_scheduler = nullptr;
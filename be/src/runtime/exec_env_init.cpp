@@ -46,6 +46,7 @@
 #include "olap/olap_define.h"
 #include "olap/options.h"
 #include "olap/page_cache.h"
+#include "olap/page_disk_cache.h"
 #include "olap/rowset/segment_v2/inverted_index_cache.h"
 #include "olap/schema_cache.h"
 #include "olap/segment_loader.h"
@@ -193,11 +194,23 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths,
                               .set_max_threads(std::numeric_limits<int>::max())
                               .set_max_queue_size(config::fragment_pool_queue_size)
                               .build(&_join_node_thread_pool));
+    static_cast<void>(ThreadPoolBuilder("JoinBuildThreadPool")
+                              .set_min_threads(1)
+                              .set_max_threads(config::parallel_hash_join_build_thread_num > 0
+                                                       ? config::parallel_hash_join_build_thread_num
+                                                       : CpuInfo::num_cores())
+                              .build(&_join_build_thread_pool));
     static_cast<void>(ThreadPoolBuilder("LazyReleaseMemoryThreadPool")
                               .set_min_threads(1)
                               .set_max_threads(1)
                               .set_max_queue_size(1000000)
                               .build(&_lazy_release_obj_pool));
+    if (config::segment_column_encode_thread_num > 0) {
+        static_cast<void>(ThreadPoolBuilder("SegmentColumnEncodeThreadPool")
+                                  .set_min_threads(1)
+                                  .set_max_threads(config::segment_column_encode_thread_num)
+                                  .build(&_segment_column_encode_thread_pool));
+    }
 
     // NOTE: runtime query statistics mgr could be visited by query and daemon thread
     // so it should be created before all query begin and deleted after all query and daemon thread stoppped
@@ -419,6 +432,18 @@ Status ExecEnv::_init_mem_env() {
     LOG(INFO) << "Storage page cache memory limit: "
               << PrettyPrinter::print(storage_cache_limit, TUnit::BYTES)
               << ", origin config value: " << config::storage_page_cache_limit;
+    if (!config::page_disk_cache_path.empty()) {
+        auto disk_cache = std::make_unique<PageDiskCache>(
+                config::page_disk_cache_path, config::page_disk_cache_capacity,
+                config::page_disk_cache_slab_size, config::page_disk_cache_write_queue_bytes);
+        Status st = disk_cache->init();
+        if (st.ok()) {
+            _storage_page_cache->set_disk_cache(std::move(disk_cache));
+        } else {
+            LOG(WARNING) << "failed to init page disk cache on " << config::page_disk_cache_path
+                         << ", continue without it: " << st;
+        }
+    }
 
     // Init row cache
     int64_t row_cache_mem_limit =
@@ -561,7 +586,9 @@ void ExecEnv::destroy() {
     SAFE_SHUTDOWN(_buffered_reader_prefetch_thread_pool);
     SAFE_SHUTDOWN(_s3_file_upload_thread_pool);
     SAFE_SHUTDOWN(_join_node_thread_pool);
+    SAFE_SHUTDOWN(_join_build_thread_pool);
     SAFE_SHUTDOWN(_lazy_release_obj_pool);
+    SAFE_SHUTDOWN(_segment_column_encode_thread_pool);
     SAFE_SHUTDOWN(_send_report_thread_pool);
     SAFE_SHUTDOWN(_send_batch_thread_pool);
 
@@ -617,7 +644,9 @@ void ExecEnv::destroy() {
     SAFE_DELETE(_runtime_filter_timer_queue);
     // TODO(zhiqiang): Maybe we should call shutdown before release thread pool?
     _join_node_thread_pool.reset(nullptr);
+    _join_build_thread_pool.reset(nullptr);
     _lazy_release_obj_pool.reset(nullptr);
+    _segment_column_encode_thread_pool.reset(nullptr);
     _send_report_thread_pool.reset(nullptr);
     _buffered_reader_prefetch_thread_pool.reset(nullptr);
     _s3_file_upload_thread_pool.reset(nullptr);
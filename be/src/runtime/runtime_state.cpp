@@ -502,4 +502,21 @@ bool RuntimeState::enable_page_cache() const {
            (_query_options.__isset.enable_page_cache && _query_options.enable_page_cache);
 }
 
+Status RuntimeState::spill_compression_type(
+        segment_v2::CompressionTypePB* compression_type) const {
+    *compression_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
+    if (!_query_options.__isset.spill_compression_codec) {
+        return Status::OK();
+    }
+    const auto& codec = _query_options.spill_compression_codec;
+    if (codec == "lz4") {
+        *compression_type = segment_v2::CompressionTypePB::LZ4;
+    } else if (codec == "zstd") {
+        *compression_type = segment_v2::CompressionTypePB::ZSTD;
+    } else if (codec != "none") {
+        return Status::InvalidArgument("unknown spill compression codec: {}", codec);
+    }
+    return Status::OK();
+}
+
 } // end namespace doris
@@ -529,6 +529,34 @@ public:
                        : 0;
     }
 
+    int64_t external_join_bytes_threshold() const {
+        return _query_options.__isset.external_join_bytes_threshold
+                       ? _query_options.external_join_bytes_threshold
+                       : 0;
+    }
+
+    int32_t external_join_partition_bits() const {
+        return _query_options.__isset.external_join_partition_bits
+                       ? _query_options.external_join_partition_bits
+                       : 4;
+    }
+
+    int64_t external_analytic_bytes_threshold() const {
+        return _query_options.__isset.external_analytic_bytes_threshold
+                       ? _query_options.external_analytic_bytes_threshold
+                       : 0;
+    }
+
+    // Codec of the spilled blocks, none if spill_compression_codec is not set. The FE checks the
+    // codec name, an unknown one is an error rather than a silent fallback.
+    Status spill_compression_type(segment_v2::CompressionTypePB* compression_type) const;
+
+    int32_t parallel_hash_join_build_num() const {
+        return _query_options.__isset.parallel_hash_join_build_num
+                       ? _query_options.parallel_hash_join_build_num
+                       : 0;
+    }
+
     inline bool enable_delete_sub_pred_v2() const {
         return _query_options.__isset.enable_delete_sub_predicate_v2 &&
                _query_options.enable_delete_sub_predicate_v2;
@@ -0,0 +1,145 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace doris {
+
+// Bit packing of blocks of 128 unsigned integers in the "vertical" layout of BP128,
+// see https://arxiv.org/abs/1209.2137 (Lemire, Boytsov: Decoding billions of integers
+// per second through vectorization).
+//
+// A block is split into LANES = 128 / WORD_BITS interleaved lanes: value i belongs to
+// lane i % LANES. Every lane packs its WORD_BITS values with `bit_width` bits each into
+// exactly `bit_width` words, and word j of lane l is stored at index j * LANES + l.
+// So the k-th values of all lanes share the same word index and shift, and unpacking
+// them is the same scalar operation on LANES adjacent words, which the compiler turns
+// into SIMD loads, shifts and masks (4 x uint32_t or 2 x uint64_t per 128-bit register).
+//
+// The kernels are instantiated for every bit width, so all shifts are constants.
+template <typename Word>
+class BP128 {
+public:
+    static constexpr size_t BLOCK_SIZE = 128;
+    static constexpr int WORD_BITS = sizeof(Word) * 8;
+    static constexpr size_t LANES = BLOCK_SIZE / WORD_BITS;
+
+    // Number of words of a packed block.
+    static constexpr size_t packed_words(int bit_width) { return bit_width * LANES; }
+
+    // Pack the lower `bit_width` bits of the 128 values of `in` into
+    // packed_words(bit_width) words of `out`. The higher bits of `in` must be zero.
+    static void pack(int bit_width, const Word* __restrict in, Word* __restrict out) {
+        static constexpr auto packers = _packers(std::make_index_sequence<WORD_BITS + 1>());
+        packers[bit_width](in, out);
+    }
+
+    // Unpack 128 values packed by pack() with `bit_width`.
+    static void unpack(int bit_width, const Word* __restrict in, Word* __restrict out) {
+        static constexpr auto unpackers = _unpackers(std::make_index_sequence<WORD_BITS + 1>());
+        unpackers[bit_width](in, out);
+    }
+
+private:
+    using Kernel = void (*)(const Word* __restrict, Word* __restrict);
+
+    template <int BitWidth>
+    static constexpr Word mask() {
+        if constexpr (BitWidth == WORD_BITS) {
+            return ~Word(0);
+        } else {
+            return (Word(1) << BitWidth) - 1;
+        }
+    }
+
+    template <int BitWidth, size_t K>
+    static inline void _pack_one(const Word* __restrict in, Word* __restrict out) {
+        constexpr size_t bit = K * BitWidth;
+        constexpr size_t word = bit / WORD_BITS;
+        constexpr int shift = bit % WORD_BITS;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            Word v = in[K * LANES + lane];
+            out[word * LANES + lane] |= v << shift;
+            if constexpr (shift + BitWidth > WORD_BITS) {
+                out[(word + 1) * LANES + lane] |= v >> (WORD_BITS - shift);
+            }
+        }
+    }
+
+    template <int BitWidth, size_t K>
+    static inline void _unpack_one(const Word* __restrict in, Word* __restrict out) {
+        constexpr size_t bit = K * BitWidth;
+        constexpr size_t word = bit / WORD_BITS;
+        constexpr int shift = bit % WORD_BITS;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            Word v = in[word * LANES + lane] >> shift;
+            if constexpr (shift + BitWidth > WORD_BITS) {
+                v |= in[(word + 1) * LANES + lane] << (WORD_BITS - shift);
+            }
+            out[K * LANES + lane] = v & mask<BitWidth>();
+        }
+    }
+
+    template <int BitWidth, size_t... K>
+    static void _pack(const Word* __restrict in, Word* __restrict out,
+                      std::index_sequence<K...>) {
+        memset(out, 0, packed_words(BitWidth) * sizeof(Word));
+        (_pack_one<BitWidth, K>(in, out), ...);
+    }
+
+    template <int BitWidth, size_t... K>
+    static void _unpack(const Word* __restrict in, Word* __restrict out,
+                        std::index_sequence<K...>) {
+        (_unpack_one<BitWidth, K>(in, out), ...);
+    }
+
+    template <int BitWidth>
+    static void _pack_kernel(const Word* __restrict in, Word* __restrict out) {
+        if constexpr (BitWidth > 0) {
+            _pack<BitWidth>(in, out, std::make_index_sequence<WORD_BITS>());
+        }
+    }
+
+    template <int BitWidth>
+    static void _unpack_kernel(const Word* __restrict in, Word* __restrict out) {
+        if constexpr (BitWidth == 0) {
+            memset(out, 0, BLOCK_SIZE * sizeof(Word));
+        } else {
+            _unpack<BitWidth>(in, out, std::make_index_sequence<WORD_BITS>());
+        }
+    }
+
+    template <size_t... BitWidth>
+    static constexpr std::array<Kernel, WORD_BITS + 1> _packers(std::index_sequence<BitWidth...>) {
+        return {&_pack_kernel<BitWidth>...};
+    }
+
+    template <size_t... BitWidth>
+    static constexpr std::array<Kernel, WORD_BITS + 1> _unpackers(
+            std::index_sequence<BitWidth...>) {
+        return {&_unpack_kernel<BitWidth>...};
+    }
+};
+
+} // namespace doris
@@ -0,0 +1,152 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace doris {
+
+// A tournament tree of losers for k-way merging.
+//
+// Every internal node keeps the loser of the match between the winners of its two subtrees,
+// so when the top (the overall winner) moves to its next value, only the log(k) matches on
+// the path from its leaf to the root are replayed, each with a single comparison, while a
+// binary heap needs two comparisons per level to sift down.
+//
+// `Compare` follows the convention of std::priority_queue: comp(a, b) returns true if `a` comes
+// out after `b`, so the top is the "largest" value.
+//
+// The tree does not look into the values, so the value of the top may be changed in place.
+// After that, update_top() must be called, unless the new value still comes out before the
+// runner_up(), in which case the top and the runner up stay the same.
+template <typename T, typename Compare>
+class LoserTree {
+public:
+    LoserTree(std::vector<T> values, const Compare& comp)
+            : _values(std::move(values)),
+              _comp(comp),
+              _num_leaves(_values.size()),
+              _size(_values.size()),
+              _removed(_values.size(), false),
+              _nodes(std::max<size_t>(_values.size(), 1), 0) {
+        _build();
+    }
+
+    bool empty() const { return _size == 0; }
+
+    size_t size() const { return _size; }
+
+    T& top() {
+        DCHECK(!empty());
+        return _values[_nodes[0]];
+    }
+
+    // index of the top in the values the tree is built from
+    size_t top_index() const { return _nodes[0]; }
+
+    // Replay the matches of the top after its value has changed.
+    void update_top() { _replay(_nodes[0]); }
+
+    // Remove the top, the value of it is reset.
+    void remove_top() {
+        DCHECK(!empty());
+        size_t leaf = _nodes[0];
+        _values[leaf] = T();
+        _removed[leaf] = true;
+        --_size;
+        _replay(leaf);
+    }
+
+    // The value which would be the top if the top was removed, only valid if size() > 1.
+    // It is computed when it is asked for the first time after the tree has changed.
+    T& runner_up() {
+        DCHECK_GT(_size, 1);
+        if (!_runner_up_valid) {
+            // all the other values have lost to one of the losers on the path of the top
+            size_t top = _nodes[0];
+            size_t best = _num_leaves;
+            for (size_t node = (_num_leaves + top) / 2; node > 0; node /= 2) {
+                if (best == _num_leaves || _beats(_nodes[node], best)) {
+                    best = _nodes[node];
+                }
+            }
+            _runner_up = best;
+            _runner_up_valid = true;
+        }
+        return _values[_runner_up];
+    }
+
+private:
+    // whether the value at leaf `a` comes out before the value at leaf `b`
+    bool _beats(size_t a, size_t b) {
+        if (_removed[a] || _removed[b]) {
+            return !_removed[a];
+        }
+        return _comp(_values[b], _values[a]);
+    }
+
+    // Leaf i is at position _num_leaves + i, the parent of position p is p / 2, position 0
+    // keeps the overall winner.
+    void _build() {
+        if (_num_leaves <= 1) {
+            return;
+        }
+        std::vector<size_t> winners(_num_leaves * 2);
+        for (size_t i = 0; i < _num_leaves; ++i) {
+            winners[_num_leaves + i] = i;
+        }
+        for (size_t node = _num_leaves - 1; node > 0; --node) {
+            size_t left = winners[node * 2];
+            size_t right = winners[node * 2 + 1];
+            if (_beats(right, left)) {
+                std::swap(left, right);
+            }
+            winners[node] = left;
+            _nodes[node] = right;
+        }
+        _nodes[0] = winners[1];
+    }
+
+    void _replay(size_t leaf) {
+        size_t winner = leaf;
+        for (size_t node = (_num_leaves + leaf) / 2; node > 0; node /= 2) {
+            if (_beats(_nodes[node], winner)) {
+                std::swap(_nodes[node], winner);
+            }
+        }
+        _nodes[0] = winner;
+        _runner_up_valid = false;
+    }
+
+    std::vector<T> _values;
+    Compare _comp;
+    size_t _num_leaves;
+    size_t _size;
+    std::vector<bool> _removed;
+    std::vector<size_t> _nodes;
+
+    size_t _runner_up = 0;
+    bool _runner_up_valid = false;
+};
+
+} // namespace doris
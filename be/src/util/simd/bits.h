@@ -55,6 +55,33 @@ inline uint32_t bytes32_mask_to_bits32_mask(const bool* data) {
     return bytes32_mask_to_bits32_mask(reinterpret_cast<const uint8_t*>(data));
 }
 
+/// Bit i of the result is set if data[i] equals byte, for the 64 bytes from data.
+inline uint64_t bytes64_eq_mask(const uint8_t* data, uint8_t byte) {
+#ifdef __AVX2__
+    const auto target32 = _mm256_set1_epi8(static_cast<char>(byte));
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                   _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), target32)))) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)), target32))))
+            << 32u);
+#elif defined(__SSE2__) || defined(__aarch64__)
+    const auto target16 = _mm_set1_epi8(static_cast<char>(byte));
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; i += 16) {
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), target16))))
+                << i;
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; ++i) {
+        mask |= static_cast<uint64_t>(data[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
 inline size_t count_zero_num(const int8_t* __restrict data, size_t size) {
     size_t num = 0;
     const int8_t* end = data + size;
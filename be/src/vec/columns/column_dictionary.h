@@ -290,11 +290,6 @@ public:
 
     uint32_t get_hash_value(uint32_t idx) const { return _dict.get_hash_value(_codes[idx], _type); }
 
-    template <typename HybridSetType>
-    void find_codes(const HybridSetType* values, std::vector<vectorized::UInt8>& selected) const {
-        return _dict.find_codes(values, selected);
-    }
-
     void set_rowset_segment_id(std::pair<RowsetId, uint32_t> rowset_segment_id) override {
         _rowset_segment_id = rowset_segment_id;
     }
@@ -439,19 +434,6 @@ public:
             return greater ? bound - greater + eq : bound - eq;
         }
 
-        template <typename HybridSetType>
-        void find_codes(const HybridSetType* values,
-                        std::vector<vectorized::UInt8>& selected) const {
-            size_t dict_word_num = _dict_data->size();
-            selected.resize(dict_word_num);
-            selected.assign(dict_word_num, false);
-            for (size_t i = 0; i < _dict_data->size(); i++) {
-                if (values->find(&((*_dict_data)[i]))) {
-                    selected[i] = true;
-                }
-            }
-        }
-
         void clear() {
             _dict_data->clear();
             _code_convert_table.clear();
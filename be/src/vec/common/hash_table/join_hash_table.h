@@ -19,6 +19,11 @@
 
 #include <gen_cpp/PlanNodes_types.h>
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
 #include "vec/columns/column_filter_helper.h"
 #include "vec/common/hash_table/hash.h"
 #include "vec/common/hash_table/hash_table.h"
@@ -73,16 +78,95 @@ public:
                size_t num_elem) {
         build_keys = keys;
         for (size_t i = 1; i < num_elem; i++) {
+            if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_elem)) {
+                __builtin_prefetch(&first[bucket_nums[i + HASH_MAP_PREFETCH_DIST]], 1, 1);
+            }
             uint32_t bucket_num = bucket_nums[i];
             next[i] = first[bucket_num];
             first[bucket_num] = i;
         }
-        if constexpr ((JoinOpType != TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN &&
-                       JoinOpType != TJoinOp::NULL_AWARE_LEFT_SEMI_JOIN) ||
-                      !with_other_conjuncts) {
-            /// Only null aware join with other conjuncts need to access the null value in hash table
-            first[bucket_size] = 0; // index = bucket_num means null
+        _finish_build<JoinOpType, with_other_conjuncts>();
+    }
+
+    /**
+     * Build the hash table by `num_tasks` tasks, `parallel_for(num_tasks, task)` runs task(i) for
+     * every i in [0, num_tasks) concurrently and returns after all of them are done.
+     *
+     * The build rows are radix partitioned by the top bits of their buckets, so a partition owns
+     * a contiguous range of `first` which stays in the cache while the partition is built. The
+     * partitions are built without synchronization, and the rows of a partition are inserted in
+     * their order, so the chains are the same as those of a serial build and probing does not
+     * change.
+     */
+    template <int JoinOpType, bool with_other_conjuncts, typename ParallelFor>
+    void build_parallel(const Key* __restrict keys, const uint32_t* __restrict bucket_nums,
+                        size_t num_elem, size_t num_tasks, ParallelFor&& parallel_for) {
+        build_keys = keys;
+        const size_t bucket_bits = __builtin_ctz(bucket_size);
+        size_t partition_bits = 0;
+        while (partition_bits < bucket_bits &&
+               ((bucket_size >> partition_bits) > PARALLEL_BUILD_PARTITION_BUCKETS ||
+                (1UL << partition_bits) < num_tasks * 4)) {
+            ++partition_bits;
         }
+        const size_t num_partitions = 1UL << partition_bits;
+        const size_t shift = bucket_bits - partition_bits;
+        // the bucket of null keys is `bucket_size`, it is in the last partition
+        auto partition_of = [&](uint32_t bucket_num) {
+            return std::min<size_t>(bucket_num >> shift, num_partitions - 1);
+        };
+
+        // the first row is mocked, the tasks count and scatter the rows of their ranges
+        const size_t rows_per_task = (num_elem - 1 + num_tasks - 1) / num_tasks;
+        auto task_rows = [&](size_t task) {
+            size_t begin = std::min(num_elem, 1 + task * rows_per_task);
+            return std::pair {begin, std::min(num_elem, begin + rows_per_task)};
+        };
+        std::vector<uint32_t> offsets(num_tasks * num_partitions, 0);
+        parallel_for(num_tasks, [&](size_t task) {
+            uint32_t* counts = offsets.data() + task * num_partitions;
+            auto [begin, end] = task_rows(task);
+            for (size_t i = begin; i < end; ++i) {
+                counts[partition_of(bucket_nums[i])]++;
+            }
+        });
+
+        // the rows of a partition are ordered by the tasks, then by the rows of a task
+        std::vector<uint32_t> partition_offsets(num_partitions + 1);
+        uint32_t offset = 0;
+        for (size_t partition = 0; partition < num_partitions; ++partition) {
+            partition_offsets[partition] = offset;
+            for (size_t task = 0; task < num_tasks; ++task) {
+                uint32_t count = offsets[task * num_partitions + partition];
+                offsets[task * num_partitions + partition] = offset;
+                offset += count;
+            }
+        }
+        partition_offsets[num_partitions] = offset;
+
+        std::vector<uint32_t> rows(offset);
+        parallel_for(num_tasks, [&](size_t task) {
+            uint32_t* cursors = offsets.data() + task * num_partitions;
+            auto [begin, end] = task_rows(task);
+            for (size_t i = begin; i < end; ++i) {
+                rows[cursors[partition_of(bucket_nums[i])]++] = i;
+            }
+        });
+
+        std::atomic<size_t> next_partition = 0;
+        parallel_for(num_tasks, [&](size_t /*task*/) {
+            for (size_t partition = next_partition++; partition < num_partitions;
+                 partition = next_partition++) {
+                for (uint32_t j = partition_offsets[partition];
+                     j < partition_offsets[partition + 1]; ++j) {
+                    uint32_t i = rows[j];
+                    uint32_t bucket_num = bucket_nums[i];
+                    next[i] = first[bucket_num];
+                    first[bucket_num] = i;
+                }
+            }
+        });
+        _finish_build<JoinOpType, with_other_conjuncts>();
     }
 
     template <int JoinOpType, bool with_other_conjuncts, bool is_mark_join, bool need_judge_null>
@@ -186,6 +270,7 @@ public:
         }
 
         while (probe_idx < probe_rows && matched_cnt < batch_size) {
+            _prefetch_build_rows<false>(build_idx_map, probe_idx, probe_rows);
             build_idx = build_idx_map[probe_idx];
 
             /// If the probe key is null
@@ -227,19 +312,74 @@ public:
 
     bool has_null_key() { return _has_null_key; }
 
+    // Replace the bucket numbers of the probe rows with the first build rows of their buckets.
+    // The buckets a few rows ahead are prefetched, `first` is too large for the cache when the
+    // build side is large.
     void pre_build_idxs(std::vector<uint32>& buckets, const uint8_t* null_map) {
+        const size_t num_rows = buckets.size();
         if (null_map) {
-            for (unsigned int& bucket : buckets) {
-                bucket = bucket == bucket_size ? bucket_size : first[bucket];
+            for (size_t i = 0; i < num_rows; ++i) {
+                if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                    __builtin_prefetch(&first[buckets[i + HASH_MAP_PREFETCH_DIST]], 0, 1);
+                }
+                buckets[i] = buckets[i] == bucket_size ? bucket_size : first[buckets[i]];
             }
         } else {
-            for (unsigned int& bucket : buckets) {
-                bucket = first[bucket];
+            for (size_t i = 0; i < num_rows; ++i) {
+                if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                    __builtin_prefetch(&first[buckets[i + HASH_MAP_PREFETCH_DIST]], 0, 1);
+                }
+                buckets[i] = first[buckets[i]];
             }
         }
     }
 
 private:
+    // number of buckets of a partition of a parallel build, `first` of them takes 256KB
+    static constexpr size_t PARALLEL_BUILD_PARTITION_BUCKETS = 65536;
+
+    template <int JoinOpType, bool with_other_conjuncts>
+    void _finish_build() {
+        if constexpr ((JoinOpType != TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN &&
+                       JoinOpType != TJoinOp::NULL_AWARE_LEFT_SEMI_JOIN) ||
+                      !with_other_conjuncts) {
+            /// Only null aware join with other conjuncts need to access the null value in hash table
+            first[bucket_size] = 0; // index = bucket_num means null
+        }
+    }
+
+    // Probing is a chain of dependent loads: the first build row of a bucket, then its key and
+    // its next row. The rows of the probe row `HASH_MAP_PREFETCH_DIST` ahead are prefetched, and
+    // the second rows of the chains of the probe row half as far ahead, whose `next` has been
+    // prefetched already. Null probe rows are marked by `bucket_size`, which is not a build row.
+    template <bool with_visited>
+    ALWAYS_INLINE void _prefetch_build_rows(const uint32_t* __restrict build_idx_map,
+                                            int probe_idx, int probe_rows) const {
+        if (LIKELY(probe_idx + HASH_MAP_PREFETCH_DIST < probe_rows)) {
+            uint32_t build_idx = build_idx_map[probe_idx + HASH_MAP_PREFETCH_DIST];
+            if (build_idx && build_idx < next.size()) {
+                __builtin_prefetch(&build_keys[build_idx], 0, 1);
+                __builtin_prefetch(&next[build_idx], 0, 1);
+                if constexpr (with_visited) {
+                    __builtin_prefetch(&visited[build_idx], 1, 1);
+                }
+            }
+        }
+        if (LIKELY(probe_idx + HASH_MAP_PREFETCH_DIST / 2 < probe_rows)) {
+            uint32_t build_idx = build_idx_map[probe_idx + HASH_MAP_PREFETCH_DIST / 2];
+            if (build_idx && build_idx < next.size() && next[build_idx]) {
+                __builtin_prefetch(&build_keys[next[build_idx]], 0, 1);
+                __builtin_prefetch(&next[next[build_idx]], 0, 1);
+            }
+        }
+    }
+
+    template <int JoinOpType>
+    static constexpr bool _need_visited() {
+        return JoinOpType == TJoinOp::RIGHT_OUTER_JOIN || JoinOpType == TJoinOp::FULL_OUTER_JOIN ||
+               JoinOpType == TJoinOp::RIGHT_ANTI_JOIN || JoinOpType == TJoinOp::RIGHT_SEMI_JOIN;
+    }
+
     template <int JoinOpType, bool with_other_conjuncts, bool is_mark_join>
     auto _process_null_aware_left_anti_join_for_empty_build_side(int probe_idx, int probe_rows,
                                                                  uint32_t* __restrict probe_idxs,
@@ -261,6 +401,7 @@ private:
                                      const uint32_t* __restrict build_idx_map, int probe_idx,
                                      int probe_rows) {
         while (probe_idx < probe_rows) {
+            _prefetch_build_rows<true>(build_idx_map, probe_idx, probe_rows);
             auto build_idx = build_idx_map[probe_idx];
 
             while (build_idx) {
@@ -282,6 +423,7 @@ private:
         const auto batch_size = max_batch_size;
 
         while (probe_idx < probe_rows && matched_cnt < batch_size) {
+            _prefetch_build_rows<false>(build_idx_map, probe_idx, probe_rows);
             if constexpr (need_judge_null) {
                 if (build_idx_map[probe_idx] == bucket_size) {
                     probe_idx++;
@@ -357,6 +499,8 @@ private:
         }
 
         while (probe_idx < probe_rows && matched_cnt < batch_size) {
+            _prefetch_build_rows<_need_visited<JoinOpType>()>(build_idx_map, probe_idx,
+                                                             probe_rows);
             build_idx = build_idx_map[probe_idx];
             do_the_probe();
         }
@@ -411,6 +555,8 @@ private:
         }
 
         while (probe_idx < probe_rows && matched_cnt < batch_size) {
+            _prefetch_build_rows<_need_visited<JoinOpType>()>(build_idx_map, probe_idx,
+                                                             probe_rows);
             build_idx = build_idx_map[probe_idx];
             do_the_probe();
         }
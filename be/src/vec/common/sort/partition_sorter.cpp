@@ -23,6 +23,8 @@
 #include <queue>
 
 #include "common/object_pool.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
 #include "vec/core/block.h"
 #include "vec/core/sort_cursor.h"
 #include "vec/functions/function_binary_arithmetic.h"
@@ -47,7 +49,13 @@ PartitionSorter::PartitionSorter(VSortExecExprs& vsort_exec_exprs, int limit, in
                                  bool has_global_limit, int partition_inner_limit,
                                  TopNAlgorithm::type top_n_algorithm, SortCursorCmp* previous_row)
         : Sorter(vsort_exec_exprs, limit, offset, pool, is_asc_order, nulls_first),
-          _state(MergeSorterState::create_unique(row_desc, offset, limit, state, profile)),
+          _spill_profile(profile == nullptr && state->external_sort_bytes_threshold() > 0
+                                 ? std::make_unique<RuntimeProfile>("PartitionSorter")
+                                 : nullptr),
+          // partition_sort_read() applies the limit of the partition, the merger of the spilled
+          // blocks must return all the rows
+          _state(MergeSorterState::create_unique(
+                  row_desc, 0, -1, state, profile != nullptr ? profile : _spill_profile.get())),
           _row_desc(row_desc),
           _has_global_limit(has_global_limit),
           _partition_inner_limit(partition_inner_limit),
@@ -63,6 +71,9 @@ Status PartitionSorter::append_block(Block* input_block) {
 }
 
 Status PartitionSorter::prepare_for_read() {
+    if (_state->is_spilled()) {
+        return _state->build_merge_tree(_sort_description);
+    }
     auto& cursors = _state->get_cursors();
     auto& blocks = _state->get_sorted_block();
     auto& priority_queue = _state->get_priority_queue();
@@ -76,7 +87,9 @@ Status PartitionSorter::prepare_for_read() {
 }
 
 Status PartitionSorter::get_next(RuntimeState* state, Block* block, bool* eos) {
-    if (_state->get_sorted_block().empty()) {
+    if (_state->is_spilled()) {
+        RETURN_IF_ERROR(_read_spilled(state, block, eos));
+    } else if (_state->get_sorted_block().empty()) {
         *eos = true;
     } else {
         if (_state->get_sorted_block().size() == 1 && _has_global_limit) {
@@ -91,8 +104,38 @@ Status PartitionSorter::get_next(RuntimeState* state, Block* block, bool* eos) {
     return Status::OK();
 }
 
+Status PartitionSorter::_read_spilled(RuntimeState* state, Block* block, bool* eos) {
+    auto& priority_queue = _state->get_priority_queue();
+    if (priority_queue.empty()) {
+        if (_merger_eos) {
+            *eos = true;
+            return Status::OK();
+        }
+        // The rows read so far are all peers of `_previous_row`, so it can point to the last one
+        // of them and only the block before the next one is kept.
+        if (_previous_row->impl != nullptr && _merged_cursor != nullptr) {
+            _previous_row->impl = _merged_cursor.get();
+            _previous_row->row = _merged_block->rows() - 1;
+        }
+        _previous_merged_block = std::move(_merged_block);
+        _previous_merged_cursor = std::move(_merged_cursor);
+        _merged_block = Block::create_unique();
+        while (_merged_block->rows() == 0 && !_merger_eos) {
+            RETURN_IF_ERROR(_state->merge_sort_read(state, _merged_block.get(), &_merger_eos));
+        }
+        if (_merged_block->rows() == 0) {
+            *eos = true;
+            return Status::OK();
+        }
+        _merged_cursor = std::make_unique<MergeSortCursorImpl>(*_merged_block, _sort_description);
+        priority_queue.push(MergeSortCursor(_merged_cursor.get()));
+    }
+    return partition_sort_read(block, eos, state->batch_size());
+}
+
 Status PartitionSorter::partition_sort_read(Block* output_block, bool* eos, int batch_size) {
-    const auto& sorted_block = _state->get_sorted_block()[0];
+    const auto& sorted_block =
+            _state->is_spilled() ? *_merged_block : _state->get_sorted_block()[0];
     size_t num_columns = sorted_block.columns();
     MutableBlock m_block =
             VectorizedUtils::build_mutable_mem_reuse_block(output_block, sorted_block);
@@ -192,7 +235,8 @@ Status PartitionSorter::partition_sort_read(Block* output_block, bool* eos, int
     }
 
     _output_total_rows += output_block->rows();
-    if (current_output_rows == 0 || get_enough_data == true) {
+    // the spilled rows are read one merged block at a time, they end when the merger does
+    if (get_enough_data == true || (current_output_rows == 0 && !_state->is_spilled())) {
         *eos = true;
     }
     return Status::OK();
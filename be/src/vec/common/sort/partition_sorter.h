@@ -90,12 +90,19 @@ public:
 
     size_t data_size() const override { return _state->data_size(); }
 
-    bool is_spilled() const override { return false; }
+    bool is_spilled() const override { return _state->is_spilled(); }
 
     Status partition_sort_read(Block* block, bool* eos, int batch_size);
     int64 get_output_rows() const { return _output_total_rows; }
 
 private:
+    // Reads the merged spilled rows back block by block, and applies the partition limit to
+    // them like to the sorted blocks in memory.
+    Status _read_spilled(RuntimeState* state, Block* block, bool* eos);
+
+    // Only the sorter of the first partition reports to the node profile, the others spill with
+    // a profile of their own.
+    std::unique_ptr<RuntimeProfile> _spill_profile;
     std::unique_ptr<MergeSorterState> _state;
     const RowDescriptor& _row_desc;
     int64 _output_total_rows = 0;
@@ -104,6 +111,14 @@ private:
     int _partition_inner_limit = 0;
     TopNAlgorithm::type _top_n_algorithm = TopNAlgorithm::type::ROW_NUMBER;
     SortCursorCmp* _previous_row = nullptr;
+
+    // The block read back from the spilled rows, and the one before it which `_previous_row`
+    // may still point to.
+    std::unique_ptr<Block> _merged_block;
+    std::unique_ptr<MergeSortCursorImpl> _merged_cursor;
+    std::unique_ptr<Block> _previous_merged_block;
+    std::unique_ptr<MergeSortCursorImpl> _previous_merged_cursor;
+    bool _merger_eos = false;
 };
 
 } // namespace doris::vectorized
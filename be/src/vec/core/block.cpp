@@ -87,6 +87,9 @@ Status Block::deserialize(const PBlock& pblock) {
     swap(Block());
     int be_exec_version = pblock.has_be_exec_version() ? pblock.be_exec_version() : 0;
     CHECK(BeExecVersionManager::check_be_exec_version(be_exec_version));
+    if (pblock.columns_size() > 0) {
+        return _deserialize_by_column(pblock);
+    }
 
     const char* buf = nullptr;
     std::string compression_scratch;
@@ -131,6 +134,41 @@ Status Block::deserialize(const PBlock& pblock) {
     return Status::OK();
 }
 
+Status Block::_deserialize_by_column(const PBlock& pblock) {
+    if (pblock.columns_size() != pblock.column_metas_size()) {
+        return Status::InternalError("PBlock has {} column metas but {} columns",
+                                     pblock.column_metas_size(), pblock.columns_size());
+    }
+    _decompressed_bytes = 0;
+    // the columns are decoded one by one, so that the scratch only holds the largest column
+    std::string compression_scratch;
+    for (int i = 0; i < pblock.column_metas_size(); ++i) {
+        const auto& pcol_meta = pblock.column_metas(i);
+        const auto& pcolumn = pblock.columns(i);
+        const char* buf = pcolumn.values().data();
+        if (pcolumn.compression_type() != segment_v2::NO_COMPRESSION) {
+            SCOPED_RAW_TIMER(&_decompress_time_ns);
+            BlockCompressionCodec* codec;
+            RETURN_IF_ERROR(get_block_compression_codec(pcolumn.compression_type(), &codec));
+            const size_t uncompressed_size = pcolumn.uncompressed_size();
+            // the serialized values are padded for streamvbyte, which reads past their end
+            compression_scratch.resize(uncompressed_size + STREAMVBYTE_PADDING);
+            Slice decompressed_slice(compression_scratch.data(), uncompressed_size);
+            RETURN_IF_ERROR(codec->decompress(Slice(pcolumn.values()), &decompressed_slice));
+            DCHECK(uncompressed_size == decompressed_slice.size);
+            _decompressed_bytes += uncompressed_size;
+            buf = compression_scratch.data();
+        }
+        DataTypePtr type = DataTypeFactory::instance().create_data_type(pcol_meta);
+        MutableColumnPtr data_column = type->create_column();
+        type->deserialize(buf, data_column.get(), pblock.be_exec_version());
+        data.emplace_back(data_column->get_ptr(), type, pcol_meta.name());
+    }
+    initialize_index_by_name();
+
+    return Status::OK();
+}
+
 void Block::reserve(size_t count) {
     index_by_name.reserve(count);
     data.reserve(count);
@@ -906,6 +944,80 @@ Status Block::serialize(int be_exec_version, PBlock* pblock,
     return Status::OK();
 }
 
+// Columns serialized into fewer bytes than this are not worth compressing.
+static constexpr size_t COLUMN_COMPRESSION_MIN_BYTES = 4 * 1024;
+// Bytes at the head of a column compressed to tell whether the column compresses.
+static constexpr size_t COLUMN_COMPRESSION_SAMPLE_BYTES = 64 * 1024;
+// A column is compressed only if its sample shrinks below this ratio, already random data
+// such as hashes or ids costs codec time on both sides for nothing.
+static constexpr double COLUMN_COMPRESSION_MAX_RATIO = 0.9;
+
+Status Block::serialize_by_column(int be_exec_version, PBlock* pblock,
+                                  size_t* uncompressed_bytes, size_t* compressed_bytes,
+                                  segment_v2::CompressionTypePB compression_type) const {
+    pblock->set_be_exec_version(be_exec_version);
+    BlockCompressionCodec* codec = nullptr;
+    if (compression_type != segment_v2::NO_COMPRESSION) {
+        RETURN_IF_ERROR(get_block_compression_codec(compression_type, &codec));
+    }
+
+    *uncompressed_bytes = 0;
+    *compressed_bytes = 0;
+    faststring buf_compressed;
+    for (const auto& c : *this) {
+        PColumnMeta* pcm = pblock->add_column_metas();
+        c.to_pb_column_meta(pcm);
+        DCHECK(pcm->type() != PGenericType::UNKNOWN) << " forget to set pb type";
+
+        const size_t content_uncompressed_size =
+                c.type->get_uncompressed_serialized_bytes(*(c.column), be_exec_version);
+        std::string column_values;
+        try {
+            column_values.resize(content_uncompressed_size + STREAMVBYTE_PADDING);
+        } catch (...) {
+            std::string msg = fmt::format("Try to alloc {} bytes for column values failed.",
+                                          content_uncompressed_size);
+            LOG(WARNING) << msg;
+            return Status::BufferAllocFailed(msg);
+        }
+        const char* end = c.type->serialize(*(c.column), column_values.data(), be_exec_version);
+        const size_t serialize_bytes = end - column_values.data();
+        *uncompressed_bytes += content_uncompressed_size;
+
+        PColumnValues* pcolumn = pblock->add_columns();
+        bool compressed = false;
+        if (codec != nullptr && serialize_bytes >= COLUMN_COMPRESSION_MIN_BYTES) {
+            SCOPED_RAW_TIMER(&_compress_time_ns);
+            const size_t sample_bytes = std::min(serialize_bytes, COLUMN_COMPRESSION_SAMPLE_BYTES);
+            RETURN_IF_ERROR_OR_CATCH_EXCEPTION(
+                    codec->compress(Slice(column_values.data(), sample_bytes), &buf_compressed));
+            if (buf_compressed.size() < sample_bytes * COLUMN_COMPRESSION_MAX_RATIO) {
+                if (sample_bytes < serialize_bytes) {
+                    RETURN_IF_ERROR_OR_CATCH_EXCEPTION(codec->compress(
+                            Slice(column_values.data(), serialize_bytes), &buf_compressed));
+                }
+                compressed = buf_compressed.size() < serialize_bytes;
+            }
+        }
+        if (compressed) {
+            pcolumn->set_compression_type(compression_type);
+            pcolumn->set_uncompressed_size(serialize_bytes);
+            pcolumn->set_values(buf_compressed.data(), buf_compressed.size());
+            *compressed_bytes += buf_compressed.size();
+        } else {
+            column_values.resize(serialize_bytes + STREAMVBYTE_PADDING);
+            pcolumn->set_values(std::move(column_values));
+            *compressed_bytes += serialize_bytes;
+        }
+    }
+
+    if (*compressed_bytes >= std::numeric_limits<int32_t>::max()) {
+        return Status::InternalError("The block is large than 2GB({}), can not send by Protobuf.",
+                                     *compressed_bytes);
+    }
+    return Status::OK();
+}
+
 MutableBlock::MutableBlock(const std::vector<TupleDescriptor*>& tuple_descs, int reserve_size,
                            bool ignore_trivial_slot) {
     for (auto* const tuple_desc : tuple_descs) {
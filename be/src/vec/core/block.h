@@ -283,6 +283,13 @@ public:
                      size_t* compressed_bytes, segment_v2::CompressionTypePB compression_type,
                      bool allow_transfer_large_data = false) const;
 
+    // Serialize block to PBlock column by column. Every column is compressed on its own,
+    // unless a sample of it shows that it does not compress. The values are not in
+    // column_values, so the block can not be sent as a large http attachment.
+    Status serialize_by_column(int be_exec_version, PBlock* pblock, size_t* uncompressed_bytes,
+                               size_t* compressed_bytes,
+                               segment_v2::CompressionTypePB compression_type) const;
+
     Status deserialize(const PBlock& pblock);
 
     std::unique_ptr<Block> create_same_struct_block(size_t size, bool is_reserve = false) const;
@@ -377,6 +384,7 @@ public:
 
 private:
     void erase_impl(size_t position);
+    Status _deserialize_by_column(const PBlock& pblock);
 };
 
 using Blocks = std::vector<Block>;
@@ -57,6 +57,12 @@ public:
 
     int64_t get_id() const { return stream_id_; }
 
+    // Compress the blocks written after, BlockSpillReader decompresses them by the codec
+    // recorded in each block.
+    void set_compression_type(segment_v2::CompressionTypePB compression_type) {
+        compression_type_ = compression_type;
+    }
+
     size_t get_written_bytes() const { return total_written_bytes_; }
 
 private:
@@ -77,6 +83,7 @@ private:
     std::string meta_;
 
     bool is_first_write_ = true;
+    segment_v2::CompressionTypePB compression_type_ = segment_v2::CompressionTypePB::NO_COMPRESSION;
     Block tmp_block_;
 
     RuntimeProfile* profile_ = nullptr;
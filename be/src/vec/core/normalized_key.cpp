@@ -0,0 +1,226 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/core/normalized_key.h"
+
+#include <glog/logging.h>
+#include <string.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "vec/columns/column.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+template <typename U>
+U to_big_endian(U value) {
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    if constexpr (sizeof(U) == 1) {
+        return value;
+    } else if constexpr (sizeof(U) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(U) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(U) == 8) {
+        return __builtin_bswap64(value);
+    } else {
+        static_assert(sizeof(U) == 16);
+        return (U(__builtin_bswap64(uint64_t(value))) << 64) |
+               __builtin_bswap64(uint64_t(value >> 64));
+    }
+#else
+    return value;
+#endif
+}
+
+// Encodes a column into the bytes [offset, row_width) of the prefixes of some rows.
+struct ColumnEncoder {
+    uint8_t* rows;
+    size_t row_width;
+    size_t offset;
+    size_t begin;
+    size_t end;
+    // number of bytes taken by the column
+    size_t size = 0;
+    // whether the whole value of every row is encoded
+    bool complete = true;
+
+    template <typename T>
+    void encode_integers(const T* data) {
+        using U = std::make_unsigned_t<T>;
+        size_t width = std::min(sizeof(T), row_width - offset);
+        for (size_t row = begin; row < end; ++row) {
+            U value = static_cast<U>(data[row]);
+            if constexpr (std::is_signed_v<T>) {
+                value ^= U(1) << (sizeof(T) * 8 - 1);
+            }
+            value = to_big_endian(value);
+            memcpy(rows + row * row_width + offset, &value, width);
+        }
+        size = width;
+        complete = width == sizeof(T);
+    }
+
+    void encode_strings(const ColumnString& column) {
+        size_t width = row_width - offset;
+        for (size_t row = begin; row < end; ++row) {
+            StringRef value = column.get_data_at(row);
+            memcpy(rows + row * row_width + offset, value.data, std::min(value.size, width));
+        }
+        // A string may have zero bytes at its end, it is not ordered by its prefix alone.
+        size = width;
+        complete = false;
+    }
+
+    template <typename ColumnType>
+    bool try_encode_integers(const IColumn& column) {
+        const auto* typed_column = check_and_get_column<ColumnType>(column);
+        if (typed_column == nullptr) {
+            return false;
+        }
+        encode_integers(typed_column->get_data().data());
+        return true;
+    }
+
+    template <typename DecimalType>
+    bool try_encode_decimals(const IColumn& column) {
+        const auto* typed_column = check_and_get_column<ColumnDecimal<DecimalType>>(column);
+        if (typed_column == nullptr) {
+            return false;
+        }
+        // the values of a column have the same scale
+        static_assert(sizeof(DecimalType) == sizeof(typename DecimalType::NativeType));
+        using NativeType = typename DecimalType::NativeType;
+        encode_integers(reinterpret_cast<const NativeType*>(typed_column->get_data().data()));
+        return true;
+    }
+
+    // Return false if the column can not be encoded.
+    bool encode(const IColumn& column) {
+        if (const auto* strings = check_and_get_column<ColumnString>(column)) {
+            encode_strings(*strings);
+            return true;
+        }
+        return try_encode_integers<ColumnVector<Int8>>(column) ||
+               try_encode_integers<ColumnVector<Int16>>(column) ||
+               try_encode_integers<ColumnVector<Int32>>(column) ||
+               try_encode_integers<ColumnVector<Int64>>(column) ||
+               try_encode_integers<ColumnVector<Int128>>(column) ||
+               try_encode_integers<ColumnVector<UInt8>>(column) ||
+               try_encode_integers<ColumnVector<UInt16>>(column) ||
+               try_encode_integers<ColumnVector<UInt32>>(column) ||
+               try_encode_integers<ColumnVector<UInt64>>(column) ||
+               try_encode_decimals<Decimal32>(column) || try_encode_decimals<Decimal64>(column) ||
+               try_encode_decimals<Decimal128V2>(column) ||
+               try_encode_decimals<Decimal128V3>(column);
+    }
+};
+
+} // namespace
+
+bool NormalizedKeys::build(
+        const std::vector<std::pair<const IColumn*, SortColumnDescription>>& columns,
+        size_t begin, size_t end) {
+    DCHECK_LE(begin, rows());
+    if (columns.empty()) {
+        return false;
+    }
+    // the prefixes of the new rows start with zeros
+    _words.resize(begin * _num_words);
+    _words.resize(end * _num_words, 0);
+
+    auto* rows = reinterpret_cast<uint8_t*>(_words.data());
+    size_t row_width = _num_words * sizeof(uint64_t);
+    size_t offset = 0;
+    _complete = true;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (offset == row_width) {
+            _complete = false;
+            break;
+        }
+        const auto& [column, description] = columns[i];
+        bool descending = description.direction < 0;
+        const IColumn* nested_column = column;
+        const uint8_t* null_map = nullptr;
+        if (const auto* nullable = check_and_get_column<ColumnNullable>(*column)) {
+            nested_column = &nullable->get_nested_column();
+            null_map = nullable->get_null_map_data().data();
+            // the marker of nulls is smaller than that of values if nulls come first
+            uint8_t null_marker = description.nulls_direction > 0 ? 2 : 0;
+            uint8_t value_marker = 1;
+            if (descending) {
+                null_marker = ~null_marker;
+                value_marker = ~value_marker;
+            }
+            for (size_t row = begin; row < end; ++row) {
+                rows[row * row_width + offset] = null_map[row] ? null_marker : value_marker;
+            }
+            ++offset;
+            if (offset == row_width) {
+                _complete = false;
+                break;
+            }
+        }
+
+        ColumnEncoder encoder {rows, row_width, offset, begin, end};
+        if (!encoder.encode(*nested_column)) {
+            if (i == 0) {
+                _words.resize(begin * _num_words);
+                return false;
+            }
+            // the null marker alone is a valid prefix
+            _complete = false;
+            break;
+        }
+        if (null_map != nullptr) {
+            for (size_t row = begin; row < end; ++row) {
+                if (null_map[row]) {
+                    memset(rows + row * row_width + offset, 0, encoder.size);
+                }
+            }
+        }
+        if (descending) {
+            for (size_t row = begin; row < end; ++row) {
+                uint8_t* bytes = rows + row * row_width + offset;
+                for (size_t pos = 0; pos < encoder.size; ++pos) {
+                    bytes[pos] = ~bytes[pos];
+                }
+            }
+        }
+        offset += encoder.size;
+        if (!encoder.complete) {
+            _complete = false;
+            break;
+        }
+    }
+
+    // the bytes of a word are in big endian order, load them as an integer
+    for (size_t i = begin * _num_words; i < end * _num_words; ++i) {
+        _words[i] = to_big_endian(_words[i]);
+    }
+    return true;
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "vec/core/sort_description.h"
+
+namespace doris::vectorized {
+
+class IColumn;
+
+// Fixed width memcmp-able prefixes of the sort keys of the rows of a block, so that most
+// comparisons of multi-column keys are a few integer comparisons instead of a virtual
+// compare_at() per column.
+//
+// The sort columns are encoded one after another into the prefix of a row: a null marker for
+// nullable columns, then the value as a big endian unsigned integer which orders like
+// compare_at() (the sign bit of signed integers is flipped), or the bytes of a string padded
+// with zeros. The bytes of a descending column are inverted. The prefix is kept as native
+// 64 bits words, comparing them in order is comparing the bytes with memcmp.
+//
+// The encoding stops at the first column which does not fit in the prefix, or which can not be
+// encoded (floats, complex types, ...). Rows with equal prefixes have equal keys only if the
+// keys are complete(), otherwise they must be compared column by column.
+class NormalizedKeys {
+public:
+    static constexpr size_t DEFAULT_WIDTH = 16;
+
+    // `width` is rounded up to a multiple of 8 bytes
+    explicit NormalizedKeys(size_t width = DEFAULT_WIDTH) : _num_words((width + 7) / 8) {}
+
+    // Build the prefixes of the rows [begin, end) of the columns, keeping those of the rows
+    // before `begin`, which must have been built from the same columns.
+    // Return false without building anything if the first column can not be encoded.
+    bool build(const std::vector<std::pair<const IColumn*, SortColumnDescription>>& columns,
+               size_t begin, size_t end);
+
+    // Whether equal prefixes mean equal keys.
+    bool is_complete() const { return _complete; }
+
+    size_t rows() const { return _words.size() / _num_words; }
+
+    void clear() { _words.clear(); }
+
+    int compare(size_t lhs, size_t rhs) const {
+        const uint64_t* lhs_words = _words.data() + lhs * _num_words;
+        const uint64_t* rhs_words = _words.data() + rhs * _num_words;
+        for (size_t i = 0; i < _num_words; ++i) {
+            if (lhs_words[i] != rhs_words[i]) {
+                return lhs_words[i] < rhs_words[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+private:
+    const size_t _num_words;
+    bool _complete = false;
+    std::vector<uint64_t> _words;
+};
+
+} // namespace doris::vectorized
@@ -20,7 +20,9 @@
 
 #include "vec/core/sort_block.h"
 
+#include "common/config.h"
 #include "vec/core/column_with_type_and_name.h"
+#include "vec/core/normalized_key.h"
 
 namespace doris::vectorized {
 
@@ -78,8 +80,25 @@ void sort_block(Block& src_block, Block& dest_block, const SortDescription& desc
 
         ColumnsWithSortDescriptions columns_with_sort_desc =
                 get_columns_with_sort_description(src_block, description);
-        {
-            EqualFlags flags(size, 1);
+        // Sort by the normalized keys first, then only the rows of equal normalized keys are
+        // sorted column by column, if the normalized keys are not the whole keys.
+        NormalizedKeys normalized_keys;
+        bool sorted_by_normalized_keys = false;
+        EqualFlags flags(size, 1);
+        if (config::enable_normalized_sort_key && limit == 0 && size > 1 &&
+            normalized_keys.build(columns_with_sort_desc, 0, size)) {
+            pdqsort(perm.begin(), perm.end(), [&](size_t lhs, size_t rhs) {
+                return normalized_keys.compare(lhs, rhs) < 0;
+            });
+            sorted_by_normalized_keys = normalized_keys.is_complete();
+            if (!sorted_by_normalized_keys) {
+                flags[0] = 0;
+                for (size_t i = 1; i < size; ++i) {
+                    flags[i] = normalized_keys.compare(perm[i - 1], perm[i]) == 0;
+                }
+            }
+        }
+        if (!sorted_by_normalized_keys) {
             EqualRange range {0, size};
 
             // TODO: ColumnSorter should be constructed only once.
@@ -36,6 +36,7 @@
 #include <memory>
 #include <ostream>
 #include <string_view>
+#include <unordered_set>
 #include <utility>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
@@ -980,6 +981,21 @@ Status NewJsonReader::_read_one_message(std::unique_ptr<uint8_t[]>* file_buf, si
 }
 // ---------SIMDJSON----------
 // simdjson, replace none simdjson function if it is ready
+// Whether every jsonpath is a plain `$.key` of a top level field, and no two are the same.
+static bool jsonpaths_are_distinct_keys(const std::vector<std::vector<JsonPath>>& jsonpaths) {
+    if (jsonpaths.empty()) {
+        return false;
+    }
+    std::unordered_set<std::string> keys;
+    for (const auto& path : jsonpaths) {
+        if (path.size() != 2 || !path[0].is_valid || !path[1].is_valid || path[1].idx != -1 ||
+            !keys.insert(path[1].key).second) {
+            return false;
+        }
+    }
+    return true;
+}
+
 Status NewJsonReader::_simdjson_init_reader() {
     RETURN_IF_ERROR(_get_range_params());
 
@@ -1002,9 +1018,15 @@ Status NewJsonReader::_simdjson_init_reader() {
         }
     }
     _ondemand_json_parser = std::make_unique<simdjson::ondemand::parser>();
+    _match_jsonpaths_by_key = jsonpaths_are_distinct_keys(_parsed_jsonpaths);
     for (int i = 0; i < _file_slot_descs.size(); ++i) {
-        _slot_desc_index[StringRef {_file_slot_descs[i]->col_name()}] = i;
+        if (!_match_jsonpaths_by_key) {
+            _slot_desc_index[StringRef {_file_slot_descs[i]->col_name()}] = i;
+        } else if (i < _parsed_jsonpaths.size()) {
+            _slot_desc_index[StringRef {_parsed_jsonpaths[i][1].key}] = i;
+        }
     }
+    _prev_positions.resize(_file_slot_descs.size());
     _simdjson_ondemand_padding_buffer.resize(_padded_size);
     _simdjson_ondemand_unscape_padding_buffer.resize(_padded_size);
     return Status::OK();
@@ -1615,38 +1637,84 @@ Status NewJsonReader::_get_json_value(size_t* size, bool* eof, simdjson::error_c
     return Status::OK();
 }
 
+Status NewJsonReader::_simdjson_write_columns_by_keys(
+        simdjson::ondemand::object* value, const std::vector<SlotDescriptor*>& slot_descs,
+        Block& block, bool* has_valid_value, bool* valid) {
+    _seen_columns.assign(slot_descs.size(), false);
+    size_t key_index = 0;
+    for (auto field : *value) {
+        std::string_view key = field.unescaped_key();
+        const size_t column_index = _column_index(StringRef(key.data(), key.size()), key_index++);
+        // the first of duplicated keys wins, as it does when looking the jsonpath up
+        if (UNLIKELY(ssize_t(column_index) < 0) || _seen_columns[column_index] ||
+            !slot_descs[column_index]->is_materialized()) {
+            continue;
+        }
+        simdjson::ondemand::value val = field.value();
+        auto* column_ptr = block.get_by_position(column_index).column->assume_mutable().get();
+        RETURN_IF_ERROR(
+                _simdjson_write_data_to_column(val, slot_descs[column_index], column_ptr, valid));
+        if (!(*valid)) {
+            return Status::OK();
+        }
+        _seen_columns[column_index] = true;
+        *has_valid_value = true;
+    }
+    for (size_t i = 0; i < slot_descs.size(); ++i) {
+        if (_seen_columns[i] || !slot_descs[i]->is_materialized()) {
+            continue;
+        }
+        // not match in jsondata, filling with default value
+        auto* column_ptr = block.get_by_position(i).column->assume_mutable().get();
+        RETURN_IF_ERROR(_fill_missing_column(slot_descs[i], column_ptr, valid));
+        if (!(*valid)) {
+            return Status::OK();
+        }
+    }
+    *valid = true;
+    return Status::OK();
+}
+
 Status NewJsonReader::_simdjson_write_columns_by_jsonpath(
         simdjson::ondemand::object* value, const std::vector<SlotDescriptor*>& slot_descs,
         Block& block, bool* valid) {
     // write by jsonpath
     bool has_valid_value = false;
-    for (size_t i = 0; i < slot_descs.size(); i++) {
-        auto* slot_desc = slot_descs[i];
-        if (!slot_desc->is_materialized()) {
-            continue;
+    if (_match_jsonpaths_by_key) {
+        RETURN_IF_ERROR(
+                _simdjson_write_columns_by_keys(value, slot_descs, block, &has_valid_value, valid));
+        if (!(*valid)) {
+            return Status::OK();
         }
-        auto* column_ptr = block.get_by_position(i).column->assume_mutable().get();
-        simdjson::ondemand::value json_value;
-        Status st;
-        if (i < _parsed_jsonpaths.size()) {
-            st = JsonFunctions::extract_from_object(*value, _parsed_jsonpaths[i], &json_value);
-            if (!st.ok() && !st.is<DATA_QUALITY_ERROR>()) {
-                return st;
+    } else {
+        for (size_t i = 0; i < slot_descs.size(); i++) {
+            auto* slot_desc = slot_descs[i];
+            if (!slot_desc->is_materialized()) {
+                continue;
             }
-        }
-        if (i >= _parsed_jsonpaths.size() || st.is<DATA_QUALITY_ERROR>()) {
-            // not match in jsondata, filling with default value
-            RETURN_IF_ERROR(_fill_missing_column(slot_desc, column_ptr, valid));
-            if (!(*valid)) {
-                return Status::OK();
+            auto* column_ptr = block.get_by_position(i).column->assume_mutable().get();
+            simdjson::ondemand::value json_value;
+            Status st;
+            if (i < _parsed_jsonpaths.size()) {
+                st = JsonFunctions::extract_from_object(*value, _parsed_jsonpaths[i], &json_value);
+                if (!st.ok() && !st.is<DATA_QUALITY_ERROR>()) {
+                    return st;
+                }
             }
-        } else {
-            RETURN_IF_ERROR(
-                    _simdjson_write_data_to_column(json_value, slot_desc, column_ptr, valid));
-            if (!(*valid)) {
-                return Status::OK();
+            if (i >= _parsed_jsonpaths.size() || st.is<DATA_QUALITY_ERROR>()) {
+                // not match in jsondata, filling with default value
+                RETURN_IF_ERROR(_fill_missing_column(slot_desc, column_ptr, valid));
+                if (!(*valid)) {
+                    return Status::OK();
+                }
+            } else {
+                RETURN_IF_ERROR(
+                        _simdjson_write_data_to_column(json_value, slot_desc, column_ptr, valid));
+                if (!(*valid)) {
+                    return Status::OK();
+                }
+                has_valid_value = true;
             }
-            has_valid_value = true;
         }
     }
     if (!has_valid_value) {
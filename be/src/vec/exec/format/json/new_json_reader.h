@@ -177,6 +177,10 @@ private:
                                           SlotDescriptor* slot_desc,
                                           vectorized::IColumn* column_ptr, bool* valid);
 
+    Status _simdjson_write_columns_by_keys(simdjson::ondemand::object* value,
+                                           const std::vector<SlotDescriptor*>& slot_descs,
+                                           Block& block, bool* has_valid_value, bool* valid);
+
     Status _simdjson_write_columns_by_jsonpath(simdjson::ondemand::object* value,
                                                const std::vector<SlotDescriptor*>& slot_descs,
                                                Block& block, bool* valid);
@@ -253,8 +257,12 @@ private:
     // ======SIMD JSON======
     // name mapping
     /// Hash table match `field name -> position in the block`. NOTE You can use perfect hash map.
+    /// The field name is the column name, or the key of its jsonpath if _match_jsonpaths_by_key.
     using NameMap = HashMap<StringRef, size_t, StringRefHash>;
     NameMap _slot_desc_index;
+    /// Every jsonpath is a distinct `$.key`, so the fields of an object are matched against the
+    /// jsonpaths in one pass over the object, instead of one lookup in the object per jsonpath.
+    bool _match_jsonpaths_by_key = false;
     /// Cached search results for previous row (keyed as index in JSON object) - used as a hint.
     std::vector<NameMap::LookupResult> _prev_positions;
     /// Set of columns which already met in row. Exception is thrown if there are more than one column with the same name.
@@ -0,0 +1,149 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/join/join_spill_partitions.h"
+
+#include <glog/logging.h>
+
+#include "runtime/block_spill_manager.h"
+#include "runtime/exec_env.h"
+#include "vec/columns/column.h"
+
+namespace doris::vectorized {
+
+JoinSpillPartitions::JoinSpillPartitions(size_t partition_count_bits, size_t level,
+                                         int batch_size, RuntimeProfile* profile)
+        : _level(level),
+          _batch_size(batch_size),
+          _profile(profile),
+          _partitions(1 << partition_count_bits),
+          _partition_rows(1 << partition_count_bits) {}
+
+JoinSpillPartitions::~JoinSpillPartitions() {
+    for (auto& partition : _partitions) {
+        if (partition.writer) {
+            static_cast<void>(partition.writer->close());
+            partition.writer.reset();
+        }
+        if (partition.stream_id >= 0) {
+            remove_stream(partition.stream_id, _profile);
+        }
+    }
+}
+
+Status JoinSpillPartitions::add_block(const Block& block, const std::vector<int>& key_col_ids,
+                                      size_t begin, size_t num_columns) {
+    size_t rows = block.rows();
+    if (begin >= rows) {
+        return Status::OK();
+    }
+    // the seed of a level is also the hash of the rows without keys
+    _hashes.assign(rows, 0x9E3779B97F4A7C15ULL * (_level + 1));
+    for (int col_id : key_col_ids) {
+        block.get_by_position(col_id).column->update_hashes_with_value(_hashes.data(), nullptr);
+    }
+
+    size_t mask = _partitions.size() - 1;
+    for (auto& partition_rows : _partition_rows) {
+        partition_rows.clear();
+    }
+    for (size_t row = begin; row < rows; ++row) {
+        _partition_rows[_hashes[row] & mask].push_back(row);
+    }
+
+    for (size_t i = 0; i < _partitions.size(); ++i) {
+        const auto& partition_rows = _partition_rows[i];
+        if (partition_rows.empty()) {
+            continue;
+        }
+        auto& partition = _partitions[i];
+        if (!partition.buffer) {
+            Block empty_block;
+            for (size_t col = 0; col < num_columns; ++col) {
+                const auto& column = block.get_by_position(col);
+                empty_block.insert({column.column->clone_empty(), column.type, column.name});
+            }
+            partition.buffer = MutableBlock::create_unique(std::move(empty_block));
+        }
+        partition.buffer->add_rows(&block, partition_rows.data(),
+                                   partition_rows.data() + partition_rows.size());
+        partition.rows += partition_rows.size();
+        if (partition.buffer->rows() >= _batch_size) {
+            RETURN_IF_ERROR(_flush(partition));
+        }
+    }
+    return Status::OK();
+}
+
+Status JoinSpillPartitions::_flush(Partition& partition) {
+    if (!partition.writer) {
+        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
+                _batch_size, partition.writer, _profile));
+        partition.stream_id = partition.writer->get_id();
+    }
+    Block block = partition.buffer->to_block();
+    partition.buffer.reset();
+    partition.bytes += block.bytes();
+    return partition.writer->write(block);
+}
+
+Status JoinSpillPartitions::finish() {
+    for (auto& partition : _partitions) {
+        if (partition.buffer && partition.buffer->rows() > 0) {
+            RETURN_IF_ERROR(_flush(partition));
+        }
+        if (partition.writer) {
+            RETURN_IF_ERROR(partition.writer->close());
+            partition.writer.reset();
+        }
+    }
+    return Status::OK();
+}
+
+int64_t JoinSpillPartitions::release_stream(size_t partition) {
+    DCHECK(!_partitions[partition].writer);
+    int64_t stream_id = _partitions[partition].stream_id;
+    _partitions[partition].stream_id = -1;
+    return stream_id;
+}
+
+void JoinSpillPartitions::remove_stream(int64_t stream_id, RuntimeProfile* profile) {
+    // closing a reader which deletes after read removes the file
+    BlockSpillReaderUPtr reader;
+    auto st = ExecEnv::GetInstance()->block_spill_mgr()->get_reader(stream_id, reader, profile,
+                                                                     true);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to remove join spill stream " << stream_id << ": " << st;
+    }
+    if (reader) {
+        static_cast<void>(reader->close());
+    }
+}
+
+JoinSpillPartition::~JoinSpillPartition() {
+    if (build_reader) {
+        // the reader deletes the file when it is closed
+        build_reader.reset();
+    } else if (build_stream_id >= 0) {
+        JoinSpillPartitions::remove_stream(build_stream_id, profile);
+    }
+    if (probe_stream_id >= 0) {
+        JoinSpillPartitions::remove_stream(probe_stream_id, profile);
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,138 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "common/status.h"
+#include "util/runtime_profile.h"
+#include "vec/core/block.h"
+#include "vec/core/block_spill_reader.h"
+#include "vec/core/block_spill_writer.h"
+
+namespace doris::vectorized {
+
+// The rows of one side of a hash join spilled to disk, distributed to partitions by the hash of
+// the join keys.
+//
+// Both sides of a join are partitioned at the same level with the same hash seed, so a partition
+// of the probe side only needs to be joined with the same partition of the build side. Each level
+// of repartitioning uses another seed, so the rows of a skewed partition spread over the
+// partitions of the next level unless they have the same keys.
+class JoinSpillPartitions {
+public:
+    // A partition is not repartitioned below this level even if its build side is too large, its
+    // rows probably have the same keys.
+    static constexpr size_t MAX_LEVEL = 3;
+
+    JoinSpillPartitions(size_t partition_count_bits, size_t level, int batch_size,
+                        RuntimeProfile* profile);
+
+    // Delete the spill files which have not been released.
+    ~JoinSpillPartitions();
+
+    // Spill the first `num_columns` columns of the rows [begin, block.rows()) of the block,
+    // `key_col_ids` are the positions of the join keys in the block.
+    Status add_block(const Block& block, const std::vector<int>& key_col_ids, size_t begin,
+                     size_t num_columns);
+
+    // Write out the buffered rows and close the spill files.
+    Status finish();
+
+    size_t level() const { return _level; }
+
+    size_t partition_count() const { return _partitions.size(); }
+
+    size_t rows(size_t partition) const { return _partitions[partition].rows; }
+
+    size_t bytes(size_t partition) const { return _partitions[partition].bytes; }
+
+    // Take the spill stream of a partition after finish(), the caller reads it, which deletes
+    // its file, or removes it. Return -1 if the partition has no rows.
+    int64_t release_stream(size_t partition);
+
+    // Delete the file of a spill stream which will not be read.
+    static void remove_stream(int64_t stream_id, RuntimeProfile* profile);
+
+private:
+    struct Partition {
+        std::unique_ptr<MutableBlock> buffer;
+        BlockSpillWriterUPtr writer;
+        int64_t stream_id = -1;
+        size_t rows = 0;
+        size_t bytes = 0;
+    };
+
+    Status _flush(Partition& partition);
+
+    const size_t _level;
+    const int _batch_size;
+    RuntimeProfile* _profile = nullptr;
+    std::vector<Partition> _partitions;
+
+    std::vector<uint64_t> _hashes;
+    std::vector<std::vector<uint32_t>> _partition_rows;
+};
+
+// A partition of a spilled hash join. Its build side is loaded into a hash table and its probe
+// side is joined with it, unless the build side is still too large, then both sides are
+// partitioned again at the next level. The spill streams which are not taken are removed.
+struct JoinSpillPartition {
+    JoinSpillPartition(size_t level_, RuntimeProfile* profile_)
+            : level(level_), profile(profile_) {}
+    ~JoinSpillPartition();
+
+    const size_t level;
+    RuntimeProfile* profile = nullptr;
+
+    int64_t build_stream_id = -1;
+    // opened in advance if the build side was read to build the runtime filters
+    BlockSpillReaderUPtr build_reader;
+    size_t build_rows = 0;
+
+    int64_t probe_stream_id = -1;
+    size_t probe_rows = 0;
+};
+
+// State of a hash join whose build side has been spilled.
+struct HashJoinSpillContext {
+    RuntimeProfile* profile = nullptr;
+    RuntimeProfile::Counter* partitions_counter = nullptr;
+    RuntimeProfile::Counter* repartitions_counter = nullptr;
+
+    // the build and the probe side at the first level, until they are finished
+    std::unique_ptr<JoinSpillPartitions> build_partitions;
+    std::unique_ptr<JoinSpillPartitions> probe_partitions;
+
+    // the probe side has been read and partitioned
+    bool probe_input_eos = false;
+
+    // partitions to be joined, the last one first
+    std::vector<std::unique_ptr<JoinSpillPartition>> pending_partitions;
+
+    // a partition is being joined, its probe side is read from `probe_reader`, which is null if
+    // the partition has no probe rows
+    bool joining_partition = false;
+    BlockSpillReaderUPtr probe_reader;
+};
+
+} // namespace doris::vectorized
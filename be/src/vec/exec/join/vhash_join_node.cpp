@@ -44,13 +44,17 @@
 #include "gutil/strings/substitute.h"
 #include "pipeline/exec/hashjoin_build_sink.h"
 #include "pipeline/exec/hashjoin_probe_operator.h"
+#include "runtime/block_spill_manager.h"
 #include "runtime/define_primitive_type.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/query_context.h"
 #include "runtime/runtime_filter_mgr.h"
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
+#include "util/countdown_latch.h"
 #include "util/defer_op.h"
+#include "util/threadpool.h"
 #include "util/uid_util.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/columns/column_vector.h"
@@ -63,6 +67,7 @@
 #include "vec/data_types/data_type_nullable.h"
 #include "vec/data_types/data_type_number.h"
 #include "vec/exec/join/join_op.h"
+#include "vec/exec/join/join_spill_partitions.h"
 #include "vec/exec/join/process_hash_table_probe.h"
 #include "vec/exec/join/vjoin_node_base.h"
 #include "vec/exprs/vexpr.h"
@@ -85,6 +90,34 @@ template Status HashJoinNode::_extract_join_column<false>(
         std::vector<IColumn const*, std::allocator<IColumn const*>>&,
         std::vector<int, std::allocator<int>> const&);
 
+int join_build_task_num(RuntimeState* state) {
+    // the calling thread runs a task as well
+    auto* pool = state->exec_env()->join_build_thread_pool();
+    int max_tasks = pool == nullptr ? 1 : pool->max_threads() + 1;
+    return std::clamp(state->parallel_hash_join_build_num(), 1, max_tasks);
+}
+
+void parallel_for_join_build(RuntimeState* state, size_t num_tasks,
+                             const std::function<void(size_t)>& task) {
+    // The calling thread runs the tasks which can not be submitted, so the build goes on even if
+    // the pool is busy.
+    auto* pool = state->exec_env()->join_build_thread_pool();
+    CountDownLatch latch(num_tasks - 1);
+    for (size_t i = 1; i < num_tasks; ++i) {
+        auto st = pool == nullptr ? Status::InternalError("no join build thread pool")
+                                  : pool->submit_func([&task, &latch, i] {
+                                        task(i);
+                                        latch.count_down();
+                                    });
+        if (!st.ok()) {
+            task(i);
+            latch.count_down();
+        }
+    }
+    task(0);
+    latch.wait();
+}
+
 HashJoinNode::HashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
         : VJoinNodeBase(pool, tnode, descs),
           _is_broadcast_join(tnode.hash_join_node.__isset.is_broadcast_join &&
@@ -267,6 +300,9 @@ Status HashJoinNode::prepare(RuntimeState* state) {
     _process_other_join_conjunct_timer = ADD_TIMER(runtime_profile(), "OtherJoinConjunctTime");
     _init_probe_side_timer = ADD_CHILD_TIMER(probe_phase_profile, "InitProbeSideTime", "ProbeTime");
 
+    _external_join_bytes_threshold = state->external_join_bytes_threshold();
+    _spill_partition_count_bits = state->external_join_partition_bits();
+
     RETURN_IF_ERROR(VExpr::prepare(_build_expr_ctxs, state, child(1)->row_desc()));
     RETURN_IF_ERROR(VExpr::prepare(_probe_expr_ctxs, state, child(0)->row_desc()));
 
@@ -320,6 +356,14 @@ Status HashJoinNode::close(RuntimeState* state) {
 }
 
 bool HashJoinNode::need_more_input_data() const {
+    if (_spill_context != nullptr) {
+        // the probe side is read and partitioned before the partitions are joined
+        return !_spill_context->probe_input_eos;
+    }
+    return _need_probe_block();
+}
+
+bool HashJoinNode::_need_probe_block() const {
     return (_probe_block.rows() == 0 || _probe_index == _probe_block.rows()) && !_probe_eos &&
            !_short_circuit_for_probe;
 }
@@ -336,6 +380,14 @@ void HashJoinNode::prepare_for_next() {
 Status HashJoinNode::pull(doris::RuntimeState* state, vectorized::Block* output_block, bool* eos) {
     SCOPED_TIMER(_exec_timer);
     SCOPED_TIMER(_probe_timer);
+    if (_spill_context != nullptr) {
+        return _pull_spilled_partitions(state, output_block, eos);
+    }
+    return _pull_probe_block(state, output_block, eos);
+}
+
+Status HashJoinNode::_pull_probe_block(RuntimeState* state, vectorized::Block* output_block,
+                                       bool* eos) {
     if (_short_circuit_for_probe) {
         // If we use a short-circuit strategy, should return empty block directly.
         *eos = true;
@@ -478,8 +530,16 @@ Status HashJoinNode::_filter_data_and_build_output(RuntimeState* state,
     return Status::OK();
 }
 
-Status HashJoinNode::push(RuntimeState* /*state*/, vectorized::Block* input_block, bool eos) {
+Status HashJoinNode::push(RuntimeState* state, vectorized::Block* input_block, bool eos) {
     SCOPED_TIMER(_exec_timer);
+    if (_spill_context != nullptr && !_spill_context->probe_input_eos) {
+        return _spill_probe_block(state, input_block, eos);
+    }
+    return _push_probe_block(state, input_block, eos);
+}
+
+Status HashJoinNode::_push_probe_block(RuntimeState* /*state*/, vectorized::Block* input_block,
+                                       bool eos) {
     _probe_eos = eos;
     if (input_block->rows() > 0) {
         COUNTER_UPDATE(_probe_rows_counter, input_block->rows());
@@ -523,7 +583,8 @@ Status HashJoinNode::get_next(RuntimeState* state, Block* output_block, bool* eo
         return Status::OK();
     }
 
-    if (_join_op == TJoinOp::RIGHT_OUTER_JOIN) {
+    // the hash table of a spilled join is built for each partition
+    if (_join_op == TJoinOp::RIGHT_OUTER_JOIN && _spill_context == nullptr) {
         const auto hash_table_empty = std::visit(
                 Overload {[&](std::monostate&) -> bool {
                               LOG(FATAL) << "FATAL: uninited hash table";
@@ -718,14 +779,8 @@ Status HashJoinNode::sink(doris::RuntimeState* state, vectorized::Block* in_bloc
         // data from probe side.
         _build_side_mem_used += in_block->allocated_bytes();
 
-        if (_build_side_mutable_block.empty()) {
-            auto tmp_build_block =
-                    VectorizedUtils::create_empty_columnswithtypename(child(1)->row_desc());
-            tmp_build_block = *(tmp_build_block.create_same_struct_block(1, false));
-            _build_col_ids.resize(_build_expr_ctxs.size());
-            RETURN_IF_ERROR(_do_evaluate(tmp_build_block, _build_expr_ctxs, *_build_expr_call_timer,
-                                         _build_col_ids));
-            _build_side_mutable_block = MutableBlock::build_mutable_block(&tmp_build_block);
+        if (_build_side_mutable_block.empty() && _spill_context == nullptr) {
+            RETURN_IF_ERROR(_init_build_side_mutable_block());
         }
 
         if (in_block->rows() != 0) {
@@ -733,17 +788,29 @@ Status HashJoinNode::sink(doris::RuntimeState* state, vectorized::Block* in_bloc
             RETURN_IF_ERROR(_do_evaluate(*in_block, _build_expr_ctxs, *_build_expr_call_timer,
                                          res_col_ids));
 
-            SCOPED_TIMER(_build_side_merge_block_timer);
-            RETURN_IF_ERROR(_build_side_mutable_block.merge(*in_block));
-            if (_build_side_mutable_block.rows() > JOIN_BUILD_SIZE_LIMIT) {
-                return Status::NotSupported(
-                        "Hash join do not support build table rows"
-                        " over:" +
-                        std::to_string(JOIN_BUILD_SIZE_LIMIT));
+            if (_spill_context != nullptr) {
+                RETURN_IF_ERROR(_spill_context->build_partitions->add_block(
+                        *in_block, res_col_ids, 0, in_block->columns()));
+            } else {
+                SCOPED_TIMER(_build_side_merge_block_timer);
+                RETURN_IF_ERROR(_build_side_mutable_block.merge(*in_block));
+                if (_build_side_mutable_block.rows() > JOIN_BUILD_SIZE_LIMIT) {
+                    return Status::NotSupported(
+                            "Hash join do not support build table rows"
+                            " over:" +
+                            std::to_string(JOIN_BUILD_SIZE_LIMIT));
+                }
+                if (_build_side_mem_used > _external_join_bytes_threshold && _can_spill(state)) {
+                    RETURN_IF_ERROR(_spill_build_side(state));
+                }
             }
         }
     }
 
+    if (_should_build_hash_table && eos && _spill_context != nullptr) {
+        return _finish_spilled_build_side(state);
+    }
+
     if (_should_build_hash_table && eos) {
         DCHECK(!_build_side_mutable_block.empty());
         _build_block = std::make_shared<Block>(_build_side_mutable_block.to_block());
@@ -928,6 +995,16 @@ void HashJoinNode::_set_build_ignore_flag(Block& block, const std::vector<int>&
     }
 }
 
+Status HashJoinNode::_init_build_side_mutable_block() {
+    auto tmp_build_block = VectorizedUtils::create_empty_columnswithtypename(child(1)->row_desc());
+    tmp_build_block = *(tmp_build_block.create_same_struct_block(1, false));
+    _build_col_ids.resize(_build_expr_ctxs.size());
+    RETURN_IF_ERROR(_do_evaluate(tmp_build_block, _build_expr_ctxs, *_build_expr_call_timer,
+                                 _build_col_ids));
+    _build_side_mutable_block = MutableBlock::build_mutable_block(&tmp_build_block);
+    return Status::OK();
+}
+
 Status HashJoinNode::_process_build_block(RuntimeState* state, Block& block) {
     SCOPED_TIMER(_build_table_timer);
     size_t rows = block.rows();
@@ -1080,6 +1157,283 @@ std::vector<uint16_t> HashJoinNode::_convert_block_to_null(Block& block) {
     return results;
 }
 
+bool HashJoinNode::_can_spill(RuntimeState* state) const {
+    // Null aware joins and mark joins need the whole build side to handle nulls, and the probe
+    // side may be pushed before the build side is finished if early start probe is enabled.
+    return _external_join_bytes_threshold > 0 && _should_build_hash_table &&
+           _shared_hashtable_controller == nullptr && !_is_mark_join &&
+           _join_op != TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN &&
+           _join_op != TJoinOp::NULL_AWARE_LEFT_SEMI_JOIN && _join_op != TJoinOp::CROSS_JOIN &&
+           !_enable_hash_join_early_start_probe(state);
+}
+
+Status HashJoinNode::_spill_build_side(RuntimeState* state) {
+    _spill_context = std::make_unique<HashJoinSpillContext>();
+    _spill_context->profile = _runtime_profile->create_child("Spill", true, true);
+    _spill_context->partitions_counter =
+            ADD_COUNTER(_spill_context->profile, "JoinedPartitions", TUnit::UNIT);
+    _spill_context->repartitions_counter =
+            ADD_COUNTER(_spill_context->profile, "Repartitions", TUnit::UNIT);
+    _spill_context->build_partitions = std::make_unique<JoinSpillPartitions>(
+            _spill_partition_count_bits, 0, state->batch_size(), _spill_context->profile);
+    _runtime_profile->add_info_string("Spilled", "true");
+
+    // skip the mocked first row
+    Block block = _build_side_mutable_block.to_block();
+    RETURN_IF_ERROR(
+            _spill_context->build_partitions->add_block(block, _build_col_ids, 1, block.columns()));
+    _build_side_mutable_block = MutableBlock();
+    return Status::OK();
+}
+
+Status HashJoinNode::_finish_spilled_build_side(RuntimeState* state) {
+    auto& build_partitions = *_spill_context->build_partitions;
+    RETURN_IF_ERROR(build_partitions.finish());
+
+    size_t build_rows = 0;
+    auto& pending_partitions = _spill_context->pending_partitions;
+    for (size_t i = 0; i < build_partitions.partition_count(); ++i) {
+        auto partition = std::make_unique<JoinSpillPartition>(0, _spill_context->profile);
+        partition->build_rows = build_partitions.rows(i);
+        partition->build_stream_id = build_partitions.release_stream(i);
+        build_rows += partition->build_rows;
+        pending_partitions.emplace_back(std::move(partition));
+    }
+
+    // The runtime filters need the whole build side, it is read once more to build them, the
+    // readers are kept to build the hash tables of the partitions later.
+    if (!_runtime_filter_descs.empty()) {
+        _runtime_filter_slots = std::make_shared<VRuntimeFilterSlots>(_build_expr_ctxs,
+                                                                      _runtime_filter_descs);
+        RETURN_IF_ERROR(_runtime_filter_slots->init(state, build_rows));
+        if (!_runtime_filter_slots->empty()) {
+            SCOPED_TIMER(_runtime_filter_compute_timer);
+            for (auto& partition : pending_partitions) {
+                if (partition->build_stream_id < 0) {
+                    continue;
+                }
+                RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_reader(
+                        partition->build_stream_id, partition->build_reader,
+                        _spill_context->profile, true));
+                bool eos = false;
+                while (!eos) {
+                    Block block;
+                    RETURN_IF_ERROR(partition->build_reader->read(&block, &eos));
+                    if (block.rows() > 0) {
+                        _runtime_filter_slots->insert(&block, 0);
+                    }
+                }
+                partition->build_reader->seek(0);
+            }
+        }
+        SCOPED_TIMER(_publish_runtime_filter_timer);
+        RETURN_IF_ERROR(_runtime_filter_slots->publish());
+    }
+
+    _spill_context->probe_partitions = std::make_unique<JoinSpillPartitions>(
+            _spill_partition_count_bits, 0, state->batch_size(), _spill_context->profile);
+    return Status::OK();
+}
+
+Status HashJoinNode::_spill_probe_block(RuntimeState* state, Block* block, bool eos) {
+    if (block->rows() > 0) {
+        size_t num_columns = block->columns();
+        std::vector<int> res_col_ids(_probe_expr_ctxs.size());
+        RETURN_IF_ERROR(_do_evaluate(*block, _probe_expr_ctxs, *_probe_expr_call_timer,
+                                     res_col_ids));
+        RETURN_IF_ERROR(_spill_context->probe_partitions->add_block(*block, res_col_ids, 0,
+                                                                    num_columns));
+        // the probe exprs are evaluated again when the partition is joined
+        block->erase_tail(num_columns);
+    }
+    if (eos) {
+        auto& probe_partitions = *_spill_context->probe_partitions;
+        RETURN_IF_ERROR(probe_partitions.finish());
+        auto& pending_partitions = _spill_context->pending_partitions;
+        DCHECK_EQ(pending_partitions.size(), probe_partitions.partition_count());
+        for (size_t i = 0; i < probe_partitions.partition_count(); ++i) {
+            pending_partitions[i]->probe_rows = probe_partitions.rows(i);
+            pending_partitions[i]->probe_stream_id = probe_partitions.release_stream(i);
+        }
+        _spill_context->build_partitions.reset();
+        _spill_context->probe_partitions.reset();
+        _spill_context->probe_input_eos = true;
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_pull_spilled_partitions(RuntimeState* state, Block* output_block,
+                                              bool* eos) {
+    DCHECK(_spill_context->probe_input_eos);
+    while (!*eos && output_block->rows() == 0) {
+        RETURN_IF_CANCELLED(state);
+        if (!_spill_context->joining_partition) {
+            bool has_partition = false;
+            RETURN_IF_ERROR(_prepare_spilled_partition(state, &has_partition));
+            if (!has_partition) {
+                *eos = true;
+                break;
+            }
+        }
+
+        while (_need_probe_block()) {
+            Block block;
+            bool partition_eos = true;
+            if (_spill_context->probe_reader != nullptr) {
+                RETURN_IF_ERROR(_spill_context->probe_reader->read(&block, &partition_eos));
+            }
+            if (block.rows() == 0 && !partition_eos) {
+                continue;
+            }
+            prepare_for_next();
+            RETURN_IF_ERROR(_push_probe_block(state, &block, partition_eos));
+        }
+
+        bool partition_eos = false;
+        RETURN_IF_ERROR(_pull_probe_block(state, output_block, &partition_eos));
+        if (partition_eos) {
+            _spill_context->joining_partition = false;
+            _spill_context->probe_reader.reset();
+            *eos = reached_limit();
+        }
+    }
+    return Status::OK();
+}
+
+bool HashJoinNode::_need_join_spilled_partition(const JoinSpillPartition& partition) const {
+    if (partition.build_rows == 0 &&
+        (_join_op == TJoinOp::INNER_JOIN || _join_op == TJoinOp::LEFT_SEMI_JOIN ||
+         _join_op == TJoinOp::RIGHT_OUTER_JOIN || _join_op == TJoinOp::RIGHT_SEMI_JOIN ||
+         _join_op == TJoinOp::RIGHT_ANTI_JOIN)) {
+        return false;
+    }
+    // only the unmatched build rows of some joins are output without probe rows
+    if (partition.probe_rows == 0 &&
+        !(_join_op == TJoinOp::RIGHT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN ||
+          _join_op == TJoinOp::RIGHT_ANTI_JOIN)) {
+        return false;
+    }
+    return partition.build_rows > 0 || partition.probe_rows > 0;
+}
+
+Status HashJoinNode::_prepare_spilled_partition(RuntimeState* state, bool* has_partition) {
+    auto* spill_mgr = ExecEnv::GetInstance()->block_spill_mgr();
+    auto& pending_partitions = _spill_context->pending_partitions;
+    while (!pending_partitions.empty()) {
+        std::unique_ptr<JoinSpillPartition> partition = std::move(pending_partitions.back());
+        pending_partitions.pop_back();
+        if (!_need_join_spilled_partition(*partition)) {
+            continue;
+        }
+
+        BlockSpillReaderUPtr build_reader = std::move(partition->build_reader);
+        if (build_reader == nullptr && partition->build_stream_id >= 0) {
+            RETURN_IF_ERROR(spill_mgr->get_reader(partition->build_stream_id, build_reader,
+                                                  _spill_context->profile, true));
+        }
+        partition->build_stream_id = -1;
+
+        // Load the build side, or partition it again at the next level once it is too large.
+        RETURN_IF_ERROR(_init_build_side_mutable_block());
+        std::unique_ptr<JoinSpillPartitions> build_partitions;
+        bool build_eos = build_reader == nullptr;
+        while (!build_eos) {
+            Block block;
+            RETURN_IF_ERROR(build_reader->read(&block, &build_eos));
+            if (block.rows() == 0) {
+                continue;
+            }
+            if (build_partitions != nullptr) {
+                RETURN_IF_ERROR(
+                        build_partitions->add_block(block, _build_col_ids, 0, block.columns()));
+                continue;
+            }
+            SCOPED_TIMER(_build_side_merge_block_timer);
+            RETURN_IF_ERROR(_build_side_mutable_block.merge(block));
+            if (partition->level < JoinSpillPartitions::MAX_LEVEL &&
+                _build_side_mutable_block.allocated_bytes() > _external_join_bytes_threshold) {
+                build_partitions = std::make_unique<JoinSpillPartitions>(
+                        _spill_partition_count_bits, partition->level + 1, state->batch_size(),
+                        _spill_context->profile);
+                Block build_block = _build_side_mutable_block.to_block();
+                RETURN_IF_ERROR(build_partitions->add_block(build_block, _build_col_ids, 1,
+                                                            build_block.columns()));
+                _build_side_mutable_block = MutableBlock();
+            }
+        }
+        build_reader.reset();
+        if (build_partitions != nullptr) {
+            RETURN_IF_ERROR(
+                    _repartition_spilled_partition(state, *partition, std::move(build_partitions)));
+            continue;
+        }
+
+        _build_block = std::make_shared<Block>(_build_side_mutable_block.to_block());
+        _build_side_mutable_block = MutableBlock();
+        _hash_table_init(state);
+        _has_null_in_build_side = false;
+        RETURN_IF_ERROR(_process_build_block(state, *_build_block));
+        _process_hashtable_ctx_variants_init(state);
+
+        if (partition->probe_stream_id >= 0) {
+            RETURN_IF_ERROR(spill_mgr->get_reader(partition->probe_stream_id,
+                                                  _spill_context->probe_reader,
+                                                  _spill_context->profile, true));
+            partition->probe_stream_id = -1;
+        }
+        _probe_eos = false;
+        prepare_for_next();
+        _spill_context->joining_partition = true;
+        COUNTER_UPDATE(_spill_context->partitions_counter, 1);
+        *has_partition = true;
+        return Status::OK();
+    }
+    *has_partition = false;
+    return Status::OK();
+}
+
+Status HashJoinNode::_repartition_spilled_partition(
+        RuntimeState* state, JoinSpillPartition& partition,
+        std::unique_ptr<JoinSpillPartitions> build_partitions) {
+    RETURN_IF_ERROR(build_partitions->finish());
+    auto probe_partitions = std::make_unique<JoinSpillPartitions>(
+            _spill_partition_count_bits, partition.level + 1, state->batch_size(),
+            _spill_context->profile);
+    if (partition.probe_stream_id >= 0) {
+        BlockSpillReaderUPtr probe_reader;
+        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_reader(
+                partition.probe_stream_id, probe_reader, _spill_context->profile, true));
+        partition.probe_stream_id = -1;
+        std::vector<int> res_col_ids(_probe_expr_ctxs.size());
+        bool probe_eos = false;
+        while (!probe_eos) {
+            Block block;
+            RETURN_IF_ERROR(probe_reader->read(&block, &probe_eos));
+            if (block.rows() == 0) {
+                continue;
+            }
+            size_t num_columns = block.columns();
+            RETURN_IF_ERROR(_do_evaluate(block, _probe_expr_ctxs, *_probe_expr_call_timer,
+                                         res_col_ids));
+            RETURN_IF_ERROR(probe_partitions->add_block(block, res_col_ids, 0, num_columns));
+        }
+    }
+    RETURN_IF_ERROR(probe_partitions->finish());
+
+    auto& pending_partitions = _spill_context->pending_partitions;
+    for (size_t i = 0; i < build_partitions->partition_count(); ++i) {
+        auto sub_partition = std::make_unique<JoinSpillPartition>(partition.level + 1,
+                                                                  _spill_context->profile);
+        sub_partition->build_rows = build_partitions->rows(i);
+        sub_partition->build_stream_id = build_partitions->release_stream(i);
+        sub_partition->probe_rows = probe_partitions->rows(i);
+        sub_partition->probe_stream_id = probe_partitions->release_stream(i);
+        pending_partitions.emplace_back(std::move(sub_partition));
+    }
+    COUNTER_UPDATE(_spill_context->repartitions_counter, 1);
+    return Status::OK();
+}
+
 HashJoinNode::~HashJoinNode() {
     if (_shared_hashtable_controller && _should_build_hash_table) {
         // signal at here is abnormal
@@ -1098,6 +1452,7 @@ void HashJoinNode::_release_mem() {
     _tuple_is_null_left_flag_column = nullptr;
     _tuple_is_null_right_flag_column = nullptr;
     _shared_hash_table_context = nullptr;
+    _spill_context = nullptr;
     _probe_block.clear();
 }
 
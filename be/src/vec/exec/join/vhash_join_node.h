@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -29,6 +30,7 @@
 #include <variant>
 #include <vector>
 
+#include "common/config.h"
 #include "common/global_types.h"
 #include "common/status.h"
 #include "exprs/runtime_filter_slots.h"
@@ -45,6 +47,7 @@
 #include "vec/core/block.h"
 #include "vec/core/types.h"
 #include "vec/exec/join/join_op.h" // IWYU pragma: keep
+#include "vec/exec/join/join_spill_partitions.h"
 #include "vec/exprs/vexpr_fwd.h"
 #include "vec/runtime/shared_hash_table_controller.h"
 #include "vjoin_node_base.h"
@@ -74,6 +77,15 @@ template <int JoinOpType, typename Parent>
 struct ProcessHashTableProbe;
 class HashJoinNode;
 
+// The number of tasks building a large hash table, the session variable
+// parallel_hash_join_build_num limited to the threads of the join build thread pool.
+int join_build_task_num(RuntimeState* state);
+
+// Run task(i) for every i in [0, num_tasks) on the join build thread pool and the calling thread,
+// return after all of them are done.
+void parallel_for_join_build(RuntimeState* state, size_t num_tasks,
+                             const std::function<void(size_t)>& task);
+
 template <typename Parent>
 Status process_runtime_filter_build(RuntimeState* state, Block* block, Parent* parent,
                                     bool is_global = false) {
@@ -131,8 +143,17 @@ struct ProcessHashTableBuild {
         hash_table_ctx.init_serialized_keys(_build_raw_ptrs, _rows,
                                             null_map ? null_map->data() : nullptr, true, true,
                                             hash_table_ctx.hash_table->get_bucket_size());
-        hash_table_ctx.hash_table->template build<JoinOpType, with_other_conjuncts>(
-                hash_table_ctx.keys, hash_table_ctx.bucket_nums.data(), _rows);
+        int build_tasks = join_build_task_num(_state);
+        if (build_tasks > 1 && _rows >= config::parallel_hash_join_build_min_rows) {
+            hash_table_ctx.hash_table->template build_parallel<JoinOpType, with_other_conjuncts>(
+                    hash_table_ctx.keys, hash_table_ctx.bucket_nums.data(), _rows, build_tasks,
+                    [&](size_t num_tasks, const std::function<void(size_t)>& task) {
+                        parallel_for_join_build(_state, num_tasks, task);
+                    });
+        } else {
+            hash_table_ctx.hash_table->template build<JoinOpType, with_other_conjuncts>(
+                    hash_table_ctx.keys, hash_table_ctx.bucket_nums.data(), _rows);
+        }
         hash_table_ctx.bucket_nums.resize(_batch_size);
         hash_table_ctx.bucket_nums.shrink_to_fit();
 
@@ -275,6 +296,25 @@ private:
     bool _enable_hash_join_early_start_probe(RuntimeState* state) const;
     bool _is_hash_join_early_start_probe_eos(RuntimeState* state) const;
 
+    // whether the current probe block has been consumed
+    bool _need_probe_block() const;
+
+    Status _push_probe_block(RuntimeState* state, vectorized::Block* input_block, bool eos);
+    Status _pull_probe_block(RuntimeState* state, vectorized::Block* output_block, bool* eos);
+
+    // Grace hash join: once the build side takes more than _external_join_bytes_threshold bytes,
+    // it is spilled to disk partitioned by the join keys, so is the probe side, then the
+    // partitions are joined one by one.
+    bool _can_spill(RuntimeState* state) const;
+    Status _spill_build_side(RuntimeState* state);
+    Status _finish_spilled_build_side(RuntimeState* state);
+    Status _spill_probe_block(RuntimeState* state, Block* block, bool eos);
+    Status _pull_spilled_partitions(RuntimeState* state, Block* output_block, bool* eos);
+    bool _need_join_spilled_partition(const JoinSpillPartition& partition) const;
+    Status _prepare_spilled_partition(RuntimeState* state, bool* has_partition);
+    Status _repartition_spilled_partition(RuntimeState* state, JoinSpillPartition& partition,
+                                          std::unique_ptr<JoinSpillPartitions> build_partitions);
+
     // probe expr
     VExprContextSPtrs _probe_expr_ctxs;
     // build expr
@@ -366,8 +406,15 @@ private:
 
     SharedHashTableContextPtr _shared_hash_table_context = nullptr;
 
+    int64_t _external_join_bytes_threshold = 0;
+    size_t _spill_partition_count_bits = 4;
+    std::unique_ptr<HashJoinSpillContext> _spill_context;
+
     Status _materialize_build_side(RuntimeState* state) override;
 
+    // the first row of the build block is mocked
+    Status _init_build_side_mutable_block();
+
     Status _process_build_block(RuntimeState* state, Block& block);
 
     Status _do_evaluate(Block& block, VExprContextSPtrs& exprs,
@@ -43,6 +43,7 @@
 #include "exec/exec_node.h"
 #include "olap/parallel_scanner_builder.h"
 #include "olap/rowset/rowset_reader.h"
+#include "olap/scan_tablet_pruner.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_manager.h"
 #include "olap/tablet_reader.h"
@@ -86,6 +87,7 @@ Status NewOlapScanNode::prepare(RuntimeState* state) {
     // if you want to add some profile in scan node, even it have not new VScanner object
     // could add here, not in the _init_profile() function
     _tablet_counter = ADD_COUNTER(_runtime_profile, "TabletNum", TUnit::UNIT);
+    _pruned_tablet_counter = ADD_COUNTER(_runtime_profile, "PrunedTabletNum", TUnit::UNIT);
     _key_range_counter = ADD_COUNTER(_runtime_profile, "KeyRangesNum", TUnit::UNIT);
     return Status::OK();
 }
@@ -150,6 +152,9 @@ Status NewOlapScanNode::_init_profile() {
     _bf_filtered_counter = ADD_COUNTER(_segment_profile, "RowsBloomFilterFiltered", TUnit::UNIT);
     _dict_filtered_counter = ADD_COUNTER(_segment_profile, "RowsDictFiltered", TUnit::UNIT);
     _del_filtered_counter = ADD_COUNTER(_scanner_profile, "RowsDelFiltered", TUnit::UNIT);
+    _late_materialization_timer = ADD_TIMER(_scanner_profile, "LateMaterializationTime");
+    _rows_late_materialized_counter =
+            ADD_COUNTER(_scanner_profile, "RowsLateMaterialized", TUnit::UNIT);
     _conditions_filtered_counter =
             ADD_COUNTER(_segment_profile, "RowsConditionsFiltered", TUnit::UNIT);
     _key_range_filtered_counter =
@@ -160,6 +165,8 @@ Status NewOlapScanNode::_init_profile() {
 
     _total_pages_num_counter = ADD_COUNTER(_segment_profile, "TotalPagesNum", TUnit::UNIT);
     _cached_pages_num_counter = ADD_COUNTER(_segment_profile, "CachedPagesNum", TUnit::UNIT);
+    _prefetched_pages_num_counter =
+            ADD_COUNTER(_segment_profile, "PrefetchedPagesNum", TUnit::UNIT);
 
     _bitmap_index_filter_counter =
             ADD_COUNTER(_segment_profile, "RowsBitmapIndexFiltered", TUnit::UNIT);
@@ -285,6 +292,7 @@ Status NewOlapScanNode::_build_key_ranges_and_filters() {
                             RETURN_IF_ERROR(_scan_keys.extend_scan_key(
                                     temp_range, _max_scan_key_num, &exact_range, &eos));
                             if (exact_range) {
+                                range.to_olap_filter(_scan_key_filters);
                                 _colname_to_value_range.erase(iter->first);
                             }
                         } else {
@@ -460,6 +468,13 @@ void NewOlapScanNode::get_cast_types_for_variants() {
 }
 
 Status NewOlapScanNode::_init_scanners(std::list<VScannerSPtr>* scanners) {
+    {
+        SCOPED_TIMER(_scanner_init_timer);
+        ScanTabletPruner pruner(_olap_filters, _scan_key_filters,
+                                _filter_predicates.bloom_filters, _filter_predicates.in_filters,
+                                _state->be_exec_version());
+        COUNTER_UPDATE(_pruned_tablet_counter, pruner.prune(&_scan_ranges));
+    }
     if (_scan_ranges.empty()) {
         _eos = true;
         return Status::OK();
@@ -29,6 +29,7 @@
 #include <ostream>
 #include <set>
 #include <shared_mutex>
+#include <unordered_set>
 
 #include "cloud/config.h"
 #include "common/config.h"
@@ -59,6 +60,7 @@
 #include "vec/exec/scan/new_olap_scan_node.h"
 #include "vec/exec/scan/vscan_node.h"
 #include "vec/exprs/vexpr_context.h"
+#include "vec/exprs/vslot_ref.h"
 #include "vec/json/path_in_data.h"
 #include "vec/olap/block_reader.h"
 
@@ -207,6 +209,14 @@ Status NewOlapScanner::init() {
     if (_state->enable_profile()) {
         _profile->add_info_string("ReadColumns",
                                   read_columns_to_string(tablet_schema, _return_columns));
+        if (!_late_columns.empty()) {
+            std::vector<uint32_t> late_cids;
+            for (const auto& late_column : _late_columns) {
+                late_cids.push_back(late_column.cid);
+            }
+            _profile->add_info_string("LateMaterializedColumns",
+                                      read_columns_to_string(tablet_schema, late_cids));
+        }
     }
 
     if (!cached_schema && !schema_key.empty()) {
@@ -330,6 +340,8 @@ Status NewOlapScanner::_init_tablet_reader_params(
     _tablet_reader_params.profile = _parent ? _parent->runtime_profile() : _local_state->profile();
     _tablet_reader_params.runtime_state = _state;
 
+    RETURN_IF_ERROR(_init_late_materialization());
+
     _tablet_reader_params.origin_return_columns = &_return_columns;
     _tablet_reader_params.tablet_columns_convert_to_null_set = &_tablet_columns_convert_to_null_set;
 
@@ -483,6 +495,191 @@ Status NewOlapScanner::_init_return_columns() {
     return Status::OK();
 }
 
+static void collect_slot_ids(const VExprSPtr& expr, std::unordered_set<SlotId>* slot_ids) {
+    if (expr->is_slot_ref()) {
+        slot_ids->insert(static_cast<const VSlotRef*>(expr.get())->slot_id());
+    }
+    for (const auto& child : expr->children()) {
+        collect_slot_ids(child, slot_ids);
+    }
+}
+
+Status NewOlapScanner::_init_late_materialization() {
+    if (!config::enable_scan_late_materialization || config::is_cloud_mode() ||
+        _conjuncts.empty() || !_common_expr_ctxs_push_down.empty()) {
+        return Status::OK();
+    }
+    auto& tablet = _tablet_reader_params.tablet;
+    auto& tablet_schema = _tablet_reader_params.tablet_schema;
+    // Row locations are only known if the reader returns the rows of segments as they are,
+    // without merging or aggregating them.
+    bool direct_read = _tablet_reader_params.direct_mode ||
+                       tablet->keys_type() == KeysType::DUP_KEYS ||
+                       (tablet->keys_type() == KeysType::UNIQUE_KEYS &&
+                        tablet->enable_unique_key_merge_on_write());
+    auto push_down_agg_type =
+            _parent ? _parent->get_push_down_agg_type() : _local_state->get_push_down_agg_type();
+    TOlapScanNode& olap_scan_node =
+            _parent ? ((NewOlapScanNode*)_parent)->_olap_scan_node
+                    : ((pipeline::OlapScanLocalState*)_local_state)->olap_scan_node();
+    // topn reads filter the block inside the reader, two-phase reads fetch by row id anyway.
+    if (!direct_read || push_down_agg_type != TPushAggOp::NONE ||
+        (olap_scan_node.__isset.sort_info && !olap_scan_node.sort_info.is_asc_order.empty()) ||
+        olap_scan_node.use_topn_opt || tablet_schema->field_index(BeConsts::ROWID_COL) >= 0 ||
+        tablet_schema->num_variant_columns() > 0) {
+        return Status::OK();
+    }
+
+    std::unordered_set<SlotId> conjunct_slots;
+    for (const auto& conjunct : _conjuncts) {
+        collect_slot_ids(conjunct->root(), &conjunct_slots);
+    }
+    // columns of the predicates pushed down to storage are read by the reader anyway
+    std::unordered_set<std::string> pushed_down_columns;
+    for (const auto& condition : _tablet_reader_params.conditions) {
+        pushed_down_columns.insert(condition.column_name);
+    }
+    for (const auto& condition : _tablet_reader_params.conditions_except_leafnode_of_andnode) {
+        pushed_down_columns.insert(condition.column_name);
+    }
+    for (const auto& filter : _tablet_reader_params.bloom_filters) {
+        pushed_down_columns.insert(filter.first);
+    }
+    for (const auto& filter : _tablet_reader_params.bitmap_filters) {
+        pushed_down_columns.insert(filter.first);
+    }
+    for (const auto& filter : _tablet_reader_params.in_filters) {
+        pushed_down_columns.insert(filter.first);
+    }
+    for (const auto& filter : _tablet_reader_params.function_filters) {
+        pushed_down_columns.insert(filter._col_name);
+    }
+
+    std::vector<uint32_t> eager_columns;
+    std::vector<LateColumn> late_columns;
+    size_t position = 0;
+    for (auto* slot : _output_tuple_desc->slots()) {
+        if (!slot->is_materialized() || !slot->need_materialize()) {
+            continue;
+        }
+        uint32_t cid = _return_columns[position];
+        const TabletColumn& column = tablet_schema->column(cid);
+        FieldType type = column.type();
+        // columns which need a conversion after they are read by the segment iterator
+        bool need_convert = type == FieldType::OLAP_FIELD_TYPE_CHAR ||
+                            type == FieldType::OLAP_FIELD_TYPE_DATE ||
+                            type == FieldType::OLAP_FIELD_TYPE_DATETIME ||
+                            type == FieldType::OLAP_FIELD_TYPE_DECIMAL ||
+                            slot->type().type == TYPE_CHAR ||
+                            _tablet_columns_convert_to_null_set.contains(cid);
+        if (conjunct_slots.contains(slot->id()) || column.is_key() || need_convert ||
+            pushed_down_columns.contains(column.name())) {
+            eager_columns.push_back(cid);
+            _eager_positions.push_back(position);
+        } else {
+            late_columns.push_back({.position = position, .cid = cid, .slot_id = slot->id()});
+        }
+        ++position;
+    }
+    if (eager_columns.empty() || late_columns.empty()) {
+        _eager_positions.clear();
+        return Status::OK();
+    }
+
+    _return_columns = std::move(eager_columns);
+    _late_columns = std::move(late_columns);
+    _tablet_reader_params.record_rowids = true;
+    _late_fetcher = std::make_unique<LocalRowIdFetcher>(
+            tablet_schema, _tablet_reader->mutable_stats(), _state->enable_page_cache());
+    for (const auto& rs_split : _tablet_reader_params.rs_splits) {
+        _late_fetcher->add_rowset(rs_split.rs_reader->rowset());
+    }
+    // the conjuncts known so far never use a late column, see above
+    _late_columns_checked_rf_num = _applied_rf_num;
+    _conjuncts_use_late_columns = false;
+    return Status::OK();
+}
+
+void NewOlapScanner::_update_conjuncts_use_late_columns() {
+    // late arrival runtime filters may be appended to the conjuncts, so this is checked
+    // again only when the number of applied runtime filters changes
+    _late_columns_checked_rf_num = _applied_rf_num;
+    std::unordered_set<SlotId> conjunct_slots;
+    for (const auto& conjunct : _conjuncts) {
+        collect_slot_ids(conjunct->root(), &conjunct_slots);
+    }
+    _conjuncts_use_late_columns =
+            std::any_of(_late_columns.begin(), _late_columns.end(),
+                        [&](const LateColumn& late_column) {
+                            return conjunct_slots.contains(late_column.slot_id);
+                        });
+}
+
+Status NewOlapScanner::_materialize_late_columns(Block* block) {
+    auto* stats = _tablet_reader->mutable_stats();
+    SCOPED_RAW_TIMER(&stats->late_materialization_ns);
+    for (const auto& late_column : _late_columns) {
+        auto& column = block->get_by_position(late_column.position);
+        auto materialized = column.type->create_column();
+        if (!_block_row_locations.empty()) {
+            materialized->reserve(_block_row_locations.size());
+            RETURN_IF_ERROR(
+                    _late_fetcher->fetch(_block_row_locations, late_column.cid, materialized));
+        }
+        column.column = std::move(materialized);
+    }
+    stats->rows_late_materialized += _block_row_locations.size();
+    _block_row_locations.clear();
+    return Status::OK();
+}
+
+Status NewOlapScanner::_filter_output_block(Block* block) {
+    if (_late_columns.empty()) {
+        return VScanner::_filter_output_block(block);
+    }
+    if (_late_columns_checked_rf_num != _applied_rf_num) {
+        _update_conjuncts_use_late_columns();
+    }
+    if (_conjuncts_use_late_columns ||
+        block->has(BeConsts::BLOCK_TEMP_COLUMN_SCANNER_FILTERED)) {
+        RETURN_IF_ERROR(_materialize_late_columns(block));
+        return VScanner::_filter_output_block(block);
+    }
+
+    // Filter the eager columns and the row locations, the late columns are still
+    // placeholders at this point and are materialized for the remaining rows.
+    auto old_rows = _block_row_locations.size();
+    IColumn::Filter filter;
+    RETURN_IF_ERROR(VExprContext::execute_conjuncts_and_filter_block(
+            _conjuncts, block, _eager_positions, block->columns(), filter));
+    size_t rows = block->get_by_position(_eager_positions[0]).column->size();
+    _counter.num_rows_unselected += old_rows - rows;
+    if (rows == 0) {
+        _block_row_locations.clear();
+    } else if (rows < old_rows) {
+        size_t pos = 0;
+        for (size_t i = 0; i < old_rows; ++i) {
+            if (filter[i]) {
+                _block_row_locations[pos++] = _block_row_locations[i];
+            }
+        }
+        DCHECK_EQ(pos, rows);
+        _block_row_locations.resize(rows);
+    }
+    // rows beyond the limit of the scanner are never returned, do not fetch them
+    if (_limit > 0 && rows > 0 && _num_rows_return + static_cast<int64_t>(rows) > _limit) {
+        rows = std::max<int64_t>(_limit - _num_rows_return, 0);
+        for (auto position : _eager_positions) {
+            auto& column = block->get_by_position(position).column;
+            column = column->cut(0, rows);
+        }
+        _block_row_locations.resize(rows);
+    }
+    RETURN_IF_ERROR(_materialize_late_columns(block));
+    _erase_temp_columns(block);
+    return Status::OK();
+}
+
 doris::TabletStorageType NewOlapScanner::get_storage_type() {
     int local_reader = 0;
     for (const auto& reader : _tablet_reader_params.rs_splits) {
@@ -502,7 +699,34 @@ Status NewOlapScanner::_get_block_impl(RuntimeState* state, Block* block, bool*
     // Read one block from block reader
     // ATTN: Here we need to let the _get_block_impl method guarantee the semantics of the interface,
     // that is, eof can be set to true only when the returned block is empty.
-    RETURN_IF_ERROR(_tablet_reader->next_block_with_aggregation(block, eof));
+    if (_late_columns.empty()) {
+        RETURN_IF_ERROR(_tablet_reader->next_block_with_aggregation(block, eof));
+    } else {
+        // the tablet reader only reads the eager columns, see _filter_output_block
+        Block eager_block;
+        for (auto position : _eager_positions) {
+            auto& column = block->get_by_position(position);
+            eager_block.insert({std::move(column.column), column.type, column.name});
+        }
+        RETURN_IF_ERROR(_tablet_reader->next_block_with_aggregation(&eager_block, eof));
+        for (size_t i = 0; i < _eager_positions.size(); ++i) {
+            block->get_by_position(_eager_positions[i]).column =
+                    std::move(eager_block.get_by_position(i).column);
+        }
+        size_t rows = eager_block.rows();
+        for (const auto& late_column : _late_columns) {
+            auto& column = block->get_by_position(late_column.position);
+            column.column = rows > 0 ? column.type->create_column_const_with_default_value(rows)
+                                     : column.type->create_column();
+        }
+        if (rows > 0) {
+            _block_row_locations =
+                    static_cast<BlockReader*>(_tablet_reader.get())->current_block_row_locations();
+            DCHECK_EQ(_block_row_locations.size(), rows);
+        } else {
+            _block_row_locations.clear();
+        }
+    }
     if (!_profile_updated) {
         _profile_updated = _tablet_reader->update_profile(_profile);
     }
@@ -525,6 +749,7 @@ Status NewOlapScanner::close(RuntimeState* state) {
     // deconstructor in reader references runtime state
     // so that it will core
     _tablet_reader_params.rs_splits.clear();
+    _late_fetcher.reset();
     _tablet_reader.reset();
     RETURN_IF_ERROR(VScanner::close(state));
     return Status::OK();
@@ -593,6 +818,8 @@ void NewOlapScanner::_update_counters_before_close() {
     COUNTER_UPDATE(Parent->_lazy_read_seek_timer, stats.block_lazy_read_seek_ns);                 \
     COUNTER_UPDATE(Parent->_lazy_read_seek_counter, stats.block_lazy_read_seek_num);              \
     COUNTER_UPDATE(Parent->_output_col_timer, stats.output_col_ns);                               \
+    COUNTER_UPDATE(Parent->_late_materialization_timer, stats.late_materialization_ns);           \
+    COUNTER_UPDATE(Parent->_rows_late_materialized_counter, stats.rows_late_materialized);        \
     COUNTER_UPDATE(Parent->_rows_vec_cond_filtered_counter, stats.rows_vec_cond_filtered);        \
     COUNTER_UPDATE(Parent->_rows_short_circuit_cond_filtered_counter,                             \
                    stats.rows_short_circuit_cond_filtered);                                       \
@@ -613,6 +840,7 @@ void NewOlapScanner::_update_counters_before_close() {
     COUNTER_UPDATE(Parent->_key_range_filtered_counter, stats.rows_key_range_filtered);           \
     COUNTER_UPDATE(Parent->_total_pages_num_counter, stats.total_pages_num);                      \
     COUNTER_UPDATE(Parent->_cached_pages_num_counter, stats.cached_pages_num);                    \
+    COUNTER_UPDATE(Parent->_prefetched_pages_num_counter, stats.prefetched_pages_num);            \
     COUNTER_UPDATE(Parent->_bitmap_index_filter_counter, stats.rows_bitmap_index_filtered);       \
     COUNTER_UPDATE(Parent->_bitmap_index_filter_timer, stats.bitmap_index_filter_timer);          \
     COUNTER_UPDATE(Parent->_inverted_index_filter_counter, stats.rows_inverted_index_filtered);   \
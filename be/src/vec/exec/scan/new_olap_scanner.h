@@ -27,7 +27,9 @@
 #include <vector>
 
 #include "common/factory_creator.h"
+#include "common/global_types.h"
 #include "common/status.h"
+#include "exec/rowid_fetcher.h"
 #include "olap/data_dir.h"
 #include "olap/rowset/rowset_meta.h"
 #include "olap/rowset/rowset_reader.h"
@@ -83,6 +85,7 @@ public:
 protected:
     Status _get_block_impl(RuntimeState* state, Block* block, bool* eos) override;
     void _update_counters_before_close() override;
+    Status _filter_output_block(Block* block) override;
 
 private:
     void _update_realtime_counters();
@@ -95,6 +98,12 @@ private:
     [[nodiscard]] Status _init_return_columns();
     [[nodiscard]] Status _init_variant_columns();
 
+    // Split the return columns into the ones read by the tablet reader and the ones read
+    // by row location after the conjuncts filtered the block, see _late_columns.
+    [[nodiscard]] Status _init_late_materialization();
+    void _update_conjuncts_use_late_columns();
+    Status _materialize_late_columns(Block* block);
+
     std::vector<OlapScanRange*> _key_ranges;
 
     TabletReader::ReaderParams _tablet_reader_params;
@@ -104,6 +113,25 @@ private:
     std::unordered_set<uint32_t> _tablet_columns_convert_to_null_set;
     std::vector<TCondition> _compound_filters;
 
+    // Late materialization: columns which are not referenced by the conjuncts of the
+    // scanner are not read by the tablet reader. The block keeps a placeholder at their
+    // position, and they are fetched by row location only for the rows that survive the
+    // conjuncts (and the limit), so filtered rows never decode them.
+    struct LateColumn {
+        size_t position;
+        uint32_t cid;
+        SlotId slot_id;
+    };
+    std::vector<LateColumn> _late_columns;
+    // block positions of the columns read by the tablet reader
+    std::vector<uint32_t> _eager_positions;
+    std::unique_ptr<LocalRowIdFetcher> _late_fetcher;
+    std::vector<RowLocation> _block_row_locations;
+    // whether a (late arrival) runtime filter of the conjuncts reads a late column, it was
+    // computed when _applied_rf_num was _late_columns_checked_rf_num
+    bool _conjuncts_use_late_columns = false;
+    int _late_columns_checked_rf_num = 0;
+
     // ========= profiles ==========
     int64_t _compressed_bytes_read = 0;
     int64_t _raw_rows_read = 0;
@@ -159,13 +159,17 @@ Status VScanner::_filter_output_block(Block* block) {
     auto old_rows = block->rows();
     Status st = VExprContext::filter_block(_conjuncts, block, block->columns());
     _counter.num_rows_unselected += old_rows - block->rows();
+    _erase_temp_columns(block);
+    return st;
+}
+
+void VScanner::_erase_temp_columns(Block* block) {
     auto all_column_names = block->get_names();
     for (auto& name : all_column_names) {
         if (name.rfind(BeConsts::BLOCK_TEMP_COLUMN_PREFIX, 0) == 0) {
             block->erase(name);
         }
     }
-    return st;
 }
 
 Status VScanner::_do_projections(vectorized::Block* origin_block, vectorized::Block* output_block) {
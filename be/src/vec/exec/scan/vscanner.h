@@ -89,7 +89,10 @@ protected:
     virtual void _update_counters_before_close();
 
     // Filter the output block finally.
-    Status _filter_output_block(Block* block);
+    virtual Status _filter_output_block(Block* block);
+
+    // Remove the temporary columns (BeConsts::BLOCK_TEMP_COLUMN_PREFIX) added while filtering.
+    static void _erase_temp_columns(Block* block);
 
     Status _do_projections(vectorized::Block* origin_block, vectorized::Block* output_block);
 
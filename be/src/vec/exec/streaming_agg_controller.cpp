@@ -0,0 +1,150 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/streaming_agg_controller.h"
+
+#include <fmt/format.h>
+
+#include <limits>
+
+namespace doris::vectorized {
+
+/// The minimum reduction factor (input rows divided by output rows) to grow hash tables
+/// in a streaming preaggregation, given that the hash tables are currently the given
+/// size or above. The sizes roughly correspond to hash table sizes where the bucket
+/// arrays will fit in  a cache level. Intuitively, we don't want the working set of the
+/// aggregation to expand to the next level of cache unless we're reducing the input
+/// enough to outweigh the increased memory latency we'll incur for each hash table
+/// lookup.
+struct StreamingHtMinReductionEntry {
+    // Use 'streaming_ht_min_reduction' if the total size of hash table bucket directories in
+    // bytes is greater than this threshold.
+    size_t min_ht_mem;
+    // The minimum reduction factor to expand the hash tables.
+    double streaming_ht_min_reduction;
+};
+
+// TODO: experimentally tune these values and also programmatically get the cache size
+// of the machine that we're running on.
+static constexpr StreamingHtMinReductionEntry STREAMING_HT_MIN_REDUCTION[] = {
+        // Expand up to L2 cache always.
+        {0, 0.0},
+        // Expand into L3 cache if we look like we're getting some reduction.
+        // At present, The L2 cache is generally 1024k or more
+        {1024 * 1024, 1.1},
+        // Expand into main memory if we're getting a significant reduction.
+        // The L3 cache is generally 16MB or more
+        {16 * 1024 * 1024, 2.0},
+};
+
+static constexpr int STREAMING_HT_MIN_REDUCTION_SIZE =
+        sizeof(STREAMING_HT_MIN_REDUCTION) / sizeof(STREAMING_HT_MIN_REDUCTION[0]);
+
+void StreamingAggController::init_profile(RuntimeProfile* profile) {
+    _profile = profile;
+    _aggregate_batches = ADD_COUNTER(profile, "PreAggAggregateBatches", TUnit::UNIT);
+    _partial_batches = ADD_COUNTER(profile, "PreAggPartialBatches", TUnit::UNIT);
+    _pass_through_batches = ADD_COUNTER(profile, "PreAggPassThroughBatches", TUnit::UNIT);
+    _mode_switches = ADD_COUNTER(profile, "PreAggModeSwitches", TUnit::UNIT);
+    _profile->add_info_string("PreAggMode", mode_name(_mode));
+}
+
+StreamingAggController::Mode StreamingAggController::next_mode(size_t ht_bytes,
+                                                               bool memory_exceeded) {
+    int cache_level = 0;
+    while (cache_level + 1 < STREAMING_HT_MIN_REDUCTION_SIZE &&
+           ht_bytes >= STREAMING_HT_MIN_REDUCTION[cache_level + 1].min_ht_mem) {
+        ++cache_level;
+    }
+
+    _memory_exceeded = memory_exceeded;
+    const double current_reduction = reduction();
+    Mode mode;
+    if (!memory_exceeded &&
+        (cache_level == 0 ||
+         current_reduction > STREAMING_HT_MIN_REDUCTION[cache_level].streaming_ht_min_reduction)) {
+        mode = Mode::AGGREGATE;
+    } else if (current_reduction > PASS_THROUGH_MAX_REDUCTION) {
+        mode = Mode::PARTIAL;
+    } else {
+        mode = Mode::PASS_THROUGH;
+    }
+    _switch_to(mode, ht_bytes);
+
+    if (mode == Mode::PASS_THROUGH && ++_batches_since_probe >= RESAMPLE_INTERVAL) {
+        // probe this batch without leaving pass through, its reduction decides whether the
+        // task goes on passing through
+        _batches_since_probe = 0;
+        mode = Mode::PARTIAL;
+    }
+
+    switch (mode) {
+    case Mode::AGGREGATE:
+        COUNTER_UPDATE(_aggregate_batches, 1);
+        break;
+    case Mode::PARTIAL:
+        COUNTER_UPDATE(_partial_batches, 1);
+        break;
+    case Mode::PASS_THROUGH:
+        COUNTER_UPDATE(_pass_through_batches, 1);
+        break;
+    }
+    return mode;
+}
+
+bool StreamingAggController::may_add_groups(Mode mode, bool overflow) const {
+    return mode == Mode::AGGREGATE || (mode == Mode::PARTIAL && !overflow && !_memory_exceeded);
+}
+
+void StreamingAggController::update(size_t rows, size_t new_groups) {
+    _probed_rows = _probed_rows * REDUCTION_DECAY + rows;
+    _new_groups = _new_groups * REDUCTION_DECAY + new_groups;
+}
+
+double StreamingAggController::reduction() const {
+    // no new group since the history decayed, every probed row hit the table
+    if (_new_groups < 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return _probed_rows / _new_groups;
+}
+
+const char* StreamingAggController::mode_name(Mode mode) {
+    switch (mode) {
+    case Mode::AGGREGATE:
+        return "AGGREGATE";
+    case Mode::PARTIAL:
+        return "PARTIAL";
+    case Mode::PASS_THROUGH:
+        return "PASS_THROUGH";
+    }
+    return "UNKNOWN";
+}
+
+void StreamingAggController::_switch_to(Mode mode, size_t ht_bytes) {
+    if (mode == _mode) {
+        return;
+    }
+    _mode = mode;
+    _batches_since_probe = 0;
+    COUNTER_UPDATE(_mode_switches, 1);
+    _profile->add_info_string("PreAggMode",
+                              fmt::format("{}, since reduction {:.2f} with {} bytes hash table",
+                                          mode_name(mode), reduction(), ht_bytes));
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,96 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/runtime_profile.h"
+
+namespace doris::vectorized {
+
+/// Decides batch by batch how a streaming pre-aggregation handles its input, from the
+/// reduction observed on recent batches and the footprint of its hash table.
+///
+/// The reduction of a batch is its rows divided by the groups it adds to the hash table,
+/// so it measures how much the next rows are worth aggregating rather than how much the
+/// table reduced in the past. It is smoothed over recent batches and compared with the
+/// minimum reduction of the cache level the hash table lives in:
+///  - up to L2 the table always aggregates and expands;
+///  - beyond that it keeps expanding only while the reduction pays for the slower lookups,
+///    otherwise it stops growing and only aggregates the rows whose groups it already has;
+///  - beyond the memory limit it never grows, not even into the room it has left;
+///  - if even those are too rare the batches are passed through without probing, and
+///    every RESAMPLE_INTERVAL batches one batch is probed again to refresh the estimate,
+///    so a task can move back to aggregating when the input changes.
+/// Every pipeline task owns its controller, tasks with different inputs decide apart.
+class StreamingAggController {
+public:
+    enum class Mode {
+        // aggregate the batch and let the hash table expand
+        AGGREGATE,
+        // aggregate the batch if the hash table has room for it and the memory limit is not
+        // exceeded, otherwise aggregate the rows whose groups are in the table and pass
+        // through the others
+        PARTIAL,
+        // pass through the whole batch
+        PASS_THROUGH,
+    };
+
+    // Reduction below which a task passes through instead of probing its hash table.
+    static constexpr double PASS_THROUGH_MAX_REDUCTION = 1.05;
+    // Weight of the history in the smoothed reduction, per batch.
+    static constexpr double REDUCTION_DECAY = 0.8;
+    // Passed through batches between two probed batches.
+    static constexpr int RESAMPLE_INTERVAL = 32;
+
+    void init_profile(RuntimeProfile* profile);
+
+    // The mode of the next batch. `ht_bytes` is the buffer size of the hash table,
+    // `memory_exceeded` forbids the table to grow.
+    Mode next_mode(size_t ht_bytes, bool memory_exceeded);
+
+    // Whether a batch in `mode`, the mode returned by the last next_mode(), may add groups to
+    // the hash table. `overflow` tells that the batch may make the table resize.
+    bool may_add_groups(Mode mode, bool overflow) const;
+
+    // `rows` rows of a probed batch found no group in the hash table, or created one.
+    void update(size_t rows, size_t new_groups);
+
+    double reduction() const;
+
+    static const char* mode_name(Mode mode);
+
+private:
+    void _switch_to(Mode mode, size_t ht_bytes);
+
+    Mode _mode = Mode::AGGREGATE;
+    bool _memory_exceeded = false;
+    // decayed sums of the rows and the new groups of the probed batches
+    double _probed_rows = 0;
+    double _new_groups = 0;
+    int _batches_since_probe = 0;
+
+    RuntimeProfile* _profile = nullptr;
+    RuntimeProfile::Counter* _aggregate_batches = nullptr;
+    RuntimeProfile::Counter* _partial_batches = nullptr;
+    RuntimeProfile::Counter* _pass_through_batches = nullptr;
+    RuntimeProfile::Counter* _mode_switches = nullptr;
+};
+
+} // namespace doris::vectorized
@@ -32,10 +32,12 @@
 #include "runtime/block_spill_manager.h"
 #include "runtime/define_primitive_type.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/memory/mem_tracker.h"
 #include "runtime/primitive_type.h"
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
+#include "util/threadpool.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/common/hash_table/hash.h"
 #include "vec/common/hash_table/hash_map_context_creator.h"
@@ -56,48 +58,6 @@ class ObjectPool;
 } // namespace doris
 
 namespace doris::vectorized {
-/// The minimum reduction factor (input rows divided by output rows) to grow hash tables
-/// in a streaming preaggregation, given that the hash tables are currently the given
-/// size or above. The sizes roughly correspond to hash table sizes where the bucket
-/// arrays will fit in  a cache level. Intuitively, we don't want the working set of the
-/// aggregation to expand to the next level of cache unless we're reducing the input
-/// enough to outweigh the increased memory latency we'll incur for each hash table
-/// lookup.
-///
-/// Note that the current reduction achieved is not always a good estimate of the
-/// final reduction. It may be biased either way depending on the ordering of the
-/// input. If the input order is random, we will underestimate the final reduction
-/// factor because the probability of a row having the same key as a previous row
-/// increases as more input is processed.  If the input order is correlated with the
-/// key, skew may bias the estimate. If high cardinality keys appear first, we
-/// may overestimate and if low cardinality keys appear first, we underestimate.
-/// To estimate the eventual reduction achieved, we estimate the final reduction
-/// using the planner's estimated input cardinality and the assumption that input
-/// is in a random order. This means that we assume that the reduction factor will
-/// increase over time.
-struct StreamingHtMinReductionEntry {
-    // Use 'streaming_ht_min_reduction' if the total size of hash table bucket directories in
-    // bytes is greater than this threshold.
-    int min_ht_mem;
-    // The minimum reduction factor to expand the hash tables.
-    double streaming_ht_min_reduction;
-};
-
-// TODO: experimentally tune these values and also programmatically get the cache size
-// of the machine that we're running on.
-static constexpr StreamingHtMinReductionEntry STREAMING_HT_MIN_REDUCTION[] = {
-        // Expand up to L2 cache always.
-        {0, 0.0},
-        // Expand into L3 cache if we look like we're getting some reduction.
-        // At present, The L2 cache is generally 1024k or more
-        {1024 * 1024, 1.1},
-        // Expand into main memory if we're getting a significant reduction.
-        // The L3 cache is generally 16MB or more
-        {16 * 1024 * 1024, 2.0},
-};
-
-static constexpr int STREAMING_HT_MIN_REDUCTION_SIZE =
-        sizeof(STREAMING_HT_MIN_REDUCTION) / sizeof(STREAMING_HT_MIN_REDUCTION[0]);
 
 AggregationNode::AggregationNode(ObjectPool* pool, const TPlanNode& tnode,
                                  const DescriptorTbl& descs)
@@ -156,6 +116,7 @@ Status AggregationNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
         _spill_partition_helper =
                 std::make_unique<SpillPartitionHelper>(spill_partition_count_bits);
+        RETURN_IF_ERROR(state->spill_compression_type(&_spill_context.compression_type));
     }
 
     _is_merge = std::any_of(agg_functions.cbegin(), agg_functions.cend(),
@@ -246,6 +207,11 @@ Status AggregationNode::prepare_profile(RuntimeState* state) {
     _hash_table_iterate_timer = ADD_TIMER(runtime_profile(), "HashTableIterateTime");
     _insert_keys_to_column_timer = ADD_TIMER(runtime_profile(), "InsertKeysToColumnTime");
     _streaming_agg_timer = ADD_TIMER(runtime_profile(), "StreamingAggTime");
+    _spill_repartition_counter =
+            ADD_COUNTER(runtime_profile(), "SpillRepartitionCount", TUnit::UNIT);
+    if (_is_streaming_preagg) {
+        _preagg_controller.init_profile(runtime_profile());
+    }
     _hash_table_size_counter = ADD_COUNTER(runtime_profile(), "HashTableSize", TUnit::UNIT);
     _hash_table_input_counter = ADD_COUNTER(runtime_profile(), "HashTableInputCount", TUnit::UNIT);
     _max_row_size_counter = ADD_COUNTER(runtime_profile(), "MaxRowSizeInBytes", TUnit::UNIT);
@@ -454,7 +420,6 @@ Status AggregationNode::do_pre_agg(vectorized::Block* input_block,
     SCOPED_TIMER(_exec_timer);
     RETURN_IF_ERROR(_executor.pre_agg(input_block, output_block));
 
-    // pre stream agg need use _num_row_return to decide whether to do pre stream agg
     _num_rows_returned += output_block->rows();
     _make_nullable_output_key(output_block);
     COUNTER_SET(_rows_returned_counter, _num_rows_returned);
@@ -713,65 +678,6 @@ void AggregationNode::_make_nullable_output_key(Block* block) {
     }
 }
 
-bool AggregationNode::_should_expand_preagg_hash_tables() {
-    if (!_should_expand_hash_table) {
-        return false;
-    }
-
-    return std::visit(
-            [&](auto&& agg_method) -> bool {
-                auto& hash_tbl = *agg_method.hash_table;
-                auto [ht_mem, ht_rows] =
-                        std::pair {hash_tbl.get_buffer_size_in_bytes(), hash_tbl.size()};
-
-                // Need some rows in tables to have valid statistics.
-                if (ht_rows == 0) {
-                    return true;
-                }
-
-                // Find the appropriate reduction factor in our table for the current hash table sizes.
-                int cache_level = 0;
-                while (cache_level + 1 < STREAMING_HT_MIN_REDUCTION_SIZE &&
-                       ht_mem >= STREAMING_HT_MIN_REDUCTION[cache_level + 1].min_ht_mem) {
-                    ++cache_level;
-                }
-
-                // Compare the number of rows in the hash table with the number of input rows that
-                // were aggregated into it. Exclude passed through rows from this calculation since
-                // they were not in hash tables.
-                const int64_t input_rows = _children[0]->rows_returned();
-                const int64_t aggregated_input_rows = input_rows - _num_rows_returned;
-                // TODO chenhao
-                //  const int64_t expected_input_rows = estimated_input_cardinality_ - num_rows_returned_;
-                double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
-
-                // TODO: workaround for IMPALA-2490: subplan node rows_returned counter may be
-                // inaccurate, which could lead to a divide by zero below.
-                if (aggregated_input_rows <= 0) {
-                    return true;
-                }
-
-                // Extrapolate the current reduction factor (r) using the formula
-                // R = 1 + (N / n) * (r - 1), where R is the reduction factor over the full input data
-                // set, N is the number of input rows, excluding passed-through rows, and n is the
-                // number of rows inserted or merged into the hash tables. This is a very rough
-                // approximation but is good enough to be useful.
-                // TODO: consider collecting more statistics to better estimate reduction.
-                //  double estimated_reduction = aggregated_input_rows >= expected_input_rows
-                //      ? current_reduction
-                //      : 1 + (expected_input_rows / aggregated_input_rows) * (current_reduction - 1);
-                double min_reduction =
-                        STREAMING_HT_MIN_REDUCTION[cache_level].streaming_ht_min_reduction;
-
-                //  COUNTER_SET(preagg_estimated_reduction_, estimated_reduction);
-                //    COUNTER_SET(preagg_streaming_ht_min_reduction_, min_reduction);
-                //  return estimated_reduction > min_reduction;
-                _should_expand_hash_table = current_reduction > min_reduction;
-                return _should_expand_hash_table;
-            },
-            _agg_data->method_variant);
-}
-
 size_t AggregationNode::_memory_usage() const {
     size_t usage = 0;
     if (_agg_arena_pool) {
@@ -817,6 +723,12 @@ size_t AggregationNode::_get_hash_table_size() {
                       _agg_data->method_variant);
 }
 
+size_t AggregationNode::_get_hash_table_buffer_size() {
+    return std::visit(
+            [&](auto&& agg_method) { return agg_method.hash_table->get_buffer_size_in_bytes(); },
+            _agg_data->method_variant);
+}
+
 void AggregationNode::_emplace_into_hash_table(AggregateDataPtr* places, ColumnRawPtrs& key_columns,
                                                const size_t num_rows) {
     std::visit(
@@ -890,6 +802,7 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
 
     size_t key_size = _probe_expr_ctxs.size();
     ColumnRawPtrs key_columns(key_size);
+    std::vector<int> key_column_ids(key_size);
     {
         SCOPED_TIMER(_expr_timer);
         for (size_t i = 0; i < key_size; ++i) {
@@ -899,6 +812,7 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
                     in_block->get_by_position(result_column_id)
                             .column->convert_to_full_column_if_const();
             key_columns[i] = in_block->get_by_position(result_column_id).column.get();
+            key_column_ids[i] = result_column_id;
         }
     }
 
@@ -913,88 +827,113 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
     // pressure. In either case we should always use the remaining space in the hash table
     // to avoid wasting memory.
     // But for fixed hash map, it never need to expand
-    bool ret_flag = false;
-    RETURN_IF_ERROR(std::visit(
-            [&](auto&& agg_method) -> Status {
-                if (auto& hash_tbl = *agg_method.hash_table;
-                    hash_tbl.add_elem_size_overflow(rows)) {
-                    /// If too much memory is used during the pre-aggregation stage,
-                    /// it is better to output the data directly without performing further aggregation.
-                    const bool used_too_much_memory =
-                            (_external_agg_bytes_threshold > 0 &&
-                             _memory_usage() > _external_agg_bytes_threshold);
-                    // do not try to do agg, just init and serialize directly return the out_block
-                    if (!_should_expand_preagg_hash_tables() || used_too_much_memory) {
-                        SCOPED_TIMER(_streaming_agg_timer);
-                        ret_flag = true;
-
-                        // will serialize value data to string column.
-                        // non-nullable column(id in `_make_nullable_keys`)
-                        // will be converted to nullable.
-                        bool mem_reuse = _make_nullable_keys.empty() && out_block->mem_reuse();
-
-                        std::vector<DataTypePtr> data_types;
-                        MutableColumns value_columns;
-                        for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
-                            auto data_type =
-                                    _aggregate_evaluators[i]->function()->get_serialized_type();
-                            if (mem_reuse) {
-                                value_columns.emplace_back(
-                                        std::move(*out_block->get_by_position(i + key_size).column)
-                                                .mutate());
-                            } else {
-                                // slot type of value it should always be string type
-                                value_columns.emplace_back(_aggregate_evaluators[i]
-                                                                   ->function()
-                                                                   ->create_serialize_column());
-                            }
-                            data_types.emplace_back(data_type);
-                        }
-
-                        for (int i = 0; i != _aggregate_evaluators.size(); ++i) {
-                            SCOPED_TIMER(_serialize_data_timer);
-                            RETURN_IF_ERROR(
-                                    _aggregate_evaluators[i]->streaming_agg_serialize_to_column(
-                                            in_block, value_columns[i], rows,
-                                            _agg_arena_pool.get()));
-                        }
-
-                        if (!mem_reuse) {
-                            ColumnsWithTypeAndName columns_with_schema;
-                            for (int i = 0; i < key_size; ++i) {
-                                columns_with_schema.emplace_back(
-                                        key_columns[i]->clone_resized(rows),
-                                        _probe_expr_ctxs[i]->root()->data_type(),
-                                        _probe_expr_ctxs[i]->root()->expr_name());
-                            }
-                            for (int i = 0; i < value_columns.size(); ++i) {
-                                columns_with_schema.emplace_back(std::move(value_columns[i]),
-                                                                 data_types[i], "");
-                            }
-                            out_block->swap(Block(columns_with_schema));
-                        } else {
-                            for (int i = 0; i < key_size; ++i) {
-                                std::move(*out_block->get_by_position(i).column)
-                                        .mutate()
-                                        ->insert_range_from(*key_columns[i], 0, rows);
-                            }
-                        }
-                    }
-                }
-                return Status::OK();
-            },
-            _agg_data->method_variant));
-
-    if (!ret_flag) {
+    /// If too much memory is used during the pre-aggregation stage,
+    /// it is better to output the data directly without performing further aggregation.
+    const bool used_too_much_memory =
+            (_external_agg_bytes_threshold > 0 && _memory_usage() > _external_agg_bytes_threshold);
+    const auto mode =
+            _preagg_controller.next_mode(_get_hash_table_buffer_size(), used_too_much_memory);
+    if (mode == StreamingAggController::Mode::PASS_THROUGH) {
+        // do not try to do agg, just init and serialize directly return the out_block
+        return _pre_agg_pass_through(in_block, key_column_ids, out_block);
+    }
+
+    const bool overflow = std::visit(
+            [&](auto&& agg_method) { return agg_method.hash_table->add_elem_size_overflow(rows); },
+            _agg_data->method_variant);
+    if (_preagg_controller.may_add_groups(mode, overflow)) {
+        const size_t groups = _get_hash_table_size();
         RETURN_IF_CATCH_EXCEPTION(_emplace_into_hash_table(_places.data(), key_columns, rows));
 
         for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
             RETURN_IF_ERROR(_aggregate_evaluators[i]->execute_batch_add(
                     in_block, _offsets_of_aggregate_states[i], _places.data(),
-                    _agg_arena_pool.get(), _should_expand_hash_table));
+                    _agg_arena_pool.get(), mode == StreamingAggController::Mode::AGGREGATE));
+        }
+        _preagg_controller.update(rows, _get_hash_table_size() - groups);
+        return Status::OK();
+    }
+
+    // the hash table may not grow or is beyond the memory limit, aggregate the rows of the
+    // groups in it and pass through the others
+    _find_in_hash_table(_places.data(), key_columns, rows);
+    IColumn::Filter miss_filter(rows);
+    size_t misses = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        miss_filter[i] = _places[i] == nullptr;
+        misses += miss_filter[i];
+    }
+    if (misses < rows) {
+        for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
+            RETURN_IF_ERROR(_aggregate_evaluators[i]->execute_batch_add_selected(
+                    in_block, _offsets_of_aggregate_states[i], _places.data(),
+                    _agg_arena_pool.get()));
         }
     }
+    _preagg_controller.update(rows, misses);
+    if (misses == 0) {
+        return Status::OK();
+    }
+    if (misses < rows) {
+        RETURN_IF_CATCH_EXCEPTION(
+                Block::filter_block_internal(in_block, miss_filter, in_block->columns()));
+    }
+    return _pre_agg_pass_through(in_block, key_column_ids, out_block);
+}
+
+Status AggregationNode::_pre_agg_pass_through(Block* in_block,
+                                              const std::vector<int>& key_column_ids,
+                                              Block* out_block) {
+    SCOPED_TIMER(_streaming_agg_timer);
+    size_t key_size = key_column_ids.size();
+    size_t rows = in_block->rows();
 
+    // will serialize value data to string column.
+    // non-nullable column(id in `_make_nullable_keys`)
+    // will be converted to nullable.
+    bool mem_reuse = _make_nullable_keys.empty() && out_block->mem_reuse();
+
+    std::vector<DataTypePtr> data_types;
+    MutableColumns value_columns;
+    for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
+        auto data_type = _aggregate_evaluators[i]->function()->get_serialized_type();
+        if (mem_reuse) {
+            value_columns.emplace_back(
+                    std::move(*out_block->get_by_position(i + key_size).column).mutate());
+        } else {
+            // slot type of value it should always be string type
+            value_columns.emplace_back(
+                    _aggregate_evaluators[i]->function()->create_serialize_column());
+        }
+        data_types.emplace_back(data_type);
+    }
+
+    for (int i = 0; i != _aggregate_evaluators.size(); ++i) {
+        SCOPED_TIMER(_serialize_data_timer);
+        RETURN_IF_ERROR(_aggregate_evaluators[i]->streaming_agg_serialize_to_column(
+                in_block, value_columns[i], rows, _agg_arena_pool.get()));
+    }
+
+    if (!mem_reuse) {
+        ColumnsWithTypeAndName columns_with_schema;
+        for (int i = 0; i < key_size; ++i) {
+            columns_with_schema.emplace_back(
+                    in_block->get_by_position(key_column_ids[i]).column->clone_resized(rows),
+                    _probe_expr_ctxs[i]->root()->data_type(),
+                    _probe_expr_ctxs[i]->root()->expr_name());
+        }
+        for (int i = 0; i < value_columns.size(); ++i) {
+            columns_with_schema.emplace_back(std::move(value_columns[i]), data_types[i], "");
+        }
+        out_block->swap(Block(columns_with_schema));
+    } else {
+        for (int i = 0; i < key_size; ++i) {
+            std::move(*out_block->get_by_position(i).column)
+                    .mutate()
+                    ->insert_range_from(*in_block->get_by_position(key_column_ids[i]).column, 0,
+                                        rows);
+        }
+    }
     return Status::OK();
 }
 
@@ -1074,26 +1013,25 @@ Status AggregationNode::_serialize_hash_table_to_block(HashTableCtxType& context
 }
 
 template <typename HashTableCtxType, typename HashTableType>
-Status AggregationNode::_spill_hash_table(HashTableCtxType& agg_method, HashTableType& hash_table) {
+Status AggregationNode::_spill_hash_table(HashTableCtxType& agg_method, HashTableType& hash_table,
+                                          AggSpillContext& context) {
     Block block;
     std::vector<typename HashTableType::key_type> keys;
     RETURN_IF_ERROR(_serialize_hash_table_to_block(agg_method, hash_table, block, keys));
     CHECK_EQ(block.rows(), hash_table.size());
     CHECK_EQ(keys.size(), block.rows());
 
-    if (!_spill_context.has_data) {
-        _spill_context.has_data = true;
-        _spill_context.runtime_profile = _runtime_profile->create_child("Spill", true, true);
+    if (!context.has_data) {
+        context.has_data = true;
+        context.runtime_profile = _runtime_profile->create_child("Spill", true, true);
     }
 
     BlockSpillWriterUPtr writer;
-    RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
-            std::numeric_limits<int32_t>::max(), writer, _spill_context.runtime_profile));
+    RETURN_IF_ERROR(context.get_writer(writer));
     Defer defer {[&]() {
         // redundant call is ok
         static_cast<void>(writer->close());
     }};
-    _spill_context.stream_ids.emplace_back(writer->get_id());
 
     std::vector<size_t> partitioned_indices(block.rows());
     std::vector<size_t> blocks_rows(_spill_partition_helper->partition_count);
@@ -1101,7 +1039,8 @@ Status AggregationNode::_spill_hash_table(HashTableCtxType& agg_method, HashTabl
     // The last row may contain a null key.
     const size_t rows = hash_table.has_null_key_data() ? block.rows() - 1 : block.rows();
     for (size_t i = 0; i < rows; ++i) {
-        const auto index = _spill_partition_helper->get_index(hash_table.hash(keys[i]));
+        const auto index =
+                _spill_partition_helper->get_index(hash_table.hash(keys[i]), context.level);
         partitioned_indices[i] = index;
         blocks_rows[index]++;
     }
@@ -1172,7 +1111,7 @@ Status AggregationNode::_try_spill_disk(bool eos) {
                     return Status::OK();
                 }
 
-                RETURN_IF_ERROR(_spill_hash_table(agg_method, hash_table));
+                RETURN_IF_ERROR(_spill_hash_table(agg_method, hash_table, _spill_context));
                 return _reset_hash_table();
             },
             _agg_data->method_variant);
@@ -1188,30 +1127,57 @@ Status AggregationNode::_execute_with_serialized_key(Block* block) {
 
 Status AggregationNode::_merge_spilt_data() {
     CHECK(!_spill_context.stream_ids.empty());
+    auto* context = _spill_context.current(_spill_partition_helper->partition_count);
+
+    std::vector<Block> blocks;
+    RETURN_IF_ERROR(context->read_partition(&blocks));
+    for (auto& block : blocks) {
+        auto st = _merge_with_serialized_key_helper<false /* limit */, true /* for_spill */>(
+                &block);
+        RETURN_IF_ERROR(st);
+        block.clear();
+
+        // The partition does not fit in memory, maybe the keys are skewed to it. Spill what has
+        // been merged into the partitions of the next level, they are merged after this one.
+        if (context->level < SpillPartitionHelper::MAX_REPARTITION_LEVEL &&
+            _memory_usage() > _external_agg_bytes_threshold) {
+            RETURN_IF_ERROR(_repartition_spilt_data(context));
+        }
+    }
 
-    for (auto& reader : _spill_context.readers) {
-        CHECK_LT(_spill_context.read_cursor, reader->block_count());
-        reader->seek(_spill_context.read_cursor);
-        Block block;
-        bool eos;
-        RETURN_IF_ERROR(reader->read(&block, &eos));
-
-        if (!block.empty()) {
-            auto st = _merge_with_serialized_key_helper<false /* limit */, true /* for_spill */>(
-                    &block);
-            RETURN_IF_ERROR(st);
+    if (context->repartitioned != nullptr) {
+        if (_get_hash_table_size() > 0) {
+            RETURN_IF_ERROR(_repartition_spilt_data(context));
         }
+        RETURN_IF_ERROR(context->repartitioned->prepare_for_reading());
     }
-    _spill_context.read_cursor++;
     return Status::OK();
 }
 
+Status AggregationNode::_repartition_spilt_data(AggSpillContext* context) {
+    if (context->repartitioned == nullptr) {
+        context->repartitioned = std::make_unique<AggSpillContext>();
+        context->repartitioned->has_data = true;
+        context->repartitioned->level = context->level + 1;
+        context->repartitioned->runtime_profile = context->runtime_profile;
+        context->repartitioned->compression_type = context->compression_type;
+        COUNTER_UPDATE(_spill_repartition_counter, 1);
+    }
+    RETURN_IF_ERROR(std::visit(
+            [&](auto&& agg_method) -> Status {
+                return _spill_hash_table(agg_method, *agg_method.hash_table,
+                                         *context->repartitioned);
+            },
+            _agg_data->method_variant));
+    return _reset_hash_table();
+}
+
 Status AggregationNode::_get_result_with_spilt_data(RuntimeState* state, Block* block, bool* eos) {
     CHECK(!_spill_context.stream_ids.empty());
     CHECK(_spill_partition_helper != nullptr) << "_spill_partition_helper should not be null";
     _aggregate_data_container->init_once();
     while (_aggregate_data_container->iterator == _aggregate_data_container->end()) {
-        if (_spill_context.read_cursor == _spill_partition_helper->partition_count) {
+        if (_spill_context.finished(_spill_partition_helper->partition_count)) {
             break;
         }
         RETURN_IF_ERROR(_reset_hash_table());
@@ -1221,7 +1187,7 @@ Status AggregationNode::_get_result_with_spilt_data(RuntimeState* state, Block*
 
     RETURN_IF_ERROR(_get_result_with_serialized_key_non_spill(state, block, eos));
     if (*eos) {
-        *eos = _spill_context.read_cursor == _spill_partition_helper->partition_count;
+        *eos = _spill_context.finished(_spill_partition_helper->partition_count);
     }
     CHECK(!block->empty() || *eos);
     return Status::OK();
@@ -1355,7 +1321,7 @@ Status AggregationNode::_serialize_with_serialized_key_result_with_spilt_data(Ru
     CHECK(_spill_partition_helper != nullptr) << "_spill_partition_helper should not be null";
     _aggregate_data_container->init_once();
     while (_aggregate_data_container->iterator == _aggregate_data_container->end()) {
-        if (_spill_context.read_cursor == _spill_partition_helper->partition_count) {
+        if (_spill_context.finished(_spill_partition_helper->partition_count)) {
             break;
         }
         RETURN_IF_ERROR(_reset_hash_table());
@@ -1365,7 +1331,7 @@ Status AggregationNode::_serialize_with_serialized_key_result_with_spilt_data(Ru
 
     RETURN_IF_ERROR(_serialize_with_serialized_key_result_non_spill(state, block, eos));
     if (*eos) {
-        *eos = _spill_context.read_cursor == _spill_partition_helper->partition_count;
+        *eos = _spill_context.finished(_spill_partition_helper->partition_count);
     }
     CHECK(!block->empty() || *eos);
     return Status::OK();
@@ -1560,4 +1526,72 @@ Status AggSpillContext::prepare_for_reading() {
     return Status::OK();
 }
 
+Status AggSpillContext::get_writer(BlockSpillWriterUPtr& writer) {
+    RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
+            std::numeric_limits<int32_t>::max(), writer, runtime_profile));
+    writer->set_compression_type(compression_type);
+    stream_ids.emplace_back(writer->get_id());
+    return Status::OK();
+}
+
+AggSpillContext* AggSpillContext::current(size_t partition_count) {
+    if (repartitioned != nullptr) {
+        if (!repartitioned->finished(partition_count)) {
+            return repartitioned->current(partition_count);
+        }
+        // the readers delete the spilled files when they are closed
+        repartitioned.reset();
+    }
+    return this;
+}
+
+Status AggSpillContext::read_partition(std::vector<Block>* blocks) {
+    CHECK(readers_prepared);
+    blocks->clear();
+    if (_prefetch_latch != nullptr) {
+        _prefetch_latch->wait();
+        _prefetch_latch.reset();
+        RETURN_IF_ERROR(_prefetch_status);
+        blocks->swap(_prefetched_blocks);
+    } else {
+        RETURN_IF_ERROR(_read_blocks(read_cursor, blocks));
+    }
+
+    ++read_cursor;
+    // every stream holds one block per partition
+    if (read_cursor < readers.front()->block_count()) {
+        _prefetch(read_cursor);
+    }
+    return Status::OK();
+}
+
+Status AggSpillContext::_read_blocks(size_t partition, std::vector<Block>* blocks) {
+    for (auto& reader : readers) {
+        CHECK_LT(partition, reader->block_count());
+        reader->seek(partition);
+        Block block;
+        bool eos;
+        RETURN_IF_ERROR(reader->read(&block, &eos));
+        if (!block.empty()) {
+            blocks->emplace_back(std::move(block));
+        }
+    }
+    return Status::OK();
+}
+
+void AggSpillContext::_prefetch(size_t partition) {
+    _prefetch_latch = std::make_unique<CountDownLatch>(1);
+    auto st = ExecEnv::GetInstance()->buffered_reader_prefetch_thread_pool()->submit_func(
+            [this, partition,
+             mem_tracker = thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker()] {
+                SCOPED_ATTACH_TASK(mem_tracker);
+                _prefetch_status = _read_blocks(partition, &_prefetched_blocks);
+                _prefetch_latch->count_down();
+            });
+    if (!st.ok()) {
+        // the partition is read when it is merged
+        _prefetch_latch.reset();
+    }
+}
+
 } // namespace doris::vectorized
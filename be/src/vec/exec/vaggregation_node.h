@@ -36,6 +36,7 @@
 #include "common/global_types.h"
 #include "common/status.h"
 #include "exec/exec_node.h"
+#include "util/countdown_latch.h"
 #include "util/runtime_profile.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/column.h"
@@ -62,6 +63,7 @@
 #include "vec/core/block_spill_writer.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/core/types.h"
+#include "vec/exec/streaming_agg_controller.h"
 #include "vec/exprs/vectorized_agg_fn.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/exprs/vexpr_context.h"
@@ -369,12 +371,37 @@ struct AggSpillContext {
     std::vector<int64_t> stream_ids;
     std::vector<BlockSpillReaderUPtr> readers;
     RuntimeProfile* runtime_profile = nullptr;
+    segment_v2::CompressionTypePB compression_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
 
     size_t read_cursor {};
 
+    /// 0 for the spilled hash tables. A partition of level n which does not fit in memory
+    /// when it is merged is spilled again into the partitions of level n + 1, which are
+    /// indexed by a different hash so that they split it.
+    size_t level = 0;
+    std::unique_ptr<AggSpillContext> repartitioned;
+
     Status prepare_for_reading();
 
+    Status get_writer(BlockSpillWriterUPtr& writer);
+
+    /// The context whose partitions are merged next: the deepest repartitioned level which
+    /// is not finished, the finished ones are released.
+    AggSpillContext* current(size_t partition_count);
+
+    bool finished(size_t partition_count) const {
+        return read_cursor == partition_count &&
+               (repartitioned == nullptr || repartitioned->finished(partition_count));
+    }
+
+    /// Read the blocks of partition `read_cursor` from every stream and move the cursor.
+    /// The next partition is read in the background while the caller merges this one.
+    Status read_partition(std::vector<Block>* blocks);
+
     ~AggSpillContext() {
+        if (_prefetch_latch) {
+            _prefetch_latch->wait();
+        }
         for (auto& reader : readers) {
             if (reader) {
                 static_cast<void>(reader->close());
@@ -382,9 +409,20 @@ struct AggSpillContext {
             }
         }
     }
+
+private:
+    Status _read_blocks(size_t partition, std::vector<Block>* blocks);
+    void _prefetch(size_t partition);
+
+    std::unique_ptr<CountDownLatch> _prefetch_latch;
+    Status _prefetch_status;
+    std::vector<Block> _prefetched_blocks;
 };
 
 struct SpillPartitionHelper {
+    /// A partition of the last level is merged in memory however large it is.
+    static constexpr size_t MAX_REPARTITION_LEVEL = 3;
+
     const size_t partition_count_bits;
     const size_t partition_count;
     const size_t max_partition_index;
@@ -394,7 +432,12 @@ struct SpillPartitionHelper {
               partition_count(1 << partition_count_bits),
               max_partition_index(partition_count - 1) {}
 
-    size_t get_index(size_t hash_value) const {
+    /// The rows of a partition share the bits of the hash which index it, so the levels over
+    /// 0 index by the hash mixed with the level to split their parent partition.
+    size_t get_index(size_t hash_value, size_t level = 0) const {
+        if (level > 0) {
+            hash_value = int_hash64(hash_value ^ (level * 0x9E3779B97F4A7C15ULL));
+        }
         return (hash_value >> (32 - partition_count_bits)) & max_partition_index;
     }
 };
@@ -481,13 +524,14 @@ private:
     RuntimeProfile::Counter* _deserialize_data_timer = nullptr;
     RuntimeProfile::Counter* _hash_table_iterate_timer = nullptr;
     RuntimeProfile::Counter* _streaming_agg_timer = nullptr;
+    RuntimeProfile::Counter* _spill_repartition_counter = nullptr;
     RuntimeProfile::Counter* _hash_table_size_counter = nullptr;
     RuntimeProfile::Counter* _max_row_size_counter = nullptr;
     RuntimeProfile::Counter* _memory_usage_counter = nullptr;
     RuntimeProfile::Counter* _hash_table_memory_usage = nullptr;
     RuntimeProfile::HighWaterMarkCounter* _serialize_key_arena_memory_usage = nullptr;
 
-    bool _should_expand_hash_table = true;
+    StreamingAggController _preagg_controller;
     bool _should_limit_output = false;
     bool _reach_limit = false;
     bool _agg_data_created_without_key = false;
@@ -498,11 +542,9 @@ private:
     std::unique_ptr<AggregateDataContainer> _aggregate_data_container;
 
     void _release_self_resource(RuntimeState* state);
-    /// Return true if we should keep expanding hash tables in the preagg. If false,
-    /// the preagg should pass through any rows it can't fit in its tables.
-    bool _should_expand_preagg_hash_tables();
 
     size_t _get_hash_table_size();
+    size_t _get_hash_table_buffer_size();
 
     Status _create_agg_status(AggregateDataPtr data);
     Status _destroy_agg_status(AggregateDataPtr data);
@@ -528,6 +570,10 @@ private:
                                                                  bool* eos);
 
     Status _pre_agg_with_serialized_key(Block* in_block, Block* out_block);
+    // serialize the rows of `in_block` to `out_block` without aggregating them,
+    // `key_column_ids` are the positions of the evaluated group by keys in `in_block`
+    Status _pre_agg_pass_through(Block* in_block, const std::vector<int>& key_column_ids,
+                                 Block* out_block);
     Status _execute_with_serialized_key(Block* block);
     Status _merge_with_serialized_key(Block* block);
     void _update_memusage_with_serialized_key();
@@ -708,7 +754,11 @@ private:
                                           Block& block, std::vector<KeyType>& keys);
 
     template <typename HashTableCtxType, typename HashTableType>
-    Status _spill_hash_table(HashTableCtxType& agg_method, HashTableType& hash_table);
+    Status _spill_hash_table(HashTableCtxType& agg_method, HashTableType& hash_table,
+                             AggSpillContext& context);
+
+    // spill the hash table into the partitions of the level under `context`
+    Status _repartition_spilt_data(AggSpillContext* context);
 
     void _find_in_hash_table(AggregateDataPtr* places, ColumnRawPtrs& key_columns, size_t num_rows);
 
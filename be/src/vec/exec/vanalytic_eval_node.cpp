@@ -22,15 +22,19 @@
 #include <thrift/protocol/TDebugProtocol.h>
 
 #include <algorithm>
+#include <limits>
 #include <ostream>
 #include <utility>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
 #include "common/exception.h"
 #include "common/logging.h"
+#include "runtime/block_spill_manager.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/memory/mem_tracker.h"
 #include "runtime/runtime_state.h"
+#include "vec/columns/column_const.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/data_types/data_type.h"
@@ -168,6 +172,8 @@ Status VAnalyticEvalNode::prepare(RuntimeState* state) {
     _blocks_memory_usage =
             runtime_profile()->AddHighWaterMarkCounter("Blocks", TUnit::BYTES, "MemoryUsage");
     _evaluation_timer = ADD_TIMER(runtime_profile(), "EvaluationTime");
+    _spill_blocks_counter = ADD_COUNTER(runtime_profile(), "SpilledBlocks", TUnit::UNIT);
+    _external_analytic_bytes_threshold = state->external_analytic_bytes_threshold();
     SCOPED_TIMER(_evaluation_timer);
 
     _intermediate_tuple_desc = state->desc_tbl().get_tuple_descriptor(_intermediate_tuple_id);
@@ -274,6 +280,7 @@ Status VAnalyticEvalNode::pull(doris::RuntimeState* /*state*/, vectorized::Block
             return Status::OK();
         }
         _next_partition = _init_next_partition(_found_partition_end);
+        RETURN_IF_ERROR(_load_partition_agg_input());
         static_cast<void>(_init_result_columns());
         size_t current_block_rows = _input_blocks[_output_block_index].rows();
         static_cast<void>(_executor.get_next(current_block_rows));
@@ -403,6 +410,7 @@ Status VAnalyticEvalNode::_consumed_block_and_init_partition(RuntimeState* state
     }
     SCOPED_TIMER(_evaluation_timer);
     *next_partition = _init_next_partition(found_partition_end);
+    RETURN_IF_ERROR(_load_partition_agg_input());
     RETURN_IF_ERROR(_init_result_columns());
     return Status::OK();
 }
@@ -536,7 +544,7 @@ Status VAnalyticEvalNode::_fetch_next_block_data(RuntimeState* state) {
     return Status::OK();
 }
 
-Status VAnalyticEvalNode::sink(doris::RuntimeState* /*state*/, vectorized::Block* input_block,
+Status VAnalyticEvalNode::sink(doris::RuntimeState* state, vectorized::Block* input_block,
                                bool eos) {
     SCOPED_TIMER(_exec_timer);
     _input_eos = eos;
@@ -559,12 +567,36 @@ Status VAnalyticEvalNode::sink(doris::RuntimeState* /*state*/, vectorized::Block
         }
     }
 
-    for (size_t i = 0; i < _agg_functions_size;
-         ++i) { //insert _agg_intput_columns, execute calculate for its
-        for (size_t j = 0; j < _agg_expr_ctxs[i].size(); ++j) {
-            RETURN_IF_ERROR(_insert_range_column(input_block, _agg_expr_ctxs[i][j],
-                                                 _agg_intput_columns[i][j].get(), block_rows));
+    bool spill = _external_analytic_bytes_threshold > 0 && block_rows > 0 &&
+                 _blocks_memory_usage->current_value() > _external_analytic_bytes_threshold;
+    // The agg input columns are loaded back in order, so those of a block are spilled as well if
+    // an earlier block still has them on disk.
+    if (block_rows > 0 && (spill || !_agg_input_spill_runs.empty())) {
+        Block agg_input_block;
+        for (size_t i = 0; i < _agg_functions_size; ++i) {
+            for (size_t j = 0; j < _agg_expr_ctxs[i].size(); ++j) {
+                int result_col_id = -1;
+                RETURN_IF_ERROR(_agg_expr_ctxs[i][j]->execute(input_block, &result_col_id));
+                DCHECK_GE(result_col_id, 0);
+                const auto& result = input_block->get_by_position(result_col_id);
+                agg_input_block.insert(
+                        {result.column->convert_to_full_column_if_const(), result.type, ""});
+            }
+        }
+        if (agg_input_block.columns() > 0) {
+            RETURN_IF_ERROR(_write_spill_run(&_agg_input_spill_runs, agg_input_block));
+        } else {
+            _agg_input_end_row += block_rows;
+        }
+    } else {
+        for (size_t i = 0; i < _agg_functions_size;
+             ++i) { //insert _agg_intput_columns, execute calculate for its
+            for (size_t j = 0; j < _agg_expr_ctxs[i].size(); ++j) {
+                RETURN_IF_ERROR(_insert_range_column(input_block, _agg_expr_ctxs[i][j],
+                                                     _agg_intput_columns[i][j].get(), block_rows));
+            }
         }
+        _agg_input_end_row += block_rows;
     }
     //record column idx in block
     for (size_t i = 0; i < _partition_by_eq_expr_ctxs.size(); ++i) {
@@ -581,6 +613,11 @@ Status VAnalyticEvalNode::sink(doris::RuntimeState* /*state*/, vectorized::Block
         _ordey_by_column_idxs[i] = result_col_id;
     }
 
+    if (spill) {
+        RETURN_IF_ERROR(_spill_input_block(state, input_block));
+    }
+    _input_block_spilled.push_back(spill);
+
     mem_tracker()->consume(input_block->allocated_bytes());
     _blocks_memory_usage->add(input_block->allocated_bytes());
 
@@ -655,10 +692,142 @@ void VAnalyticEvalNode::_insert_result_info(int64_t current_block_rows) {
     }
 }
 
+Status VAnalyticEvalNode::_write_spill_run(std::deque<SpillRun>* runs, const Block& block) {
+    if (runs->empty() || runs->back().writer == nullptr) {
+        auto& run = runs->emplace_back();
+        // a block is written as a whole, so it is read back as it was
+        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
+                std::numeric_limits<int32_t>::max(), run.writer, runtime_profile()));
+    }
+    auto& run = runs->back();
+    RETURN_IF_ERROR(run.writer->write(block));
+    run.num_blocks++;
+    return Status::OK();
+}
+
+Status VAnalyticEvalNode::_read_spill_run(std::deque<SpillRun>* runs, Block* block) {
+    if (runs->empty()) {
+        return Status::InternalError("No spilled analytic block to read");
+    }
+    auto& run = runs->front();
+    if (run.writer != nullptr) {
+        RETURN_IF_ERROR(run.writer->close());
+        int64_t stream_id = run.writer->get_id();
+        run.writer.reset();
+        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_reader(
+                stream_id, run.reader, runtime_profile(), true));
+    }
+    bool eos = false;
+    RETURN_IF_ERROR(run.reader->read(block, &eos));
+    if (eos) {
+        return Status::InternalError("Failed to read spilled analytic block, {} blocks left",
+                                     run.num_blocks);
+    }
+    if (--run.num_blocks == 0) {
+        // the reader deletes the file when it is closed
+        runs->pop_front();
+    }
+    return Status::OK();
+}
+
+void VAnalyticEvalNode::_remove_spill_runs(std::deque<SpillRun>* runs) {
+    // the runs which are not read are opened by readers which delete their files
+    for (auto& run : *runs) {
+        if (run.writer == nullptr) {
+            continue;
+        }
+        int64_t stream_id = run.writer->get_id();
+        static_cast<void>(run.writer->close());
+        run.writer.reset();
+        auto st = ExecEnv::GetInstance()->block_spill_mgr()->get_reader(stream_id, run.reader,
+                                                                         runtime_profile(), true);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to remove analytic spill stream " << stream_id << ": " << st;
+        }
+    }
+    runs->clear();
+}
+
+Status VAnalyticEvalNode::_spill_input_block(RuntimeState* state, Block* block) {
+    Block origin_block;
+    for (auto col : _origin_cols) {
+        origin_block.insert(block->get_by_position(col));
+    }
+    RETURN_IF_ERROR(_write_spill_run(&_spill_runs, origin_block));
+    _input_spilled = true;
+    COUNTER_UPDATE(_spill_blocks_counter, 1);
+
+    // The spilled columns and the results of the agg input exprs are replaced by constants of
+    // the same rows, the columns of the partition by and order by exprs are kept.
+    auto is_key_column = [&](int64_t col) {
+        return std::find(_partition_by_column_idxs.begin(), _partition_by_column_idxs.end(),
+                         col) != _partition_by_column_idxs.end() ||
+               std::find(_ordey_by_column_idxs.begin(), _ordey_by_column_idxs.end(), col) !=
+                       _ordey_by_column_idxs.end();
+    };
+    for (int64_t col = 0; col < block->columns(); ++col) {
+        auto& column = block->get_by_position(col).column;
+        if (is_key_column(col) || is_column_const(*column)) {
+            continue;
+        }
+        column = ColumnConst::create(column->clone_resized(1), column->size());
+    }
+    return Status::OK();
+}
+
+Status VAnalyticEvalNode::_restore_input_block(Block* block) {
+    Block origin_block;
+    RETURN_IF_ERROR(_read_spill_run(&_spill_runs, &origin_block));
+    if (origin_block.rows() != block->rows()) {
+        return Status::InternalError("Failed to read spilled analytic input block, rows {} vs {}",
+                                     origin_block.rows(), block->rows());
+    }
+    for (size_t i = 0; i < _origin_cols.size(); ++i) {
+        block->get_by_position(_origin_cols[i]) = origin_block.get_by_position(i);
+    }
+    return Status::OK();
+}
+
+Status VAnalyticEvalNode::_load_partition_agg_input() {
+    if (!_input_spilled) {
+        return Status::OK();
+    }
+    // The rows of the finished partitions are dropped once they are at least as many as the rows
+    // kept, so every row is copied a constant number of times on average.
+    int64_t dropped_rows = _partition_by_start.pos - _agg_input_first_row;
+    int64_t kept_rows = _agg_input_end_row - _partition_by_start.pos;
+    if (dropped_rows > 0 && dropped_rows >= kept_rows) {
+        for (auto& columns : _agg_intput_columns) {
+            for (auto& column : columns) {
+                auto kept_column = column->clone_empty();
+                kept_column->insert_range_from(*column, dropped_rows, kept_rows);
+                column = std::move(kept_column);
+            }
+        }
+        _agg_input_first_row = _partition_by_start.pos;
+    }
+
+    while (_agg_input_end_row < _partition_by_end.pos) {
+        Block block;
+        RETURN_IF_ERROR(_read_spill_run(&_agg_input_spill_runs, &block));
+        size_t col = 0;
+        for (auto& columns : _agg_intput_columns) {
+            for (auto& column : columns) {
+                column->insert_range_from(*block.get_by_position(col++).column, 0, block.rows());
+            }
+        }
+        _agg_input_end_row += block.rows();
+    }
+    return Status::OK();
+}
+
 Status VAnalyticEvalNode::_output_current_block(Block* block) {
     block->swap(std::move(_input_blocks[_output_block_index]));
     _blocks_memory_usage->add(-block->allocated_bytes());
     mem_tracker()->consume(-block->allocated_bytes());
+    if (_input_block_spilled[_output_block_index]) {
+        RETURN_IF_ERROR(_restore_input_block(block));
+    }
     if (_origin_cols.size() < block->columns()) {
         block->erase_not_in(_origin_cols);
     }
@@ -684,13 +853,15 @@ Status VAnalyticEvalNode::_output_current_block(Block* block) {
 //sum min max count avg first_value last_value functions
 void VAnalyticEvalNode::_execute_for_win_func(int64_t partition_start, int64_t partition_end,
                                               int64_t frame_start, int64_t frame_end) {
+    // the agg input columns start at `_agg_input_first_row`
     for (size_t i = 0; i < _agg_functions_size; ++i) {
         std::vector<const IColumn*> _agg_columns;
         for (int j = 0; j < _agg_intput_columns[i].size(); ++j) {
             _agg_columns.push_back(_agg_intput_columns[i][j].get());
         }
         _agg_functions[i]->function()->add_range_single_place(
-                partition_start, partition_end, frame_start, frame_end,
+                partition_start - _agg_input_first_row, partition_end - _agg_input_first_row,
+                frame_start - _agg_input_first_row, frame_end - _agg_input_first_row,
                 _fn_place_ptr + _offsets_of_aggregate_states[i], _agg_columns.data(), nullptr);
     }
 
@@ -821,6 +992,9 @@ void VAnalyticEvalNode::_release_mem() {
 
     std::vector<MutableColumnPtr> tmp_result_window_columns;
     _result_window_columns.swap(tmp_result_window_columns);
+
+    _remove_spill_runs(&_spill_runs);
+    _remove_spill_runs(&_agg_input_spill_runs);
 }
 
 } // namespace doris::vectorized
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -36,6 +37,8 @@
 #include "vec/columns/column.h"
 #include "vec/common/arena.h"
 #include "vec/core/block.h"
+#include "vec/core/block_spill_reader.h"
+#include "vec/core/block_spill_writer.h"
 #include "vec/data_types/data_type.h"
 #include "vec/exprs/vexpr_fwd.h"
 
@@ -135,6 +138,21 @@ private:
 
     void _release_mem();
 
+    // Consecutive spilled blocks are written to a run, a run is closed and read once its first
+    // block is needed.
+    struct SpillRun {
+        BlockSpillWriterUPtr writer;
+        BlockSpillReaderUPtr reader;
+        size_t num_blocks = 0;
+    };
+
+    Status _spill_input_block(RuntimeState* state, Block* block);
+    Status _restore_input_block(Block* block);
+    Status _load_partition_agg_input();
+    Status _write_spill_run(std::deque<SpillRun>* runs, const Block& block);
+    Status _read_spill_run(std::deque<SpillRun>* runs, Block* block);
+    void _remove_spill_runs(std::deque<SpillRun>* runs);
+
 private:
     std::vector<Block> _input_blocks;
     std::vector<int64_t> input_block_first_row_positions;
@@ -190,5 +208,21 @@ private:
     RuntimeProfile::HighWaterMarkCounter* _blocks_memory_usage;
 
     std::vector<bool> _change_to_nullable_flags;
+
+    // Once the buffered input blocks use more memory than this, the columns of the next input
+    // blocks are spilled to disk, only the columns of the partition by and order by exprs stay in
+    // memory to find the boundaries of partitions and peer groups. The agg input columns of the
+    // spilled blocks are spilled as well and loaded back when their partition is evaluated, so
+    // only the current partition is kept in `_agg_intput_columns`. The pipelineX analytic
+    // operators do not spill.
+    int64_t _external_analytic_bytes_threshold = 0;
+    std::vector<bool> _input_block_spilled;
+    std::deque<SpillRun> _spill_runs;
+    std::deque<SpillRun> _agg_input_spill_runs;
+    // `_agg_intput_columns` hold the rows in [_agg_input_first_row, _agg_input_end_row)
+    int64_t _agg_input_first_row = 0;
+    int64_t _agg_input_end_row = 0;
+    bool _input_spilled = false;
+    RuntimeProfile::Counter* _spill_blocks_counter = nullptr;
 };
 } // namespace doris::vectorized
@@ -54,6 +54,7 @@ Status PartitionBlocks::do_partition_topn_sort() {
         RETURN_IF_ERROR(_partition_topn_sorter->append_block(block.get()));
     }
     blocks.clear();
+    _buffered_bytes = 0;
     _partition_topn_sorter->init_profile(_partition_sort_info->_runtime_profile);
     RETURN_IF_ERROR(_partition_topn_sorter->prepare_for_read());
     bool current_eos = false;
@@ -67,6 +68,7 @@ Status PartitionBlocks::do_partition_topn_sort() {
         auto rows = output_block->rows();
         if (rows > 0) {
             current_output_rows += rows;
+            _buffered_bytes += output_block->bytes();
             blocks.emplace_back(std::move(output_block));
         }
     }
@@ -78,6 +80,51 @@ Status PartitionBlocks::do_partition_topn_sort() {
     return Status::OK();
 }
 
+Status PartitionBlocks::spill_if_needed() {
+    auto threshold = _partition_sort_info->_runtime_state->external_sort_bytes_threshold();
+    if (threshold <= 0 || _buffered_bytes < threshold) {
+        return Status::OK();
+    }
+    if (_sorter == nullptr) {
+        _sorter = _create_sorter();
+    }
+    for (const auto& block : blocks) {
+        RETURN_IF_ERROR(_sorter->append_block(block.get()));
+    }
+    blocks.clear();
+    _buffered_bytes = 0;
+    return Status::OK();
+}
+
+Status PartitionBlocks::build_sorter(std::unique_ptr<PartitionSorter>* sorter) {
+    if (_sorter == nullptr) {
+        _sorter = _create_sorter();
+    }
+    DCHECK(blocks.empty() || _partition_sort_info->_row_desc.num_materialized_slots() ==
+                                     blocks.back()->columns());
+    //get blocks from every partition, and sorter get those data.
+    for (const auto& block : blocks) {
+        RETURN_IF_ERROR(_sorter->append_block(block.get()));
+    }
+    blocks.clear();
+    _buffered_bytes = 0;
+    _sorter->init_profile(_partition_sort_info->_runtime_profile);
+    RETURN_IF_ERROR(_sorter->prepare_for_read());
+    *sorter = std::move(_sorter);
+    return Status::OK();
+}
+
+std::unique_ptr<PartitionSorter> PartitionBlocks::_create_sorter() {
+    return PartitionSorter::create_unique(
+            *_partition_sort_info->_vsort_exec_exprs, _partition_sort_info->_limit,
+            _partition_sort_info->_offset, _partition_sort_info->_pool,
+            _partition_sort_info->_is_asc_order, _partition_sort_info->_nulls_first,
+            _partition_sort_info->_row_desc, _partition_sort_info->_runtime_state,
+            _is_first_sorter ? _partition_sort_info->_runtime_profile : nullptr,
+            _partition_sort_info->_has_global_limit, _partition_sort_info->_partition_inner_limit,
+            _partition_sort_info->_top_n_algorithm, _partition_sort_info->_previous_row);
+}
+
 VPartitionSortNode::VPartitionSortNode(ObjectPool* pool, const TPlanNode& tnode,
                                        const DescriptorTbl& descs)
         : ExecNode(pool, tnode, descs), _hash_table_size_counter(nullptr) {
@@ -142,15 +189,14 @@ Status VPartitionSortNode::_split_block_by_partition(vectorized::Block* input_bl
         DCHECK(result_column_id != -1);
         _partition_columns[i] = input_block->get_by_position(result_column_id).column.get();
     }
-    _emplace_into_hash_table(_partition_columns, input_block, batch_size);
-    return Status::OK();
+    return _emplace_into_hash_table(_partition_columns, input_block, batch_size);
 }
 
-void VPartitionSortNode::_emplace_into_hash_table(const ColumnRawPtrs& key_columns,
-                                                  const vectorized::Block* input_block,
-                                                  int batch_size) {
-    std::visit(
-            [&](auto&& agg_method) -> void {
+Status VPartitionSortNode::_emplace_into_hash_table(const ColumnRawPtrs& key_columns,
+                                                    const vectorized::Block* input_block,
+                                                    int batch_size) {
+    return std::visit(
+            [&](auto&& agg_method) -> Status {
                 SCOPED_TIMER(_build_timer);
                 using HashMethodType = std::decay_t<decltype(agg_method)>;
                 using AggState = typename HashMethodType::State;
@@ -183,10 +229,11 @@ void VPartitionSortNode::_emplace_into_hash_table(const ColumnRawPtrs& key_colum
 
                 SCOPED_TIMER(_selector_block_timer);
                 for (auto* place : _value_places) {
-                    place->append_block_by_selector(input_block, child(0)->row_desc(),
-                                                    _has_global_limit, _partition_inner_limit,
-                                                    batch_size);
+                    RETURN_IF_ERROR(place->append_block_by_selector(
+                            input_block, child(0)->row_desc(), _has_global_limit,
+                            _partition_inner_limit, batch_size));
                 }
+                return Status::OK();
             },
             _partitioned_data->method_variant);
 }
@@ -202,7 +249,8 @@ Status VPartitionSortNode::sink(RuntimeState* state, vectorized::Block* input_bl
                         new PartitionBlocks(_partition_sort_info, _value_places.empty())));
             }
             //no partition key
-            _value_places[0]->append_whole_block(input_block, child(0)->row_desc());
+            RETURN_IF_ERROR(
+                    _value_places[0]->append_whole_block(input_block, child(0)->row_desc()));
         } else {
             //just simply use partition num to check
             //if is TWO_PHASE_GLOBAL, must be sort all data thought partition num threshold have been exceeded.
@@ -226,21 +274,9 @@ Status VPartitionSortNode::sink(RuntimeState* state, vectorized::Block* input_bl
         _agg_arena_pool.reset(nullptr);
         _partitioned_data.reset(nullptr);
         SCOPED_TIMER(_partition_sort_timer);
-        for (int i = 0; i < _value_places.size(); ++i) {
-            auto sorter = PartitionSorter::create_unique(
-                    _vsort_exec_exprs, _limit, 0, _pool, _is_asc_order, _nulls_first,
-                    child(0)->row_desc(), state, i == 0 ? _runtime_profile.get() : nullptr,
-                    _has_global_limit, _partition_inner_limit, _top_n_algorithm,
-                    _previous_row.get());
-
-            DCHECK(child(0)->row_desc().num_materialized_slots() ==
-                   _value_places[i]->blocks.back()->columns());
-            //get blocks from every partition, and sorter get those data.
-            for (const auto& block : _value_places[i]->blocks) {
-                RETURN_IF_ERROR(sorter->append_block(block.get()));
-            }
-            sorter->init_profile(_runtime_profile.get());
-            RETURN_IF_ERROR(sorter->prepare_for_read());
+        for (auto* place : _value_places) {
+            std::unique_ptr<PartitionSorter> sorter;
+            RETURN_IF_ERROR(place->build_sorter(&sorter));
             _partition_sorts.push_back(std::move(sorter));
         }
 
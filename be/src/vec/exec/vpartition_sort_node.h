@@ -91,13 +91,14 @@ public:
 
     void add_row_idx(size_t row) { selector.push_back(row); }
 
-    void append_block_by_selector(const vectorized::Block* input_block,
-                                  const RowDescriptor& row_desc, bool is_limit,
-                                  int64_t partition_inner_limit, int batch_size) {
+    Status append_block_by_selector(const vectorized::Block* input_block,
+                                    const RowDescriptor& row_desc, bool is_limit,
+                                    int64_t partition_inner_limit, int batch_size) {
         if (blocks.empty() || reach_limit()) {
             _init_rows = batch_size;
             blocks.push_back(Block::create_unique(VectorizedUtils::create_empty_block(row_desc)));
         }
+        auto bytes = blocks.back()->bytes();
         auto columns = input_block->get_columns();
         auto mutable_columns = blocks.back()->mutate_columns();
         DCHECK(columns.size() == mutable_columns.size());
@@ -105,6 +106,7 @@ public:
             columns[i]->append_data_by_selector(mutable_columns[i], selector);
         }
         blocks.back()->set_columns(std::move(mutable_columns));
+        _buffered_bytes += blocks.back()->bytes() - bytes;
         auto selector_rows = selector.size();
         _init_rows = _init_rows - selector_rows;
         _total_rows = _total_rows + selector_rows;
@@ -113,19 +115,31 @@ public:
         // maybe better could change by user PARTITION_SORT_ROWS_THRESHOLD
         if (_current_input_rows >= PARTITION_SORT_ROWS_THRESHOLD &&
             _partition_sort_info->_topn_phase != TPartTopNPhase::TWO_PHASE_GLOBAL) {
-            static_cast<void>(do_partition_topn_sort()); // fixed : should return status
-            _current_input_rows = 0;                     // reset record
+            RETURN_IF_ERROR(do_partition_topn_sort());
+            _current_input_rows = 0; // reset record
         }
+        return spill_if_needed();
     }
 
     Status do_partition_topn_sort();
 
-    void append_whole_block(vectorized::Block* input_block, const RowDescriptor& row_desc) {
+    Status append_whole_block(vectorized::Block* input_block, const RowDescriptor& row_desc) {
         auto empty_block = Block::create_unique(VectorizedUtils::create_empty_block(row_desc));
         empty_block->swap(*input_block);
+        _buffered_bytes += empty_block->bytes();
         blocks.emplace_back(std::move(empty_block));
+        return spill_if_needed();
     }
 
+    // Once the buffered blocks use more memory than the external sort threshold, they are moved
+    // into `_sorter`, which spills its sorted blocks instead of keeping a large partition in
+    // memory until the input ends.
+    Status spill_if_needed();
+
+    // Appends the rest of the buffered blocks to the sorter of the partition and prepares it
+    // for read.
+    Status build_sorter(std::unique_ptr<PartitionSorter>* sorter);
+
     bool reach_limit() {
         return _init_rows <= 0 || blocks.back()->bytes() > INITIAL_BUFFERED_BLOCK_BYTES;
     }
@@ -138,11 +152,16 @@ public:
     size_t _total_rows = 0;
     size_t _current_input_rows = 0;
     size_t _topn_filter_rows = 0;
+    size_t _buffered_bytes = 0;
     int _init_rows = 4096;
     bool _is_first_sorter = false;
 
     std::unique_ptr<PartitionSorter> _partition_topn_sorter = nullptr;
+    std::unique_ptr<PartitionSorter> _sorter = nullptr;
     std::shared_ptr<PartitionSortInfo> _partition_sort_info = nullptr;
+
+private:
+    std::unique_ptr<PartitionSorter> _create_sorter();
 };
 
 using PartitionDataPtr = PartitionBlocks*;
@@ -262,8 +281,8 @@ public:
 private:
     void _init_hash_method();
     Status _split_block_by_partition(vectorized::Block* input_block, int batch_size);
-    void _emplace_into_hash_table(const ColumnRawPtrs& key_columns,
-                                  const vectorized::Block* input_block, int batch_size);
+    Status _emplace_into_hash_table(const ColumnRawPtrs& key_columns,
+                                    const vectorized::Block* input_block, int batch_size);
     Status get_sorted_block(RuntimeState* state, Block* output_block, bool* eos);
 
     // hash table
@@ -189,7 +189,8 @@ Status VCollectIterator::build_heap(std::vector<RowsetReaderSharedPtr>& rs_reade
     return Status::OK();
 }
 
-bool VCollectIterator::LevelIteratorComparator::operator()(LevelIterator* lhs, LevelIterator* rhs) {
+bool VCollectIterator::LevelIteratorComparator::operator()(
+        const std::unique_ptr<LevelIterator>& lhs, const std::unique_ptr<LevelIterator>& rhs) {
     const IteratorRowRef& lhs_ref = *lhs->current_row_ref();
     const IteratorRowRef& rhs_ref = *rhs->current_row_ref();
 
@@ -602,15 +603,6 @@ VCollectIterator::Level1Iterator::Level1Iterator(
     }
 }
 
-VCollectIterator::Level1Iterator::~Level1Iterator() {
-    if (_heap) {
-        while (!_heap->empty()) {
-            delete _heap->top();
-            _heap->pop();
-        }
-    }
-}
-
 // Read next row into *row.
 // Returns
 //      OK when read successfully.
@@ -665,21 +657,22 @@ Status VCollectIterator::Level1Iterator::init(bool get_data_by_ref) {
                 break;
             }
         }
-        _heap.reset(new MergeHeap {LevelIteratorComparator(sequence_loc, _is_reverse)});
+        std::vector<std::unique_ptr<LevelIterator>> children;
+        children.reserve(_children.size());
         for (auto&& child : _children) {
             DCHECK(child != nullptr);
-            //DCHECK(child->current_row().ok());
-            _heap->push(child.release());
+            children.push_back(std::move(child));
         }
-        _cur_child.reset(_heap->top());
-        _heap->pop();
         // Clear _children earlier to release any related references
         _children.clear();
+        _merge_tree = std::make_unique<MergeTree>(
+                std::move(children), LevelIteratorComparator(sequence_loc, _is_reverse));
+        _cur_child = _merge_tree->top().get();
+        _in_run = false;
     } else {
         _merge = false;
-        _heap.reset(nullptr);
-        _cur_child = std::move(*_children.begin());
-        _children.pop_front();
+        _merge_tree.reset();
+        _cur_child = _children.begin()->get();
     }
     _ref = *_cur_child->current_row_ref();
     return Status::OK();
@@ -711,28 +704,82 @@ void VCollectIterator::Level1Iterator::init_level0_iterators_for_union() {
     }
 }
 
+bool VCollectIterator::Level1Iterator::_precedes_runner_up(const Block& block, size_t row_pos) {
+    const IteratorRowRef& bound = *_merge_tree->runner_up()->current_row_ref();
+    int cmp_res = UNLIKELY(_compare_columns)
+                          ? block.compare_at(row_pos, bound.row_pos, _compare_columns,
+                                             *bound.block, -1)
+                          : block.compare_at(row_pos, bound.row_pos, _schema.num_key_columns(),
+                                             *bound.block, -1);
+    return UNLIKELY(_is_reverse) ? cmp_res > 0 : cmp_res < 0;
+}
+
+void VCollectIterator::Level1Iterator::_update_merge_tree() {
+    // A row whose key comes before the runner up comes before all the rows of the other
+    // children, and there is no row of the same key to be marked as same.
+    if (_in_run) {
+        const IteratorRowRef& row = *_cur_child->current_row_ref();
+        if (_merge_tree->size() == 1 || _precedes_runner_up(*row.block, row.row_pos)) {
+            return;
+        }
+    }
+    size_t top = _merge_tree->top_index();
+    _merge_tree->update_top();
+    _in_run = _merge_tree->top_index() == top;
+}
+
+size_t VCollectIterator::Level1Iterator::_run_rows(size_t max_rows) {
+    if (!_in_run || !_cur_child->current_block_is_run()) {
+        return 1;
+    }
+    const IteratorRowRef& row = *_cur_child->current_row_ref();
+    size_t begin = row.row_pos;
+    size_t end = std::min<size_t>(row.block->rows(), begin + max_rows);
+    if (_merge_tree->size() == 1) {
+        return end - begin;
+    }
+    // The current row may have the same key as the runner up and come first by its version,
+    // the rows after it are sorted by key.
+    if (end - begin == 1 || !_precedes_runner_up(*row.block, begin + 1)) {
+        return 1;
+    }
+    if (_precedes_runner_up(*row.block, end - 1)) {
+        return end - begin;
+    }
+    // the row at `lo` comes before the runner up, the row at `hi` does not
+    size_t lo = begin + 1;
+    size_t hi = end - 1;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (_precedes_runner_up(*row.block, mid)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return hi - begin;
+}
+
 Status VCollectIterator::Level1Iterator::_merge_next(IteratorRowRef* ref) {
     auto res = _cur_child->next(ref);
     if (LIKELY(res.ok())) {
-        _heap->push(_cur_child.release());
-        _cur_child.reset(_heap->top());
-        _heap->pop();
+        _update_merge_tree();
     } else if (res.is<END_OF_FILE>()) {
         // current child has been read, to read next
-        if (!_heap->empty()) {
-            _cur_child.reset(_heap->top());
-            _heap->pop();
-        } else {
+        _merge_tree->remove_top();
+        _in_run = false;
+        if (_merge_tree->empty()) {
             _ref.reset();
-            _cur_child.reset();
+            _cur_child = nullptr;
             return Status::Error<END_OF_FILE>("");
         }
     } else {
         _ref.reset();
-        _cur_child.reset();
+        _cur_child = nullptr;
         LOG(WARNING) << "failed to get next from child, res=" << res;
         return res;
     }
+    _cur_child = _merge_tree->top().get();
 
     if (_skip_same && _cur_child->is_same()) {
         _reader->_merged_rows++;
@@ -755,16 +802,16 @@ Status VCollectIterator::Level1Iterator::_normal_next(IteratorRowRef* ref) {
         return Status::OK();
     } else if (res.is<END_OF_FILE>()) {
         // current child has been read, to read next
+        _children.pop_front();
         if (!_children.empty()) {
-            _cur_child = std::move(*(_children.begin()));
-            _children.pop_front();
+            _cur_child = _children.begin()->get();
             return _normal_next(ref);
         } else {
-            _cur_child.reset();
+            _cur_child = nullptr;
             return Status::Error<END_OF_FILE>("");
         }
     } else {
-        _cur_child.reset();
+        _cur_child = nullptr;
         LOG(WARNING) << "failed to get next from child, res=" << res;
         return res;
     }
@@ -788,11 +835,21 @@ Status VCollectIterator::Level1Iterator::_merge_next(Block* block) {
     }
     int continuous_row_in_block = 0;
     do {
+        // The next rows of the current child which come before the rows of the other children
+        // are taken at once, the current child is moved to the last of them.
+        size_t run_rows = _run_rows(batch_size - target_block_row);
         if (UNLIKELY(_reader->_reader_context.record_rowids)) {
-            _block_row_locations[target_block_row] = _cur_child->current_row_location();
+            for (size_t i = 0; i < run_rows; ++i) {
+                if (i > 0) {
+                    _cur_child->advance_in_block(1);
+                }
+                _block_row_locations[target_block_row + i] = _cur_child->current_row_location();
+            }
+        } else if (run_rows > 1) {
+            _cur_child->advance_in_block(run_rows - 1);
         }
-        ++target_block_row;
-        ++continuous_row_in_block;
+        target_block_row += run_rows;
+        continuous_row_in_block += run_rows;
         // cur block finished, copy before merge_next cause merge_next will
         // clear block column data
         if (pre_row_ref.row_pos + continuous_row_in_block == pre_row_ref.block->rows()) {
@@ -857,16 +914,16 @@ Status VCollectIterator::Level1Iterator::_normal_next(Block* block) {
         return Status::OK();
     } else if (res.is<END_OF_FILE>()) {
         // current child has been read, to read next
+        _children.pop_front();
         if (!_children.empty()) {
-            _cur_child = std::move(*(_children.begin()));
-            _children.pop_front();
+            _cur_child = _children.begin()->get();
             return _normal_next(block);
         } else {
-            _cur_child.reset();
+            _cur_child = nullptr;
             return Status::Error<END_OF_FILE>("");
         }
     } else {
-        _cur_child.reset();
+        _cur_child = nullptr;
         LOG(WARNING) << "failed to get next from child, res=" << res;
         return res;
     }
@@ -25,22 +25,13 @@
 #include <vector>
 
 #include "common/status.h"
-#include "olap/rowset/rowset_reader_context.h"
-#include "olap/utils.h"
-#ifdef USE_LIBCPP
-#include <queue>
-#else
-#include <ext/pb_ds/priority_queue.hpp>
-#endif
-
 #include "olap/rowset/rowset_reader.h"
+#include "olap/rowset/rowset_reader_context.h"
 #include "olap/tablet_reader.h"
+#include "olap/utils.h"
+#include "util/loser_tree.h"
 #include "vec/core/block.h"
 
-namespace __gnu_pbds {
-struct pairing_heap_tag;
-} // namespace __gnu_pbds
-
 namespace doris {
 
 class TabletSchema;
@@ -111,7 +102,7 @@ private:
     // This interface is the actual implementation of the new version of iterator.
     // It currently contains two implementations, one is Level0Iterator,
     // which only reads data from the rowset reader, and the other is Level1Iterator,
-    // which can read merged data from multiple LevelIterators through MergeHeap.
+    // which can read merged data from multiple LevelIterators through MergeTree.
     // By using Level1Iterator, some rowset readers can be merged in advance and
     // then merged with other rowset readers.
     class LevelIterator {
@@ -150,6 +141,13 @@ private:
 
         virtual bool update_profile(RuntimeProfile* profile) = 0;
 
+        // Whether the rows after the current one in its block are the next rows of this
+        // iterator, so that a run of them can be merged at once.
+        virtual bool current_block_is_run() const { return false; }
+
+        // Move the current row forward in its block, only if current_block_is_run().
+        virtual void advance_in_block(size_t rows) {}
+
     protected:
         const TabletSchema& _schema;
         IteratorRowRef _ref;
@@ -163,7 +161,8 @@ private:
         LevelIteratorComparator(int sequence, bool is_reverse)
                 : _sequence(sequence), _is_reverse(is_reverse) {}
 
-        bool operator()(LevelIterator* lhs, LevelIterator* rhs);
+        bool operator()(const std::unique_ptr<LevelIterator>& lhs,
+                        const std::unique_ptr<LevelIterator>& rhs);
 
     private:
         int _sequence;
@@ -171,13 +170,7 @@ private:
         bool _is_reverse = false;
     };
 
-#ifdef USE_LIBCPP
-    using MergeHeap = std::priority_queue<LevelIterator*, std::vector<LevelIterator*>,
-                                          LevelIteratorComparator>;
-#else
-    using MergeHeap = __gnu_pbds::priority_queue<LevelIterator*, LevelIteratorComparator,
-                                                 __gnu_pbds::pairing_heap_tag>;
-#endif
+    using MergeTree = LoserTree<std::unique_ptr<LevelIterator>, LevelIteratorComparator>;
 
     // Iterate from rowset reader. This Iterator usually like a leaf node
     class Level0Iterator : public LevelIterator {
@@ -216,6 +209,13 @@ private:
             return false;
         }
 
+        bool current_block_is_run() const override { return !_get_data_by_ref; }
+
+        void advance_in_block(size_t rows) override {
+            _ref.row_pos += rows;
+            DCHECK_LT(_ref.row_pos, _block->rows());
+        }
+
         Status refresh_current_row();
 
     private:
@@ -287,8 +287,6 @@ private:
 
         [[nodiscard]] Status ensure_first_row_ref() override;
 
-        ~Level1Iterator() override;
-
         bool update_profile(RuntimeProfile* profile) override {
             if (_cur_child != nullptr) {
                 return _cur_child->update_profile(profile);
@@ -307,16 +305,27 @@ private:
 
         Status _merge_next(Block* block);
 
-        // Each LevelIterator corresponds to a rowset reader,
-        // it will be cleared after '_heap' has been initialized when '_merge == true'.
+        // Update the merge tree after the current child has moved to its next row.
+        void _update_merge_tree();
+
+        // Number of rows from the current row in the block of the current child, which come
+        // before the rows of the other children, at most `max_rows`.
+        size_t _run_rows(size_t max_rows);
+
+        // Whether a row comes before the current row of the runner up by key.
+        bool _precedes_runner_up(const Block& block, size_t row_pos);
+
+        // Each LevelIterator corresponds to a rowset reader, they are moved to '_merge_tree'
+        // when '_merge == true', otherwise the first one is the current child and it is
+        // removed when it reaches EOF.
         std::list<std::unique_ptr<LevelIterator>> _children;
-        // point to the Level0Iterator containing the next output row.
+        // point to the LevelIterator containing the next output row.
         // null when VCollectIterator hasn't been initialized or reaches EOF.
-        std::unique_ptr<LevelIterator> _cur_child;
+        LevelIterator* _cur_child = nullptr;
         TabletReader* _reader = nullptr;
 
-        // when `_merge == true`, rowset reader returns ordered rows and VCollectIterator uses a priority queue to merge
-        // sort them. The output of VCollectIterator is also ordered.
+        // when `_merge == true`, rowset reader returns ordered rows and VCollectIterator uses a loser tree
+        // to merge sort them. The output of VCollectIterator is also ordered.
         // When `_merge == false`, rowset reader returns *partial* ordered rows. VCollectIterator simply returns all rows
         // from the first rowset, the second rowset, .., the last rowset. The output of CollectorIterator is also
         // *partially* ordered.
@@ -326,7 +335,10 @@ private:
 
         bool _skip_same;
         // used when `_merge == true`
-        std::unique_ptr<MergeHeap> _heap;
+        std::unique_ptr<MergeTree> _merge_tree;
+        // Whether the current child has won the last match of it, it is then likely to win
+        // again and its next rows are compared with the runner up only.
+        bool _in_run = false;
 
         std::vector<RowLocation> _block_row_locations;
     };
@@ -759,9 +759,17 @@ Status BlockSerializer<Parent>::serialize_block(const Block* src, PBlock* dest,
         SCOPED_TIMER(_parent->_serialize_batch_timer);
         dest->Clear();
         size_t uncompressed_bytes = 0, compressed_bytes = 0;
-        RETURN_IF_ERROR(src->serialize(
-                _parent->_state->be_exec_version(), dest, &uncompressed_bytes, &compressed_bytes,
-                _parent->compression_type(), _parent->transfer_large_data_by_brpc()));
+        if (config::enable_exchange_column_compression &&
+            !_parent->transfer_large_data_by_brpc()) {
+            RETURN_IF_ERROR(src->serialize_by_column(_parent->_state->be_exec_version(), dest,
+                                                     &uncompressed_bytes, &compressed_bytes,
+                                                     _parent->compression_type()));
+        } else {
+            RETURN_IF_ERROR(src->serialize(_parent->_state->be_exec_version(), dest,
+                                           &uncompressed_bytes, &compressed_bytes,
+                                           _parent->compression_type(),
+                                           _parent->transfer_large_data_by_brpc()));
+        }
         COUNTER_UPDATE(_parent->_bytes_sent_counter, compressed_bytes * num_receivers);
         COUNTER_UPDATE(_parent->_uncompressed_bytes_counter, uncompressed_bytes * num_receivers);
         COUNTER_UPDATE(_parent->_compress_timer, src->get_compress_time());
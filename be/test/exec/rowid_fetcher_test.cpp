@@ -0,0 +1,301 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/rowid_fetcher.h"
+
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/status.h"
+#include "io/fs/local_file_system.h"
+#include "olap/olap_common.h"
+#include "olap/options.h"
+#include "olap/rowset/rowset.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_reader.h"
+#include "olap/rowset/rowset_reader_context.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_schema.h"
+#include "runtime/exec_env.h"
+#include "vec/columns/column.h"
+#include "vec/core/block.h"
+
+namespace doris {
+using namespace ErrorCode;
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static StorageEngine* engine_ref = nullptr;
+static const std::string kTestDir = "/ut_dir/rowid_fetcher_test";
+
+// A row of the test tablet, (c1, c2, c3)
+using Row = std::tuple<int32_t, int32_t, int32_t>;
+
+// Late materialization of the olap scanner reads the filter columns through the rowset
+// reader with row locations, and fetches the other columns by row location only for the
+// rows that pass the filter. These tests check that this gives the same rows as reading
+// all columns and filtering them.
+class LocalRowIdFetcherTest : public testing::Test {
+protected:
+    void SetUp() override {
+        char buffer[MAX_PATH_LEN];
+        ASSERT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        _absolute_dir = std::string(buffer) + kTestDir;
+        auto st = io::global_local_filesystem()->delete_directory(_absolute_dir);
+        ASSERT_TRUE(st.ok()) << st;
+        st = io::global_local_filesystem()->create_directory(_absolute_dir);
+        ASSERT_TRUE(st.ok()) << st;
+        doris::EngineOptions options;
+        auto engine = std::make_unique<StorageEngine>(options);
+        engine_ref = engine.get();
+        ExecEnv::GetInstance()->set_storage_engine(std::move(engine));
+
+        _tablet_schema = _create_schema();
+        _rowset = _create_rowset({3000, 2000});
+    }
+
+    void TearDown() override {
+        _rowset.reset();
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(_absolute_dir).ok());
+        engine_ref = nullptr;
+        ExecEnv::GetInstance()->set_storage_engine(nullptr);
+    }
+
+    static TabletSchemaSPtr _create_schema() {
+        TabletSchemaSPtr tablet_schema = std::make_shared<TabletSchema>();
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(DUP_KEYS);
+        tablet_schema_pb.set_num_short_key_columns(1);
+        tablet_schema_pb.set_num_rows_per_row_block(1024);
+        tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+        tablet_schema_pb.set_next_column_unique_id(4);
+        for (int i = 1; i <= 3; ++i) {
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(i);
+            column->set_name("c" + std::to_string(i));
+            column->set_type("INT");
+            column->set_is_key(i == 1);
+            column->set_length(4);
+            column->set_index_length(4);
+            column->set_is_nullable(false);
+            column->set_is_bf_column(false);
+        }
+        tablet_schema->init_from_pb(tablet_schema_pb);
+        return tablet_schema;
+    }
+
+    static Row _row(int32_t i) { return {i, i * 7 % 100, i * 13}; }
+
+    // the first `num_columns` columns of row `i` of `block`, the others are 0
+    static Row _get_row(const vectorized::Block& block, size_t i, size_t num_columns) {
+        int32_t values[3] = {0, 0, 0};
+        for (size_t c = 0; c < num_columns; ++c) {
+            values[c] = static_cast<int32_t>(block.get_by_position(c).column->get_int(i));
+        }
+        return {values[0], values[1], values[2]};
+    }
+
+    RowsetSharedPtr _create_rowset(const std::vector<int>& segment_rows) {
+        RowsetWriterContext writer_context;
+        RowsetId rowset_id;
+        rowset_id.init(20000);
+        writer_context.rowset_id = rowset_id;
+        writer_context.rowset_type = BETA_ROWSET;
+        writer_context.rowset_state = VISIBLE;
+        writer_context.tablet_schema = _tablet_schema;
+        writer_context.rowset_dir = _absolute_dir;
+        writer_context.version = {2, 2};
+        writer_context.segments_overlap = NONOVERLAPPING;
+        writer_context.max_rows_per_segment = UINT32_MAX;
+        auto res = RowsetFactory::create_rowset_writer(*engine_ref, writer_context, false);
+        EXPECT_TRUE(res.has_value()) << res.error();
+        auto rowset_writer = std::move(res).value();
+
+        int32_t next = 0;
+        for (int rows : segment_rows) {
+            vectorized::Block block = _tablet_schema->create_block();
+            auto columns = block.mutate_columns();
+            for (int i = 0; i < rows; ++i, ++next) {
+                auto [c1, c2, c3] = _row(next);
+                columns[0]->insert_data((const char*)&c1, sizeof(c1));
+                columns[1]->insert_data((const char*)&c2, sizeof(c2));
+                columns[2]->insert_data((const char*)&c3, sizeof(c3));
+            }
+            EXPECT_TRUE(rowset_writer->add_block(&block).ok());
+            EXPECT_TRUE(rowset_writer->flush().ok());
+        }
+        RowsetSharedPtr rowset;
+        EXPECT_EQ(Status::OK(), rowset_writer->build(rowset));
+        EXPECT_EQ(segment_rows.size(), rowset->rowset_meta()->num_segments());
+        return rowset;
+    }
+
+    RowsetReaderSharedPtr _create_reader(const std::vector<uint32_t>* return_columns,
+                                         bool record_rowids) {
+        // the reader keeps a pointer to its context
+        auto& context = _reader_contexts.emplace_back();
+        context.tablet_schema = _tablet_schema;
+        context.need_ordered_result = false;
+        context.return_columns = return_columns;
+        context.record_rowids = record_rowids;
+        context.stats = &_stats;
+        RowsetReaderSharedPtr reader;
+        EXPECT_TRUE(_rowset->create_reader(&reader).ok());
+        EXPECT_TRUE(reader->init(&context).ok());
+        return reader;
+    }
+
+    // Read all columns and apply `filter` on the rows, like a scanner without late
+    // materialization does.
+    template <typename Filter>
+    std::vector<Row> _read_eager(Filter filter) {
+        std::vector<uint32_t> return_columns = {0, 1, 2};
+        auto reader = _create_reader(&return_columns, false);
+        std::vector<Row> rows;
+        Status st;
+        do {
+            vectorized::Block block = _tablet_schema->create_block(return_columns);
+            st = reader->next_block(&block);
+            for (size_t i = 0; i < block.rows(); ++i) {
+                Row row = _get_row(block, i, 3);
+                if (filter(row)) {
+                    rows.push_back(row);
+                }
+            }
+        } while (st.ok());
+        EXPECT_TRUE(st.is<END_OF_FILE>()) << st;
+        return rows;
+    }
+
+    // Read c1 and c2 with their row locations, apply `filter` and fetch c3 by row location
+    // for the remaining rows only, at most `limit` rows in total.
+    template <typename Filter>
+    std::vector<Row> _read_late(Filter filter, size_t limit = SIZE_MAX) {
+        std::vector<uint32_t> return_columns = {0, 1};
+        auto reader = _create_reader(&return_columns, true);
+        LocalRowIdFetcher fetcher(_tablet_schema, &_stats, false);
+        fetcher.add_rowset(_rowset);
+        std::vector<Row> rows;
+        Status st;
+        do {
+            vectorized::Block block = _tablet_schema->create_block(return_columns);
+            st = reader->next_block(&block);
+            if (block.rows() == 0) {
+                continue;
+            }
+            std::vector<RowLocation> locations;
+            EXPECT_TRUE(reader->current_block_row_locations(&locations).ok());
+            EXPECT_EQ(block.rows(), locations.size());
+            std::vector<RowLocation> selected_locations;
+            std::vector<size_t> selected;
+            for (size_t i = 0; i < block.rows() && rows.size() + selected.size() < limit; ++i) {
+                Row row = _get_row(block, i, 2);
+                if (filter(row)) {
+                    selected.push_back(i);
+                    selected_locations.push_back(locations[i]);
+                }
+            }
+            auto c3 = _tablet_schema->column(2).get_vec_type()->create_column();
+            EXPECT_TRUE(fetcher.fetch(selected_locations, 2, c3).ok());
+            EXPECT_EQ(selected.size(), c3->size());
+            for (size_t i = 0; i < selected.size(); ++i) {
+                rows.emplace_back(block.get_by_position(0).column->get_int(selected[i]),
+                                  block.get_by_position(1).column->get_int(selected[i]),
+                                  c3->get_int(i));
+            }
+        } while (st.ok() && rows.size() < limit);
+        EXPECT_TRUE(st.ok() || st.is<END_OF_FILE>()) << st;
+        return rows;
+    }
+
+    std::string _absolute_dir;
+    TabletSchemaSPtr _tablet_schema;
+    RowsetSharedPtr _rowset;
+    OlapReaderStatistics _stats;
+    std::list<RowsetReaderContext> _reader_contexts;
+};
+
+TEST_F(LocalRowIdFetcherTest, SameRowsAsEagerRead) {
+    auto all = [](const Row&) { return true; };
+    auto eager = _read_eager(all);
+    ASSERT_EQ(5000, eager.size());
+    EXPECT_EQ(eager, _read_late(all));
+
+    auto selective = [](const Row& row) { return std::get<1>(row) % 3 == 0; };
+    eager = _read_eager(selective);
+    ASSERT_FALSE(eager.empty());
+    ASSERT_LT(eager.size(), 5000);
+    EXPECT_EQ(eager, _read_late(selective));
+
+    auto none = [](const Row& row) { return std::get<1>(row) > 100; };
+    EXPECT_TRUE(_read_eager(none).empty());
+    EXPECT_TRUE(_read_late(none).empty());
+}
+
+TEST_F(LocalRowIdFetcherTest, Limit) {
+    auto selective = [](const Row& row) { return std::get<1>(row) % 2 == 1; };
+    auto eager = _read_eager(selective);
+    ASSERT_GT(eager.size(), 100);
+    eager.resize(100);
+    EXPECT_EQ(eager, _read_late(selective, 100));
+}
+
+TEST_F(LocalRowIdFetcherTest, FetchAcrossSegmentsAndOutOfOrder) {
+    LocalRowIdFetcher fetcher(_tablet_schema, &_stats, false);
+    fetcher.add_rowset(_rowset);
+    // rows of both segments, a descending step inside a segment costs a seek
+    std::vector<RowLocation> locations = {
+            {_rowset->rowset_id(), 0, 10},   {_rowset->rowset_id(), 0, 2999},
+            {_rowset->rowset_id(), 1, 0},    {_rowset->rowset_id(), 1, 1999},
+            {_rowset->rowset_id(), 1, 1000}, {_rowset->rowset_id(), 0, 0}};
+    std::vector<int32_t> expected = {10, 2999, 3000, 4999, 4000, 0};
+    for (uint32_t cid = 0; cid < 3; ++cid) {
+        auto column = _tablet_schema->column(cid).get_vec_type()->create_column();
+        auto st = fetcher.fetch(locations, cid, column);
+        ASSERT_TRUE(st.ok()) << st;
+        ASSERT_EQ(locations.size(), column->size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            Row row = _row(expected[i]);
+            int32_t value = cid == 0 ? std::get<0>(row)
+                                     : (cid == 1 ? std::get<1>(row) : std::get<2>(row));
+            EXPECT_EQ(value, column->get_int(i)) << "cid " << cid << " row " << i;
+        }
+    }
+}
+
+TEST_F(LocalRowIdFetcherTest, UnknownRowsetOrSegment) {
+    LocalRowIdFetcher fetcher(_tablet_schema, &_stats, false);
+    auto column = _tablet_schema->column(2).get_vec_type()->create_column();
+    // the rowset was not added
+    auto st = fetcher.fetch({{_rowset->rowset_id(), 0, 0}}, 2, column);
+    EXPECT_FALSE(st.ok());
+
+    fetcher.add_rowset(_rowset);
+    st = fetcher.fetch({{_rowset->rowset_id(), 5, 0}}, 2, column);
+    EXPECT_FALSE(st.ok());
+    EXPECT_EQ(0, column->size());
+}
+
+} // namespace doris
@@ -29,6 +29,7 @@
 #include <filesystem>
 #include <vector>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "common/sync_point.h"
 #include "gtest/gtest_pred_impl.h"
@@ -137,6 +138,53 @@ TEST_F(LocalFileSystemTest, WriteRead) {
     }
 }
 
+TEST_F(LocalFileSystemTest, BatchRead) {
+    auto fname = fmt::format("{}/batch", test_dir);
+    std::string content;
+    for (int i = 0; i < 100000; ++i) {
+        content.push_back((char)(i * 31 + 7));
+    }
+    auto st = save_string_file(fname, content);
+    ASSERT_TRUE(st.ok()) << st;
+
+    bool enable_io_uring = config::enable_io_uring;
+    for (bool use_io_uring : {false, true}) {
+        config::enable_io_uring = use_io_uring;
+        io::FileReaderSPtr file_reader;
+        st = io::global_local_filesystem()->open_file(fname, &file_reader);
+        ASSERT_TRUE(st.ok()) << st;
+
+        // more requests than the queue depth, the last one exceeds the end of file
+        std::vector<std::string> bufs(100);
+        std::vector<io::FileReadRequest> requests;
+        for (int i = 0; i < 100; ++i) {
+            bufs[i].resize(1000 + i * 13);
+            requests.push_back({.offset = (size_t)i * 997, .result = Slice(bufs[i])});
+        }
+        bufs.back().resize(2000);
+        requests.back() = {.offset = content.size() - 1000, .result = Slice(bufs.back())};
+
+        st = file_reader->read_batch_at(&requests);
+        ASSERT_TRUE(st.ok()) << st;
+        for (const auto& request : requests) {
+            ASSERT_EQ(request.bytes_read, std::min(request.result.size,
+                                                   content.size() - request.offset));
+            EXPECT_EQ(std::string_view(request.result.data, request.bytes_read),
+                      std::string_view(content).substr(request.offset, request.bytes_read));
+        }
+
+        std::vector<io::FileReadRequest> bad_requests {
+                {.offset = 0, .result = Slice(bufs[0])},
+                {.offset = content.size() + 1, .result = Slice(bufs[1])}};
+        st = file_reader->read_batch_at(&bad_requests);
+        ASSERT_FALSE(st.ok());
+
+        st = file_reader->close();
+        ASSERT_TRUE(st.ok()) << st;
+    }
+    config::enable_io_uring = enable_io_uring;
+}
+
 TEST_F(LocalFileSystemTest, Exist) {
     auto fname = fmt::format("{}/abc", test_dir);
     ASSERT_FALSE(check_exist(fname));
@@ -0,0 +1,102 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "exprs/bloom_filter_func.h"
+#include "exprs/create_predicate_function.h"
+#include "exprs/minmax_predicate.h"
+#include "olap/bloom_filter_predicate.h"
+#include "olap/wrapper_field.h"
+#include "runtime/define_primitive_type.h"
+
+namespace doris {
+
+class BloomFilterColumnPredicateTest : public testing::Test {
+public:
+    void SetUp() override {
+        _min = WrapperField::create_by_type(FieldType::OLAP_FIELD_TYPE_INT);
+        _max = WrapperField::create_by_type(FieldType::OLAP_FIELD_TYPE_INT);
+    }
+
+    void TearDown() override {
+        delete _min;
+        delete _max;
+    }
+
+    // zone map of a page whose values are in [min, max]
+    void set_zone_map(const std::string& min, const std::string& max) {
+        _min->set_not_null();
+        _max->set_not_null();
+        EXPECT_TRUE(_min->from_string(min).ok());
+        EXPECT_TRUE(_max->from_string(max).ok());
+    }
+
+protected:
+    WrapperField* _min = nullptr;
+    WrapperField* _max = nullptr;
+};
+
+TEST_F(BloomFilterColumnPredicateTest, evaluate_and_without_range) {
+    std::shared_ptr<BloomFilterFuncBase> filter(create_bloom_filter(TYPE_INT));
+    BloomFilterColumnPredicate<TYPE_INT> predicate(0, filter, 0);
+    set_zone_map("1", "100");
+    EXPECT_TRUE(predicate.evaluate_and({_min, _max}));
+
+    // a range of another type is not used
+    std::shared_ptr<MinMaxFuncBase> min_max(create_minmax_filter(TYPE_BIGINT));
+    int64_t value = 1000;
+    min_max->insert(&value);
+    filter->set_min_max(min_max, TYPE_BIGINT);
+    EXPECT_TRUE(predicate.evaluate_and({_min, _max}));
+}
+
+TEST_F(BloomFilterColumnPredicateTest, evaluate_and_with_range) {
+    std::shared_ptr<BloomFilterFuncBase> filter(create_bloom_filter(TYPE_INT));
+    std::shared_ptr<MinMaxFuncBase> min_max(create_minmax_filter(TYPE_INT));
+    for (int32_t value : {50, 70, 60}) {
+        min_max->insert(&value);
+    }
+    filter->set_min_max(min_max, TYPE_INT);
+    BloomFilterColumnPredicate<TYPE_INT> predicate(0, filter, 0);
+
+    set_zone_map("1", "49");
+    EXPECT_FALSE(predicate.evaluate_and({_min, _max}));
+    set_zone_map("71", "100");
+    EXPECT_FALSE(predicate.evaluate_and({_min, _max}));
+    set_zone_map("1", "50");
+    EXPECT_TRUE(predicate.evaluate_and({_min, _max}));
+    set_zone_map("70", "100");
+    EXPECT_TRUE(predicate.evaluate_and({_min, _max}));
+    set_zone_map("55", "58");
+    EXPECT_TRUE(predicate.evaluate_and({_min, _max}));
+
+    // the page contains nulls, only its max is known
+    set_zone_map("1", "100");
+    _min->set_null();
+    EXPECT_TRUE(predicate.evaluate_and({_min, _max}));
+    set_zone_map("1", "40");
+    _min->set_null();
+    EXPECT_FALSE(predicate.evaluate_and({_min, _max}));
+
+    // the page only contains nulls
+    _max->set_null();
+    EXPECT_FALSE(predicate.evaluate_and({_min, _max}));
+}
+
+} // namespace doris
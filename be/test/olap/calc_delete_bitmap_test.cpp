@@ -0,0 +1,315 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/AgentService_types.h>
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/status.h"
+#include "io/fs/local_file_system.h"
+#include "olap/base_tablet.h"
+#include "olap/calc_delete_bitmap_executor.h"
+#include "olap/key_coder.h"
+#include "olap/olap_common.h"
+#include "olap/options.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/segment_loader.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tablet_meta.h"
+#include "olap/tablet_schema.h"
+#include "olap/utils.h"
+#include "runtime/exec_env.h"
+#include "util/key_util.h"
+#include "vec/core/block.h"
+
+namespace doris {
+using namespace ErrorCode;
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static const std::string kTestDir = "/ut_dir/calc_delete_bitmap_test";
+
+// The old rowset of a merge-on-write tablet has a segment of the even keys in [0, 8000) and a
+// later segment of the multiples of 3 in [0, 9000). The new rowset has one segment of the keys
+// in [0, NEW_ROWS), so the keys around every split of the new segment are in the old rowset.
+class CalcDeleteBitmapTest : public testing::Test {
+public:
+    static constexpr int32_t NEW_ROWS = 5000;
+
+    void SetUp() override {
+        char buffer[MAX_PATH_LEN];
+        ASSERT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        _absolute_dir = std::string(buffer) + kTestDir;
+        auto st = io::global_local_filesystem()->delete_directory(_absolute_dir);
+        ASSERT_TRUE(st.ok()) << st;
+        st = io::global_local_filesystem()->create_directory(_absolute_dir);
+        ASSERT_TRUE(st.ok()) << st;
+        auto engine = std::make_unique<StorageEngine>(EngineOptions {});
+        _engine = engine.get();
+        ExecEnv::GetInstance()->set_storage_engine(std::move(engine));
+        _executor.init();
+        _rows_per_task = config::calc_delete_bitmap_rows_per_task;
+        _correctness_check = config::enable_merge_on_write_correctness_check;
+        // the sentinel marks are not rows of the old rowset
+        config::enable_merge_on_write_correctness_check = false;
+
+        _schema = create_schema();
+        _tablet = create_tablet();
+        std::vector<int32_t> even_keys;
+        for (int32_t key = 0; key < 8000; key += 2) {
+            even_keys.push_back(key);
+        }
+        std::vector<int32_t> multiples_of_3;
+        for (int32_t key = 0; key < 9000; key += 3) {
+            multiples_of_3.push_back(key);
+        }
+        _old_rowset = create_rowset({even_keys, multiples_of_3}, 2);
+        std::vector<int32_t> new_keys;
+        for (int32_t key = 0; key < NEW_ROWS; ++key) {
+            new_keys.push_back(key);
+        }
+        _new_rowset = create_rowset({new_keys}, 3);
+        ASSERT_TRUE(std::static_pointer_cast<BetaRowset>(_new_rowset)
+                            ->load_segments(&_new_segments)
+                            .ok());
+        ASSERT_EQ(1, _new_segments.size());
+        ASSERT_EQ(uint32_t(NEW_ROWS), _new_segments[0]->num_rows());
+    }
+
+    void TearDown() override {
+        config::calc_delete_bitmap_rows_per_task = _rows_per_task;
+        config::enable_merge_on_write_correctness_check = _correctness_check;
+        _new_segments.clear();
+        _new_rowset.reset();
+        _old_rowset.reset();
+        _tablet.reset();
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(_absolute_dir).ok());
+        _engine = nullptr;
+        ExecEnv::GetInstance()->set_storage_engine(nullptr);
+    }
+
+protected:
+    static TabletSchemaSPtr create_schema() {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(UNIQUE_KEYS);
+        tablet_schema_pb.set_num_short_key_columns(1);
+        tablet_schema_pb.set_num_rows_per_row_block(1024);
+        tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+        tablet_schema_pb.set_next_column_unique_id(4);
+        const std::vector<std::tuple<std::string, std::string, int32_t>> columns = {
+                {"c1", "INT", 4}, {"c2", "INT", 4}, {DELETE_SIGN, "TINYINT", 1}};
+        for (int i = 0; i < columns.size(); ++i) {
+            const auto& [name, type, length] = columns[i];
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(i + 1);
+            column->set_name(name);
+            column->set_type(type);
+            column->set_is_key(i == 0);
+            column->set_length(length);
+            column->set_index_length(length);
+            column->set_is_nullable(false);
+            column->set_is_bf_column(false);
+        }
+        auto tablet_schema = std::make_shared<TabletSchema>();
+        tablet_schema->init_from_pb(tablet_schema_pb);
+        return tablet_schema;
+    }
+
+    TabletSharedPtr create_tablet() {
+        std::vector<TColumn> cols;
+        std::unordered_map<uint32_t, uint32_t> col_ordinal_to_unique_id;
+        for (int i = 0; i < _schema->num_columns(); ++i) {
+            const TabletColumn& column = _schema->column(i);
+            TColumn col;
+            col.column_type.type = i < 2 ? TPrimitiveType::INT : TPrimitiveType::TINYINT;
+            col.__set_column_name(column.name());
+            col.__set_is_key(column.is_key());
+            cols.push_back(col);
+            col_ordinal_to_unique_id[i] = column.unique_id();
+        }
+        TTabletSchema t_tablet_schema;
+        t_tablet_schema.__set_short_key_column_count(1);
+        t_tablet_schema.__set_schema_hash(3333);
+        t_tablet_schema.__set_keys_type(TKeysType::UNIQUE_KEYS);
+        t_tablet_schema.__set_storage_type(TStorageType::COLUMN);
+        t_tablet_schema.__set_columns(cols);
+        TabletMetaSharedPtr tablet_meta(new TabletMeta(
+                1, 1, 1, 1, 3333, 1, t_tablet_schema, 4, col_ordinal_to_unique_id, UniqueId(1, 2),
+                TTabletType::TABLET_TYPE_DISK, TCompressionType::LZ4F, 0, true));
+        TabletSharedPtr tablet(new Tablet(*_engine, tablet_meta, nullptr));
+        EXPECT_TRUE(tablet->init().ok());
+        return tablet;
+    }
+
+    // Each vector of keys is flushed as one segment, c2 of a key is its 7 times.
+    RowsetSharedPtr create_rowset(const std::vector<std::vector<int32_t>>& segment_keys,
+                                  int64_t version) {
+        RowsetWriterContext writer_context;
+        RowsetId rowset_id;
+        rowset_id.init(10000 + version);
+        writer_context.rowset_id = rowset_id;
+        writer_context.rowset_type = BETA_ROWSET;
+        writer_context.rowset_state = VISIBLE;
+        writer_context.tablet_schema = _schema;
+        writer_context.rowset_dir = _absolute_dir;
+        writer_context.version = {version, version};
+        writer_context.segments_overlap = OVERLAPPING;
+        writer_context.max_rows_per_segment = UINT32_MAX;
+        writer_context.enable_unique_key_merge_on_write = true;
+        auto res = RowsetFactory::create_rowset_writer(*_engine, writer_context, false);
+        EXPECT_TRUE(res.has_value()) << res.error();
+        auto rowset_writer = std::move(res).value();
+
+        for (const auto& keys : segment_keys) {
+            vectorized::Block block = _schema->create_block();
+            auto columns = block.mutate_columns();
+            for (int32_t key : keys) {
+                int32_t value = key * 7;
+                int8_t delete_sign = 0;
+                columns[0]->insert_data((const char*)&key, sizeof(key));
+                columns[1]->insert_data((const char*)&value, sizeof(value));
+                columns[2]->insert_data((const char*)&delete_sign, sizeof(delete_sign));
+            }
+            EXPECT_TRUE(rowset_writer->add_block(&block).ok());
+            EXPECT_TRUE(rowset_writer->flush().ok());
+        }
+        RowsetSharedPtr rowset;
+        auto st = rowset_writer->build(rowset);
+        EXPECT_TRUE(st.ok()) << st;
+        EXPECT_EQ(int64_t(segment_keys.size()), rowset->num_segments());
+        return rowset;
+    }
+
+    static std::string encode_key(int32_t key) {
+        std::string encoded_key;
+        encoded_key.push_back(KEY_NORMAL_MARKER);
+        get_key_coder(FieldType::OLAP_FIELD_TYPE_INT)->full_encode_ascending(&key, &encoded_key);
+        return encoded_key;
+    }
+
+    // The delete bitmap of the new rowset against the old one, computed with the segment split
+    // into tasks of `rows_per_task` rows, 0 computes it in the calling thread.
+    DeleteBitmapPtr calc_delete_bitmap(int32_t rows_per_task) {
+        config::calc_delete_bitmap_rows_per_task = rows_per_task;
+        auto delete_bitmap = std::make_shared<DeleteBitmap>(_tablet->tablet_id());
+        std::unique_ptr<CalcDeleteBitmapToken> token;
+        if (rows_per_task != 0) {
+            token = _executor.create_token();
+        }
+        auto st = BaseTablet::calc_delete_bitmap(_tablet, _new_rowset, _new_segments,
+                                                 {_old_rowset}, delete_bitmap, 2, token.get());
+        EXPECT_TRUE(st.ok()) << st;
+        if (token != nullptr) {
+            st = token->wait();
+            EXPECT_TRUE(st.ok()) << st;
+        }
+        return delete_bitmap;
+    }
+
+    std::string _absolute_dir;
+    StorageEngine* _engine = nullptr;
+    CalcDeleteBitmapExecutor _executor;
+    int32_t _rows_per_task = 0;
+    bool _correctness_check = false;
+    TabletSchemaSPtr _schema;
+    TabletSharedPtr _tablet;
+    RowsetSharedPtr _old_rowset;
+    RowsetSharedPtr _new_rowset;
+    std::vector<segment_v2::SegmentSharedPtr> _new_segments;
+};
+
+TEST_F(CalcDeleteBitmapTest, LookupWithKeptIndexIterators) {
+    std::vector<std::unique_ptr<SegmentCacheHandle>> segment_caches(1);
+    std::vector<PrimaryKeyIndexIterators> pk_index_iterators(1);
+    auto lookup = [&](int32_t key, bool keep_iterators, RowLocation* loc) {
+        std::vector<std::unique_ptr<SegmentCacheHandle>> caches(1);
+        return _tablet->lookup_row_key(encode_key(key), false, {_old_rowset}, loc, 2,
+                                       keep_iterators ? segment_caches : caches, nullptr, true,
+                                       keep_iterators ? &pk_index_iterators : nullptr);
+    };
+    // ascending keys like the delete bitmap calculation, then descending ones
+    std::vector<int32_t> keys;
+    for (int32_t key = -10; key < 9010; ++key) {
+        keys.push_back(key);
+    }
+    for (int32_t key = 9010; key >= -10; key -= 7) {
+        keys.push_back(key);
+    }
+    for (int32_t key : keys) {
+        RowLocation expected;
+        auto expected_st = lookup(key, false, &expected);
+        RowLocation loc;
+        auto st = lookup(key, true, &loc);
+        ASSERT_EQ(expected_st.code(), st.code()) << "key " << key << " " << st;
+        if (!st.ok()) {
+            EXPECT_TRUE(st.is<KEY_NOT_FOUND>()) << st;
+            continue;
+        }
+        EXPECT_EQ(expected.rowset_id, loc.rowset_id);
+        EXPECT_EQ(expected.segment_id, loc.segment_id) << "key " << key;
+        EXPECT_EQ(expected.row_id, loc.row_id) << "key " << key;
+        // the later segment has the key if both do
+        if (key % 3 == 0) {
+            EXPECT_EQ(1U, loc.segment_id);
+            EXPECT_EQ(uint32_t(key / 3), loc.row_id);
+        } else {
+            EXPECT_EQ(0U, loc.segment_id);
+            EXPECT_EQ(uint32_t(key / 2), loc.row_id);
+        }
+    }
+    // the kept iterators were created once
+    ASSERT_EQ(2, pk_index_iterators[0].size());
+    EXPECT_NE(nullptr, pk_index_iterators[0][0]);
+    EXPECT_NE(nullptr, pk_index_iterators[0][1]);
+}
+
+TEST_F(CalcDeleteBitmapTest, SplitSegmentSameAsWholeSegment) {
+    // the keys of the new rowset delete the rows of the latest segment with the key
+    DeleteBitmap expected(_tablet->tablet_id());
+    for (int32_t key = 0; key < NEW_ROWS; ++key) {
+        if (key % 3 == 0) {
+            expected.add({_old_rowset->rowset_id(), 1, DeleteBitmap::TEMP_VERSION_COMMON},
+                         key / 3);
+        } else if (key % 2 == 0) {
+            expected.add({_old_rowset->rowset_id(), 0, DeleteBitmap::TEMP_VERSION_COMMON},
+                         key / 2);
+        }
+    }
+
+    auto whole = calc_delete_bitmap(0);
+    EXPECT_EQ(expected.delete_bitmap, whole->delete_bitmap);
+    // one task, the splits are not aligned with the batches of 1024 keys, a split of one key
+    // more than half of the segment, and a last split of one key
+    for (int32_t rows_per_task : {INT32_MAX, 1000, 1024, 1537, 2501, NEW_ROWS - 1}) {
+        auto split = calc_delete_bitmap(rows_per_task);
+        EXPECT_EQ(whole->delete_bitmap, split->delete_bitmap) << "rows per task " << rows_per_task;
+    }
+}
+
+} // namespace doris
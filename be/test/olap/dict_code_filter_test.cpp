@@ -0,0 +1,157 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/dict_code_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "olap/olap_common.h"
+#include "vec/columns/column_dictionary.h"
+
+namespace doris {
+
+class DictCodeFilterTest : public testing::Test {
+public:
+    void SetUp() override {
+        _column = vectorized::ColumnDictI32::create(FieldType::OLAP_FIELD_TYPE_VARCHAR);
+        _column->set_rowset_segment_id({RowsetId(), 1});
+    }
+
+    // `rows` rows with random codes of `_words`, about a quarter of them null
+    void fill(size_t rows) {
+        std::mt19937 rng(1);
+        std::vector<int32_t> codes(rows);
+        _column->reserve(rows);
+        _null_map.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            codes[i] = rng() % _words.size();
+            _null_map[i] = rng() % 4 == 0;
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            if (_null_map[i]) {
+                _column->insert_default();
+            } else {
+                _column->insert_many_dict_data(codes.data(), i, _words.data(), 1, _words.size());
+            }
+        }
+    }
+
+    bool expected(size_t row, bool nullable, bool opposite) const {
+        if (nullable && _null_map[row]) {
+            return opposite;
+        }
+        return opposite ^ _match(_column->get_value(_column->get_data()[row]));
+    }
+
+    static bool _match(const StringRef& word) { return word.size >= 2; }
+
+protected:
+    std::vector<StringRef> _words = {StringRef("a"), StringRef("bb"), StringRef("ccc"),
+                                     StringRef("d"), StringRef("ee")};
+    vectorized::ColumnDictI32::MutablePtr _column;
+    std::vector<uint8_t> _null_map;
+};
+
+TEST_F(DictCodeFilterTest, CodeFlags) {
+    DictCodeFilter filter;
+    int calls = 0;
+    auto matcher = [&calls](const StringRef& word) {
+        ++calls;
+        return _match(word);
+    };
+    // empty dictionary, all rows read so far are null
+    EXPECT_EQ(1, filter.get(*_column, matcher).size());
+    EXPECT_EQ(0, calls);
+
+    fill(10);
+    const auto& flags = filter.get(*_column, matcher);
+    ASSERT_EQ(_words.size() + 1, flags.size());
+    EXPECT_EQ(0, flags[0]);
+    for (size_t code = 0; code < _words.size(); ++code) {
+        EXPECT_EQ(_match(_words[code]), flags[code + 1]);
+    }
+    // computed once per segment
+    filter.get(*_column, matcher);
+    EXPECT_EQ(_words.size(), calls);
+
+    _column->set_rowset_segment_id({RowsetId(), 2});
+    filter.get(*_column, matcher);
+    EXPECT_EQ(_words.size() * 2, calls);
+}
+
+TEST_F(DictCodeFilterTest, Evaluate) {
+    const size_t rows = 1000;
+    fill(rows);
+    DictCodeFilter filter;
+    const auto& flags = filter.get(*_column, _match);
+
+    for (bool nullable : {false, true}) {
+        for (bool opposite : {false, true}) {
+            const uint8_t* null_map = nullable ? _null_map.data() : nullptr;
+
+            // all rows, compacted 32 rows at a time
+            std::vector<uint16_t> sel(rows);
+            for (uint16_t i = 0; i < rows; ++i) {
+                sel[i] = i;
+            }
+            uint16_t size = DictCodeFilter::evaluate(flags, *_column, null_map, opposite,
+                                                     sel.data(), rows);
+            std::vector<uint16_t> expected_sel;
+            for (uint16_t i = 0; i < rows; ++i) {
+                if (expected(i, nullable, opposite)) {
+                    expected_sel.push_back(i);
+                }
+            }
+            ASSERT_EQ(expected_sel, std::vector<uint16_t>(sel.begin(), sel.begin() + size));
+
+            // a subset of the rows
+            sel.clear();
+            for (uint16_t i = 0; i < rows; i += 3) {
+                sel.push_back(i);
+            }
+            size = DictCodeFilter::evaluate(flags, *_column, null_map, opposite, sel.data(),
+                                            sel.size());
+            expected_sel.clear();
+            for (uint16_t i = 0; i < rows; i += 3) {
+                if (expected(i, nullable, opposite)) {
+                    expected_sel.push_back(i);
+                }
+            }
+            ASSERT_EQ(expected_sel, std::vector<uint16_t>(sel.begin(), sel.begin() + size));
+
+            bool result[rows];
+            DictCodeFilter::evaluate_vec<false>(flags, *_column, null_map, opposite, rows, result);
+            for (size_t i = 0; i < rows; ++i) {
+                ASSERT_EQ(expected(i, nullable, opposite), result[i]) << "row " << i;
+            }
+            bool and_result[rows];
+            for (size_t i = 0; i < rows; ++i) {
+                and_result[i] = i % 2;
+            }
+            DictCodeFilter::evaluate_vec<true>(flags, *_column, null_map, opposite, rows,
+                                               and_result);
+            for (size_t i = 0; i < rows; ++i) {
+                ASSERT_EQ(i % 2 && expected(i, nullable, opposite), and_result[i]) << "row " << i;
+            }
+        }
+    }
+}
+
+} // namespace doris
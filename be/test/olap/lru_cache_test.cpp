@@ -441,6 +441,194 @@ TEST_F(CacheTest, Number) {
     EXPECT_EQ(0, cache.get_usage());
 }
 
+static bool lookup_LRUCache(LRUCache& cache, const CacheKey& key) {
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    Cache::Handle* handle = cache.lookup(key, hash);
+    if (handle == nullptr) {
+        return false;
+    }
+    cache.release(handle);
+    return true;
+}
+
+TEST_F(CacheTest, SegmentedLRU) {
+    LRUCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(10);
+    cache.set_eviction_policy(CacheEvictionPolicy::SLRU);
+
+    // 1~5 are hit once, so they are moved to the protected segment
+    for (int i = 1; i <= 5; ++i) {
+        insert_number_LRUCache(cache, CacheKey {std::to_string(i)}, i, 1, CachePriority::NORMAL);
+        EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+    EXPECT_EQ(5, cache.get_protected_usage());
+
+    // a scan of entries never hit again only cycles through the probation segment
+    for (int i = 100; i < 200; ++i) {
+        insert_number_LRUCache(cache, CacheKey {std::to_string(i)}, i, 1, CachePriority::NORMAL);
+    }
+    EXPECT_EQ(10, cache.get_usage());
+    for (int i = 1; i <= 5; ++i) {
+        EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+
+    // the protected segment is limited to 80% of the capacity, the oldest protected
+    // entries are demoted to probation
+    for (int i = 6; i <= 10; ++i) {
+        insert_number_LRUCache(cache, CacheKey {std::to_string(i)}, i, 1, CachePriority::NORMAL);
+        EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+    EXPECT_EQ(8, cache.get_protected_usage());
+    insert_number_LRUCache(cache, CacheKey {"200"}, 200, 1, CachePriority::NORMAL);
+    insert_number_LRUCache(cache, CacheKey {"201"}, 201, 1, CachePriority::NORMAL);
+    insert_number_LRUCache(cache, CacheKey {"202"}, 202, 1, CachePriority::NORMAL);
+    EXPECT_FALSE(lookup_LRUCache(cache, CacheKey {"1"}));
+    EXPECT_FALSE(lookup_LRUCache(cache, CacheKey {"2"}));
+    EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {"3"}));
+
+    CacheKey key3("3");
+    cache.erase(key3, key3.hash(key3.data(), key3.size(), 0));
+    cache.prune();
+    EXPECT_EQ(0, cache.get_usage());
+    EXPECT_EQ(0, cache.get_protected_usage());
+}
+
+TEST_F(CacheTest, TinyLFUAdmission) {
+    LRUCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(4);
+    cache.set_eviction_policy(CacheEvictionPolicy::TINY_LFU);
+
+    for (int i = 1; i <= 4; ++i) {
+        insert_number_LRUCache(cache, CacheKey {std::to_string(i)}, i, 1, CachePriority::NORMAL);
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+        }
+    }
+
+    // a cold entry does not replace the frequently accessed ones
+    insert_number_LRUCache(cache, CacheKey {"100"}, 100, 1, CachePriority::NORMAL);
+    EXPECT_EQ(1, cache.get_admission_rejected_count());
+    EXPECT_EQ(4, cache.get_usage());
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+
+    // misses count, a key asked for more often than the victim is admitted
+    for (int j = 0; j < 8; ++j) {
+        EXPECT_FALSE(lookup_LRUCache(cache, CacheKey {"100"}));
+    }
+    insert_number_LRUCache(cache, CacheKey {"100"}, 100, 1, CachePriority::NORMAL);
+    EXPECT_EQ(1, cache.get_admission_rejected_count());
+    EXPECT_EQ(4, cache.get_usage());
+    EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {"100"}));
+
+    // durable entries are not subject to admission
+    insert_number_LRUCache(cache, CacheKey {"200"}, 200, 1, CachePriority::DURABLE);
+    EXPECT_EQ(1, cache.get_admission_rejected_count());
+    EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {"200"}));
+}
+
+TEST_F(CacheTest, ExistsIsNotCounted) {
+    LRUCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(4);
+    cache.set_eviction_policy(CacheEvictionPolicy::TINY_LFU);
+    for (int i = 1; i <= 4; ++i) {
+        insert_number_LRUCache(cache, CacheKey {std::to_string(i)}, i, 1, CachePriority::NORMAL);
+        EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+    EXPECT_EQ(4, cache.get_lookup_count());
+    EXPECT_EQ(4, cache.get_hit_count());
+
+    CacheKey key1("1");
+    CacheKey key100("100");
+    for (int j = 0; j < 8; ++j) {
+        EXPECT_TRUE(cache.exists(key1, key1.hash(key1.data(), key1.size(), 0)));
+        EXPECT_FALSE(cache.exists(key100, key100.hash(key100.data(), key100.size(), 0)));
+    }
+    EXPECT_EQ(4, cache.get_lookup_count());
+    EXPECT_EQ(4, cache.get_hit_count());
+    // probing a missing key does not earn it the admission that lookups would
+    insert_number_LRUCache(cache, key100, 100, 1, CachePriority::NORMAL);
+    EXPECT_EQ(1, cache.get_admission_rejected_count());
+    EXPECT_FALSE(cache.exists(key100, key100.hash(key100.data(), key100.size(), 0)));
+}
+
+TEST_F(CacheTest, FrequencySketch) {
+    FrequencySketch sketch;
+    sketch.increment(1);
+    EXPECT_EQ(0, sketch.frequency(1));
+
+    sketch.ensure_capacity(1024);
+    for (int i = 0; i < 5; ++i) {
+        sketch.increment(1);
+    }
+    // count-min never underestimates
+    EXPECT_GE(sketch.frequency(1), 5);
+    for (int i = 0; i < 20; ++i) {
+        sketch.increment(1);
+    }
+    EXPECT_EQ(15, sketch.frequency(1));
+
+    // aging halves all counters
+    sketch._reset();
+    EXPECT_EQ(7, sketch.frequency(1));
+
+    // growing keeps the frequencies
+    for (uint32_t hash = 100; hash < 200; ++hash) {
+        for (uint32_t i = 0; i < hash % 8; ++i) {
+            sketch.increment(hash);
+        }
+    }
+    std::vector<uint32_t> frequencies;
+    for (uint32_t hash = 100; hash < 200; ++hash) {
+        frequencies.push_back(sketch.frequency(hash));
+    }
+    uint32_t frequency = sketch.frequency(1);
+    sketch.ensure_capacity(64 * 1024);
+    EXPECT_EQ(4096, sketch._table.size());
+    EXPECT_EQ(frequency, sketch.frequency(1));
+    for (uint32_t hash = 100; hash < 200; ++hash) {
+        EXPECT_EQ(frequencies[hash - 100], sketch.frequency(hash));
+    }
+}
+
+static int rejected_deleted = 0;
+static void count_deleter(const CacheKey& key, void* v) {
+    ++rejected_deleted;
+}
+
+TEST_F(CacheTest, TinyLFURejectedHandle) {
+    static std::unique_ptr<MemTrackerLimiter> tracker = std::make_unique<MemTrackerLimiter>(
+            MemTrackerLimiter::Type::GLOBAL, "TestTinyLFURejectedHandle");
+    LRUCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(2);
+    cache.set_eviction_policy(CacheEvictionPolicy::TINY_LFU);
+    for (int i = 1; i <= 2; ++i) {
+        insert_number_LRUCache(cache, CacheKey {std::to_string(i)}, i, 1, CachePriority::NORMAL);
+        EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+
+    rejected_deleted = 0;
+    CacheKey key("100");
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    Cache::Handle* handle = cache.insert(key, hash, EncodeValue(100), 1, &count_deleter,
+                                         tracker.get(), CachePriority::NORMAL, 100);
+    // the caller owns the only reference of a rejected entry and can use its value
+    ASSERT_NE(nullptr, handle);
+    EXPECT_EQ(1, cache.get_admission_rejected_count());
+    EXPECT_EQ(100, DecodeValue(reinterpret_cast<LRUHandle*>(handle)->value));
+    EXPECT_EQ(3, cache.get_usage());
+    EXPECT_FALSE(lookup_LRUCache(cache, key));
+    EXPECT_EQ(0, rejected_deleted);
+
+    // releasing it frees the value and leaves the cached entries alone
+    cache.release(handle);
+    EXPECT_EQ(1, rejected_deleted);
+    EXPECT_EQ(2, cache.get_usage());
+    EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {"1"}));
+    EXPECT_TRUE(lookup_LRUCache(cache, CacheKey {"2"}));
+}
+
 TEST_F(CacheTest, HeavyEntries) {
     // Add a bunch of light and heavy entries and then count the combined
     // size of items still in the cache, which must be approximately the
@@ -0,0 +1,218 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/Descriptors_types.h>
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "olap/memtable.h"
+#include "olap/tablet_meta.h"
+#include "olap/tablet_schema.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/memory/mem_tracker.h"
+#include "vec/core/block.h"
+
+namespace doris {
+
+// Inserts the same rounds of rows with duplicate keys into a memtable which merges them on
+// insert like MemTableWriter::write does, and into one which merges them only at flush. The
+// flushed blocks must be the same.
+class MemTableMergeOnInsertTest : public testing::Test {
+public:
+    static constexpr int ROUNDS = 5;
+    static constexpr int ROWS_PER_ROUND = 1000;
+    static constexpr int NUM_KEYS = 400;
+
+    void SetUp() override {
+        _merge_rows = config::memtable_merge_on_insert_rows;
+        _min_dup_ratio = config::memtable_merge_on_insert_min_dup_ratio;
+        // the first round has 60% duplicate keys, the later ones only have duplicate keys
+        config::memtable_merge_on_insert_rows = 100;
+    }
+
+    void TearDown() override {
+        config::memtable_merge_on_insert_rows = _merge_rows;
+        config::memtable_merge_on_insert_min_dup_ratio = _min_dup_ratio;
+    }
+
+protected:
+    // k is the key, the value columns are INT columns with the given aggregations, a column
+    // named SEQUENCE_COL is the sequence column
+    void create_schema(KeysType keys_type,
+                       const std::vector<std::pair<std::string, std::string>>& values) {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(keys_type);
+        tablet_schema_pb.set_num_short_key_columns(1);
+        tablet_schema_pb.set_num_rows_per_row_block(1024);
+        tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+        tablet_schema_pb.set_next_column_unique_id(values.size() + 2);
+        TDescriptorTableBuilder builder;
+        TTupleDescriptorBuilder tuple_builder;
+        for (int i = 0; i <= values.size(); ++i) {
+            std::string name = i == 0 ? "k" : values[i - 1].first;
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(i + 1);
+            column->set_name(name);
+            column->set_type("INT");
+            column->set_is_key(i == 0);
+            column->set_length(4);
+            column->set_index_length(4);
+            column->set_is_nullable(false);
+            if (i > 0) {
+                column->set_aggregation(values[i - 1].second);
+            }
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(TYPE_INT)
+                                           .nullable(false)
+                                           .column_name(name)
+                                           .column_pos(i)
+                                           .build());
+        }
+        _schema = std::make_shared<TabletSchema>();
+        _schema->init_from_pb(tablet_schema_pb);
+        tuple_builder.build(&builder);
+        DescriptorTbl* desc_tbl = nullptr;
+        ASSERT_TRUE(DescriptorTbl::create(&_pool, builder.desc_tbl(), &desc_tbl).ok());
+        _tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    }
+
+    // The rows of each round cycle through the keys in a different order, the values of a
+    // column are not ordered by the round, so later rows can have lower sequence values.
+    std::vector<vectorized::Block> create_rounds() {
+        std::vector<vectorized::Block> rounds;
+        for (int round = 0; round < ROUNDS; ++round) {
+            vectorized::Block block = _schema->create_block();
+            auto columns = block.mutate_columns();
+            for (int i = 0; i < ROWS_PER_ROUND; ++i) {
+                int32_t key = (i * 7 + round * 13) % NUM_KEYS;
+                columns[0]->insert_data((const char*)&key, sizeof(key));
+                for (int cid = 1; cid < columns.size(); ++cid) {
+                    int32_t value = (i * 31 + round * 17 + cid * 5) % 50;
+                    columns[cid]->insert_data((const char*)&value, sizeof(value));
+                }
+            }
+            block.set_columns(std::move(columns));
+            rounds.push_back(std::move(block));
+        }
+        return rounds;
+    }
+
+    // Inserts the rounds into a new memtable with the current merge on insert configs and
+    // returns the flushed rows. `agg_times` is set to the number of aggregations including the
+    // one at flush, `merging` to whether merging on insert was still on at flush.
+    std::string load(const std::vector<vectorized::Block>& rounds, bool enable_mow,
+                     int64_t* agg_times, bool* merging = nullptr) {
+        auto insert_tracker = std::make_shared<MemTracker>("MemTableMergeOnInsertTest");
+        auto flush_tracker = std::make_shared<MemTracker>("MemTableMergeOnInsertTest");
+        MemTable mem_table(1, _schema.get(), &_tuple_desc->slots(), _tuple_desc, enable_mow,
+                           nullptr, insert_tracker, flush_tracker);
+        for (const auto& block : rounds) {
+            std::vector<uint32_t> row_idxs(block.rows());
+            for (uint32_t i = 0; i < row_idxs.size(); ++i) {
+                row_idxs[i] = i;
+            }
+            mem_table.insert(&block, row_idxs);
+            if (mem_table.need_merge_on_insert()) {
+                mem_table.merge_on_insert();
+            }
+        }
+        if (merging != nullptr) {
+            *merging = mem_table._merge_on_insert;
+        }
+        auto block = mem_table.to_block();
+        *agg_times = mem_table.stat().agg_times;
+        EXPECT_EQ(size_t(NUM_KEYS), block->rows());
+        return block->dump_data(0, block->rows());
+    }
+
+    // Loads the rounds with merging on insert at `min_dup_ratio` and at flush only, and checks
+    // that the flushed rows are the same.
+    void check_same_as_final_aggregation(double min_dup_ratio, bool enable_mow,
+                                         int64_t expected_agg_times) {
+        auto rounds = create_rounds();
+        config::memtable_merge_on_insert_min_dup_ratio = 0;
+        int64_t agg_times = 0;
+        std::string expected = load(rounds, enable_mow, &agg_times);
+        EXPECT_EQ(1, agg_times);
+
+        config::memtable_merge_on_insert_min_dup_ratio = min_dup_ratio;
+        bool merging = false;
+        EXPECT_EQ(expected, load(rounds, enable_mow, &agg_times, &merging));
+        EXPECT_EQ(expected_agg_times, agg_times);
+        EXPECT_TRUE(merging);
+    }
+
+    ObjectPool _pool;
+    TabletSchemaSPtr _schema;
+    TupleDescriptor* _tuple_desc = nullptr;
+    int64_t _merge_rows = 0;
+    double _min_dup_ratio = 0;
+};
+
+TEST_F(MemTableMergeOnInsertTest, AggKeys) {
+    create_schema(AGG_KEYS, {{"v_sum", "SUM"}, {"v_max", "MAX"}, {"v_replace", "REPLACE"}});
+    // a merge after each round, the last one leaves nothing to aggregate at flush
+    check_same_as_final_aggregation(0.5, false, ROUNDS);
+}
+
+TEST_F(MemTableMergeOnInsertTest, UniqueKeysWithSequenceColumn) {
+    create_schema(UNIQUE_KEYS, {{"v", "REPLACE"}, {SEQUENCE_COL, "REPLACE"}});
+    ASSERT_TRUE(_schema->has_sequence_col());
+    // the rows of a key with lower sequence values than a merged row must not replace it
+    for (bool enable_mow : {false, true}) {
+        check_same_as_final_aggregation(0.5, enable_mow, ROUNDS);
+    }
+}
+
+TEST_F(MemTableMergeOnInsertTest, TurnedOffByFewDuplicates) {
+    create_schema(UNIQUE_KEYS, {{"v", "REPLACE"}, {SEQUENCE_COL, "REPLACE"}});
+    auto rounds = create_rounds();
+    config::memtable_merge_on_insert_min_dup_ratio = 0;
+    int64_t agg_times = 0;
+    std::string expected = load(rounds, false, &agg_times);
+
+    // only 60% of the first round are duplicates, the memtable gives merging up after the
+    // first merge and aggregates the rest at flush
+    config::memtable_merge_on_insert_min_dup_ratio = 0.9;
+    bool merging = true;
+    EXPECT_EQ(expected, load(rounds, false, &agg_times, &merging));
+    EXPECT_FALSE(merging);
+    EXPECT_EQ(2, agg_times);
+}
+
+TEST_F(MemTableMergeOnInsertTest, NeverMergedByDefault) {
+    EXPECT_EQ(0, _min_dup_ratio);
+    create_schema(AGG_KEYS, {{"v_sum", "SUM"}});
+    auto rounds = create_rounds();
+    config::memtable_merge_on_insert_min_dup_ratio = _min_dup_ratio;
+    bool merging = true;
+    int64_t agg_times = 0;
+    load(rounds, false, &agg_times, &merging);
+    EXPECT_FALSE(merging);
+    // only the aggregation at flush
+    EXPECT_EQ(1, agg_times);
+}
+
+} // namespace doris
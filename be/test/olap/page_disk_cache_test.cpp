@@ -0,0 +1,174 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/page_disk_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "io/fs/local_file_system.h"
+#include "olap/page_cache.h"
+
+namespace doris {
+
+static const std::string kTestDir = "./ut_dir/page_disk_cache_test";
+
+class PageDiskCacheTest : public testing::Test {
+public:
+    void SetUp() override {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(kTestDir));
+    }
+
+    void TearDown() override {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(kTestDir));
+    }
+
+    static DataPage* make_page(size_t size, char fill) {
+        auto* page = new DataPage(size);
+        memset(page->data(), fill, size);
+        return page;
+    }
+
+    static void check_page(PageDiskCache* cache, const std::string& key, size_t size, char fill) {
+        std::unique_ptr<DataPage> page;
+        ASSERT_TRUE(cache->lookup(key, &page)) << key;
+        ASSERT_EQ(size, page->size());
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(fill, page->data()[i]);
+        }
+    }
+};
+
+TEST_F(PageDiskCacheTest, WriteAndRead) {
+    PageDiskCache cache(kTestDir, 8 << 20, 1 << 20, 64 << 20);
+    ASSERT_TRUE(cache.init().ok());
+    for (int i = 0; i < 10; ++i) {
+        cache.insert("page_" + std::to_string(i), make_page(1000 + i, 'a' + i));
+    }
+    cache.wait_for_writes();
+    EXPECT_EQ(10, cache.write_count());
+    EXPECT_EQ(10, cache.num_pages());
+
+    for (int i = 0; i < 10; ++i) {
+        check_page(&cache, "page_" + std::to_string(i), 1000 + i, 'a' + i);
+    }
+    std::unique_ptr<DataPage> page;
+    EXPECT_FALSE(cache.lookup("page_10", &page));
+    EXPECT_EQ(10, cache.hit_count());
+    EXPECT_EQ(1, cache.miss_count());
+
+    // a page which is already cached is not written again
+    cache.insert("page_0", make_page(1000, 'x'));
+    cache.wait_for_writes();
+    EXPECT_EQ(10, cache.write_count());
+    check_page(&cache, "page_0", 1000, 'a');
+}
+
+TEST_F(PageDiskCacheTest, RecycleSlabs) {
+    // two slabs of 1MB, each holds 5 pages of 200KB
+    PageDiskCache cache(kTestDir, 2 << 20, 1 << 20, 64 << 20);
+    ASSERT_TRUE(cache.init().ok());
+    for (int i = 0; i < 20; ++i) {
+        cache.insert("page_" + std::to_string(i), make_page(200 << 10, 'a' + i));
+    }
+    cache.wait_for_writes();
+    EXPECT_LE(cache.num_pages(), 10);
+
+    // the oldest pages are dropped with their slab, the newest ones are readable
+    std::unique_ptr<DataPage> page;
+    EXPECT_FALSE(cache.lookup("page_0", &page));
+    for (int i = 16; i < 20; ++i) {
+        check_page(&cache, "page_" + std::to_string(i), 200 << 10, 'a' + i);
+    }
+
+    // pages larger than a slab are not cached
+    cache.insert("large", make_page(2 << 20, 'l'));
+    cache.wait_for_writes();
+    EXPECT_FALSE(cache.lookup("large", &page));
+}
+
+TEST_F(PageDiskCacheTest, WriteQueueLimit) {
+    PageDiskCache cache(kTestDir, 8 << 20, 1 << 20, 1000);
+    ASSERT_TRUE(cache.init().ok());
+    cache.insert("large", make_page(2000, 'l'));
+    cache.wait_for_writes();
+    EXPECT_EQ(1, cache.dropped_count());
+    EXPECT_EQ(0, cache.num_pages());
+}
+
+TEST_F(PageDiskCacheTest, Recover) {
+    {
+        PageDiskCache cache(kTestDir, 4 << 20, 1 << 20, 64 << 20);
+        ASSERT_TRUE(cache.init().ok());
+        for (int i = 0; i < 10; ++i) {
+            cache.insert("page_" + std::to_string(i), make_page(100 << 10, 'a' + i));
+        }
+        cache.wait_for_writes();
+    }
+    PageDiskCache cache(kTestDir, 4 << 20, 1 << 20, 64 << 20);
+    ASSERT_TRUE(cache.init().ok());
+    EXPECT_EQ(10, cache.num_pages());
+    for (int i = 0; i < 10; ++i) {
+        check_page(&cache, "page_" + std::to_string(i), 100 << 10, 'a' + i);
+    }
+    // appending continues after the recovered pages
+    cache.insert("page_10", make_page(100 << 10, 'z'));
+    cache.wait_for_writes();
+    check_page(&cache, "page_10", 100 << 10, 'z');
+    check_page(&cache, "page_9", 100 << 10, 'a' + 9);
+}
+
+TEST_F(PageDiskCacheTest, SecondTierOfPageCache) {
+    static constexpr int kNumShards = StoragePageCache::kDefaultNumShards;
+    StoragePageCache cache(kNumShards * 2048, 0, 0, kNumShards);
+    auto disk_cache = std::make_unique<PageDiskCache>(kTestDir, 8 << 20, 1 << 20, 64 << 20);
+    ASSERT_TRUE(disk_cache->init().ok());
+    PageDiskCache* disk_cache_ptr = disk_cache.get();
+    cache.set_disk_cache(std::move(disk_cache));
+
+    segment_v2::PageTypePB page_type = segment_v2::DATA_PAGE;
+    StoragePageCache::CacheKey key("abc", 0, 0);
+    {
+        PageCacheHandle handle;
+        cache.insert(key, make_page(1024, 'p'), &handle, page_type, false);
+    }
+    // put too many page to evict the first page
+    for (int i = 0; i < 10 * kNumShards; ++i) {
+        StoragePageCache::CacheKey other_key("bcd", 0, i);
+        PageCacheHandle handle;
+        cache.insert(other_key, make_page(1024, 'o'), &handle, page_type, false);
+    }
+    disk_cache_ptr->wait_for_writes();
+
+    // read back from the disk and cached in memory again
+    PageCacheHandle handle;
+    ASSERT_TRUE(cache.lookup(key, &handle, page_type));
+    Slice data = handle.data();
+    ASSERT_EQ(1024, data.size);
+    for (size_t i = 0; i < data.size; ++i) {
+        ASSERT_EQ('p', data.data[i]);
+    }
+    EXPECT_EQ(1, disk_cache_ptr->hit_count());
+
+    StoragePageCache::CacheKey miss_key("abc", 0, 1);
+    EXPECT_FALSE(cache.lookup(miss_key, &handle, page_type));
+}
+
+} // namespace doris
@@ -0,0 +1,238 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/parallel_scanner_builder.h"
+
+#include <gen_cpp/AgentService_types.h>
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "exec/olap_utils.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/segment_loader.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tablet_meta.h"
+#include "olap/tablet_schema.h"
+#include "runtime/exec_env.h"
+#include "util/runtime_profile.h"
+#include "vec/core/block.h"
+#include "vec/exec/scan/new_olap_scan_node.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static const std::string kTestDir = "/ut_dir/parallel_scanner_builder_test";
+
+// A duplicate key tablet has one rowset of NUM_SEGMENTS segments, segment i has the keys in
+// [i * ROWS_PER_SEGMENT, (i + 1) * ROWS_PER_SEGMENT).
+class ParallelScannerBuilderTest : public testing::Test {
+public:
+    static constexpr int NUM_SEGMENTS = 3;
+    static constexpr int ROWS_PER_SEGMENT = 100;
+
+    void SetUp() override {
+        char buffer[MAX_PATH_LEN];
+        ASSERT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        _absolute_dir = std::string(buffer) + kTestDir;
+        auto st = io::global_local_filesystem()->delete_directory(_absolute_dir);
+        ASSERT_TRUE(st.ok()) << st;
+        st = io::global_local_filesystem()->create_directory(_absolute_dir);
+        ASSERT_TRUE(st.ok()) << st;
+        auto engine = std::make_unique<StorageEngine>(EngineOptions {});
+        _engine = engine.get();
+        ExecEnv::GetInstance()->set_storage_engine(std::move(engine));
+        _enable_pruning = config::enable_segment_pruning_by_rowset_meta;
+
+        create_tablet();
+        create_rowset();
+        st = _tablet->add_rowset(_rowset);
+        ASSERT_TRUE(st.ok()) << st;
+    }
+
+    void TearDown() override {
+        config::enable_segment_pruning_by_rowset_meta = _enable_pruning;
+        SegmentLoader::instance()->erase_segments(_rowset->rowset_id(), NUM_SEGMENTS);
+        _rowset.reset();
+        _tablet.reset();
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(_absolute_dir).ok());
+        _engine = nullptr;
+        ExecEnv::GetInstance()->set_storage_engine(nullptr);
+    }
+
+protected:
+    void create_tablet() {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(DUP_KEYS);
+        tablet_schema_pb.set_num_short_key_columns(1);
+        tablet_schema_pb.set_num_rows_per_row_block(1024);
+        tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+        tablet_schema_pb.set_next_column_unique_id(3);
+        std::vector<TColumn> cols;
+        std::unordered_map<uint32_t, uint32_t> col_ordinal_to_unique_id;
+        for (int i = 0; i < 2; ++i) {
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(i + 1);
+            column->set_name(i == 0 ? "k" : "v");
+            column->set_type("INT");
+            column->set_is_key(i == 0);
+            column->set_length(4);
+            column->set_index_length(4);
+            column->set_is_nullable(false);
+            if (i > 0) {
+                column->set_aggregation("NONE");
+            }
+            TColumn col;
+            col.column_type.type = TPrimitiveType::INT;
+            col.__set_column_name(column->name());
+            col.__set_is_key(column->is_key());
+            cols.push_back(col);
+            col_ordinal_to_unique_id[i] = i + 1;
+        }
+        _schema = std::make_shared<TabletSchema>();
+        _schema->init_from_pb(tablet_schema_pb);
+
+        TTabletSchema t_tablet_schema;
+        t_tablet_schema.__set_short_key_column_count(1);
+        t_tablet_schema.__set_schema_hash(3333);
+        t_tablet_schema.__set_keys_type(TKeysType::DUP_KEYS);
+        t_tablet_schema.__set_storage_type(TStorageType::COLUMN);
+        t_tablet_schema.__set_columns(cols);
+        TabletMetaSharedPtr tablet_meta(new TabletMeta(
+                1, 1, 1, 1, 3333, 1, t_tablet_schema, 3, col_ordinal_to_unique_id, UniqueId(1, 2),
+                TTabletType::TABLET_TYPE_DISK, TCompressionType::LZ4F, 0, false));
+        _tablet.reset(new Tablet(*_engine, tablet_meta, nullptr));
+        ASSERT_TRUE(_tablet->init().ok());
+    }
+
+    void create_rowset() {
+        RowsetWriterContext writer_context;
+        RowsetId rowset_id;
+        rowset_id.init(30001);
+        writer_context.rowset_id = rowset_id;
+        writer_context.rowset_type = BETA_ROWSET;
+        writer_context.rowset_state = VISIBLE;
+        writer_context.tablet_schema = _schema;
+        writer_context.rowset_dir = _absolute_dir;
+        writer_context.version = {0, 1};
+        writer_context.segments_overlap = NONOVERLAPPING;
+        writer_context.max_rows_per_segment = UINT32_MAX;
+        auto res = RowsetFactory::create_rowset_writer(*_engine, writer_context, false);
+        ASSERT_TRUE(res.has_value()) << res.error();
+        auto rowset_writer = std::move(res).value();
+        for (int segment = 0; segment < NUM_SEGMENTS; ++segment) {
+            vectorized::Block block = _schema->create_block();
+            auto columns = block.mutate_columns();
+            for (int32_t key = segment * ROWS_PER_SEGMENT; key < (segment + 1) * ROWS_PER_SEGMENT;
+                 ++key) {
+                columns[0]->insert_data((const char*)&key, sizeof(key));
+                columns[1]->insert_data((const char*)&key, sizeof(key));
+            }
+            ASSERT_TRUE(rowset_writer->add_block(&block).ok());
+            ASSERT_TRUE(rowset_writer->flush().ok());
+        }
+        auto st = rowset_writer->build(_rowset);
+        ASSERT_TRUE(st.ok()) << st;
+        ASSERT_EQ(NUM_SEGMENTS, _rowset->num_segments());
+    }
+
+    // Loads the tablet like ParallelScannerBuilder::build_scanners() for the key ranges, and
+    // returns the ids of the loaded segments.
+    std::vector<uint32_t> load(const std::vector<OlapScanRange*>& key_ranges, size_t* total_rows) {
+        ParallelScannerBuilder<vectorized::NewOlapScanNode> builder(
+                nullptr, {{_tablet, 1}}, std::make_shared<RuntimeProfile>("test"), key_ranges,
+                nullptr, -1, true, false);
+        auto st = builder._load();
+        EXPECT_TRUE(st.ok()) << st;
+        *total_rows = builder._total_rows;
+        std::vector<uint32_t> segment_ids;
+        for (const auto& segment :
+             builder._segment_cache_handles[_rowset->rowset_id()].get_segments()) {
+            segment_ids.push_back(segment->id());
+        }
+        return segment_ids;
+    }
+
+    bool in_segment_cache(uint32_t segment_id) {
+        SegmentCacheHandle handle;
+        return SegmentLoader::instance()->_segment_cache->lookup(
+                SegmentCache::CacheKey(_rowset->rowset_id(), segment_id), &handle);
+    }
+
+    std::string _absolute_dir;
+    StorageEngine* _engine = nullptr;
+    bool _enable_pruning = false;
+    TabletSchemaSPtr _schema;
+    TabletSharedPtr _tablet;
+    RowsetSharedPtr _rowset;
+};
+
+TEST_F(ParallelScannerBuilderTest, PrunedSegmentsAreNotLoaded) {
+    config::enable_segment_pruning_by_rowset_meta = true;
+    // k in [120, 150] or k = 250
+    std::vector<std::string> begin = {"120"};
+    std::vector<std::string> end = {"150"};
+    OlapScanRange range(true, true, begin, end);
+    std::vector<std::string> point = {"250"};
+    OlapScanRange point_range(true, true, point, point);
+
+    size_t total_rows = 0;
+    EXPECT_EQ(std::vector<uint32_t> {1}, load({&range}, &total_rows));
+    EXPECT_EQ(size_t(ROWS_PER_SEGMENT), total_rows);
+    EXPECT_FALSE(in_segment_cache(0));
+    EXPECT_TRUE(in_segment_cache(1));
+    EXPECT_FALSE(in_segment_cache(2));
+
+    EXPECT_EQ((std::vector<uint32_t> {1, 2}), load({&range, &point_range}, &total_rows));
+    EXPECT_EQ(size_t(2 * ROWS_PER_SEGMENT), total_rows);
+    EXPECT_FALSE(in_segment_cache(0));
+    EXPECT_TRUE(in_segment_cache(2));
+}
+
+TEST_F(ParallelScannerBuilderTest, AllSegmentsLoadedWithoutPruning) {
+    // the whole tablet is read
+    config::enable_segment_pruning_by_rowset_meta = true;
+    OlapScanRange full_range;
+    size_t total_rows = 0;
+    EXPECT_EQ((std::vector<uint32_t> {0, 1, 2}), load({&full_range}, &total_rows));
+    EXPECT_EQ(size_t(NUM_SEGMENTS * ROWS_PER_SEGMENT), total_rows);
+
+    // pruning is turned off
+    SegmentLoader::instance()->erase_segments(_rowset->rowset_id(), NUM_SEGMENTS);
+    config::enable_segment_pruning_by_rowset_meta = false;
+    std::vector<std::string> begin = {"120"};
+    std::vector<std::string> end = {"150"};
+    OlapScanRange range(true, true, begin, end);
+    EXPECT_EQ((std::vector<uint32_t> {0, 1, 2}), load({&range}, &total_rows));
+    EXPECT_EQ(size_t(NUM_SEGMENTS * ROWS_PER_SEGMENT), total_rows);
+    for (uint32_t segment_id = 0; segment_id < NUM_SEGMENTS; ++segment_id) {
+        EXPECT_TRUE(in_segment_cache(segment_id));
+    }
+}
+
+} // namespace doris
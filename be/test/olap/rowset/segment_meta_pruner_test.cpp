@@ -0,0 +1,196 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_meta_pruner.h"
+
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "olap/block_column_predicate.h"
+#include "olap/comparison_predicate.h"
+#include "olap/row_cursor.h"
+#include "olap/tablet_schema.h"
+#include "util/key_util.h"
+
+namespace doris {
+
+class SegmentMetaPrunerTest : public testing::Test {
+public:
+    void SetUp() override {
+        TabletSchemaPB schema_pb;
+        schema_pb.set_keys_type(DUP_KEYS);
+        add_column(&schema_pb, 1, "k1", "INT", 4, true);
+        add_column(&schema_pb, 2, "k2", "VARCHAR", 20, true);
+        add_column(&schema_pb, 3, "k3", "INT", 4, true);
+        add_column(&schema_pb, 4, "v1", "INT", 4, false);
+        _tablet_schema = std::make_shared<TabletSchema>();
+        _tablet_schema->init_from_pb(schema_pb);
+    }
+
+    static void add_column(TabletSchemaPB* schema_pb, int32_t unique_id, const std::string& name,
+                           const std::string& type, int32_t length, bool is_key) {
+        ColumnPB* column = schema_pb->add_column();
+        column->set_unique_id(unique_id);
+        column->set_name(name);
+        column->set_type(type);
+        column->set_length(length);
+        column->set_index_length(length);
+        column->set_is_key(is_key);
+        column->set_is_nullable(false);
+        if (!is_key) {
+            column->set_aggregation("NONE");
+        }
+    }
+
+    std::unique_ptr<RowCursor> make_key(const std::vector<std::string>& values) {
+        auto key = std::make_unique<RowCursor>();
+        EXPECT_TRUE(key->init_scan_key(_tablet_schema, values).ok());
+        EXPECT_TRUE(key->from_tuple(OlapTuple(values)).ok());
+        return key;
+    }
+
+    // the key of a row, encoded as the segment writer does
+    std::string encode_row(const std::vector<std::string>& values) {
+        std::string buf;
+        encode_key<RowCursor, true>(&buf, *make_key(values), values.size());
+        return buf;
+    }
+
+    // compare the first `n` columns of two keys
+    static int compare_prefix(const std::vector<std::string>& row,
+                              const std::vector<std::string>& key) {
+        for (size_t i = 0; i < key.size(); ++i) {
+            int cmp = i == 1 ? row[i].compare(key[i]) : std::stoi(row[i]) - std::stoi(key[i]);
+            if (cmp != 0) {
+                return cmp;
+            }
+        }
+        return 0;
+    }
+
+protected:
+    TabletSchemaSPtr _tablet_schema;
+};
+
+TEST_F(SegmentMetaPrunerTest, EncodeKeyBound) {
+    // strings with bytes smaller than the markers of the next column
+    std::vector<std::string> strings = {"", "a", std::string("a\x01", 2), std::string("a\x01z", 3),
+                                        "a\x02", "ab", "b"};
+    std::vector<std::vector<std::string>> rows;
+    for (const char* k1 : {"-1", "1", "2"}) {
+        for (const auto& k2 : strings) {
+            for (const char* k3 : {"1", "5"}) {
+                rows.push_back({k1, k2, k3});
+            }
+        }
+    }
+    for (const auto& bound_row : rows) {
+        for (size_t num_columns = 1; num_columns <= 3; ++num_columns) {
+            std::vector<std::string> key(bound_row.begin(), bound_row.begin() + num_columns);
+            auto cursor = make_key(key);
+            std::string lower = SegmentMetaPruner::encode_key_bound(*cursor, 3, false);
+            std::string upper = SegmentMetaPruner::encode_key_bound(*cursor, 3, true);
+            for (const auto& row : rows) {
+                std::string encoded_row = encode_row(row);
+                int cmp = compare_prefix(row, key);
+                if (cmp >= 0) {
+                    EXPECT_LE(lower, encoded_row);
+                }
+                if (cmp <= 0) {
+                    EXPECT_GE(upper, encoded_row);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(SegmentMetaPrunerTest, MayMatch) {
+    auto rowset_meta = std::make_shared<RowsetMeta>();
+    rowset_meta->set_num_segments(3);
+    // segment i has k1 in [10 * i, 10 * i + 9] and v1 in [100 * i, 100 * i + 99]
+    std::vector<KeyBoundsPB> key_bounds;
+    std::vector<SegmentZoneMapsPB> zone_maps;
+    for (int i = 0; i < 3; ++i) {
+        KeyBoundsPB& bounds = key_bounds.emplace_back();
+        bounds.set_min_key(encode_row({std::to_string(10 * i), "a", "1"}));
+        bounds.set_max_key(encode_row({std::to_string(10 * i + 9), "z", "1"}));
+        ColumnZoneMapPB* column = zone_maps.emplace_back().add_columns();
+        column->set_unique_id(4);
+        column->set_type(int32_t(FieldType::OLAP_FIELD_TYPE_INT));
+        column->set_length(4);
+        column->mutable_zone_map()->set_min(std::to_string(100 * i));
+        column->mutable_zone_map()->set_max(std::to_string(100 * i + 99));
+        column->mutable_zone_map()->set_has_not_null(true);
+        column->mutable_zone_map()->set_has_null(false);
+    }
+    rowset_meta->set_segments_key_bounds(key_bounds);
+
+    StorageReadOptions read_options;
+    read_options.tablet_schema = _tablet_schema;
+    {
+        // nothing is pruned without any condition
+        SegmentMetaPruner pruner(rowset_meta, read_options);
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_TRUE(pruner.may_match(i));
+        }
+    }
+
+    // k1 in [12, 15]
+    auto lower = make_key({"12"});
+    auto upper = make_key({"15"});
+    read_options.key_ranges.emplace_back(lower.get(), true, upper.get(), true);
+    {
+        SegmentMetaPruner pruner(rowset_meta, read_options);
+        EXPECT_FALSE(pruner.may_match(0));
+        EXPECT_TRUE(pruner.may_match(1));
+        EXPECT_FALSE(pruner.may_match(2));
+    }
+    // or k1 = 29
+    auto point = make_key({"29"});
+    read_options.key_ranges.emplace_back(point.get(), true, point.get(), true);
+    {
+        SegmentMetaPruner pruner(rowset_meta, read_options);
+        EXPECT_FALSE(pruner.may_match(0));
+        EXPECT_TRUE(pruner.may_match(1));
+        EXPECT_TRUE(pruner.may_match(2));
+    }
+
+    // v1 > 250, the zone maps are not used before they are in the meta
+    std::unique_ptr<ColumnPredicate> pred(
+            new ComparisonPredicateBase<TYPE_INT, PredicateType::GT>(3, 250));
+    read_options.col_id_to_predicates.emplace(3, std::make_shared<AndBlockColumnPredicate>());
+    read_options.col_id_to_predicates[3]->add_column_predicate(
+            new SingleColumnBlockPredicate(pred.get()));
+    {
+        SegmentMetaPruner pruner(rowset_meta, read_options);
+        EXPECT_TRUE(pruner.may_match(1));
+        EXPECT_TRUE(pruner.may_match(2));
+    }
+    rowset_meta->set_segments_zone_maps(zone_maps);
+    {
+        SegmentMetaPruner pruner(rowset_meta, read_options);
+        EXPECT_FALSE(pruner.may_match(0));
+        EXPECT_FALSE(pruner.may_match(1));
+        EXPECT_TRUE(pruner.may_match(2));
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,310 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/bitpacked_page.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "olap/comparison_predicate.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "util/bp128_coding.h"
+#include "vec/common/assert_cast.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class BitPackedPageTest : public testing::Test {
+public:
+    template <FieldType Type>
+    OwnedSlice build(const std::vector<typename TypeTraits<Type>::CppType>& src) {
+        PageBuilderOptions options;
+        options.data_page_size = 1024 * 1024;
+        BitPackedPageBuilder<Type> builder(options);
+        size_t n = src.size();
+        EXPECT_TRUE(builder.add(reinterpret_cast<const uint8_t*>(src.data()), &n).ok());
+        EXPECT_EQ(src.size(), n);
+        OwnedSlice page = builder.finish();
+        if (!src.empty()) {
+            typename TypeTraits<Type>::CppType value;
+            EXPECT_TRUE(builder.get_first_value(&value).ok());
+            EXPECT_EQ(src.front(), value);
+            EXPECT_TRUE(builder.get_last_value(&value).ok());
+            EXPECT_EQ(src.back(), value);
+        }
+        return page;
+    }
+
+    template <FieldType Type>
+    void test_encode_decode(const std::vector<typename TypeTraits<Type>::CppType>& src) {
+        using CppType = typename TypeTraits<Type>::CppType;
+        OwnedSlice page = build<Type>(src);
+        BitPackedPageDecoder<Type> decoder(page.slice(), PageDecoderOptions());
+        ASSERT_TRUE(decoder.init().ok());
+        ASSERT_EQ(src.size(), decoder.count());
+
+        // whole blocks are decoded into the column vector directly
+        vectorized::MutableColumnPtr column = vectorized::ColumnVector<CppType>::create();
+        size_t n = src.size() + 10;
+        ASSERT_TRUE(decoder.next_batch(&n, column).ok());
+        ASSERT_EQ(src.size(), n);
+        const auto& data = assert_cast<vectorized::ColumnVector<CppType>&>(*column).get_data();
+        for (size_t i = 0; i < src.size(); ++i) {
+            ASSERT_EQ(src[i], data[i]) << "index " << i;
+        }
+
+        // small batches into a nullable column go through the decoded block
+        std::mt19937 rng(1);
+        ASSERT_TRUE(decoder.seek_to_position_in_page(0).ok());
+        vectorized::MutableColumnPtr nullable = vectorized::ColumnNullable::create(
+                vectorized::ColumnVector<CppType>::create(), vectorized::ColumnUInt8::create());
+        while (decoder.has_remaining()) {
+            size_t batch = rng() % 300 + 1;
+            ASSERT_TRUE(decoder.next_batch(&batch, nullable).ok());
+        }
+        ASSERT_EQ(src.size(), nullable->size());
+        const auto& nested =
+                assert_cast<vectorized::ColumnNullable&>(*nullable).get_nested_column();
+        for (size_t i = 0; i < src.size(); ++i) {
+            ASSERT_EQ(src[i], nested.get_int(i)) << "index " << i;
+        }
+
+        std::vector<rowid_t> rowids;
+        for (size_t i = 0; i < src.size(); i += rng() % 200 + 1) {
+            rowids.push_back(i + 1000);
+        }
+        vectorized::MutableColumnPtr by_rowids = vectorized::ColumnVector<CppType>::create();
+        n = rowids.size();
+        ASSERT_TRUE(decoder.read_by_rowids(rowids.data(), 1000, &n, by_rowids).ok());
+        ASSERT_EQ(rowids.size(), n);
+        for (size_t i = 0; i < rowids.size(); ++i) {
+            ASSERT_EQ(src[rowids[i] - 1000], by_rowids->get_int(i));
+        }
+    }
+
+    template <FieldType Type, PredicateType PT, typename Op>
+    void check_predicate(BitPackedPageDecoder<Type>* decoder,
+                         const std::vector<typename TypeTraits<Type>::CppType>& src,
+                         typename TypeTraits<Type>::CppType value, size_t start, Op op) {
+        ASSERT_TRUE(decoder->seek_to_position_in_page(start).ok());
+        size_t n = src.size();
+        std::vector<uint8_t> flags(src.size());
+        ASSERT_TRUE(decoder->template evaluate<PT>(value, &n, flags.data()).ok());
+        ASSERT_EQ(src.size() - start, n);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(op(src[start + i], value), flags[i]) << "index " << start + i;
+        }
+    }
+
+    // the same as check_predicate, through the PageDecoder interface and a ColumnPredicate
+    template <PredicateType PT, typename Op>
+    void check_column_predicate(PageDecoder* decoder, const std::vector<int32_t>& src,
+                                int32_t value, size_t start, Op op) {
+        ComparisonPredicateBase<TYPE_INT, PT> predicate(0, value);
+        ASSERT_TRUE(decoder->seek_to_position_in_page(start).ok());
+        size_t n = src.size();
+        std::vector<uint8_t> flags(src.size());
+        auto st = decoder->evaluate(predicate, &n, flags.data());
+        ASSERT_TRUE(st.ok()) << st;
+        ASSERT_EQ(src.size() - start, n);
+        ASSERT_EQ(src.size(), decoder->current_index());
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(op(src[start + i], value), flags[i]) << "index " << start + i;
+        }
+    }
+
+    template <FieldType Type>
+    void test_predicates(const std::vector<typename TypeTraits<Type>::CppType>& src) {
+        using CppType = typename TypeTraits<Type>::CppType;
+        OwnedSlice page = build<Type>(src);
+        BitPackedPageDecoder<Type> decoder(page.slice(), PageDecoderOptions());
+        ASSERT_TRUE(decoder.init().ok());
+
+        std::mt19937 rng(2);
+        std::vector<CppType> values = {std::numeric_limits<CppType>::min(),
+                                       std::numeric_limits<CppType>::max()};
+        for (int i = 0; i < 10; ++i) {
+            CppType value = src[rng() % src.size()];
+            values.push_back(value);
+            values.push_back(value + 1);
+        }
+        for (CppType value : values) {
+            size_t start = rng() % src.size();
+            check_predicate<Type, PredicateType::EQ>(&decoder, src, value, start, std::equal_to());
+            check_predicate<Type, PredicateType::NE>(&decoder, src, value, start,
+                                                     std::not_equal_to());
+            check_predicate<Type, PredicateType::LT>(&decoder, src, value, start, std::less());
+            check_predicate<Type, PredicateType::LE>(&decoder, src, value, start,
+                                                     std::less_equal());
+            check_predicate<Type, PredicateType::GT>(&decoder, src, value, start, std::greater());
+            check_predicate<Type, PredicateType::GE>(&decoder, src, value, start,
+                                                     std::greater_equal());
+        }
+    }
+};
+
+TEST_F(BitPackedPageTest, BP128) {
+    std::mt19937_64 rng(1);
+    for (int bit_width = 0; bit_width <= 32; ++bit_width) {
+        uint32_t in[128];
+        uint32_t packed[128];
+        uint32_t out[128];
+        for (auto& v : in) {
+            v = bit_width == 32 ? uint32_t(rng()) : uint32_t(rng()) & ((1U << bit_width) - 1);
+        }
+        BP128<uint32_t>::pack(bit_width, in, packed);
+        BP128<uint32_t>::unpack(bit_width, packed, out);
+        for (int i = 0; i < 128; ++i) {
+            ASSERT_EQ(in[i], out[i]) << "bit width " << bit_width;
+        }
+    }
+    for (int bit_width = 0; bit_width <= 64; ++bit_width) {
+        uint64_t in[128];
+        uint64_t packed[128];
+        uint64_t out[128];
+        for (auto& v : in) {
+            v = bit_width == 64 ? rng() : rng() & ((uint64_t(1) << bit_width) - 1);
+        }
+        BP128<uint64_t>::pack(bit_width, in, packed);
+        BP128<uint64_t>::unpack(bit_width, packed, out);
+        for (int i = 0; i < 128; ++i) {
+            ASSERT_EQ(in[i], out[i]) << "bit width " << bit_width;
+        }
+    }
+}
+
+TEST_F(BitPackedPageTest, SortedTimestamps) {
+    std::mt19937_64 rng(1);
+    std::vector<int64_t> src;
+    int64_t ts = 1700000000000000L;
+    for (int i = 0; i < 10000; ++i) {
+        ts += rng() % 1000;
+        src.push_back(ts);
+    }
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_BIGINT>(src);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_BIGINT>(src);
+    // deltas of less than 10 bits instead of 64 bit values
+    OwnedSlice page = build<FieldType::OLAP_FIELD_TYPE_BIGINT>(src);
+    EXPECT_EQ(BITPACKED_DELTA, page.slice().data[4]);
+    EXPECT_LT(page.slice().size, src.size() * 2);
+}
+
+TEST_F(BitPackedPageTest, AutoIncrement) {
+    std::vector<int32_t> src;
+    for (int i = 0; i < 5000; ++i) {
+        src.push_back(i + 100000);
+    }
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    OwnedSlice page = build<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    EXPECT_LT(page.slice().size, 1024);
+}
+
+TEST_F(BitPackedPageTest, Exceptions) {
+    std::mt19937_64 rng(1);
+    std::vector<int32_t> src;
+    for (int i = 0; i < 5001; ++i) {
+        src.push_back(int32_t(rng() % 100) - 50 + (i % 97 == 0 ? 1000000000 : 0));
+    }
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    // outliers are patched instead of widening the blocks to 30 bits
+    OwnedSlice page = build<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    EXPECT_EQ(BITPACKED_FOR, page.slice().data[4]);
+    EXPECT_LT(page.slice().size, src.size() * 2);
+}
+
+TEST_F(BitPackedPageTest, RandomValues) {
+    std::mt19937_64 rng(1);
+    std::vector<int8_t> tinyints;
+    std::vector<int16_t> smallints;
+    std::vector<int64_t> bigints;
+    std::vector<uint32_t> datev2s;
+    for (int i = 0; i < 3001; ++i) {
+        tinyints.push_back(int8_t(rng()));
+        smallints.push_back(int16_t(5000 - i * 7));
+        bigints.push_back(int64_t(rng()));
+        datev2s.push_back(std::numeric_limits<uint32_t>::max() - rng() % 16);
+    }
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_TINYINT>(tinyints);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_TINYINT>(tinyints);
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_SMALLINT>(smallints);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_SMALLINT>(smallints);
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_BIGINT>(bigints);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_BIGINT>(bigints);
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_DATEV2>(datev2s);
+    test_predicates<FieldType::OLAP_FIELD_TYPE_DATEV2>(datev2s);
+}
+
+TEST_F(BitPackedPageTest, ColumnPredicate) {
+    std::mt19937_64 rng(3);
+    std::vector<int32_t> src;
+    for (int i = 0; i < 3001; ++i) {
+        src.push_back(int32_t(rng() % 1000) - 500 + (i % 101 == 0 ? 100000 : 0));
+    }
+    OwnedSlice page = build<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    BitPackedPageDecoder<FieldType::OLAP_FIELD_TYPE_INT> bitpacked(page.slice(),
+                                                                   PageDecoderOptions());
+    ASSERT_TRUE(bitpacked.init().ok());
+    PageDecoder* decoder = &bitpacked;
+    for (int32_t value : {std::numeric_limits<int32_t>::min(), -501, -500, 0, 17, 499, 100000,
+                          std::numeric_limits<int32_t>::max()}) {
+        size_t start = rng() % src.size();
+        check_column_predicate<PredicateType::EQ>(decoder, src, value, start, std::equal_to());
+        check_column_predicate<PredicateType::NE>(decoder, src, value, start,
+                                                  std::not_equal_to());
+        check_column_predicate<PredicateType::LT>(decoder, src, value, start, std::less());
+        check_column_predicate<PredicateType::LE>(decoder, src, value, start, std::less_equal());
+        check_column_predicate<PredicateType::GT>(decoder, src, value, start, std::greater());
+        check_column_predicate<PredicateType::GE>(decoder, src, value, start,
+                                                  std::greater_equal());
+    }
+
+    // predicates which can not be evaluated on the page leave the decoder where it is
+    ASSERT_TRUE(decoder->seek_to_position_in_page(10).ok());
+    std::vector<uint8_t> flags(src.size());
+    size_t n = src.size();
+    ComparisonPredicateBase<TYPE_INT, PredicateType::EQ> opposite(0, 17, true);
+    EXPECT_TRUE(
+            decoder->evaluate(opposite, &n, flags.data()).is<ErrorCode::NOT_IMPLEMENTED_ERROR>());
+    ComparisonPredicateBase<TYPE_BIGINT, PredicateType::EQ> other_type(0, 17);
+    EXPECT_TRUE(
+            decoder->evaluate(other_type, &n, flags.data()).is<ErrorCode::NOT_IMPLEMENTED_ERROR>());
+    EXPECT_EQ(10, decoder->current_index());
+}
+
+TEST_F(BitPackedPageTest, EmptyAndSingle) {
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_INT>({});
+    test_encode_decode<FieldType::OLAP_FIELD_TYPE_INT>({42});
+    test_predicates<FieldType::OLAP_FIELD_TYPE_INT>({42});
+}
+
+TEST_F(BitPackedPageTest, Corruption) {
+    std::vector<int32_t> src(1000, 7);
+    OwnedSlice page = build<FieldType::OLAP_FIELD_TYPE_INT>(src);
+    Slice truncated(page.slice().data, 10);
+    BitPackedPageDecoder<FieldType::OLAP_FIELD_TYPE_INT> decoder(truncated, PageDecoderOptions());
+    EXPECT_FALSE(decoder.init().ok());
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -23,6 +23,7 @@
 #include "io/fs/file_writer.h"
 #include "io/fs/local_file_system.h"
 #include "olap/column_block.h"
+#include "olap/comparison_predicate.h"
 #include "olap/decimal12.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/column_reader.h"
@@ -30,6 +31,8 @@
 #include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
 #include "testutil/test_util.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
 #include "vec/core/types.h"
 #include "vec/data_types/data_type_date.h"
 #include "vec/data_types/data_type_date_time.h"
@@ -671,6 +674,99 @@ TEST_F(ColumnReaderWriterTest, test_nullable) {
     delete[] double_vals;
 }
 
+// Evaluate `v >= 0` and `v = 17` with ColumnIterator::evaluate_predicate on a nullable INT
+// column, pages with null values are evaluated on decoded values.
+template <EncodingTypePB encoding>
+void test_evaluate_predicate(std::string test_name) {
+    const int num_rows = 100000;
+    std::vector<int32_t> src(num_rows);
+    std::vector<uint8_t> is_null(num_rows);
+    for (int i = 0; i < num_rows; ++i) {
+        src[i] = i % 1000 - 500 + (i % 997 == 0 ? 1000000 : 0);
+        // the pages of the first half have no null values
+        is_null[i] = i >= num_rows / 2 && i % 13 == 0;
+    }
+
+    ColumnMetaPB meta;
+    std::string fname = TEST_DIR + "/" + test_name;
+    auto fs = io::global_local_filesystem();
+    {
+        io::FileWriterPtr file_writer;
+        Status st = fs->create_file(fname, &file_writer);
+        ASSERT_TRUE(st.ok()) << st;
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.meta = &meta;
+        writer_opts.meta->set_column_id(0);
+        writer_opts.meta->set_unique_id(0);
+        writer_opts.meta->set_type(FieldType::OLAP_FIELD_TYPE_INT);
+        writer_opts.meta->set_length(0);
+        writer_opts.meta->set_encoding(encoding);
+        writer_opts.meta->set_compression(segment_v2::CompressionTypePB::LZ4F);
+        writer_opts.meta->set_is_nullable(true);
+        writer_opts.data_page_size = 16 * 1024;
+
+        TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, FieldType::OLAP_FIELD_TYPE_INT);
+        std::unique_ptr<ColumnWriter> writer;
+        ASSERT_TRUE(ColumnWriter::create(writer_opts, &column, file_writer.get(), &writer).ok());
+        ASSERT_TRUE(writer->init().ok());
+        for (int i = 0; i < num_rows; ++i) {
+            ASSERT_TRUE(writer->append(is_null[i], &src[i]).ok());
+        }
+        ASSERT_TRUE(writer->finish().ok());
+        ASSERT_TRUE(writer->write_data().ok());
+        ASSERT_TRUE(writer->write_ordinal_index().ok());
+        ASSERT_TRUE(file_writer->close().ok());
+    }
+
+    io::FileReaderSPtr file_reader;
+    ASSERT_EQ(fs->open_file(fname, &file_reader), Status::OK());
+    ColumnReaderOptions reader_opts;
+    std::unique_ptr<ColumnReader> reader;
+    ASSERT_TRUE(ColumnReader::create(reader_opts, meta, num_rows, file_reader, &reader).ok());
+    ColumnIterator* iter = nullptr;
+    ASSERT_TRUE(reader->new_iterator(&iter).ok());
+    std::unique_ptr<ColumnIterator> iter_holder(iter);
+    ColumnIteratorOptions iter_opts;
+    OlapReaderStatistics stats;
+    iter_opts.stats = &stats;
+    iter_opts.file_reader = file_reader.get();
+    ASSERT_TRUE(iter->init(iter_opts).ok());
+    EXPECT_EQ(encoding == BITPACK_ENCODING, iter->support_page_evaluation());
+
+    ComparisonPredicateBase<TYPE_INT, PredicateType::GE> ge(0, 0);
+    ComparisonPredicateBase<TYPE_INT, PredicateType::EQ> eq(0, 17);
+    vectorized::MutableColumnPtr buffer = vectorized::ColumnNullable::create(
+            vectorized::ColumnInt32::create(), vectorized::ColumnUInt8::create());
+    std::vector<const ColumnPredicate*> predicates = {&ge, &eq};
+    for (const auto* predicate : predicates) {
+        // batches cross page boundaries, and the last one reads past the end
+        for (int start : {0, 12345, num_rows - 4000}) {
+            ASSERT_TRUE(iter->seek_to_ordinal(start).ok());
+            int row = start;
+            while (row < num_rows) {
+                size_t n = 4064;
+                std::unique_ptr<bool[]> flags(new bool[n]);
+                auto st = iter->evaluate_predicate(*predicate, &n, flags.get(), buffer);
+                ASSERT_TRUE(st.ok()) << st;
+                ASSERT_EQ(std::min<size_t>(4064, num_rows - row), n);
+                for (size_t i = 0; i < n; ++i, ++row) {
+                    bool expected = !is_null[row] && (predicate == predicates[0] ? src[row] >= 0
+                                                                                 : src[row] == 17);
+                    ASSERT_EQ(expected, flags[i]) << "row " << row;
+                }
+                ASSERT_EQ(row, iter->get_current_ordinal());
+            }
+        }
+    }
+}
+
+TEST_F(ColumnReaderWriterTest, test_evaluate_predicate) {
+    test_evaluate_predicate<BITPACK_ENCODING>("evaluate_predicate_bitpack");
+    // pages of other encodings are decoded and evaluated as usual
+    test_evaluate_predicate<BIT_SHUFFLE>("evaluate_predicate_bs");
+}
+
 TEST_F(ColumnReaderWriterTest, test_types) {
     size_t num_uint8_rows = LOOP_LESS_OR_MORE(1024, 1024 * 1024);
     uint8_t* is_null = new uint8_t[num_uint8_rows];
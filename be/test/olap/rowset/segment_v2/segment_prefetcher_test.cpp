@@ -0,0 +1,141 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_prefetcher.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <vector>
+
+#include "gtest/gtest_pred_impl.h"
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "io/io_common.h"
+#include "olap/olap_common.h"
+#include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/page_io.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class SegmentPrefetcherTest : public testing::Test {};
+
+static std::vector<SegmentPrefetcher::PrefetchPage> make_pages(
+        const std::vector<std::pair<uint64_t, uint32_t>>& pointers) {
+    std::vector<SegmentPrefetcher::PrefetchPage> pages;
+    for (auto [offset, size] : pointers) {
+        pages.push_back({.page_pointer = PagePointer(offset, size)});
+    }
+    return pages;
+}
+
+TEST_F(SegmentPrefetcherTest, CoalesceAdjacent) {
+    auto pages = make_pages({{0, 100}, {100, 50}, {150, 200}});
+    auto reads = SegmentPrefetcher::coalesce(pages, 0, 1024);
+    ASSERT_EQ(1, reads.size());
+    EXPECT_EQ(0, reads[0].offset);
+    EXPECT_EQ(350, reads[0].size);
+    EXPECT_EQ(0, reads[0].first_page);
+    EXPECT_EQ(3, reads[0].last_page);
+}
+
+TEST_F(SegmentPrefetcherTest, CoalesceWithGap) {
+    // gap between the 1st and 2nd page is 20, between the 2nd and 3rd is 200
+    auto pages = make_pages({{0, 100}, {120, 100}, {420, 100}});
+    auto reads = SegmentPrefetcher::coalesce(pages, 50, 1024);
+    ASSERT_EQ(2, reads.size());
+    EXPECT_EQ(0, reads[0].offset);
+    EXPECT_EQ(220, reads[0].size);
+    EXPECT_EQ(0, reads[0].first_page);
+    EXPECT_EQ(2, reads[0].last_page);
+    EXPECT_EQ(420, reads[1].offset);
+    EXPECT_EQ(100, reads[1].size);
+    EXPECT_EQ(2, reads[1].first_page);
+    EXPECT_EQ(3, reads[1].last_page);
+
+    reads = SegmentPrefetcher::coalesce(pages, 200, 1024);
+    ASSERT_EQ(1, reads.size());
+    EXPECT_EQ(520, reads[0].size);
+}
+
+TEST_F(SegmentPrefetcherTest, CoalesceMaxReadSize) {
+    auto pages = make_pages({{0, 100}, {100, 100}, {200, 100}, {300, 100}});
+    auto reads = SegmentPrefetcher::coalesce(pages, 0, 250);
+    ASSERT_EQ(2, reads.size());
+    EXPECT_EQ(0, reads[0].offset);
+    EXPECT_EQ(200, reads[0].size);
+    EXPECT_EQ(200, reads[1].offset);
+    EXPECT_EQ(200, reads[1].size);
+
+    // a page larger than the max read size is read alone
+    pages = make_pages({{0, 1000}, {1000, 10}});
+    reads = SegmentPrefetcher::coalesce(pages, 0, 250);
+    ASSERT_EQ(2, reads.size());
+    EXPECT_EQ(1000, reads[0].size);
+    EXPECT_EQ(10, reads[1].size);
+}
+
+TEST_F(SegmentPrefetcherTest, UncachedPages) {
+    const std::string dir = "./ut_dir/segment_prefetcher_test";
+    auto fs = io::global_local_filesystem();
+    ASSERT_TRUE(fs->delete_directory(dir).ok());
+    ASSERT_TRUE(fs->create_directory(dir).ok());
+    const std::string fname = dir + "/pages";
+    {
+        io::FileWriterPtr file_writer;
+        ASSERT_TRUE(fs->create_file(fname, &file_writer).ok());
+        std::string data(4096, 'x');
+        ASSERT_TRUE(file_writer->append(data).ok());
+        ASSERT_TRUE(file_writer->close().ok());
+    }
+    io::FileReaderSPtr file_reader;
+    ASSERT_TRUE(fs->open_file(fname, &file_reader).ok());
+
+    OlapReaderStatistics stats;
+    io::IOContext io_ctx;
+    PageReadOptions opts {.use_page_cache = true,
+                          .type = DATA_PAGE,
+                          .file_reader = file_reader.get(),
+                          .page_pointer = PagePointer(1024, 1024),
+                          .stats = &stats,
+                          .io_ctx = io_ctx};
+    auto* cache = StoragePageCache::instance();
+    ASSERT_NE(nullptr, cache);
+    EXPECT_FALSE(PageIO::is_page_cached(opts));
+
+    StoragePageCache::CacheKey key(fname, file_reader->size(), 1024);
+    {
+        PageCacheHandle handle;
+        cache->insert(key, new DataPage(1024), &handle, DATA_PAGE);
+    }
+    EXPECT_TRUE(PageIO::is_page_cached(opts));
+    // only the page at the offset is cached, and only in the cache of its type
+    opts.page_pointer = PagePointer(0, 1024);
+    EXPECT_FALSE(PageIO::is_page_cached(opts));
+    opts.page_pointer = PagePointer(1024, 1024);
+    opts.type = INDEX_PAGE;
+    EXPECT_FALSE(PageIO::is_page_cached(opts));
+    // the page cache is not used for the read
+    opts.type = DATA_PAGE;
+    opts.use_page_cache = false;
+    EXPECT_FALSE(PageIO::is_page_cached(opts));
+    EXPECT_TRUE(fs->delete_directory(dir).ok());
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,179 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/vertical_segment_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "common/config.h"
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/tablet_schema.h"
+#include "olap/tablet_schema_helper.h"
+#include "runtime/exec_env.h"
+#include "util/threadpool.h"
+#include "vec/core/block.h"
+
+namespace doris::segment_v2 {
+
+static const std::string kSegmentDir = "./ut_dir/vertical_segment_writer_test";
+
+// Writes the same rows with the value columns encoded one by one and in parallel groups of
+// ENCODE_THREADS columns, the segment files must be the same.
+class VerticalSegmentWriterTest : public testing::Test {
+public:
+    static constexpr int ENCODE_THREADS = 4;
+    static constexpr int NUM_ROWS = 5000;
+
+    void SetUp() override {
+        auto st = io::global_local_filesystem()->delete_directory(kSegmentDir);
+        ASSERT_TRUE(st.ok()) << st;
+        st = io::global_local_filesystem()->create_directory(kSegmentDir);
+        ASSERT_TRUE(st.ok()) << st;
+        // no threads are kept until the columns are encoded in parallel
+        std::unique_ptr<ThreadPool> pool;
+        ASSERT_TRUE(ThreadPoolBuilder("SegmentColumnEncodeThreadPool")
+                            .set_min_threads(0)
+                            .set_max_threads(ENCODE_THREADS)
+                            .set_idle_timeout(std::chrono::minutes(10))
+                            .build(&pool)
+                            .ok());
+        ExecEnv::GetInstance()->_segment_column_encode_thread_pool = std::move(pool);
+        _encode_thread_num = config::segment_column_encode_thread_num;
+
+        // k, v1, s, v2, v3, v4, v5: the value columns are encoded in groups [v1, v3] and [v4, v5]
+        _schema = std::make_shared<TabletSchema>();
+        _schema->append_column(create_int_key(0));
+        constexpr auto none = FieldAggregationMethod::OLAP_FIELD_AGGREGATION_NONE;
+        _schema->append_column(create_int_value(1, none));
+        TabletColumn s = create_string_key(2);
+        s._is_key = false;
+        s._aggregation = none;
+        _schema->append_column(s);
+        for (int32_t id = 3; id < 7; ++id) {
+            _schema->append_column(create_int_value(id, none));
+        }
+        _schema->_keys_type = DUP_KEYS;
+        _schema->_num_short_key_columns = 1;
+    }
+
+    void TearDown() override {
+        config::segment_column_encode_thread_num = _encode_thread_num;
+        ExecEnv::GetInstance()->_segment_column_encode_thread_pool->shutdown();
+        ExecEnv::GetInstance()->_segment_column_encode_thread_pool.reset();
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(kSegmentDir).ok());
+    }
+
+protected:
+    vectorized::Block create_block() {
+        vectorized::Block block = _schema->create_block();
+        auto columns = block.mutate_columns();
+        for (int32_t row = 0; row < NUM_ROWS; ++row) {
+            columns[0]->insert_data((const char*)&row, sizeof(row));
+            std::string s = "s" + std::to_string(row % 100);
+            columns[2]->insert_data(s.data(), s.size());
+            for (int cid : {1, 3, 4, 5, 6}) {
+                int32_t value = row * (cid + 3) % 1000;
+                if (row % 7 == cid) {
+                    columns[cid]->insert_default();
+                } else {
+                    columns[cid]->insert_data((const char*)&value, sizeof(value));
+                }
+            }
+        }
+        return block;
+    }
+
+    // Writes the rows as two batched blocks of a memtable flush, `content` is set to the bytes
+    // of the segment file.
+    Status write_segment(const std::string& name, std::string* content) {
+        std::string path = kSegmentDir + "/" + name + ".dat";
+        io::FileWriterPtr file_writer;
+        RETURN_IF_ERROR(io::global_local_filesystem()->create_file(path, &file_writer));
+        RowsetWriterContext context;
+        context.tablet_schema = _schema;
+        VerticalSegmentWriterOptions opts;
+        opts.rowset_ctx = &context;
+        opts.write_type = DataWriteType::TYPE_DIRECT;
+        VerticalSegmentWriter writer(file_writer.get(), 0, _schema, nullptr, nullptr, INT32_MAX,
+                                     opts, nullptr);
+        RETURN_IF_ERROR(writer.init());
+
+        auto block = create_block();
+        RETURN_IF_ERROR(writer.batch_block(&block, 0, 3000));
+        RETURN_IF_ERROR(writer.batch_block(&block, 3000, NUM_ROWS - 3000));
+        RETURN_IF_ERROR(writer.write_batch());
+        EXPECT_EQ(uint32_t(NUM_ROWS), writer.num_rows_written());
+        uint64_t file_size = 0;
+        uint64_t index_size = 0;
+        RETURN_IF_ERROR(writer.finalize(&file_size, &index_size));
+        RETURN_IF_ERROR(file_writer->close());
+
+        std::ifstream file(path, std::ios::binary);
+        content->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        EXPECT_EQ(file_size, content->size());
+        return Status::OK();
+    }
+
+    static ThreadPool* encode_pool() {
+        return ExecEnv::GetInstance()->segment_column_encode_thread_pool();
+    }
+
+    TabletSchemaSPtr _schema;
+    int32_t _encode_thread_num = 0;
+};
+
+TEST_F(VerticalSegmentWriterTest, SameSegmentAsSerialEncoding) {
+    config::segment_column_encode_thread_num = 0;
+    std::string serial;
+    auto st = write_segment("serial", &serial);
+    ASSERT_TRUE(st.ok()) << st;
+    EXPECT_EQ(0, encode_pool()->num_threads());
+
+    config::segment_column_encode_thread_num = ENCODE_THREADS;
+    std::string parallel;
+    st = write_segment("parallel", &parallel);
+    ASSERT_TRUE(st.ok()) << st;
+    EXPECT_GT(encode_pool()->num_threads(), 0);
+
+    EXPECT_FALSE(serial.empty());
+    EXPECT_TRUE(serial == parallel);
+}
+
+TEST_F(VerticalSegmentWriterTest, ColumnErrorIsReturned) {
+    // the values of s are longer than the limit, converting them fails in an encode task
+    int32_t length_limit = config::string_type_length_soft_limit_bytes;
+    config::string_type_length_soft_limit_bytes = 2;
+    for (int thread_num : {0, ENCODE_THREADS}) {
+        config::segment_column_encode_thread_num = thread_num;
+        std::string content;
+        auto st = write_segment("error_" + std::to_string(thread_num), &content);
+        EXPECT_FALSE(st.ok());
+        EXPECT_NE(std::string::npos, st.to_string().find("string_type_length_soft_limit_bytes"))
+                << st;
+    }
+    config::string_type_length_soft_limit_bytes = length_limit;
+}
+
+} // namespace doris::segment_v2
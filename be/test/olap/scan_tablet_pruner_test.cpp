@@ -0,0 +1,248 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/scan_tablet_pruner.h"
+
+#include <gen_cpp/AgentService_types.h>
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "agent/be_exec_version_manager.h"
+#include "exec/olap_common.h"
+#include "exprs/bloom_filter_func.h"
+#include "exprs/create_predicate_function.h"
+#include "exprs/hybrid_set.h"
+#include "exprs/minmax_predicate.h"
+#include "olap/options.h"
+#include "olap/rowset/rowset_meta.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tablet_meta.h"
+#include "runtime/define_primitive_type.h"
+
+namespace doris {
+
+static std::unique_ptr<StorageEngine> k_engine;
+
+// Each tablet has an empty rowset [0-1] and a rowset [2-2] of two segments, segment 0 has k1 in
+// [0, 9] and v1 in [100, 199], segment 1 has k1 in [10, 19] and v1 in [200, 299].
+class ScanTabletPrunerTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        EngineOptions options;
+        k_engine = std::make_unique<StorageEngine>(options);
+    }
+
+    static void TearDownTestSuite() { k_engine.reset(); }
+
+    TabletSharedPtr create_tablet(TKeysType::type keys_type, bool with_zone_maps = true) {
+        std::vector<TColumn> cols(2);
+        cols[0].column_type.type = TPrimitiveType::INT;
+        cols[0].__set_column_name("k1");
+        cols[0].__set_is_key(true);
+        cols[1].column_type.type = TPrimitiveType::INT;
+        cols[1].__set_column_name("v1");
+        cols[1].__set_is_key(false);
+        cols[1].__set_aggregation_type(keys_type == TKeysType::AGG_KEYS ? TAggregationType::SUM
+                                                                         : TAggregationType::NONE);
+        TTabletSchema t_tablet_schema;
+        t_tablet_schema.__set_short_key_column_count(1);
+        t_tablet_schema.__set_schema_hash(3333);
+        t_tablet_schema.__set_keys_type(keys_type);
+        t_tablet_schema.__set_storage_type(TStorageType::COLUMN);
+        t_tablet_schema.__set_columns(cols);
+        int64_t tablet_id = ++_next_tablet_id;
+        TabletMetaSharedPtr tablet_meta(new TabletMeta(
+                1, 2, tablet_id, tablet_id, 3333, 0, t_tablet_schema, 2, {{0, 0}, {1, 1}},
+                UniqueId(1, tablet_id), TTabletType::TABLET_TYPE_DISK, TCompressionType::LZ4F));
+
+        std::vector<SegmentZoneMapsPB> zone_maps(2);
+        for (int i = 0; i < 2; ++i) {
+            add_zone_map(&zone_maps[i], tablet_meta->tablet_schema()->column(0).unique_id(),
+                         10 * i, 10 * i + 9);
+            add_zone_map(&zone_maps[i], tablet_meta->tablet_schema()->column(1).unique_id(),
+                         100 * (i + 1), 100 * (i + 1) + 99);
+        }
+        if (!with_zone_maps) {
+            zone_maps.clear();
+        }
+        EXPECT_TRUE(tablet_meta->add_rs_meta(create_rs_meta(tablet_meta, 0, 1, {})).ok());
+        EXPECT_TRUE(tablet_meta->add_rs_meta(create_rs_meta(tablet_meta, 2, 2, zone_maps, 2)).ok());
+        TabletSharedPtr tablet(new Tablet(*k_engine, tablet_meta, nullptr));
+        EXPECT_TRUE(tablet->init().ok());
+        return tablet;
+    }
+
+    static RowsetMetaSharedPtr create_rs_meta(const TabletMetaSharedPtr& tablet_meta,
+                                              int64_t start_version, int64_t end_version,
+                                              const std::vector<SegmentZoneMapsPB>& zone_maps,
+                                              int64_t num_segments = 0) {
+        RowsetMetaPB rowset_meta_pb;
+        rowset_meta_pb.set_tablet_id(tablet_meta->tablet_id());
+        rowset_meta_pb.set_rowset_type(BETA_ROWSET);
+        rowset_meta_pb.set_rowset_state(VISIBLE);
+        rowset_meta_pb.set_start_version(start_version);
+        rowset_meta_pb.set_end_version(end_version);
+        rowset_meta_pb.set_num_segments(num_segments);
+        rowset_meta_pb.set_empty(num_segments == 0);
+        auto rs_meta = std::make_shared<RowsetMeta>();
+        rs_meta->init_from_pb(rowset_meta_pb);
+        RowsetId rowset_id;
+        rowset_id.init(tablet_meta->tablet_id() * 1000 + end_version);
+        rs_meta->set_rowset_id(rowset_id);
+        rs_meta->set_tablet_schema(tablet_meta->tablet_schema());
+        if (!zone_maps.empty()) {
+            rs_meta->set_segments_zone_maps(zone_maps);
+        }
+        return rs_meta;
+    }
+
+    static void add_zone_map(SegmentZoneMapsPB* zone_maps, int32_t unique_id, int32_t min,
+                             int32_t max) {
+        ColumnZoneMapPB* column = zone_maps->add_columns();
+        column->set_unique_id(unique_id);
+        column->set_type(int32_t(FieldType::OLAP_FIELD_TYPE_INT));
+        column->set_length(4);
+        column->mutable_zone_map()->set_min(std::to_string(min));
+        column->mutable_zone_map()->set_max(std::to_string(max));
+        column->mutable_zone_map()->set_has_not_null(true);
+        column->mutable_zone_map()->set_has_null(false);
+    }
+
+    static TCondition condition(const std::string& column, const std::string& op,
+                                std::vector<std::string> values) {
+        TCondition condition;
+        condition.__set_column_name(column);
+        condition.__set_condition_op(op);
+        condition.__set_condition_values(std::move(values));
+        return condition;
+    }
+
+    bool may_match(const TabletSharedPtr& tablet, const std::vector<TCondition>& conditions,
+                   const std::vector<TCondition>& scan_key_conditions = {},
+                   int64_t version = 2) {
+        ScanTabletPruner pruner(conditions, scan_key_conditions, _bloom_filters, _in_filters,
+                                BeExecVersionManager::get_newest_version());
+        return pruner.may_match(tablet, version);
+    }
+
+protected:
+    int64_t _next_tablet_id = 10000;
+    std::vector<std::pair<std::string, std::shared_ptr<BloomFilterFuncBase>>> _bloom_filters;
+    std::vector<std::pair<std::string, std::shared_ptr<HybridSetBase>>> _in_filters;
+};
+
+TEST_F(ScanTabletPrunerTest, MinMax) {
+    auto tablet = create_tablet(TKeysType::DUP_KEYS);
+    EXPECT_TRUE(may_match(tablet, {}));
+    EXPECT_FALSE(may_match(tablet, {condition("k1", ">=", {"20"})}));
+    EXPECT_TRUE(may_match(tablet, {condition("k1", ">=", {"19"})}));
+    EXPECT_FALSE(may_match(tablet, {condition("k1", "<<", {"0"})}));
+    EXPECT_FALSE(may_match(tablet, {condition("v1", ">>", {"299"})}));
+    EXPECT_TRUE(may_match(tablet, {condition("v1", ">>", {"250"})}));
+    // each condition matches one segment, but no segment matches both
+    EXPECT_FALSE(
+            may_match(tablet, {condition("k1", "<=", {"9"}), condition("v1", ">=", {"200"})}));
+    EXPECT_TRUE(
+            may_match(tablet, {condition("k1", "<=", {"10"}), condition("v1", ">=", {"200"})}));
+    EXPECT_FALSE(may_match(tablet, {condition("k1", "*=", {"25", "30"})}));
+    EXPECT_TRUE(may_match(tablet, {condition("k1", "*=", {"5", "30"})}));
+}
+
+TEST_F(ScanTabletPrunerTest, ScanKeyConditions) {
+    auto tablet = create_tablet(TKeysType::DUP_KEYS);
+    // the exact key ranges are moved to the scan keys, the scan nodes keep them as conditions
+    ColumnValueRange<TYPE_INT> fixed_range("k1", false, 0, 0);
+    EXPECT_TRUE(fixed_range.add_fixed_value(25).ok());
+    EXPECT_TRUE(fixed_range.add_fixed_value(30).ok());
+    std::vector<TCondition> scan_key_conditions;
+    fixed_range.to_olap_filter(scan_key_conditions);
+    EXPECT_FALSE(may_match(tablet, {}, scan_key_conditions));
+
+    ColumnValueRange<TYPE_INT> range("k1", false, 0, 0);
+    EXPECT_TRUE(range.add_range(FILTER_LARGER_OR_EQUAL, 12).ok());
+    EXPECT_TRUE(range.add_range(FILTER_LESS, 15).ok());
+    scan_key_conditions.clear();
+    range.to_olap_filter(scan_key_conditions);
+    EXPECT_TRUE(may_match(tablet, {}, scan_key_conditions));
+    // and the other conditions still apply
+    EXPECT_FALSE(may_match(tablet, {condition("v1", "<<", {"200"})}, scan_key_conditions));
+}
+
+TEST_F(ScanTabletPrunerTest, InFilter) {
+    auto tablet = create_tablet(TKeysType::DUP_KEYS);
+    std::shared_ptr<HybridSetBase> set(create_set(TYPE_INT));
+    for (int32_t value : {25, 40}) {
+        set->insert(&value);
+    }
+    _in_filters.emplace_back("k1", set);
+    EXPECT_FALSE(may_match(tablet, {}));
+
+    int32_t value = 15;
+    set->insert(&value);
+    _in_filters.clear();
+    _in_filters.emplace_back("k1", set);
+    EXPECT_TRUE(may_match(tablet, {}));
+}
+
+TEST_F(ScanTabletPrunerTest, BloomFilter) {
+    auto tablet = create_tablet(TKeysType::DUP_KEYS);
+    std::shared_ptr<BloomFilterFuncBase> filter(create_bloom_filter(TYPE_INT));
+    _bloom_filters.emplace_back("k1", filter);
+    // a bloom filter without its range cannot prune
+    EXPECT_TRUE(may_match(tablet, {}));
+
+    std::shared_ptr<MinMaxFuncBase> min_max(create_minmax_filter(TYPE_INT));
+    for (int32_t value : {30, 50}) {
+        min_max->insert(&value);
+    }
+    filter->set_min_max(min_max, TYPE_INT);
+    EXPECT_FALSE(may_match(tablet, {}));
+
+    int32_t value = 19;
+    min_max->insert(&value);
+    EXPECT_TRUE(may_match(tablet, {}));
+}
+
+TEST_F(ScanTabletPrunerTest, KeepTabletsWhichCannotBeDecided) {
+    // the rowset was written before the zone maps were kept in its meta
+    auto tablet = create_tablet(TKeysType::DUP_KEYS, false);
+    EXPECT_TRUE(may_match(tablet, {condition("k1", ">=", {"20"})}));
+
+    // the values of an aggregate table are only known after merging the rows of a key
+    auto agg_tablet = create_tablet(TKeysType::AGG_KEYS);
+    EXPECT_TRUE(may_match(agg_tablet, {condition("v1", ">>", {"299"})}));
+    EXPECT_FALSE(may_match(agg_tablet, {condition("k1", ">=", {"20"})}));
+    auto mor_tablet = create_tablet(TKeysType::UNIQUE_KEYS);
+    EXPECT_TRUE(may_match(mor_tablet, {condition("v1", ">>", {"299"})}));
+    EXPECT_FALSE(may_match(mor_tablet, {condition("k1", ">=", {"20"})}));
+
+    // a column the tablet does not have
+    auto dup_tablet = create_tablet(TKeysType::DUP_KEYS);
+    EXPECT_TRUE(may_match(dup_tablet, {condition("k2", ">=", {"20"})}));
+
+    // a missing version is left to the scanner to report
+    EXPECT_TRUE(may_match(dup_tablet, {condition("k1", ">=", {"20"})}, {}, 3));
+}
+
+} // namespace doris
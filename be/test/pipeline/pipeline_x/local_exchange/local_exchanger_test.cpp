@@ -0,0 +1,224 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "pipeline/pipeline_x/local_exchange/local_exchanger.h"
+
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pipeline/pipeline_x/local_exchange/local_exchange_sink_operator.h"
+#include "pipeline/pipeline_x/local_exchange/local_exchange_source_operator.h"
+#include "runtime/exec_env.h"
+#include "runtime/memory/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::pipeline {
+
+TEST(LocalExchangeQueuesTest, MultipleSinksAndSources) {
+    constexpr int num_senders = 4;
+    constexpr int num_channels = 3;
+    constexpr int64_t num_blocks = 20000;
+    LocalExchangeQueues<int64_t> queues;
+    queues.init(num_channels, num_senders);
+
+    // sender -1 has no producer tokens, it enqueues through the implicit sub-queues
+    std::vector<std::thread> senders;
+    std::atomic<int> running_senders = num_senders + 1;
+    for (int sender_id = -1; sender_id < num_senders; ++sender_id) {
+        senders.emplace_back([&, sender_id]() {
+            for (int64_t i = 0; i < num_blocks; ++i) {
+                int64_t block = (sender_id + 1) * num_blocks + i;
+                queues.enqueue(sender_id, i % num_channels, std::move(block));
+            }
+            running_senders--;
+        });
+    }
+    std::vector<std::vector<int64_t>> received(num_channels);
+    std::vector<std::thread> sources;
+    for (int channel_id = 0; channel_id < num_channels; ++channel_id) {
+        sources.emplace_back([&, channel_id]() {
+            int64_t block = 0;
+            while (true) {
+                bool done = running_senders == 0;
+                if (queues.try_dequeue(channel_id, block)) {
+                    received[channel_id].push_back(block);
+                } else if (done) {
+                    break;
+                }
+            }
+        });
+    }
+    for (auto& thread : senders) {
+        thread.join();
+    }
+    for (auto& thread : sources) {
+        thread.join();
+    }
+
+    // every block is delivered once, to its channel, and in the order of its sender
+    std::vector<int> delivered((num_senders + 1) * num_blocks, 0);
+    for (int channel_id = 0; channel_id < num_channels; ++channel_id) {
+        std::vector<int64_t> last(num_senders + 1, -1);
+        for (int64_t block : received[channel_id]) {
+            int64_t sender = block / num_blocks;
+            int64_t i = block % num_blocks;
+            EXPECT_EQ(channel_id, i % num_channels);
+            EXPECT_LT(last[sender], i);
+            last[sender] = i;
+            delivered[block]++;
+        }
+    }
+    for (int count : delivered) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+// Two sinks shuffle into 4 partitions read by 2 sources, the blocks released by the sources
+// are reused by the next sink calls.
+class ShuffleExchangerTest : public testing::Test {
+public:
+    static constexpr int NUM_SINKS = 2;
+    static constexpr int NUM_SOURCES = 2;
+    static constexpr int NUM_PARTITIONS = 4;
+
+    void SetUp() override {
+        TQueryOptions query_options;
+        query_options.__set_batch_size(4096);
+        _state = std::make_unique<RuntimeState>(TUniqueId(), query_options, TQueryGlobals(),
+                                                ExecEnv::GetInstance());
+
+        _shared_state = LocalExchangeSharedState::create_unique(NUM_SOURCES);
+        _shared_state->exchanger = BucketShuffleExchanger::create_unique(
+                NUM_SINKS, NUM_SOURCES, NUM_PARTITIONS, true);
+        _exchanger = static_cast<ShuffleExchanger*>(_shared_state->exchanger.get());
+        _shared_state->sink_dependency =
+                std::make_shared<LocalExchangeSinkDependency>(0, 0, nullptr);
+        for (int i = 0; i < NUM_SOURCES; ++i) {
+            auto dependency = std::make_shared<LocalExchangeSourceDependency>(i + 1, 0, nullptr);
+            dependency->set_shared_state(_shared_state.get());
+            _shared_state->source_dependencies[i] = dependency;
+            _mem_trackers.push_back(std::make_unique<MemTracker>("LocalExchangeSource"));
+            _shared_state->mem_trackers[i] = _mem_trackers.back().get();
+
+            auto source = std::make_unique<LocalExchangeSourceLocalState>(_state.get(), nullptr);
+            source->_shared_state = _shared_state.get();
+            source->_dependency = dependency.get();
+            source->_channel_id = i;
+            source->_get_block_failed_counter =
+                    ADD_COUNTER(&_profile, "GetBlockFailedTime" + std::to_string(i), TUnit::UNIT);
+            _sources.push_back(std::move(source));
+        }
+        for (int i = 0; i < NUM_SINKS; ++i) {
+            auto sink = std::make_unique<LocalExchangeSinkLocalState>(nullptr, _state.get());
+            sink->_shared_state = _shared_state.get();
+            sink->_sender_id = _exchanger->_next_sender_id.fetch_add(1);
+            _sinks.push_back(std::move(sink));
+        }
+    }
+
+    // Sink `num_rows` rows starting at `first` from each sink, the partition of a value is the
+    // value modulo the number of partitions.
+    void sink_rows(int64_t first, int64_t num_rows) {
+        for (int sink_id = 0; sink_id < NUM_SINKS; ++sink_id) {
+            auto column = vectorized::ColumnInt64::create();
+            std::vector<uint32_t> channel_ids;
+            for (int64_t i = 0; i < num_rows; ++i) {
+                int64_t value = (first + i) * NUM_SINKS + sink_id;
+                column->insert_value(value);
+                channel_ids.push_back(value % NUM_PARTITIONS);
+            }
+            vectorized::Block block;
+            block.insert({std::move(column), std::make_shared<vectorized::DataTypeInt64>(), "v"});
+            EXPECT_TRUE(_exchanger
+                                ->_split_rows(_state.get(), channel_ids.data(), &block,
+                                              SourceState::DEPEND_ON_SOURCE, *_sinks[sink_id])
+                                .ok());
+        }
+    }
+
+    // Read all the blocks queued for the sources, check each value went to its source.
+    void drain(std::vector<int>* received) {
+        for (int source_id = 0; source_id < NUM_SOURCES; ++source_id) {
+            while (true) {
+                vectorized::Block block;
+                SourceState source_state = SourceState::DEPEND_ON_SOURCE;
+                EXPECT_TRUE(_exchanger
+                                    ->get_block(_state.get(), &block, source_state,
+                                                *_sources[source_id])
+                                    .ok());
+                if (block.rows() == 0) {
+                    break;
+                }
+                const auto& column = *block.get_by_position(0).column;
+                for (size_t i = 0; i < block.rows(); ++i) {
+                    int64_t value = column.get_int(i);
+                    EXPECT_EQ(source_id, value % NUM_PARTITIONS % NUM_SOURCES);
+                    (*received)[value]++;
+                }
+            }
+        }
+    }
+
+protected:
+    std::unique_ptr<RuntimeState> _state;
+    RuntimeProfile _profile {"test"};
+    std::vector<std::unique_ptr<MemTracker>> _mem_trackers;
+    std::shared_ptr<LocalExchangeSharedState> _shared_state;
+    ShuffleExchanger* _exchanger = nullptr;
+    std::vector<std::unique_ptr<LocalExchangeSinkLocalState>> _sinks;
+    std::vector<std::unique_ptr<LocalExchangeSourceLocalState>> _sources;
+};
+
+TEST_F(ShuffleExchangerTest, ReuseFreedBlocks) {
+    constexpr int64_t rows_per_round = 1000;
+    constexpr int num_rounds = 5;
+    std::vector<int> received(num_rounds * rows_per_round * NUM_SINKS, 0);
+    for (int round = 0; round < num_rounds; ++round) {
+        sink_rows(round * rows_per_round, rows_per_round);
+        // the blocks freed by the previous round were taken by the sinks
+        EXPECT_EQ(0U, _exchanger->_free_blocks.size_approx());
+        drain(&received);
+        // each block is freed once all its partitions were read
+        EXPECT_EQ(size_t(NUM_SINKS), _exchanger->_free_blocks.size_approx());
+    }
+    EXPECT_EQ(0U, _shared_state->mem_usage.load());
+
+    // the sources finish once the sinks are done and the queues are empty
+    _exchanger->_running_sink_operators = 0;
+    for (int source_id = 0; source_id < NUM_SOURCES; ++source_id) {
+        vectorized::Block block;
+        SourceState source_state = SourceState::DEPEND_ON_SOURCE;
+        EXPECT_TRUE(
+                _exchanger->get_block(_state.get(), &block, source_state, *_sources[source_id])
+                        .ok());
+        EXPECT_EQ(SourceState::FINISHED, source_state);
+    }
+    for (int count : received) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+} // namespace doris::pipeline
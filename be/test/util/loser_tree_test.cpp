@@ -0,0 +1,136 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/loser_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace doris {
+
+// a sorted run of ints, its current value is runs[run][pos]
+struct RunCursor {
+    const std::vector<int>* run = nullptr;
+    size_t pos = 0;
+
+    int value() const { return (*run)[pos]; }
+};
+
+struct RunCursorComparator {
+    size_t* num_compares;
+
+    bool operator()(const RunCursor& lhs, const RunCursor& rhs) {
+        ++*num_compares;
+        return lhs.value() > rhs.value();
+    }
+};
+
+class LoserTreeTest : public testing::Test {
+public:
+    // merge the runs, using the runner up to skip matches as VCollectIterator does if
+    // `use_runner_up` is true
+    static std::vector<int> merge(const std::vector<std::vector<int>>& runs, bool use_runner_up,
+                                  size_t* num_compares) {
+        std::vector<RunCursor> cursors;
+        for (const auto& run : runs) {
+            if (!run.empty()) {
+                cursors.push_back({&run, 0});
+            }
+        }
+        LoserTree<RunCursor, RunCursorComparator> tree(std::move(cursors), {num_compares});
+        std::vector<int> result;
+        while (!tree.empty()) {
+            RunCursor& top = tree.top();
+            result.push_back(top.value());
+            if (++top.pos == top.run->size()) {
+                tree.remove_top();
+            } else if (!use_runner_up || tree.size() == 1 ||
+                       top.value() >= tree.runner_up().value()) {
+                tree.update_top();
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(LoserTreeTest, Merge) {
+    std::default_random_engine re(42);
+    for (size_t num_runs : {0, 1, 2, 3, 5, 8, 13, 20}) {
+        std::vector<std::vector<int>> runs(num_runs);
+        std::vector<int> expected;
+        for (auto& run : runs) {
+            size_t size = re() % 100;
+            for (size_t i = 0; i < size; ++i) {
+                run.push_back(re() % 1000);
+            }
+            std::sort(run.begin(), run.end());
+            expected.insert(expected.end(), run.begin(), run.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        size_t num_compares = 0;
+        EXPECT_EQ(expected, merge(runs, false, &num_compares)) << num_runs;
+        EXPECT_EQ(expected, merge(runs, true, &num_compares)) << num_runs;
+    }
+}
+
+TEST_F(LoserTreeTest, RunnerUp) {
+    std::vector<RunCursor> cursors;
+    std::vector<std::vector<int>> runs = {{5}, {3}, {9}, {1}, {7}};
+    for (const auto& run : runs) {
+        cursors.push_back({&run, 0});
+    }
+    size_t num_compares = 0;
+    LoserTree<RunCursor, RunCursorComparator> tree(std::move(cursors), {&num_compares});
+    EXPECT_EQ(5, tree.size());
+    EXPECT_EQ(3, tree.top_index());
+    EXPECT_EQ(1, tree.top().value());
+    EXPECT_EQ(3, tree.runner_up().value());
+    tree.remove_top();
+    EXPECT_EQ(3, tree.top().value());
+    EXPECT_EQ(5, tree.runner_up().value());
+    tree.remove_top();
+    tree.remove_top();
+    EXPECT_EQ(7, tree.top().value());
+    EXPECT_EQ(9, tree.runner_up().value());
+    tree.remove_top();
+    EXPECT_EQ(1, tree.size());
+    EXPECT_EQ(9, tree.top().value());
+    tree.remove_top();
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST_F(LoserTreeTest, FewerComparesForRuns) {
+    // runs which do not overlap, a top is only compared with the runner up until its run ends
+    std::vector<std::vector<int>> runs(20);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        for (int j = 0; j < 100; ++j) {
+            runs[i].push_back(int(i) * 100 + j);
+        }
+    }
+    size_t compares_per_row = 0;
+    size_t compares_with_runner_up = 0;
+    auto result = merge(runs, false, &compares_per_row);
+    EXPECT_EQ(result, merge(runs, true, &compares_with_runner_up));
+    EXPECT_TRUE(std::is_sorted(result.begin(), result.end()));
+    EXPECT_LT(compares_with_runner_up * 2, compares_per_row);
+}
+
+} // namespace doris
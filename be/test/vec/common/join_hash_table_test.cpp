@@ -0,0 +1,130 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/hash_table/join_hash_table.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace doris {
+
+using TestJoinHashTable = JoinHashTable<uint64_t>;
+
+class JoinHashTableTest : public testing::Test {
+public:
+    void SetUp() override {
+        std::default_random_engine re(11);
+        // the first row is mocked
+        _build_keys.push_back(0);
+        for (size_t i = 1; i < kBuildRows; ++i) {
+            _build_keys.push_back(re() % (kBuildRows / 3));
+        }
+        for (size_t i = 0; i < kProbeRows; ++i) {
+            _probe_keys.push_back(re() % (kBuildRows / 2));
+        }
+    }
+
+    void prepare(TestJoinHashTable& table, std::vector<uint32_t>& bucket_nums) {
+        table.prepare_build<TJoinOp::INNER_JOIN>(_build_keys.size(), kBatchSize, false);
+        bucket_nums.resize(_build_keys.size());
+        for (size_t i = 0; i < _build_keys.size(); ++i) {
+            bucket_nums[i] = table.hash(_build_keys[i]) & (table.get_bucket_size() - 1);
+        }
+    }
+
+    // all (probe row, build row) pairs of an inner join, in the order of the probe
+    std::vector<std::pair<uint32_t, uint32_t>> probe(TestJoinHashTable& table) {
+        std::vector<uint32_t> build_idx_map(_probe_keys.size());
+        for (size_t i = 0; i < _probe_keys.size(); ++i) {
+            build_idx_map[i] = table.hash(_probe_keys[i]) & (table.get_bucket_size() - 1);
+        }
+        table.pre_build_idxs(build_idx_map, nullptr);
+
+        std::vector<std::pair<uint32_t, uint32_t>> matches;
+        std::vector<uint32_t> probe_idxs(kBatchSize + 1);
+        std::vector<uint32_t> build_idxs(kBatchSize + 1);
+        bool probe_visited = false;
+        int probe_idx = 0;
+        uint32_t build_idx = 0;
+        int probe_rows = _probe_keys.size();
+        while (probe_idx < probe_rows || build_idx != 0) {
+            auto [new_probe_idx, new_build_idx, matched_cnt] =
+                    table.find_batch<TJoinOp::INNER_JOIN, false, false, false>(
+                            _probe_keys.data(), build_idx_map.data(), probe_idx, build_idx,
+                            probe_rows, probe_idxs.data(), probe_visited, build_idxs.data());
+            for (int i = 0; i < matched_cnt; ++i) {
+                matches.emplace_back(probe_idxs[i], build_idxs[i]);
+            }
+            probe_idx = new_probe_idx;
+            build_idx = new_build_idx;
+        }
+        return matches;
+    }
+
+protected:
+    static constexpr size_t kBuildRows = 300000;
+    static constexpr size_t kProbeRows = 20000;
+    static constexpr int kBatchSize = 4064;
+    std::vector<uint64_t> _build_keys;
+    std::vector<uint64_t> _probe_keys;
+};
+
+TEST_F(JoinHashTableTest, ParallelBuild) {
+    TestJoinHashTable serial_table;
+    std::vector<uint32_t> serial_bucket_nums;
+    prepare(serial_table, serial_bucket_nums);
+    serial_table.build<TJoinOp::INNER_JOIN, false>(_build_keys.data(), serial_bucket_nums.data(),
+                                                   _build_keys.size());
+    auto expected = probe(serial_table);
+
+    std::unordered_map<uint64_t, size_t> key_counts;
+    for (size_t i = 1; i < _build_keys.size(); ++i) {
+        key_counts[_build_keys[i]]++;
+    }
+    size_t expected_matches = 0;
+    for (uint64_t key : _probe_keys) {
+        expected_matches += key_counts[key];
+    }
+    ASSERT_EQ(expected_matches, expected.size());
+
+    for (size_t num_tasks : {2, 3, 8}) {
+        TestJoinHashTable table;
+        std::vector<uint32_t> bucket_nums;
+        prepare(table, bucket_nums);
+        table.build_parallel<TJoinOp::INNER_JOIN, false>(
+                _build_keys.data(), bucket_nums.data(), _build_keys.size(), num_tasks,
+                [](size_t n, const std::function<void(size_t)>& task) {
+                    std::vector<std::thread> threads;
+                    for (size_t i = 0; i < n; ++i) {
+                        threads.emplace_back(task, i);
+                    }
+                    for (auto& thread : threads) {
+                        thread.join();
+                    }
+                });
+        // the chains are the same as those of a serial build
+        EXPECT_EQ(expected, probe(table)) << num_tasks;
+    }
+}
+
+} // namespace doris
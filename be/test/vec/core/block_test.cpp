@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <random>
 #include <string>
 
 #include "agent/be_exec_version_manager.h"
@@ -299,6 +300,54 @@ TEST(BlockTest, SerializeAndDeserializeBlock) {
     serialize_and_deserialize_test(segment_v2::CompressionTypePB::LZ4);
 }
 
+TEST(BlockTest, SerializeByColumn) {
+    // compresses well
+    auto repeated = vectorized::ColumnVector<Int32>::create();
+    // does not compress
+    auto random = vectorized::ColumnVector<vectorized::Int64>::create();
+    // too small to be worth compressing
+    auto small = vectorized::ColumnString::create();
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 8192; ++i) {
+        repeated->insert_value(i % 7);
+        random->insert_value(static_cast<vectorized::Int64>(rng()));
+        if (i < 16) {
+            std::string value = std::to_string(i);
+            small->insert_data(value.data(), value.size());
+        }
+    }
+    vectorized::Block block({{repeated->get_ptr(), std::make_shared<vectorized::DataTypeInt32>(),
+                              "repeated"}});
+    vectorized::Block small_block(
+            {{small->get_ptr(), std::make_shared<vectorized::DataTypeString>(), "small"}});
+    block.insert({random->get_ptr(), std::make_shared<vectorized::DataTypeInt64>(), "random"});
+
+    for (auto* src : {&block, &small_block}) {
+        PBlock pblock;
+        size_t uncompressed_bytes = 0;
+        size_t compressed_bytes = 0;
+        ASSERT_TRUE(src->serialize_by_column(BeExecVersionManager::get_newest_version(), &pblock,
+                                             &uncompressed_bytes, &compressed_bytes,
+                                             segment_v2::CompressionTypePB::LZ4)
+                            .ok());
+        EXPECT_FALSE(pblock.has_column_values());
+        ASSERT_EQ(src->columns(), pblock.columns_size());
+        EXPECT_GE(uncompressed_bytes, compressed_bytes);
+
+        vectorized::Block block2;
+        ASSERT_TRUE(block2.deserialize(pblock).ok());
+        EXPECT_EQ(src->dump_data(), block2.dump_data());
+        if (src == &small_block) {
+            EXPECT_EQ(segment_v2::CompressionTypePB::NO_COMPRESSION,
+                      pblock.columns(0).compression_type());
+        } else {
+            EXPECT_EQ(segment_v2::CompressionTypePB::LZ4, pblock.columns(0).compression_type());
+            EXPECT_EQ(segment_v2::CompressionTypePB::NO_COMPRESSION,
+                      pblock.columns(1).compression_type());
+        }
+    }
+}
+
 TEST(BlockTest, dump_data) {
     auto vec = vectorized::ColumnVector<Int32>::create();
     auto& int32_data = vec->get_data();
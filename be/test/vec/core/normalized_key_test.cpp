@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/core/normalized_key.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/sort_block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+class NormalizedKeysTest : public testing::Test {
+public:
+    void SetUp() override {
+        std::default_random_engine re(7);
+        auto int_column = ColumnInt32::create();
+        auto null_map = ColumnUInt8::create();
+        auto string_column = ColumnString::create();
+        auto bigint_column = ColumnInt64::create();
+        const std::vector<std::string> strings = {"",   "a",  std::string("a\0", 2),
+                                                  "ab", "b",  "abcdefghijklmnopqrstuvwxyz",
+                                                  "\xff"};
+        for (size_t i = 0; i < kNumRows; ++i) {
+            int_column->insert_value(int32_t(re() % 7) - 3);
+            null_map->insert_value(re() % 5 == 0);
+            const auto& value = strings[re() % strings.size()];
+            string_column->insert_data(value.data(), value.size());
+            bigint_column->insert_value(int64_t(re() % 5) - 2);
+        }
+        _block.insert({ColumnNullable::create(std::move(int_column), std::move(null_map)),
+                       make_nullable(std::make_shared<DataTypeInt32>()), "k1"});
+        _block.insert({std::move(bigint_column), std::make_shared<DataTypeInt64>(), "k2"});
+        _block.insert({std::move(string_column), std::make_shared<DataTypeString>(), "k3"});
+    }
+
+    int compare_rows(const ColumnsWithSortDescriptions& columns, size_t lhs, size_t rhs) {
+        for (const auto& [column, description] : columns) {
+            int res = description.direction *
+                      column->compare_at(lhs, rhs, *column, description.nulls_direction);
+            if (res != 0) {
+                return res;
+            }
+        }
+        return 0;
+    }
+
+    // the order of the normalized keys agrees with the order of the rows
+    void check(const SortDescription& description, size_t width, bool expect_complete) {
+        auto columns = get_columns_with_sort_description(_block, description);
+        NormalizedKeys keys(width);
+        // built in two batches as memtables do
+        ASSERT_TRUE(keys.build(columns, 0, kNumRows / 2));
+        ASSERT_TRUE(keys.build(columns, kNumRows / 2, kNumRows));
+        ASSERT_EQ(kNumRows, keys.rows());
+        EXPECT_EQ(expect_complete, keys.is_complete());
+        for (size_t lhs = 0; lhs < kNumRows; ++lhs) {
+            for (size_t rhs = 0; rhs < kNumRows; ++rhs) {
+                int expected = compare_rows(columns, lhs, rhs);
+                int res = keys.compare(lhs, rhs);
+                if (res != 0) {
+                    ASSERT_EQ(expected > 0, res > 0) << lhs << " " << rhs;
+                    ASSERT_NE(0, expected) << lhs << " " << rhs;
+                } else if (keys.is_complete()) {
+                    ASSERT_EQ(0, expected) << lhs << " " << rhs;
+                }
+            }
+        }
+    }
+
+protected:
+    static constexpr size_t kNumRows = 200;
+    Block _block;
+};
+
+TEST_F(NormalizedKeysTest, Integers) {
+    check({{0, 1, -1}, {1, 1, 1}}, 16, true);
+    check({{0, -1, 1}, {1, -1, -1}}, 16, true);
+    check({{1, 1, 1}, {0, -1, -1}}, 16, true);
+    // the second column does not fit
+    check({{0, 1, -1}, {1, 1, 1}}, 8, false);
+}
+
+TEST_F(NormalizedKeysTest, Strings) {
+    check({{2, 1, 1}}, 8, false);
+    check({{2, -1, 1}, {0, 1, 1}}, 16, false);
+    check({{0, 1, 1}, {2, 1, 1}, {1, 1, 1}}, 24, false);
+    check({{0, -1, -1}, {2, -1, 1}, {1, 1, 1}}, 24, false);
+}
+
+TEST_F(NormalizedKeysTest, SortBlock) {
+    for (const SortDescription& description :
+         std::vector<SortDescription> {{{0, 1, -1}, {1, -1, 1}},
+                                       {{2, 1, 1}, {0, -1, -1}, {1, 1, 1}},
+                                       {{1, -1, 1}, {2, -1, -1}}}) {
+        Block sorted = _block.clone_empty();
+        sort_block(_block, sorted, description);
+        auto columns = get_columns_with_sort_description(sorted, description);
+        for (size_t row = 1; row < kNumRows; ++row) {
+            ASSERT_LE(compare_rows(columns, row - 1, row), 0) << row;
+        }
+    }
+}
+
+} // namespace doris::vectorized
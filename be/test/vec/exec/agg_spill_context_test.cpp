@@ -0,0 +1,207 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
+#include "util/threadpool.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/exec/vaggregation_node.h"
+
+namespace doris::vectorized {
+
+class AggSpillContextTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        char buffer[1024];
+        EXPECT_NE(getcwd(buffer, sizeof(buffer)), nullptr);
+        _spill_dir = std::string(buffer) + "/agg_spill_context_test";
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        ASSERT_TRUE(io::global_local_filesystem()->create_directory(_spill_dir).ok());
+        std::vector<StorePath> paths;
+        paths.emplace_back(_spill_dir, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        ASSERT_TRUE(_spill_manager->init().ok());
+    }
+
+    static void TearDownTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        _spill_manager.reset();
+    }
+
+    void SetUp() override {
+        ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get();
+        if (ExecEnv::GetInstance()->_buffered_reader_prefetch_thread_pool == nullptr) {
+            std::unique_ptr<ThreadPool> pool;
+            static_cast<void>(ThreadPoolBuilder("BufferedReaderPrefetchThreadPool")
+                                      .set_min_threads(1)
+                                      .set_max_threads(2)
+                                      .build(&pool));
+            ExecEnv::GetInstance()->_buffered_reader_prefetch_thread_pool = std::move(pool);
+        }
+        _context.runtime_profile = &_profile;
+        _context.compression_type = segment_v2::CompressionTypePB::LZ4;
+    }
+
+    static Block make_block(const std::vector<int64_t>& values) {
+        auto column = ColumnInt64::create();
+        for (auto value : values) {
+            column->insert_value(value);
+        }
+        Block block;
+        block.insert({std::move(column), std::make_shared<DataTypeInt64>(), "value"});
+        return block;
+    }
+
+    // one stream of `partitions` blocks, the block of partition p holds
+    // `stream * 1000 + p * 10 + i` for i < p
+    void write_stream(int64_t stream, int64_t partitions) {
+        BlockSpillWriterUPtr writer;
+        ASSERT_TRUE(_context.get_writer(writer).ok());
+        for (int64_t p = 0; p < partitions; ++p) {
+            std::vector<int64_t> values;
+            for (int64_t i = 0; i < p; ++i) {
+                values.push_back(stream * 1000 + p * 10 + i);
+            }
+            ASSERT_TRUE(writer->write(make_block(values)).ok());
+        }
+        ASSERT_TRUE(writer->close().ok());
+    }
+
+protected:
+    static std::string _spill_dir;
+    static std::unique_ptr<BlockSpillManager> _spill_manager;
+    RuntimeProfile _profile {"test"};
+    AggSpillContext _context;
+};
+
+std::string AggSpillContextTest::_spill_dir;
+std::unique_ptr<BlockSpillManager> AggSpillContextTest::_spill_manager;
+
+TEST_F(AggSpillContextTest, ReadPartitions) {
+    constexpr int64_t partitions = 4;
+    for (int64_t stream = 0; stream < 3; ++stream) {
+        write_stream(stream, partitions);
+    }
+    ASSERT_TRUE(_context.prepare_for_reading().ok());
+
+    for (int64_t p = 0; p < partitions; ++p) {
+        ASSERT_FALSE(_context.finished(partitions));
+        std::vector<Block> blocks;
+        ASSERT_TRUE(_context.read_partition(&blocks).ok());
+        // the empty blocks of partition 0 are skipped
+        std::set<int64_t> values;
+        for (const auto& block : blocks) {
+            const auto& column = *block.get_by_position(0).column;
+            for (size_t row = 0; row < block.rows(); ++row) {
+                values.insert(column.get_int(row));
+            }
+        }
+        std::set<int64_t> expected;
+        for (int64_t stream = 0; stream < 3; ++stream) {
+            for (int64_t i = 0; i < p; ++i) {
+                expected.insert(stream * 1000 + p * 10 + i);
+            }
+        }
+        EXPECT_EQ(expected, values);
+    }
+    EXPECT_TRUE(_context.finished(partitions));
+}
+
+TEST_F(AggSpillContextTest, RepartitionedLevelIsMergedFirst) {
+    constexpr int64_t partitions = 2;
+    write_stream(0, partitions);
+    ASSERT_TRUE(_context.prepare_for_reading().ok());
+    std::vector<Block> blocks;
+    ASSERT_TRUE(_context.read_partition(&blocks).ok());
+
+    _context.repartitioned = std::make_unique<AggSpillContext>();
+    auto* repartitioned = _context.repartitioned.get();
+    repartitioned->level = 1;
+    repartitioned->runtime_profile = &_profile;
+    BlockSpillWriterUPtr writer;
+    ASSERT_TRUE(repartitioned->get_writer(writer).ok());
+    ASSERT_TRUE(writer->write(make_block({1})).ok());
+    ASSERT_TRUE(writer->write(make_block({2})).ok());
+    ASSERT_TRUE(writer->close().ok());
+    ASSERT_TRUE(repartitioned->prepare_for_reading().ok());
+
+    EXPECT_EQ(repartitioned, _context.current(partitions));
+    ASSERT_TRUE(repartitioned->read_partition(&blocks).ok());
+    ASSERT_TRUE(repartitioned->read_partition(&blocks).ok());
+    EXPECT_FALSE(_context.finished(partitions));
+    // the finished level is released, the parent goes on with its next partition
+    EXPECT_EQ(&_context, _context.current(partitions));
+    EXPECT_TRUE(_context.repartitioned == nullptr);
+    ASSERT_TRUE(_context.read_partition(&blocks).ok());
+    EXPECT_TRUE(_context.finished(partitions));
+}
+
+TEST_F(AggSpillContextTest, NextLevelSplitsPartition) {
+    SpillPartitionHelper helper(4);
+    std::vector<size_t> level0_counts(helper.partition_count);
+    std::vector<size_t> level1_counts(helper.partition_count);
+    for (uint64_t key = 0; key < 100000; ++key) {
+        auto hash = int_hash64(key);
+        if (helper.get_index(hash) != 0) {
+            continue;
+        }
+        ++level0_counts[0];
+        ++level1_counts[helper.get_index(hash, 1)];
+    }
+    ASSERT_GT(level0_counts[0], 0);
+    for (auto count : level1_counts) {
+        EXPECT_GT(count, 0);
+        EXPECT_LT(count, level0_counts[0]);
+    }
+}
+
+TEST_F(AggSpillContextTest, CompressionCodec) {
+    auto compression_type = [](const std::string& codec, segment_v2::CompressionTypePB* type) {
+        TQueryOptions query_options;
+        if (!codec.empty()) {
+            query_options.__set_spill_compression_codec(codec);
+        }
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        return state.spill_compression_type(type);
+    };
+    segment_v2::CompressionTypePB type;
+    EXPECT_TRUE(compression_type("", &type).ok());
+    EXPECT_EQ(segment_v2::CompressionTypePB::NO_COMPRESSION, type);
+    EXPECT_TRUE(compression_type("none", &type).ok());
+    EXPECT_EQ(segment_v2::CompressionTypePB::NO_COMPRESSION, type);
+    EXPECT_TRUE(compression_type("lz4", &type).ok());
+    EXPECT_EQ(segment_v2::CompressionTypePB::LZ4, type);
+    EXPECT_TRUE(compression_type("zstd", &type).ok());
+    EXPECT_EQ(segment_v2::CompressionTypePB::ZSTD, type);
+    EXPECT_FALSE(compression_type("snappy", &type).ok());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,66 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "util/slice.h"
+#include "vec/exec/format/csv/csv_reader.h"
+
+namespace doris::vectorized {
+
+static std::vector<std::string> split(PlainCsvTextFieldSplitter& splitter,
+                                      const std::string& line) {
+    std::vector<Slice> values;
+    splitter.split_line(Slice(line), &values);
+    std::vector<std::string> result;
+    for (const auto& value : values) {
+        result.emplace_back(value.to_string());
+    }
+    return result;
+}
+
+TEST(CsvFieldSplitterTest, SeparatorsAcrossBlocks) {
+    PlainCsvTextFieldSplitter splitter(false, false, ",");
+    // values of every length around the 64 bytes scanned at a time, so that separators
+    // fall on both sides of the block boundaries
+    std::vector<std::string> expected;
+    std::string line;
+    for (int len = 0; len < 140; len += 7) {
+        if (!expected.empty()) {
+            line += ',';
+        }
+        expected.emplace_back(len, 'a' + len % 26);
+        line += expected.back();
+    }
+    EXPECT_EQ(expected, split(splitter, line));
+    // empty values at the ends
+    EXPECT_EQ(std::vector<std::string>({"", std::string(64, 'x'), ""}),
+              split(splitter, "," + std::string(64, 'x') + ","));
+    EXPECT_EQ(std::vector<std::string>(129, ""), split(splitter, std::string(128, ',')));
+}
+
+TEST(CsvFieldSplitterTest, NonAsciiSeparatorAndTrim) {
+    PlainCsvTextFieldSplitter splitter(true, true, "\xe9", 1, '"');
+    std::string value(70, 'v');
+    EXPECT_EQ(std::vector<std::string>({value, value, ""}),
+              split(splitter, value + "  \xe9\"" + value + "\"\xe9"));
+}
+
+} // namespace doris::vectorized
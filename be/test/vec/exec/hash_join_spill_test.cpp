@@ -0,0 +1,303 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/types.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/exec/join/vhash_join_node.h"
+
+namespace doris::vectorized {
+
+// Joins the same data with and without spilling the build side, the spilled join must return
+// the same rows as the in-memory join.
+class HashJoinSpillTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        char buffer[1024];
+        EXPECT_NE(getcwd(buffer, sizeof(buffer)), nullptr);
+        _spill_dir = std::string(buffer) + "/hash_join_spill_test";
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        ASSERT_TRUE(io::global_local_filesystem()->create_directory(_spill_dir).ok());
+        std::vector<StorePath> paths;
+        paths.emplace_back(_spill_dir, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        ASSERT_TRUE(_spill_manager->init().ok());
+    }
+
+    static void TearDownTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        _spill_manager.reset();
+    }
+
+    void SetUp() override { ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get(); }
+
+protected:
+    struct JoinResult {
+        std::vector<std::string> rows;
+        bool spilled = false;
+        int64_t repartitions = 0;
+    };
+
+    static constexpr int BLOCK_ROWS = 1024;
+
+    // probe rows j in [0, 8000) are (j % 4000, j), build rows i in [0, 6000) are
+    // (i % 3000 + 2000, i), keys [2000, 4000) match twice on both sides
+    static std::vector<Block> make_blocks(int rows, int key_mod, int key_base) {
+        std::vector<Block> blocks;
+        for (int first = 0; first < rows; first += BLOCK_ROWS) {
+            auto key_column = ColumnInt32::create();
+            auto value_column = ColumnInt32::create();
+            for (int i = first; i < std::min(rows, first + BLOCK_ROWS); ++i) {
+                key_column->insert_value(i % key_mod + key_base);
+                value_column->insert_value(i);
+            }
+            Block block;
+            block.insert({std::move(key_column), std::make_shared<DataTypeInt32>(), "k"});
+            block.insert({std::move(value_column), std::make_shared<DataTypeInt32>(), "v"});
+            blocks.emplace_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    static TExpr slot_ref(TSlotId slot_id, TTupleId tuple_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(create_type_desc(TYPE_INT));
+        node.__set_num_children(0);
+        node.__set_is_nullable(false);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(slot_id);
+        slot_ref.__set_tuple_id(tuple_id);
+        node.__set_slot_ref(slot_ref);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    static void add_tuple(TDescriptorTableBuilder* builder, int num_slots, bool nullable) {
+        TTupleDescriptorBuilder tuple_builder;
+        for (int i = 0; i < num_slots; ++i) {
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(TYPE_INT)
+                                           .nullable(nullable)
+                                           .column_name(i % 2 == 0 ? "k" : "v")
+                                           .column_pos(i)
+                                           .build());
+        }
+        tuple_builder.build(builder);
+    }
+
+    // tuple 0 and 1 are the probe and build children, 2 and 3 the intermediate tuples of the
+    // probe and build sides, 4 the output tuple
+    static TDescriptorTable make_desc_table(TJoinOp::type join_op, int num_output_slots) {
+        const bool probe_nullable =
+                join_op == TJoinOp::RIGHT_OUTER_JOIN || join_op == TJoinOp::FULL_OUTER_JOIN;
+        const bool build_nullable =
+                join_op == TJoinOp::LEFT_OUTER_JOIN || join_op == TJoinOp::FULL_OUTER_JOIN;
+        TDescriptorTableBuilder builder;
+        add_tuple(&builder, 2, false);
+        add_tuple(&builder, 2, false);
+        add_tuple(&builder, 2, probe_nullable);
+        add_tuple(&builder, 2, build_nullable);
+        add_tuple(&builder, num_output_slots, true);
+        return builder.desc_tbl();
+    }
+
+    static TPlan make_plan(TJoinOp::type join_op) {
+        TPlanNode join_node;
+        join_node.__set_node_id(0);
+        join_node.__set_node_type(TPlanNodeType::HASH_JOIN_NODE);
+        join_node.__set_num_children(2);
+        join_node.__set_limit(-1);
+        join_node.__set_row_tuples({0, 1});
+        join_node.__set_nullable_tuples({false, false});
+        join_node.__set_compact_data(false);
+
+        THashJoinNode hash_join_node;
+        hash_join_node.__set_join_op(join_op);
+        TEqJoinCondition eq_join_conjunct;
+        eq_join_conjunct.__set_left(slot_ref(0, 0));
+        eq_join_conjunct.__set_right(slot_ref(2, 1));
+        hash_join_node.__set_eq_join_conjuncts({eq_join_conjunct});
+        hash_join_node.__set_voutput_tuple_id(4);
+        if (join_op == TJoinOp::LEFT_SEMI_JOIN || join_op == TJoinOp::LEFT_ANTI_JOIN) {
+            hash_join_node.__set_vintermediate_tuple_id_list({2});
+        } else if (join_op == TJoinOp::RIGHT_SEMI_JOIN || join_op == TJoinOp::RIGHT_ANTI_JOIN) {
+            hash_join_node.__set_vintermediate_tuple_id_list({3});
+        } else {
+            hash_join_node.__set_vintermediate_tuple_id_list({2, 3});
+        }
+        join_node.__set_hash_join_node(hash_join_node);
+
+        TPlan plan;
+        plan.nodes.push_back(join_node);
+        for (int i = 0; i < 2; ++i) {
+            TPlanNode child;
+            child.__set_node_id(i + 1);
+            child.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+            child.__set_num_children(0);
+            child.__set_limit(-1);
+            child.__set_row_tuples({i});
+            child.__set_nullable_tuples({false});
+            child.__set_compact_data(false);
+            plan.nodes.push_back(child);
+        }
+        return plan;
+    }
+
+    // drives the node like the pipeline operators do: the build side is sunk, the probe blocks
+    // are pushed whenever the node needs more input, and the output is pulled otherwise
+    JoinResult join(TJoinOp::type join_op, int64_t bytes_threshold, int partition_bits = 4) {
+        JoinResult result;
+        const bool semi_anti =
+                join_op == TJoinOp::LEFT_SEMI_JOIN || join_op == TJoinOp::LEFT_ANTI_JOIN ||
+                join_op == TJoinOp::RIGHT_SEMI_JOIN || join_op == TJoinOp::RIGHT_ANTI_JOIN;
+        const int num_output_slots = semi_anti ? 2 : 4;
+
+        TQueryOptions query_options;
+        query_options.__set_batch_size(BLOCK_ROWS);
+        query_options.__set_external_join_bytes_threshold(bytes_threshold);
+        query_options.__set_external_join_partition_bits(partition_bits);
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.init_mem_trackers();
+
+        ObjectPool pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        EXPECT_TRUE(DescriptorTbl::create(&pool, make_desc_table(join_op, num_output_slots),
+                                          &desc_tbl)
+                            .ok());
+        state.set_desc_tbl(desc_tbl);
+        ExecNode* root = nullptr;
+        EXPECT_TRUE(ExecNode::create_tree(&state, &pool, make_plan(join_op), *desc_tbl, &root)
+                            .ok());
+        auto* node = static_cast<HashJoinNode*>(root);
+        EXPECT_TRUE(node->prepare(&state).ok());
+        EXPECT_TRUE(node->alloc_resource(&state).ok());
+
+        auto build_blocks = make_blocks(6000, 3000, 2000);
+        for (auto& block : build_blocks) {
+            EXPECT_TRUE(node->sink(&state, &block, false).ok());
+        }
+        Block build_eos_block;
+        EXPECT_TRUE(node->sink(&state, &build_eos_block, true).ok());
+
+        auto probe_blocks = make_blocks(8000, 4000, 0);
+        size_t next_probe_block = 0;
+        bool eos = false;
+        while (!eos) {
+            if (node->need_more_input_data()) {
+                Block block;
+                if (next_probe_block < probe_blocks.size()) {
+                    block.swap(probe_blocks[next_probe_block++]);
+                }
+                node->prepare_for_next();
+                EXPECT_TRUE(
+                        node->push(&state, &block, next_probe_block == probe_blocks.size()).ok());
+            }
+            if (!node->need_more_input_data()) {
+                Block output_block;
+                EXPECT_TRUE(node->pull(&state, &output_block, &eos).ok());
+                EXPECT_TRUE(output_block.rows() == 0 ||
+                            output_block.columns() == num_output_slots);
+                for (size_t row = 0; row < output_block.rows(); ++row) {
+                    result.rows.emplace_back(output_block.dump_one_line(row, num_output_slots));
+                }
+            }
+        }
+
+        result.spilled = node->runtime_profile()->get_info_string("Spilled") != nullptr;
+        std::vector<RuntimeProfile*> children;
+        node->runtime_profile()->get_children(&children);
+        for (auto* child : children) {
+            if (child->name() == "Spill") {
+                result.repartitions = child->get_counter("Repartitions")->value();
+            }
+        }
+        EXPECT_TRUE(node->close(&state).ok());
+        std::sort(result.rows.begin(), result.rows.end());
+        return result;
+    }
+
+    void check_join(TJoinOp::type join_op, size_t expected_rows) {
+        auto in_memory = join(join_op, 0);
+        EXPECT_FALSE(in_memory.spilled);
+        EXPECT_EQ(expected_rows, in_memory.rows.size());
+
+        auto spilled = join(join_op, 16 * 1024);
+        EXPECT_TRUE(spilled.spilled);
+        EXPECT_EQ(in_memory.rows, spilled.rows);
+    }
+
+    static std::string _spill_dir;
+    static std::unique_ptr<BlockSpillManager> _spill_manager;
+};
+
+std::string HashJoinSpillTest::_spill_dir;
+std::unique_ptr<BlockSpillManager> HashJoinSpillTest::_spill_manager;
+
+TEST_F(HashJoinSpillTest, InnerJoin) {
+    check_join(TJoinOp::INNER_JOIN, 8000);
+}
+
+TEST_F(HashJoinSpillTest, OuterJoin) {
+    check_join(TJoinOp::LEFT_OUTER_JOIN, 12000);
+    check_join(TJoinOp::RIGHT_OUTER_JOIN, 10000);
+    check_join(TJoinOp::FULL_OUTER_JOIN, 14000);
+}
+
+TEST_F(HashJoinSpillTest, SemiAntiJoin) {
+    check_join(TJoinOp::LEFT_SEMI_JOIN, 4000);
+    check_join(TJoinOp::LEFT_ANTI_JOIN, 4000);
+    check_join(TJoinOp::RIGHT_SEMI_JOIN, 4000);
+    check_join(TJoinOp::RIGHT_ANTI_JOIN, 2000);
+}
+
+TEST_F(HashJoinSpillTest, Repartition) {
+    // every partition exceeds the threshold, so it is partitioned again up to the last level
+    for (auto join_op : {TJoinOp::INNER_JOIN, TJoinOp::FULL_OUTER_JOIN, TJoinOp::LEFT_ANTI_JOIN,
+                         TJoinOp::RIGHT_ANTI_JOIN}) {
+        auto in_memory = join(join_op, 0);
+        auto spilled = join(join_op, 1, 1);
+        EXPECT_TRUE(spilled.spilled);
+        EXPECT_GT(spilled.repartitions, 0);
+        EXPECT_EQ(in_memory.rows, spilled.rows);
+    }
+}
+
+} // namespace doris::vectorized
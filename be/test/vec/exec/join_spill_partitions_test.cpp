@@ -0,0 +1,193 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/join/join_spill_partitions.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/exec_env.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+class JoinSpillPartitionsTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        char buffer[1024];
+        EXPECT_NE(getcwd(buffer, sizeof(buffer)), nullptr);
+        _spill_dir = std::string(buffer) + "/join_spill_partitions_test";
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        ASSERT_TRUE(io::global_local_filesystem()->create_directory(_spill_dir).ok());
+        std::vector<StorePath> paths;
+        paths.emplace_back(_spill_dir, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        ASSERT_TRUE(_spill_manager->init().ok());
+    }
+
+    static void TearDownTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        _spill_manager.reset();
+    }
+
+    void SetUp() override { ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get(); }
+
+    // a block of (key, row number), the key is nullable if `nullable`
+    static Block make_block(const std::vector<int64_t>& keys, bool nullable, int64_t first_row) {
+        auto key_column = ColumnInt64::create();
+        auto row_column = ColumnInt64::create();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            key_column->insert_value(keys[i]);
+            row_column->insert_value(first_row + i);
+        }
+        auto key_type = std::make_shared<DataTypeInt64>();
+        Block block;
+        if (nullable) {
+            block.insert({ColumnNullable::create(std::move(key_column),
+                                                 ColumnUInt8::create(keys.size(), 0)),
+                          make_nullable(key_type), "key"});
+        } else {
+            block.insert({std::move(key_column), key_type, "key"});
+        }
+        block.insert({std::move(row_column), std::make_shared<DataTypeInt64>(), "row"});
+        return block;
+    }
+
+    // read back the keys of each partition
+    std::vector<std::multiset<int64_t>> read_keys(JoinSpillPartitions& partitions) {
+        std::vector<std::multiset<int64_t>> keys(partitions.partition_count());
+        for (size_t i = 0; i < partitions.partition_count(); ++i) {
+            int64_t stream_id = partitions.release_stream(i);
+            if (stream_id < 0) {
+                EXPECT_EQ(0, partitions.rows(i));
+                continue;
+            }
+            BlockSpillReaderUPtr reader;
+            EXPECT_TRUE(_spill_manager->get_reader(stream_id, reader, &_profile, true).ok());
+            bool eos = false;
+            size_t rows = 0;
+            while (!eos) {
+                Block block;
+                EXPECT_TRUE(reader->read(&block, &eos).ok());
+                if (block.rows() == 0) {
+                    continue;
+                }
+                EXPECT_EQ(2, block.columns());
+                const auto& column = *remove_nullable(block.get_by_position(0).column);
+                for (size_t row = 0; row < block.rows(); ++row) {
+                    keys[i].insert(column.get_int(row));
+                }
+                rows += block.rows();
+            }
+            EXPECT_EQ(partitions.rows(i), rows);
+        }
+        return keys;
+    }
+
+protected:
+    static std::string _spill_dir;
+    static std::unique_ptr<BlockSpillManager> _spill_manager;
+    RuntimeProfile _profile {"test"};
+};
+
+std::string JoinSpillPartitionsTest::_spill_dir;
+std::unique_ptr<BlockSpillManager> JoinSpillPartitionsTest::_spill_manager;
+
+TEST_F(JoinSpillPartitionsTest, SameKeysSamePartition) {
+    JoinSpillPartitions build(3, 0, 16, &_profile);
+    JoinSpillPartitions probe(3, 0, 16, &_profile);
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 1000; ++i) {
+        keys.push_back(i * 7 % 300);
+    }
+    // the first row of the build block is skipped like a mocked row, the key is evaluated
+    // into a column after the spilled columns
+    Block build_block = make_block(keys, false, 0);
+    build_block.insert(build_block.get_by_position(0));
+    ASSERT_TRUE(build.add_block(build_block, {2}, 1, 2).ok());
+    // nullable keys are partitioned as the same non null keys
+    ASSERT_TRUE(probe.add_block(make_block(keys, true, 0), {0}, 0, 2).ok());
+    ASSERT_TRUE(build.finish().ok());
+    ASSERT_TRUE(probe.finish().ok());
+
+    auto build_keys = read_keys(build);
+    auto probe_keys = read_keys(probe);
+    size_t build_rows = 0;
+    size_t non_empty_partitions = 0;
+    for (size_t i = 0; i < build.partition_count(); ++i) {
+        build_rows += build_keys[i].size();
+        non_empty_partitions += !build_keys[i].empty();
+        std::set<int64_t> build_set(build_keys[i].begin(), build_keys[i].end());
+        std::set<int64_t> probe_set(probe_keys[i].begin(), probe_keys[i].end());
+        EXPECT_EQ(build_set, probe_set);
+    }
+    EXPECT_EQ(keys.size() - 1, build_rows);
+    EXPECT_GT(non_empty_partitions, 4);
+}
+
+TEST_F(JoinSpillPartitionsTest, NextLevelSpreadsPartition) {
+    JoinSpillPartitions level0(2, 0, 64, &_profile);
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 2000; ++i) {
+        keys.push_back(i);
+    }
+    ASSERT_TRUE(level0.add_block(make_block(keys, false, 0), {0}, 0, 2).ok());
+    ASSERT_TRUE(level0.finish().ok());
+    auto partition_keys = read_keys(level0);
+
+    const auto& skewed = partition_keys[0];
+    ASSERT_FALSE(skewed.empty());
+    JoinSpillPartitions level1(2, 1, 64, &_profile);
+    ASSERT_TRUE(level1
+                        .add_block(make_block({skewed.begin(), skewed.end()}, false, 0), {0}, 0,
+                                   2)
+                        .ok());
+    ASSERT_TRUE(level1.finish().ok());
+    for (size_t i = 0; i < level1.partition_count(); ++i) {
+        EXPECT_GT(level1.rows(i), 0);
+        EXPECT_LT(level1.rows(i), skewed.size());
+    }
+}
+
+TEST_F(JoinSpillPartitionsTest, RemoveUnreadStreams) {
+    {
+        JoinSpillPartitions partitions(2, 0, 8, &_profile);
+        ASSERT_TRUE(partitions.add_block(make_block({1, 2, 3, 4, 5, 6, 7, 8}, false, 0), {0}, 0, 2)
+                            .ok());
+        ASSERT_TRUE(partitions.finish().ok());
+    }
+    std::vector<io::FileInfo> files;
+    bool exists = false;
+    ASSERT_TRUE(io::global_local_filesystem()
+                        ->list(_spill_dir + "/spill", true, &files, &exists)
+                        .ok());
+    EXPECT_TRUE(files.empty());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,237 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/format/json/new_json_reader.h"
+
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gen_cpp/Types_types.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "io/fs/local_file_system.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
+#include "vec/core/block.h"
+#include "vec/exec/scan/vscanner.h"
+
+namespace doris::vectorized {
+
+// The values of the materialized slots of a row, "NULL" for a null.
+using Row = std::vector<std::string>;
+
+// Reads json lines with jsonpaths through the simdjson reader. The slots are nullable strings
+// named c1, c2, ..., so only the jsonpaths tell which key goes to which slot.
+class NewJsonReaderTest : public testing::Test {
+public:
+    void SetUp() override {
+        char buffer[1024];
+        ASSERT_NE(getcwd(buffer, sizeof(buffer)), nullptr);
+        _dir = std::string(buffer) + "/new_json_reader_test";
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_dir));
+        ASSERT_TRUE(io::global_local_filesystem()->create_directory(_dir).ok());
+        TQueryOptions query_options;
+        query_options.__set_batch_size(1024);
+        _state = std::make_unique<RuntimeState>(TUniqueId(), query_options, TQueryGlobals(),
+                                                ExecEnv::GetInstance());
+    }
+
+    void TearDown() override {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_dir));
+    }
+
+protected:
+    void create_slots(const std::vector<bool>& materialized) {
+        TDescriptorTableBuilder builder;
+        TTupleDescriptorBuilder tuple_builder;
+        for (int i = 0; i < materialized.size(); ++i) {
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .string_type(65535)
+                                           .nullable(true)
+                                           .is_materialized(materialized[i])
+                                           .column_name("c" + std::to_string(i + 1))
+                                           .column_pos(i)
+                                           .build());
+        }
+        tuple_builder.build(&builder);
+        DescriptorTbl* desc_tbl = nullptr;
+        ASSERT_TRUE(DescriptorTbl::create(&_pool, builder.desc_tbl(), &desc_tbl).ok());
+        _slots = desc_tbl->get_tuple_descriptor(0)->slots();
+    }
+
+    // Reads all the rows of `json_lines`. `match_by_key` is set to whether the reader looks the
+    // jsonpaths up by the keys of the objects, `per_path` makes it extract each jsonpath instead.
+    std::vector<Row> read(const std::string& json_lines, const std::string& jsonpaths,
+                          bool* match_by_key, bool per_path = false) {
+        std::string path = _dir + "/" + std::to_string(_next_file++) + ".json";
+        std::ofstream(path) << json_lines;
+
+        TFileAttributes attributes;
+        attributes.__set_jsonpaths(jsonpaths);
+        attributes.__set_read_json_by_line(true);
+        attributes.__set_strip_outer_array(false);
+        TFileScanRangeParams params;
+        params.__set_file_type(TFileType::FILE_LOCAL);
+        params.__set_format_type(TFileFormatType::FORMAT_JSON);
+        params.__set_file_attributes(attributes);
+        TFileRangeDesc range;
+        range.__set_path(path);
+        range.__set_start_offset(0);
+        range.__set_size(json_lines.size());
+        range.__set_file_size(json_lines.size());
+
+        RuntimeProfile profile("NewJsonReaderTest");
+        ScannerCounter counter;
+        bool scanner_eof = false;
+        NewJsonReader reader(_state.get(), &profile, &counter, params, range, _slots,
+                             &scanner_eof, nullptr);
+        // the simdjson reader is only enabled on AVX2, it is used directly to not depend on it
+        EXPECT_TRUE(reader._simdjson_init_reader().ok());
+        reader._col_default_value_map = _defaults;
+        *match_by_key = reader._match_jsonpaths_by_key;
+        EXPECT_EQ(_slots.size(), reader._prev_positions.size());
+        if (per_path) {
+            reader._match_jsonpaths_by_key = false;
+        }
+
+        Block block;
+        for (auto* slot : _slots) {
+            auto type = slot->get_data_type_ptr();
+            block.insert({type->create_column(), type, slot->col_name()});
+        }
+        size_t read_rows = 0;
+        bool eof = false;
+        while (!eof) {
+            EXPECT_TRUE(reader.get_next_block(&block, &read_rows, &eof).ok());
+        }
+        EXPECT_EQ(0, counter.num_rows_filtered);
+
+        std::vector<Row> rows(read_rows);
+        for (size_t c = 0; c < _slots.size(); ++c) {
+            const auto& column = *block.get_by_position(c).column;
+            if (!_slots[c]->is_materialized()) {
+                EXPECT_EQ(0, column.size());
+                continue;
+            }
+            EXPECT_EQ(read_rows, column.size());
+            for (size_t i = 0; i < read_rows && i < column.size(); ++i) {
+                rows[i].push_back(column.is_null_at(i) ? "NULL"
+                                                       : column.get_data_at(i).to_string());
+            }
+        }
+        return rows;
+    }
+
+    std::string _dir;
+    int _next_file = 0;
+    ObjectPool _pool;
+    std::unique_ptr<RuntimeState> _state;
+    std::vector<SlotDescriptor*> _slots;
+    std::unordered_map<std::string, std::string> _defaults;
+};
+
+TEST_F(NewJsonReaderTest, MatchJsonpathsByKeys) {
+    // c3 is not materialized, c1 has a default value
+    create_slots({true, true, false, true});
+    _defaults["c1"] = "d1";
+    const std::string jsonpaths = R"(["$.k1", "$.k2", "$.k3", "$.k4"])";
+    const std::string json_lines =
+            // in the order of the jsonpaths
+            R"({"k1":"a","k2":1,"k3":"x","k4":true})"
+            "\n"
+            // out of order, the cached positions of the first row do not match
+            R"({"k4":false,"k3":"y","k2":{"n":2},"k1":"b"})"
+            "\n"
+            // missing keys get the default value or null
+            R"({"k2":"c"})"
+            "\n"
+            // the first of duplicated keys wins
+            R"({"k1":"first","k2":null,"k1":"second"})"
+            "\n"
+            // unknown keys, and more keys than slots
+            R"({"x":1,"y":2,"k4":"h","k2":"g","k1":"f","z":3})"
+            "\n"
+            R"({"k1":"a2","k2":"b2","k3":"c2","k4":"d2"})"
+            "\n";
+    const std::vector<Row> expected = {{"a", "1", "1"},     {"b", R"({"n":2})", "0"},
+                                       {"d1", "c", "NULL"}, {"first", "NULL", "NULL"},
+                                       {"f", "g", "h"},     {"a2", "b2", "d2"}};
+
+    bool match_by_key = false;
+    EXPECT_EQ(expected, read(json_lines, jsonpaths, &match_by_key));
+    EXPECT_TRUE(match_by_key);
+    // the same rows as extracting each jsonpath from the object
+    EXPECT_EQ(expected, read(json_lines, jsonpaths, &match_by_key, true));
+}
+
+TEST_F(NewJsonReaderTest, EscapedKeys) {
+    create_slots({true, true});
+    // the keys are looked up unescaped, like the rapidjson reader does, an escaped duplicate
+    // of a key is still a duplicate
+    const std::string json_lines =
+            R"({"k\u0031":"escaped","k2":"e"})"
+            "\n"
+            R"({"k2":"f","k\u0032":"g"})"
+            "\n";
+    bool match_by_key = false;
+    EXPECT_EQ((std::vector<Row> {{"escaped", "e"}, {"NULL", "f"}}),
+              read(json_lines, R"(["$.k1", "$.k2"])", &match_by_key));
+    EXPECT_TRUE(match_by_key);
+}
+
+TEST_F(NewJsonReaderTest, MoreSlotsThanJsonpaths) {
+    create_slots({true, true, true});
+    // c3 has no jsonpath, it is not matched by its name
+    const std::string json_lines = R"({"k1":"a","k2":"b","c3":"x"})"
+                                   "\n";
+    const std::vector<Row> expected = {{"b", "a", "NULL"}};
+    bool match_by_key = false;
+    EXPECT_EQ(expected, read(json_lines, R"(["$.k2", "$.k1"])", &match_by_key));
+    EXPECT_TRUE(match_by_key);
+    EXPECT_EQ(expected, read(json_lines, R"(["$.k2", "$.k1"])", &match_by_key, true));
+}
+
+TEST_F(NewJsonReaderTest, ExtractEachJsonpath) {
+    create_slots({true, true, true});
+    bool match_by_key = true;
+    // nested and array paths
+    EXPECT_EQ((std::vector<Row> {{"v", "nested", "20"}}),
+              read(R"({"k1":"v","a":{"b":"nested"},"arr":[10,20]})"
+                   "\n",
+                   R"(["$.k1", "$.a.b", "$.arr[1]"])", &match_by_key));
+    EXPECT_FALSE(match_by_key);
+
+    // the same key in two jsonpaths
+    match_by_key = true;
+    EXPECT_EQ((std::vector<Row> {{"v", "v", "NULL"}}),
+              read(R"({"k1":"v","k2":"w"})"
+                   "\n",
+                   R"(["$.k1", "$.k1"])", &match_by_key));
+    EXPECT_FALSE(match_by_key);
+}
+
+} // namespace doris::vectorized
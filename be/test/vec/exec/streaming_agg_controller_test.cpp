@@ -0,0 +1,147 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/streaming_agg_controller.h"
+
+#include <gtest/gtest.h>
+
+#include "util/runtime_profile.h"
+
+namespace doris::vectorized {
+
+using Mode = StreamingAggController::Mode;
+
+static constexpr size_t L2_TABLE_BYTES = 256 * 1024;
+static constexpr size_t L3_TABLE_BYTES = 4 * 1024 * 1024;
+static constexpr size_t MEMORY_TABLE_BYTES = 64 * 1024 * 1024;
+
+class StreamingAggControllerTest : public testing::Test {
+public:
+    void SetUp() override { _controller.init_profile(&_profile); }
+
+    int64_t counter(const std::string& name) { return _profile.get_counter(name)->value(); }
+
+    // every row of the batches is a new group
+    void feed_distinct_batches(int batches) {
+        for (int i = 0; i < batches; ++i) {
+            _controller.update(4096, 4096);
+        }
+    }
+
+protected:
+    RuntimeProfile _profile {"test"};
+    StreamingAggController _controller;
+};
+
+TEST_F(StreamingAggControllerTest, SmallTableAlwaysAggregates) {
+    EXPECT_EQ(Mode::AGGREGATE, _controller.next_mode(0, false));
+    feed_distinct_batches(10);
+    EXPECT_EQ(Mode::AGGREGATE, _controller.next_mode(L2_TABLE_BYTES, false));
+    EXPECT_EQ(2, counter("PreAggAggregateBatches"));
+    EXPECT_EQ(0, counter("PreAggModeSwitches"));
+}
+
+TEST_F(StreamingAggControllerTest, ReductionDecidesExpansion) {
+    // 4096 rows into 2048 groups
+    for (int i = 0; i < 10; ++i) {
+        _controller.update(4096, 2048);
+    }
+    EXPECT_DOUBLE_EQ(2.0, _controller.reduction());
+    EXPECT_EQ(Mode::AGGREGATE, _controller.next_mode(L3_TABLE_BYTES, false));
+    // the table does not grow into main memory for this reduction
+    EXPECT_EQ(Mode::PARTIAL, _controller.next_mode(MEMORY_TABLE_BYTES, false));
+    EXPECT_EQ(Mode::AGGREGATE, _controller.next_mode(L3_TABLE_BYTES, false));
+    // nor beyond the memory limit
+    EXPECT_EQ(Mode::PARTIAL, _controller.next_mode(L2_TABLE_BYTES, true));
+    EXPECT_EQ(3, counter("PreAggModeSwitches"));
+}
+
+TEST_F(StreamingAggControllerTest, ExceededMemoryAddsNoGroups) {
+    // 4096 rows into 2048 groups
+    for (int i = 0; i < 10; ++i) {
+        _controller.update(4096, 2048);
+    }
+    auto mode = _controller.next_mode(L3_TABLE_BYTES, false);
+    EXPECT_EQ(Mode::AGGREGATE, mode);
+    EXPECT_TRUE(_controller.may_add_groups(mode, false));
+    EXPECT_TRUE(_controller.may_add_groups(mode, true));
+
+    // the table uses the room it has left, but does not resize
+    mode = _controller.next_mode(MEMORY_TABLE_BYTES, false);
+    EXPECT_EQ(Mode::PARTIAL, mode);
+    EXPECT_TRUE(_controller.may_add_groups(mode, false));
+    EXPECT_FALSE(_controller.may_add_groups(mode, true));
+
+    // beyond the memory limit the batch only aggregates into the groups in the table, even
+    // if it has room for the others
+    mode = _controller.next_mode(L2_TABLE_BYTES, true);
+    EXPECT_EQ(Mode::PARTIAL, mode);
+    EXPECT_FALSE(_controller.may_add_groups(mode, false));
+    EXPECT_FALSE(_controller.may_add_groups(mode, true));
+
+    // and neither does a probed batch while passing through
+    feed_distinct_batches(20);
+    for (int i = 0; i < StreamingAggController::RESAMPLE_INTERVAL; ++i) {
+        mode = _controller.next_mode(L2_TABLE_BYTES, true);
+        EXPECT_FALSE(_controller.may_add_groups(mode, false));
+    }
+    EXPECT_EQ(Mode::PARTIAL, mode);
+
+    // the groups may be added again once the memory is released
+    mode = _controller.next_mode(L2_TABLE_BYTES, false);
+    EXPECT_EQ(Mode::AGGREGATE, mode);
+    EXPECT_TRUE(_controller.may_add_groups(mode, false));
+}
+
+TEST_F(StreamingAggControllerTest, PassThroughProbesPeriodically) {
+    feed_distinct_batches(10);
+    int partial = 0;
+    int pass_through = 0;
+    for (int i = 0; i < StreamingAggController::RESAMPLE_INTERVAL * 3; ++i) {
+        auto mode = _controller.next_mode(L3_TABLE_BYTES, false);
+        ASSERT_NE(Mode::AGGREGATE, mode);
+        if (mode == Mode::PARTIAL) {
+            ++partial;
+            // the probed batch found nothing either
+            _controller.update(4096, 4096);
+        } else {
+            ++pass_through;
+        }
+    }
+    EXPECT_EQ(3, partial);
+    EXPECT_EQ(StreamingAggController::RESAMPLE_INTERVAL * 3 - 3, pass_through);
+    EXPECT_EQ(partial, counter("PreAggPartialBatches"));
+    EXPECT_EQ(pass_through, counter("PreAggPassThroughBatches"));
+    // probing does not leave pass through
+    EXPECT_EQ(1, counter("PreAggModeSwitches"));
+}
+
+TEST_F(StreamingAggControllerTest, ProbeLeavesPassThrough) {
+    feed_distinct_batches(10);
+    auto mode = _controller.next_mode(L3_TABLE_BYTES, false);
+    EXPECT_EQ(Mode::PASS_THROUGH, mode);
+    while (mode == Mode::PASS_THROUGH) {
+        mode = _controller.next_mode(L3_TABLE_BYTES, false);
+    }
+    // the input changed, every row of the probed batch hits a group
+    _controller.update(4096, 0);
+    EXPECT_GT(_controller.reduction(), 1.1);
+    EXPECT_EQ(Mode::AGGREGATE, _controller.next_mode(L3_TABLE_BYTES, false));
+    EXPECT_EQ(2, counter("PreAggModeSwitches"));
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,340 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vanalytic_eval_node.h"
+
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/types.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+// Evaluates sum(v) over (partition by p order by o) on sorted input, with and without spilling
+// the buffered input blocks, and checks every result against a brute force computation.
+class VAnalyticEvalNodeTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        char buffer[1024];
+        EXPECT_NE(getcwd(buffer, sizeof(buffer)), nullptr);
+        _spill_dir = std::string(buffer) + "/vanalytic_eval_node_test";
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        ASSERT_TRUE(io::global_local_filesystem()->create_directory(_spill_dir).ok());
+        std::vector<StorePath> paths;
+        paths.emplace_back(_spill_dir, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        ASSERT_TRUE(_spill_manager->init().ok());
+    }
+
+    static void TearDownTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        _spill_manager.reset();
+    }
+
+    void SetUp() override { ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get(); }
+
+protected:
+    enum class Window { PARTITION, ROWS, RANGE };
+
+    static constexpr int BLOCK_ROWS = 1024;
+    // the partitions of 3000 rows cross the blocks, the peer groups have 2 rows
+    static constexpr int NUM_ROWS = 20000;
+    static constexpr int PARTITION_ROWS = 3000;
+
+    static int64_t p_of(int64_t row) { return row / PARTITION_ROWS; }
+    static int64_t o_of(int64_t row) { return row % PARTITION_ROWS / 2; }
+    static int64_t v_of(int64_t row) { return row * 7 % 101; }
+
+    static std::vector<Block> make_blocks() {
+        std::vector<Block> blocks;
+        for (int first = 0; first < NUM_ROWS; first += BLOCK_ROWS) {
+            auto p_column = ColumnInt32::create();
+            auto o_column = ColumnInt32::create();
+            auto v_column = ColumnInt32::create();
+            for (int i = first; i < std::min(NUM_ROWS, first + BLOCK_ROWS); ++i) {
+                p_column->insert_value(p_of(i));
+                o_column->insert_value(o_of(i));
+                v_column->insert_value(v_of(i));
+            }
+            Block block;
+            block.insert({std::move(p_column), std::make_shared<DataTypeInt32>(), "p"});
+            block.insert({std::move(o_column), std::make_shared<DataTypeInt32>(), "o"});
+            block.insert({std::move(v_column), std::make_shared<DataTypeInt32>(), "v"});
+            blocks.emplace_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    static int64_t expected_sum(Window window, int64_t row) {
+        int64_t partition_start = p_of(row) * PARTITION_ROWS;
+        int64_t partition_end = std::min<int64_t>(partition_start + PARTITION_ROWS, NUM_ROWS);
+        int64_t start = partition_start;
+        int64_t end = partition_end;
+        if (window == Window::ROWS) {
+            start = std::max(partition_start, row - 2);
+            end = std::min(partition_end, row + 2);
+        } else if (window == Window::RANGE) {
+            end = row + 1;
+            while (end < partition_end && o_of(end) == o_of(row)) {
+                ++end;
+            }
+        }
+        int64_t sum = 0;
+        for (int64_t i = start; i < end; ++i) {
+            sum += v_of(i);
+        }
+        return sum;
+    }
+
+    static TExprNode slot_ref_node(TSlotId slot_id, PrimitiveType type) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(create_type_desc(type));
+        node.__set_num_children(0);
+        node.__set_is_nullable(false);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(slot_id);
+        slot_ref.__set_tuple_id(0);
+        node.__set_slot_ref(slot_ref);
+        return node;
+    }
+
+    static TExpr slot_ref(TSlotId slot_id) {
+        TExpr expr;
+        expr.nodes.push_back(slot_ref_node(slot_id, TYPE_INT));
+        return expr;
+    }
+
+    // sum(v)
+    static TExpr sum_expr() {
+        TFunctionName name;
+        name.__set_function_name("sum");
+        TFunction fn;
+        fn.__set_name(name);
+        fn.__set_binary_type(TFunctionBinaryType::BUILTIN);
+        fn.__set_arg_types({create_type_desc(TYPE_INT)});
+        fn.__set_ret_type(create_type_desc(TYPE_BIGINT));
+        fn.__set_has_var_args(false);
+
+        TAggregateExpr agg_expr;
+        agg_expr.__set_is_merge_agg(false);
+        agg_expr.__set_param_types({create_type_desc(TYPE_INT)});
+
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::AGG_EXPR);
+        node.__set_type(create_type_desc(TYPE_BIGINT));
+        node.__set_num_children(1);
+        node.__set_is_nullable(false);
+        node.__set_fn(fn);
+        node.__set_agg_expr(agg_expr);
+
+        TExpr expr;
+        expr.nodes.push_back(node);
+        expr.nodes.push_back(slot_ref_node(2, TYPE_INT));
+        return expr;
+    }
+
+    static void add_tuple(TDescriptorTableBuilder* builder, PrimitiveType type,
+                          const std::vector<std::string>& names, bool nullable) {
+        TTupleDescriptorBuilder tuple_builder;
+        for (int i = 0; i < names.size(); ++i) {
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(type)
+                                           .nullable(nullable)
+                                           .column_name(names[i])
+                                           .column_pos(i)
+                                           .build());
+        }
+        tuple_builder.build(builder);
+    }
+
+    // tuple 0 is the input, 1 the buffered tuple, 2 and 3 the intermediate and output tuples
+    static TDescriptorTable make_desc_table() {
+        TDescriptorTableBuilder builder;
+        add_tuple(&builder, TYPE_INT, {"p", "o", "v"}, false);
+        add_tuple(&builder, TYPE_INT, {"p", "o", "v"}, false);
+        add_tuple(&builder, TYPE_BIGINT, {"sum"}, true);
+        add_tuple(&builder, TYPE_BIGINT, {"sum"}, true);
+        return builder.desc_tbl();
+    }
+
+    static TPlan make_plan(Window window) {
+        TAnalyticNode analytic_node;
+        analytic_node.__set_partition_exprs({slot_ref(0)});
+        analytic_node.__set_order_by_exprs({slot_ref(1)});
+        analytic_node.__set_analytic_functions({sum_expr()});
+        analytic_node.__set_intermediate_tuple_id(2);
+        analytic_node.__set_output_tuple_id(3);
+        analytic_node.__set_buffered_tuple_id(1);
+        if (window == Window::ROWS) {
+            TAnalyticWindowBoundary start;
+            start.__set_type(TAnalyticWindowBoundaryType::PRECEDING);
+            start.__set_rows_offset_value(2);
+            TAnalyticWindowBoundary end;
+            end.__set_type(TAnalyticWindowBoundaryType::FOLLOWING);
+            end.__set_rows_offset_value(1);
+            TAnalyticWindow analytic_window;
+            analytic_window.__set_type(TAnalyticWindowType::ROWS);
+            analytic_window.__set_window_start(start);
+            analytic_window.__set_window_end(end);
+            analytic_node.__set_window(analytic_window);
+        } else if (window == Window::RANGE) {
+            TAnalyticWindowBoundary end;
+            end.__set_type(TAnalyticWindowBoundaryType::CURRENT_ROW);
+            TAnalyticWindow analytic_window;
+            analytic_window.__set_type(TAnalyticWindowType::RANGE);
+            analytic_window.__set_window_end(end);
+            analytic_node.__set_window(analytic_window);
+        }
+
+        TPlanNode node;
+        node.__set_node_id(0);
+        node.__set_node_type(TPlanNodeType::ANALYTIC_EVAL_NODE);
+        node.__set_num_children(1);
+        node.__set_limit(-1);
+        node.__set_row_tuples({0, 3});
+        node.__set_nullable_tuples({false, false});
+        node.__set_compact_data(false);
+        node.__set_analytic_node(analytic_node);
+
+        TPlanNode child;
+        child.__set_node_id(1);
+        child.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        child.__set_num_children(0);
+        child.__set_limit(-1);
+        child.__set_row_tuples({0});
+        child.__set_nullable_tuples({false});
+        child.__set_compact_data(false);
+
+        TPlan plan;
+        plan.nodes.push_back(node);
+        plan.nodes.push_back(child);
+        return plan;
+    }
+
+    // Drives the node like the pipeline operators do: input blocks are sunk while the node needs
+    // more input, and the output is pulled otherwise. Returns the number of spilled blocks.
+    int64_t check_window(Window window, int64_t bytes_threshold, size_t max_output_blocks = 0) {
+        TQueryOptions query_options;
+        query_options.__set_batch_size(BLOCK_ROWS);
+        query_options.__set_external_analytic_bytes_threshold(bytes_threshold);
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.init_mem_trackers();
+
+        ObjectPool pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        EXPECT_TRUE(DescriptorTbl::create(&pool, make_desc_table(), &desc_tbl).ok());
+        state.set_desc_tbl(desc_tbl);
+        ExecNode* root = nullptr;
+        EXPECT_TRUE(ExecNode::create_tree(&state, &pool, make_plan(window), *desc_tbl, &root).ok());
+        auto* node = static_cast<VAnalyticEvalNode*>(root);
+        EXPECT_TRUE(node->prepare(&state).ok());
+        EXPECT_TRUE(node->alloc_resource(&state).ok());
+
+        auto input_blocks = make_blocks();
+        size_t next_input_block = 0;
+        size_t output_blocks = 0;
+        int64_t row = 0;
+        bool eos = false;
+        while (!eos && (max_output_blocks == 0 || output_blocks < max_output_blocks)) {
+            if (node->can_write() && next_input_block < input_blocks.size()) {
+                auto& block = input_blocks[next_input_block++];
+                EXPECT_TRUE(
+                        node->sink(&state, &block, next_input_block == input_blocks.size()).ok());
+                continue;
+            }
+            Block output_block;
+            EXPECT_TRUE(node->pull(&state, &output_block, &eos).ok());
+            if (output_block.rows() == 0) {
+                continue;
+            }
+            output_blocks++;
+            EXPECT_EQ(4, output_block.columns());
+            const auto& p_column = *output_block.get_by_position(0).column;
+            const auto& o_column = *output_block.get_by_position(1).column;
+            const auto& v_column = *output_block.get_by_position(2).column;
+            const auto& sum_column = *remove_nullable(output_block.get_by_position(3).column);
+            for (size_t i = 0; i < output_block.rows(); ++i, ++row) {
+                EXPECT_EQ(p_of(row), p_column.get_int(i));
+                EXPECT_EQ(o_of(row), o_column.get_int(i));
+                EXPECT_EQ(v_of(row), v_column.get_int(i));
+                EXPECT_EQ(expected_sum(window, row), sum_column.get_int(i)) << "row " << row;
+            }
+        }
+        if (max_output_blocks == 0) {
+            EXPECT_EQ(NUM_ROWS, row);
+        }
+
+        int64_t spilled_blocks = node->runtime_profile()->get_counter("SpilledBlocks")->value();
+        EXPECT_TRUE(node->close(&state).ok());
+        return spilled_blocks;
+    }
+
+    static std::string _spill_dir;
+    static std::unique_ptr<BlockSpillManager> _spill_manager;
+};
+
+std::string VAnalyticEvalNodeTest::_spill_dir;
+std::unique_ptr<BlockSpillManager> VAnalyticEvalNodeTest::_spill_manager;
+
+TEST_F(VAnalyticEvalNodeTest, NoSpill) {
+    for (auto window : {Window::PARTITION, Window::ROWS, Window::RANGE}) {
+        EXPECT_EQ(0, check_window(window, 0));
+    }
+}
+
+TEST_F(VAnalyticEvalNodeTest, SpillAllBlocks) {
+    // every block but the first one is spilled
+    for (auto window : {Window::PARTITION, Window::ROWS, Window::RANGE}) {
+        EXPECT_GT(check_window(window, 1), 0);
+    }
+}
+
+TEST_F(VAnalyticEvalNodeTest, SpillSomeBlocks) {
+    // The blocks are spilled while more than 3 blocks are buffered, the blocks after a spilled
+    // one keep their agg input on disk until it is loaded.
+    for (auto window : {Window::PARTITION, Window::ROWS, Window::RANGE}) {
+        EXPECT_GT(check_window(window, 3 * 3 * 4 * BLOCK_ROWS), 0);
+    }
+}
+
+TEST_F(VAnalyticEvalNodeTest, CloseWithSpilledBlocks) {
+    EXPECT_GT(check_window(Window::ROWS, 1, 1), 0);
+}
+
+} // namespace doris::vectorized
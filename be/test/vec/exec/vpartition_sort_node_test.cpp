@@ -0,0 +1,304 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vpartition_sort_node.h"
+
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/types.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+// Computes row_number(), rank() and dense_rank() <= n over (partition by p order by o) with the
+// partition topn node, with and without spilling the partitions, and checks the rows of every
+// partition against the expected ones.
+class VPartitionSortNodeTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        char buffer[1024];
+        EXPECT_NE(getcwd(buffer, sizeof(buffer)), nullptr);
+        _spill_dir = std::string(buffer) + "/vpartition_sort_node_test";
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        ASSERT_TRUE(io::global_local_filesystem()->create_directory(_spill_dir).ok());
+        std::vector<StorePath> paths;
+        paths.emplace_back(_spill_dir, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        ASSERT_TRUE(_spill_manager->init().ok());
+    }
+
+    static void TearDownTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_directory(_spill_dir));
+        _spill_manager.reset();
+    }
+
+    void SetUp() override { ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get(); }
+
+protected:
+    static constexpr int BLOCK_ROWS = 1024;
+    static constexpr int NUM_ROWS = 6000;
+    static constexpr int NUM_PARTITIONS = 3;
+    // The wide rows make the spilled rows be read back in blocks of about 1000 rows, so the
+    // limits and the peer groups of 3 rows cross the blocks.
+    static constexpr int VALUE_BYTES = 8192;
+
+    // the input is not sorted, row r is the input row r * 7919 % NUM_ROWS
+    static int64_t row_of(int64_t i) { return i * 7919 % NUM_ROWS; }
+    static int64_t p_of(int64_t row) { return row % NUM_PARTITIONS; }
+    static int64_t o_of(int64_t row) { return row / NUM_PARTITIONS / 3; }
+
+    static std::vector<Block> make_blocks() {
+        std::vector<Block> blocks;
+        for (int first = 0; first < NUM_ROWS; first += BLOCK_ROWS) {
+            auto p_column = ColumnInt32::create();
+            auto o_column = ColumnInt32::create();
+            auto v_column = ColumnString::create();
+            for (int i = first; i < std::min(NUM_ROWS, first + BLOCK_ROWS); ++i) {
+                int64_t row = row_of(i);
+                p_column->insert_value(p_of(row));
+                o_column->insert_value(o_of(row));
+                std::string v = std::to_string(row);
+                v.resize(VALUE_BYTES, 'x');
+                v_column->insert_data(v.data(), v.size());
+            }
+            Block block;
+            block.insert({std::move(p_column), std::make_shared<DataTypeInt32>(), "p"});
+            block.insert({std::move(o_column), std::make_shared<DataTypeInt32>(), "o"});
+            block.insert({std::move(v_column), std::make_shared<DataTypeString>(), "v"});
+            blocks.emplace_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    // The rows of a partition which the node returns, ordered by o and the row. Row k of the
+    // sorted partition has o = k / 3, so its rank is 3 * o + 1 and its dense rank o + 1.
+    static std::vector<std::pair<int64_t, int64_t>> expected_rows(TopNAlgorithm::type algorithm,
+                                                                  int64_t p, int64_t limit) {
+        std::vector<std::pair<int64_t, int64_t>> rows;
+        for (int64_t row = p; row < NUM_ROWS; row += NUM_PARTITIONS) {
+            int64_t k = row / NUM_PARTITIONS;
+            bool selected = algorithm == TopNAlgorithm::ROW_NUMBER ? k < limit
+                            : algorithm == TopNAlgorithm::RANK     ? 3 * o_of(row) < limit
+                                                                   : o_of(row) < limit;
+            if (selected) {
+                rows.emplace_back(o_of(row), row);
+            }
+        }
+        return rows;
+    }
+
+    static TExprNode slot_ref_node(TSlotId slot_id, PrimitiveType type) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(create_type_desc(type));
+        node.__set_num_children(0);
+        node.__set_is_nullable(false);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(slot_id);
+        slot_ref.__set_tuple_id(0);
+        node.__set_slot_ref(slot_ref);
+        return node;
+    }
+
+    static TExpr slot_ref(TSlotId slot_id) {
+        TExpr expr;
+        expr.nodes.push_back(slot_ref_node(slot_id, TYPE_INT));
+        return expr;
+    }
+
+    static TDescriptorTable make_desc_table() {
+        TDescriptorTableBuilder builder;
+        TTupleDescriptorBuilder tuple_builder;
+        std::vector<std::pair<std::string, PrimitiveType>> slots = {
+                {"p", TYPE_INT}, {"o", TYPE_INT}, {"v", TYPE_STRING}};
+        for (int i = 0; i < slots.size(); ++i) {
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(slots[i].second)
+                                           .nullable(false)
+                                           .column_name(slots[i].first)
+                                           .column_pos(i)
+                                           .build());
+        }
+        tuple_builder.build(&builder);
+        return builder.desc_tbl();
+    }
+
+    static TPlan make_plan(TopNAlgorithm::type algorithm, int64_t limit) {
+        TSortInfo sort_info;
+        sort_info.__set_ordering_exprs({slot_ref(1)});
+        sort_info.__set_is_asc_order({true});
+        sort_info.__set_nulls_first({false});
+
+        TPartitionSortNode partition_sort_node;
+        partition_sort_node.__set_partition_exprs({slot_ref(0)});
+        partition_sort_node.__set_sort_info(sort_info);
+        partition_sort_node.__set_has_global_limit(false);
+        partition_sort_node.__set_top_n_algorithm(algorithm);
+        partition_sort_node.__set_partition_inner_limit(limit);
+        partition_sort_node.__set_ptopn_phase(TPartTopNPhase::TWO_PHASE_GLOBAL);
+
+        TPlanNode node;
+        node.__set_node_id(0);
+        node.__set_node_type(TPlanNodeType::PARTITION_SORT_NODE);
+        node.__set_num_children(1);
+        node.__set_limit(-1);
+        node.__set_row_tuples({0});
+        node.__set_nullable_tuples({false});
+        node.__set_compact_data(false);
+        node.__set_partition_sort_node(partition_sort_node);
+
+        TPlanNode child;
+        child.__set_node_id(1);
+        child.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        child.__set_num_children(0);
+        child.__set_limit(-1);
+        child.__set_row_tuples({0});
+        child.__set_nullable_tuples({false});
+        child.__set_compact_data(false);
+
+        TPlan plan;
+        plan.nodes.push_back(node);
+        plan.nodes.push_back(child);
+        return plan;
+    }
+
+    // Sinks all the input blocks and checks the returned rows. Returns the number of partitions
+    // whose sorter spilled.
+    int check_partition_topn(TopNAlgorithm::type algorithm, int64_t limit,
+                             int64_t bytes_threshold) {
+        TQueryOptions query_options;
+        query_options.__set_batch_size(BLOCK_ROWS);
+        query_options.__set_external_sort_bytes_threshold(bytes_threshold);
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.init_mem_trackers();
+
+        ObjectPool pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        EXPECT_TRUE(DescriptorTbl::create(&pool, make_desc_table(), &desc_tbl).ok());
+        state.set_desc_tbl(desc_tbl);
+        ExecNode* root = nullptr;
+        EXPECT_TRUE(ExecNode::create_tree(&state, &pool, make_plan(algorithm, limit), *desc_tbl,
+                                          &root)
+                            .ok());
+        auto* node = static_cast<VPartitionSortNode*>(root);
+        EXPECT_TRUE(node->prepare(&state).ok());
+        EXPECT_TRUE(node->alloc_resource(&state).ok());
+
+        auto input_blocks = make_blocks();
+        for (size_t i = 0; i < input_blocks.size(); ++i) {
+            auto st = node->sink(&state, &input_blocks[i], i + 1 == input_blocks.size());
+            EXPECT_TRUE(st.ok()) << st;
+        }
+        int spilled_partitions = 0;
+        EXPECT_EQ(NUM_PARTITIONS, node->_partition_sorts.size());
+        for (const auto& sorter : node->_partition_sorts) {
+            spilled_partitions += sorter->is_spilled();
+        }
+
+        std::map<int64_t, std::vector<std::pair<int64_t, int64_t>>> partitions;
+        bool eos = false;
+        while (!eos) {
+            Block output_block;
+            auto st = node->pull(&state, &output_block, &eos);
+            EXPECT_TRUE(st.ok()) << st;
+            if (!st.ok()) {
+                break;
+            }
+            for (size_t i = 0; i < output_block.rows(); ++i) {
+                int64_t p = output_block.get_by_position(0).column->get_int(i);
+                int64_t o = output_block.get_by_position(1).column->get_int(i);
+                auto v = output_block.get_by_position(2).column->get_data_at(i).to_string();
+                EXPECT_EQ(VALUE_BYTES, v.size());
+                partitions[p].emplace_back(o, std::stoll(v));
+            }
+        }
+
+        EXPECT_EQ(NUM_PARTITIONS, partitions.size());
+        for (auto& [p, rows] : partitions) {
+            EXPECT_TRUE(std::is_sorted(rows.begin(), rows.end(), [](auto& lhs, auto& rhs) {
+                return lhs.first < rhs.first;
+            })) << "partition "
+                << p;
+            auto expected = expected_rows(algorithm, p, limit);
+            if (algorithm == TopNAlgorithm::ROW_NUMBER) {
+                // the peers of the last row can be any of them
+                ASSERT_EQ(expected.size(), rows.size()) << "partition " << p;
+                for (size_t i = 0; i < rows.size(); ++i) {
+                    EXPECT_EQ(expected[i].first, rows[i].first) << "partition " << p;
+                }
+            } else {
+                std::sort(rows.begin(), rows.end());
+                EXPECT_EQ(expected, rows) << "partition " << p;
+            }
+        }
+        EXPECT_TRUE(node->close(&state).ok());
+        return spilled_partitions;
+    }
+
+    static std::string _spill_dir;
+    static std::unique_ptr<BlockSpillManager> _spill_manager;
+};
+
+std::string VPartitionSortNodeTest::_spill_dir;
+std::unique_ptr<BlockSpillManager> VPartitionSortNodeTest::_spill_manager;
+
+TEST_F(VPartitionSortNodeTest, NoSpill) {
+    EXPECT_EQ(0, check_partition_topn(TopNAlgorithm::ROW_NUMBER, 1600, 0));
+    EXPECT_EQ(0, check_partition_topn(TopNAlgorithm::RANK, 1600, 0));
+    EXPECT_EQ(0, check_partition_topn(TopNAlgorithm::DENSE_RANK, 550, 0));
+}
+
+TEST_F(VPartitionSortNodeTest, SpillAllBlocks) {
+    // every block of every partition is spilled as soon as it is buffered
+    EXPECT_EQ(NUM_PARTITIONS, check_partition_topn(TopNAlgorithm::ROW_NUMBER, 1600, 1));
+    EXPECT_EQ(NUM_PARTITIONS, check_partition_topn(TopNAlgorithm::RANK, 1600, 1));
+    EXPECT_EQ(NUM_PARTITIONS, check_partition_topn(TopNAlgorithm::DENSE_RANK, 550, 1));
+}
+
+TEST_F(VPartitionSortNodeTest, SpillSomeBlocks) {
+    // The buffered blocks of a partition are moved to its sorter at about 1700 rows, the sorter
+    // keeps the first block of 1024 rows in memory and spills the later ones.
+    int64_t threshold = 1500 * VALUE_BYTES;
+    EXPECT_EQ(NUM_PARTITIONS, check_partition_topn(TopNAlgorithm::ROW_NUMBER, 1600, threshold));
+    EXPECT_EQ(NUM_PARTITIONS, check_partition_topn(TopNAlgorithm::RANK, 1600, threshold));
+    EXPECT_EQ(NUM_PARTITIONS, check_partition_topn(TopNAlgorithm::DENSE_RANK, 550, threshold));
+}
+
+} // namespace doris::vectorized
@@ -356,6 +356,11 @@ public class SessionVariable implements Serializable, Writable {
     public static final String EXTERNAL_SORT_BYTES_THRESHOLD = "external_sort_bytes_threshold";
     public static final String EXTERNAL_AGG_BYTES_THRESHOLD = "external_agg_bytes_threshold";
     public static final String EXTERNAL_AGG_PARTITION_BITS = "external_agg_partition_bits";
+    public static final String EXTERNAL_JOIN_BYTES_THRESHOLD = "external_join_bytes_threshold";
+    public static final String EXTERNAL_JOIN_PARTITION_BITS = "external_join_partition_bits";
+    public static final String PARALLEL_HASH_JOIN_BUILD_NUM = "parallel_hash_join_build_num";
+    public static final String EXTERNAL_ANALYTIC_BYTES_THRESHOLD = "external_analytic_bytes_threshold";
+    public static final String SPILL_COMPRESSION_CODEC = "spill_compression_codec";
 
     public static final String ENABLE_TWO_PHASE_READ_OPT = "enable_two_phase_read_opt";
     public static final String TOPN_OPT_LIMIT_THRESHOLD = "topn_opt_limit_threshold";
@@ -1233,6 +1238,35 @@ public class SessionVariable implements Serializable, Writable {
             checker = "checkExternalAggPartitionBits", fuzzy = true)
     public int externalAggPartitionBits = 8; // means that the hash table will be partitioned into 256 blocks.
 
+    // Set to 0 to disable; min: 128M
+    public static final long MIN_EXTERNAL_JOIN_BYTES_THRESHOLD = 134217728;
+    @VariableMgr.VarAttr(name = EXTERNAL_JOIN_BYTES_THRESHOLD,
+            checker = "checkExternalJoinBytesThreshold")
+    public long externalJoinBytesThreshold = 0;
+
+    public static final int MIN_EXTERNAL_JOIN_PARTITION_BITS = 2;
+    public static final int MAX_EXTERNAL_JOIN_PARTITION_BITS = 8;
+    @VariableMgr.VarAttr(name = EXTERNAL_JOIN_PARTITION_BITS,
+            checker = "checkExternalJoinPartitionBits")
+    public int externalJoinPartitionBits = 4; // 16 partitions of each level of a spilled hash join
+
+    // Set to 0 to disable; min: 128M
+    public static final long MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD = 134217728;
+    @VariableMgr.VarAttr(name = EXTERNAL_ANALYTIC_BYTES_THRESHOLD,
+            checker = "checkExternalAnalyticBytesThreshold")
+    public long externalAnalyticBytesThreshold = 0;
+
+    // Codec of the blocks spilled to disk: none, lz4 or zstd
+    public static final List<String> SPILL_COMPRESSION_CODECS = ImmutableList.of("none", "lz4", "zstd");
+    @VariableMgr.VarAttr(name = SPILL_COMPRESSION_CODEC, checker = "checkSpillCompressionCodec")
+    public String spillCompressionCodec = "lz4";
+
+    // Number of threads building a large hash table of a hash join, 0 or 1 to build it serially
+    public static final int MAX_PARALLEL_HASH_JOIN_BUILD_NUM = 64;
+    @VariableMgr.VarAttr(name = PARALLEL_HASH_JOIN_BUILD_NUM, fuzzy = true,
+            checker = "checkParallelHashJoinBuildNum")
+    public int parallelHashJoinBuildNum = 0;
+
     // Whether enable two phase read optimization
     // 1. read related rowids along with necessary column data
     // 2. spawn fetch RPC to other nodes to get related data by sorted rowids
@@ -1602,6 +1636,7 @@ public class SessionVariable implements Serializable, Writable {
         this.partitionedHashJoinRowsThreshold = random.nextBoolean() ? 8 : 1048576;
         this.partitionedHashAggRowsThreshold = random.nextBoolean() ? 8 : 1048576;
         this.enableShareHashTableForBroadcastJoin = random.nextBoolean();
+        this.parallelHashJoinBuildNum = random.nextInt(4);
         // this.enableHashJoinEarlyStartProbe = random.nextBoolean();
         int randomInt = random.nextInt(4);
         if (randomInt % 2 == 0) {
@@ -2642,6 +2677,51 @@ public class SessionVariable implements Serializable, Writable {
         }
     }
 
+    public void checkExternalJoinBytesThreshold(String externalJoinBytesThreshold) {
+        long value = Long.valueOf(externalJoinBytesThreshold);
+        if (value > 0 && value < MIN_EXTERNAL_JOIN_BYTES_THRESHOLD) {
+            LOG.warn("external join bytes threshold: {}, min: {}", value, MIN_EXTERNAL_JOIN_BYTES_THRESHOLD);
+            throw new UnsupportedOperationException("minimum value is " + MIN_EXTERNAL_JOIN_BYTES_THRESHOLD);
+        }
+    }
+
+    public void checkExternalAnalyticBytesThreshold(String externalAnalyticBytesThreshold) {
+        long value = Long.valueOf(externalAnalyticBytesThreshold);
+        if (value > 0 && value < MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD) {
+            LOG.warn("external analytic bytes threshold: {}, min: {}", value,
+                    MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD);
+            throw new UnsupportedOperationException("minimum value is " + MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD);
+        }
+    }
+
+    public void checkExternalJoinPartitionBits(String externalJoinPartitionBits) {
+        int value = Integer.valueOf(externalJoinPartitionBits);
+        if (value < MIN_EXTERNAL_JOIN_PARTITION_BITS || value > MAX_EXTERNAL_JOIN_PARTITION_BITS) {
+            LOG.warn("external join partition bits: {}, min: {}, max: {}",
+                    value, MIN_EXTERNAL_JOIN_PARTITION_BITS, MAX_EXTERNAL_JOIN_PARTITION_BITS);
+            throw new UnsupportedOperationException("min value is " + MIN_EXTERNAL_JOIN_PARTITION_BITS
+                    + " max value is " + MAX_EXTERNAL_JOIN_PARTITION_BITS);
+        }
+    }
+
+    public void checkParallelHashJoinBuildNum(String parallelHashJoinBuildNum) {
+        int value = Integer.valueOf(parallelHashJoinBuildNum);
+        if (value < 0 || value > MAX_PARALLEL_HASH_JOIN_BUILD_NUM) {
+            LOG.warn("parallel hash join build num: {}, min: 0, max: {}",
+                    value, MAX_PARALLEL_HASH_JOIN_BUILD_NUM);
+            throw new UnsupportedOperationException("min value is 0 max value is "
+                    + MAX_PARALLEL_HASH_JOIN_BUILD_NUM);
+        }
+    }
+
+    public void checkSpillCompressionCodec(String spillCompressionCodec) {
+        if (!SPILL_COMPRESSION_CODECS.contains(spillCompressionCodec.trim().toLowerCase())) {
+            LOG.warn("spill compression codec is invalid, the invalid value is {}", spillCompressionCodec);
+            throw new UnsupportedOperationException("spill compression codec should be one of "
+                    + SPILL_COMPRESSION_CODECS + ", the invalid value is " + spillCompressionCodec);
+        }
+    }
+
     public void checkExternalAggPartitionBits(String externalAggPartitionBits) {
         int value = Integer.valueOf(externalAggPartitionBits);
         if (value < MIN_EXTERNAL_AGG_PARTITION_BITS || value > MAX_EXTERNAL_AGG_PARTITION_BITS) {
@@ -2830,6 +2910,12 @@ public class SessionVariable implements Serializable, Writable {
 
         tResult.setExternalAggPartitionBits(externalAggPartitionBits);
 
+        tResult.setExternalJoinBytesThreshold(externalJoinBytesThreshold);
+        tResult.setExternalJoinPartitionBits(externalJoinPartitionBits);
+        tResult.setParallelHashJoinBuildNum(parallelHashJoinBuildNum);
+        tResult.setExternalAnalyticBytesThreshold(externalAnalyticBytesThreshold);
+        tResult.setSpillCompressionCodec(spillCompressionCodec.trim().toLowerCase());
+
         tResult.setEnableFileCache(enableFileCache);
 
         tResult.setEnablePageCache(enablePageCache);
@@ -132,6 +132,24 @@ public class SessionVariablesTest extends TestWithFeService {
         Assert.assertEquals(num, result.size());
     }
 
+    @Test
+    public void testSpillCompressionCodec() throws Exception {
+        connectContext.setThreadLocalInfo();
+        SessionVariable sessionVar = connectContext.getSessionVariable();
+        for (String codec : new String[] {"none", "ZSTD", "lz4"}) {
+            SetStmt setStmt = (SetStmt) parseAndAnalyzeStmt("set spill_compression_codec='" + codec + "'",
+                    connectContext);
+            new SetExecutor(connectContext, setStmt).execute();
+            Assertions.assertEquals(codec, sessionVar.spillCompressionCodec);
+        }
+
+        SetStmt setStmt = (SetStmt) parseAndAnalyzeStmt("set spill_compression_codec='snappy'", connectContext);
+        SetExecutor setExecutor = new SetExecutor(connectContext, setStmt);
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class, "spill compression codec should be one of",
+                () -> setExecutor.execute());
+        Assertions.assertEquals("lz4", sessionVar.spillCompressionCodec);
+    }
+
     @Test
     public void testForwardSessionVariables() {
         Map<String, String> vars = sessionVariable.getForwardVariables();
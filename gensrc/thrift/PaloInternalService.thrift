@@ -272,6 +272,22 @@ struct TQueryOptions {
 
   98: optional bool skip_bad_tablet = false;
 
+  // spill the build side of a hash join to disk when it uses more memory than this, 0 to disable
+  99: optional i64 external_join_bytes_threshold = 0;
+
+  // partition count(1 << external_join_partition_bits) of each level of a spilled hash join
+  100: optional i32 external_join_partition_bits = 4;
+
+  // number of threads building the hash table of a hash join, 0 or 1 to build it serially
+  101: optional i32 parallel_hash_join_build_num = 0;
+
+  // spill the buffered input of an analytic node to disk when it uses more memory than this,
+  // 0 to disable
+  102: optional i64 external_analytic_bytes_threshold = 0;
+
+  // codec of the blocks spilled to disk: none, lz4 or zstd
+  103: optional string spill_compression_codec;
+
   // For cloud, to control if the content would be written into file cache
   1000: optional bool disable_file_cache = false
 }